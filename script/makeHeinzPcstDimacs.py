@@ -12,6 +12,7 @@ filename1 = full_output_dir + "/" + "1-" + filename
 filename2 = full_output_dir + "/" + "2-" + filename
 filename3 = full_output_dir + "/" + "3-" + filename
 filename4 = full_output_dir + "/" + "4-" + filename
+filename5 = full_output_dir + "/" + "5-" + filename
 timelimit_pbs = sys.argv[4]
 timelimit_heinz = sys.argv[5]
 
@@ -25,4 +26,5 @@ print "( /usr/bin/time -o " + filename1 + ".time bin/heinz_pcst_no_pre " + full_
 print "( /usr/bin/time -o " + filename2 + ".time bin/heinz_pcst_no_dc " + full_filename + " " + timelimit_heinz + " 2 " + filename2 + ".dimacs" + " > " + filename2 + ".out 2> " + filename2 + ".err ) &"
 print "( /usr/bin/time -o " + filename3 + ".time bin/heinz_pcst_dc " + full_filename + " " + timelimit_heinz + " 2 " + filename3 + ".dimacs" + " > " + filename3 + ".out 2> " + filename3 + ".err ) &"
 print "( /usr/bin/time -o " + filename4 + ".time bin/heinz_pcst_mc " + full_filename + " " + timelimit_heinz + " 2 " + filename4 + ".dimacs" + " > " + filename4 + ".out 2> " + filename4 + ".err ) &"
+print "( /usr/bin/time -o " + filename5 + ".time bin/heinz_pcst_native " + full_filename + " " + timelimit_heinz + " 2 " + filename5 + ".dimacs" + " > " + filename5 + ".out 2> " + filename5 + ".err ) &"
 print "wait"
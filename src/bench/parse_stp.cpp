@@ -0,0 +1,393 @@
+/*
+ *  parse_stp.cpp
+ *
+ *   Created on: 16-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <set>
+#include <limits>
+#include <string.h>
+#include <algorithm>
+#include <lemon/arg_parser.h>
+#include <lemon/time_measure.h>
+
+#include "parser/mappedfile.h"
+#include "parser/stpparser.h"
+#include "parser/stppcstparser.h"
+
+#include "utils.h"
+#include "config.h"
+
+using namespace nina;
+using namespace nina::mwcs;
+
+typedef Parser<Graph> ParserType;
+typedef StpParser<Graph> StpParserType;
+typedef StpPcstParser<Graph> StpPcstParserType;
+typedef ParserType::InvIdNodeMap InvIdNodeMap;
+
+struct Instance
+{
+  Graph _g;
+  Graph::NodeMap<std::string> _label;
+  DoubleNodeMap _weight;
+  InvIdNodeMap _invLabel;
+  std::set<int> _root;
+  double _profit;
+
+  Instance()
+    : _g()
+    , _label(_g)
+    , _weight(_g)
+    , _invLabel()
+    , _root()
+    , _profit(0)
+  {
+  }
+};
+
+static bool parse(const std::string& filename,
+                  bool pcst,
+                  bool mapped,
+                  Instance& instance,
+                  std::string& name)
+{
+  instance._invLabel.clear();
+
+  bool res = false;
+  if (pcst)
+  {
+    StpPcstParserType parser(filename);
+    parser.setMapped(mapped);
+    parser.setGraph(&instance._g);
+    parser.setIdNodeMap(&instance._label);
+    parser.setWeightNodeMap(&instance._weight);
+    parser.setInvIdNodeMap(&instance._invLabel);
+    res = parser.parse();
+    name = parser.getName();
+
+    StpPcstParserType::NodeSet root = parser.getRootNodes();
+    for (StpPcstParserType::NodeSet::const_iterator it = root.begin(); it != root.end(); ++it)
+    {
+      instance._root.insert(instance._g.id(*it));
+    }
+    instance._profit = parser.getTotalNodeProfit();
+  }
+  else
+  {
+    StpParserType parser(filename);
+    parser.setMapped(mapped);
+    parser.setGraph(&instance._g);
+    parser.setIdNodeMap(&instance._label);
+    parser.setWeightNodeMap(&instance._weight);
+    parser.setInvIdNodeMap(&instance._invLabel);
+    res = parser.parse();
+    name = parser.getName();
+  }
+
+  return res;
+}
+
+static bool getLine(std::istream& in, std::string& line)
+{
+  if (!std::getline(in, line))
+    return false;
+
+  if (!line.empty() && line[line.size() - 1] == '\r')
+    line.erase(line.size() - 1);
+  return true;
+}
+
+static bool skipTo(std::istream& in, std::string& line, const char* prefix)
+{
+  while (getLine(in, line))
+  {
+    if (line.compare(0, strlen(prefix), prefix) == 0)
+      return true;
+  }
+  return false;
+}
+
+static void setLabel(Instance& instance, Node u, const char* label)
+{
+  instance._label[u] = label;
+  instance._invLabel.set(label, label + strlen(label), u);
+}
+
+/// Reference parse along the std::istream path the STP parsers used
+/// before LineTokenizer: lines are split by a std::stringstream and
+/// numbers are read with operator>>, i.e. by strtod rather than by
+/// LineTokenizer::scanDouble
+static bool referenceParse(const std::string& filename,
+                           bool pcst,
+                           Instance& instance,
+                           std::string& name)
+{
+  std::ifstream in(filename.c_str());
+  std::string line, text;
+  char buf[1024];
+
+  if (!getLine(in, line) || line.substr(0, 8) != "33D32945"
+      || !skipTo(in, line, "Name") || line.size() < 6)
+  {
+    std::cerr << "Error: reference parse of " << filename << " failed at header" << std::endl;
+    return false;
+  }
+  name = line.substr(5);
+
+  int nNodes = -1, nEdges = -1;
+  if (!skipTo(in, line, "SECTION Graph")
+      || !getLine(in, line) || !(std::stringstream(line) >> text >> nNodes) || text != "Nodes"
+      || !getLine(in, line) || !(std::stringstream(line) >> text >> nEdges) || text != "Edges")
+  {
+    std::cerr << "Error: reference parse of " << filename << " failed at graph section" << std::endl;
+    return false;
+  }
+
+  instance._invLabel.clear();
+  instance._root.clear();
+  instance._profit = 0;
+
+  for (int i = 0; i < nNodes; ++i)
+  {
+    Node u = instance._g.addNode();
+    instance._weight[u] = 0;
+    if (pcst)
+    {
+      snprintf(buf, 1024, "%d", i + 1);
+      setLabel(instance, u, buf);
+    }
+  }
+
+  for (int i = 0; i < nEdges; ++i)
+  {
+    int idU = -1, idV = -1;
+    double costUV = 0;
+    if (!getLine(in, line))
+      return false;
+
+    std::stringstream ss(line);
+    ss >> text >> idU >> idV;
+    if (pcst)
+      ss >> costUV;
+
+    if (text != "E" || !(0 < idU && idU <= nNodes) || !(0 < idV && idV <= nNodes))
+    {
+      std::cerr << "Error: reference parse of " << filename << " failed at edge " << i << std::endl;
+      return false;
+    }
+
+    Node u = instance._g.nodeFromId(idU - 1);
+    Node v = instance._g.nodeFromId(idV - 1);
+    if (pcst)
+    {
+      Node uv = instance._g.addNode();
+      instance._g.addEdge(u, uv);
+      instance._g.addEdge(uv, v);
+      instance._weight[uv] = -costUV;
+      snprintf(buf, 1024, "%d--%d", idU, idV);
+      setLabel(instance, uv, buf);
+    }
+    else
+    {
+      instance._g.addEdge(u, v);
+    }
+  }
+
+  int nTerminals = -1;
+  if (!skipTo(in, line, "SECTION Terminals")
+      || !getLine(in, line) || !(std::stringstream(line) >> text >> nTerminals) || text != "Terminals")
+  {
+    std::cerr << "Error: reference parse of " << filename << " failed at terminal section" << std::endl;
+    return false;
+  }
+
+  for (int i = 0; i < nTerminals; ++i)
+  {
+    int idU = -1;
+    double weightU = 0;
+    if (!getLine(in, line))
+      return false;
+
+    std::stringstream ss(line);
+    ss >> text >> idU >> weightU;
+
+    if (!(0 < idU && idU <= nNodes))
+    {
+      std::cerr << "Error: reference parse of " << filename << " failed at terminal " << i << std::endl;
+      return false;
+    }
+
+    Node u = instance._g.nodeFromId(idU - 1);
+    if (text == "RootP")
+    {
+      instance._root.insert(idU - 1);
+    }
+    else
+    {
+      instance._weight[u] = weightU;
+      if (pcst)
+      {
+        instance._profit += weightU;
+      }
+      else
+      {
+        snprintf(buf, 1024, "%d", idU);
+        setLabel(instance, u, buf);
+      }
+    }
+  }
+
+  return true;
+}
+
+static bool identical(const Instance& a, const Instance& b)
+{
+  if (lemon::countNodes(a._g) != lemon::countNodes(b._g)
+      || lemon::countEdges(a._g) != lemon::countEdges(b._g)
+      || a._invLabel.size() != b._invLabel.size()
+      || a._root != b._root
+      || memcmp(&a._profit, &b._profit, sizeof(double)) != 0)
+  {
+    return false;
+  }
+
+  for (NodeIt v(a._g); v != lemon::INVALID; ++v)
+  {
+    Node w = b._g.nodeFromId(a._g.id(v));
+    if (a._label[v] != b._label[w]
+        || memcmp(&a._weight[v], &b._weight[w], sizeof(double)) != 0)
+    {
+      return false;
+    }
+  }
+
+  for (EdgeIt e(a._g); e != lemon::INVALID; ++e)
+  {
+    Edge f = b._g.edgeFromId(a._g.id(e));
+    if (a._g.id(a._g.u(e)) != b._g.id(b._g.u(f))
+        || a._g.id(a._g.v(e)) != b._g.id(b._g.v(f)))
+    {
+      return false;
+    }
+  }
+
+  for (int i = 0; i < a._invLabel.size(); ++i)
+  {
+    int j = b._invLabel.find(a._invLabel.label(i));
+    if (j == -1 || a._g.id(a._invLabel.value(i)) != b._g.id(b._invLabel.value(j)))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  int repeats = 5;
+  int verbosityLevel = 1;
+
+  lemon::ArgParser ap(argc, argv);
+  ap
+    .boolOption("version", "Show version number")
+    .boolOption("pcst", "Inputs are STP-PCST files")
+    .refOption("r", "Number of repetitions per mode (default: 5)", repeats, false)
+    .refOption("v", "Specifies the verbosity level:\n"
+               "     0 - No output\n"
+               "     1 - Only necessary output (default)\n"
+               "     2 - More verbose output\n"
+               "     3 - Debug output", verbosityLevel, false)
+    .other("file", "STP input file(s)");
+  ap.parse();
+
+  if (ap.given("version"))
+  {
+    std::cout << "Version number: " << HEINZ_VERSION << std::endl;
+    return 0;
+  }
+
+  if (ap.files().empty() || repeats < 1)
+  {
+    std::cerr << "Usage: " << argv[0] << " [-pcst] [-r <repeats>] <file> ..." << std::endl;
+    return 1;
+  }
+
+  g_verbosity = static_cast<VerbosityLevel>(verbosityLevel);
+  bool pcst = ap.given("pcst");
+
+  std::cout << std::left << std::setw(40) << "file"
+            << std::right << std::setw(12) << "MB"
+            << std::setw(14) << "ref MB/s"
+            << std::setw(14) << "stream MB/s"
+            << std::setw(14) << "mapped MB/s"
+            << std::setw(10) << "speedup"
+            << std::setw(11) << "identical" << std::endl;
+
+  bool allIdentical = true;
+  for (size_t i = 0; i < ap.files().size(); ++i)
+  {
+    const std::string& filename = ap.files()[i];
+
+    MappedFile file;
+    if (!file.open(filename))
+    {
+      std::cerr << "Error: could not open file " << filename << " for reading" << std::endl;
+      return 1;
+    }
+    double mb = file.size() / (1024. * 1024.);
+    file.close();
+
+    // best of 'repeats' runs, fresh graph for every run
+    double best[3] = { std::numeric_limits<double>::max(),
+                       std::numeric_limits<double>::max(),
+                       std::numeric_limits<double>::max() };
+    bool same = true;
+    for (int r = 0; r < repeats; ++r)
+    {
+      Instance refInstance, streamInstance, mappedInstance;
+      std::string refName, streamName, mappedName;
+
+      lemon::Timer t;
+      if (!referenceParse(filename, pcst, refInstance, refName))
+        return 1;
+      best[0] = std::min(best[0], t.realTime());
+
+      t.restart();
+      if (!parse(filename, pcst, false, streamInstance, streamName))
+        return 1;
+      best[1] = std::min(best[1], t.realTime());
+
+      t.restart();
+      if (!parse(filename, pcst, true, mappedInstance, mappedName))
+        return 1;
+      best[2] = std::min(best[2], t.realTime());
+
+      // both modes must give exactly the graph the reference parse gives
+      if (r == 0)
+      {
+        same = refName == streamName && refName == mappedName
+          && identical(refInstance, streamInstance)
+          && identical(refInstance, mappedInstance);
+      }
+    }
+
+    allIdentical = allIdentical && same;
+    std::cout << std::left << std::setw(40) << filename
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << mb
+              << std::setw(14) << mb / best[0]
+              << std::setw(14) << mb / best[1]
+              << std::setw(14) << mb / best[2]
+              << std::setw(10) << best[0] / best[2]
+              << std::setw(11) << (same ? "yes" : "NO") << std::endl;
+  }
+
+  return allIdentical ? 0 : 1;
+}
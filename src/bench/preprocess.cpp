@@ -0,0 +1,228 @@
+/*
+ *  preprocess.cpp
+ *
+ *   Created on: 16-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <lemon/arg_parser.h>
+#include <lemon/time_measure.h>
+
+#include "parser/stpparser.h"
+#include "parser/stppcstparser.h"
+#include "mwcspreprocessedgraph.h"
+
+#include "utils.h"
+#include "config.h"
+
+using namespace nina;
+using namespace nina::mwcs;
+
+typedef StpParser<Graph> StpParserType;
+typedef StpPcstParser<Graph> StpPcstParserType;
+typedef MwcsPreprocessedGraph<Graph> MwcsPreprocessedGraphType;
+typedef MwcsPreprocessedGraphType::NodeSet NodeSet;
+typedef MwcsPreprocessedGraphType::NodeSetIt NodeSetIt;
+typedef std::vector<std::string> StringVector;
+typedef MwcsPreprocessedGraphType::RuleStatistics RuleStatistics;
+typedef MwcsPreprocessedGraphType::RuleStatisticsVector RuleStatisticsVector;
+
+static bool load(const std::string& filename,
+                 bool pcst,
+                 MwcsPreprocessedGraphType& instance,
+                 NodeSet& rootNodes)
+{
+  if (pcst)
+  {
+    StpPcstParserType parser(filename);
+    if (!instance.init(&parser, false))
+      return false;
+    rootNodes = parser.getRootNodes();
+  }
+  else
+  {
+    StpParserType parser(filename);
+    if (!instance.init(&parser, false))
+      return false;
+  }
+
+  return true;
+}
+
+/// Writes the reduced graph such that two runs can be compared with diff:
+/// every node is identified by the sorted ids of its original nodes and
+/// every edge by the smallest original id of its end nodes, both sorted
+static void writeReducedGraph(const MwcsPreprocessedGraphType& instance,
+                              std::ostream& out)
+{
+  const Graph& orgG = instance.getOrgGraph();
+  const Graph& g = instance.getGraph();
+  Graph::NodeMap<int> key(g);
+
+  StringVector lines;
+  for (Graph::NodeIt v(g); v != lemon::INVALID; ++v)
+  {
+    std::vector<int> ids;
+    const NodeSet orgNodes = instance.getOrgNodes(v);
+    for (NodeSetIt nodeIt = orgNodes.begin(); nodeIt != orgNodes.end(); ++nodeIt)
+    {
+      ids.push_back(orgG.id(*nodeIt));
+    }
+    std::sort(ids.begin(), ids.end());
+    key[v] = ids.front();
+
+    std::stringstream line;
+    line << "V " << std::setprecision(12) << instance.getScore(v);
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+      line << " " << ids[i];
+    }
+    lines.push_back(line.str());
+  }
+  std::sort(lines.begin(), lines.end());
+  for (size_t i = 0; i < lines.size(); ++i)
+  {
+    out << lines[i] << "\n";
+  }
+
+  std::vector<std::pair<int, int> > edges;
+  for (Graph::EdgeIt e(g); e != lemon::INVALID; ++e)
+  {
+    edges.push_back(std::make_pair(std::min(key[g.u(e)], key[g.v(e)]),
+                                   std::max(key[g.u(e)], key[g.v(e)])));
+  }
+  std::sort(edges.begin(), edges.end());
+  for (size_t i = 0; i < edges.size(); ++i)
+  {
+    out << "E " << edges[i].first << " " << edges[i].second << "\n";
+  }
+}
+
+static void printRuleStatistics(const RuleStatisticsVector& ruleStatistics)
+{
+  for (size_t i = 0; i < ruleStatistics.size(); ++i)
+  {
+    const RuleStatistics& stats = ruleStatistics[i];
+    std::cout << "  " << stats._phase << " " << std::left << std::setw(20) << stats._name
+              << std::right << std::setw(10) << stats._nInvocations
+              << std::setw(10) << stats._nEffective
+              << std::setw(10) << stats._nRemovedNodes
+              << std::fixed << std::setprecision(4)
+              << std::setw(12) << stats._time << std::endl;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  int repeats = 5;
+  int nThreads = 1;
+  int verbosityLevel = 0;
+  std::string outputDir;
+
+  lemon::ArgParser ap(argc, argv);
+  ap
+    .boolOption("version", "Show version number")
+    .boolOption("pcst", "Inputs are STP-PCST files, root nodes are kept")
+    .boolOption("stats", "Print the invocations, effective invocations, removed nodes\n"
+                "     and time of every rule (of the last repetition)")
+    .refOption("r", "Number of repetitions per file (default: 5)", repeats, false)
+    .refOption("m", "Number of threads (default: 1)", nThreads, false)
+    .refOption("o", "Directory to write the reduced graph of every file to,\n"
+               "     as <file name>.reduced", outputDir, false)
+    .refOption("v", "Specifies the verbosity level:\n"
+               "     0 - No output (default)\n"
+               "     1 - Only necessary output\n"
+               "     2 - More verbose output\n"
+               "     3 - Debug output", verbosityLevel, false)
+    .other("file", "STP input file(s)");
+  ap.parse();
+
+  if (ap.given("version"))
+  {
+    std::cout << "Version number: " << HEINZ_VERSION << std::endl;
+    return 0;
+  }
+
+  if (ap.files().empty() || repeats < 1)
+  {
+    std::cerr << "Usage: " << argv[0] << " [-pcst] [-stats] [-r <repeats>] [-m <threads>] [-o <dir>] <file> ..." << std::endl;
+    return 1;
+  }
+
+  g_verbosity = static_cast<VerbosityLevel>(verbosityLevel);
+  bool pcst = ap.given("pcst");
+  bool stats = ap.given("stats");
+
+  std::cout << std::left << std::setw(40) << "file"
+            << std::right << std::setw(10) << "nodes"
+            << std::setw(10) << "edges"
+            << std::setw(10) << "nodes'"
+            << std::setw(10) << "edges'"
+            << std::setw(12) << "best s"
+            << std::setw(12) << "mean s" << std::endl;
+
+  for (size_t i = 0; i < ap.files().size(); ++i)
+  {
+    const std::string& filename = ap.files()[i];
+
+    MwcsPreprocessedGraphType instance;
+    instance.setThreads(nThreads);
+    NodeSet rootNodes;
+    if (!load(filename, pcst, instance, rootNodes))
+    {
+      std::cerr << "Error: could not parse " << filename << std::endl;
+      return 1;
+    }
+
+    // every run starts from a fresh copy of the parsed graph
+    double best = std::numeric_limits<double>::max();
+    double total = 0;
+    for (int r = 0; r < repeats; ++r)
+    {
+      instance.clear();
+
+      lemon::Timer t;
+      instance.preprocess(rootNodes);
+      double time = t.realTime();
+      best = std::min(best, time);
+      total += time;
+    }
+
+    std::cout << std::left << std::setw(40) << filename
+              << std::right << std::setw(10) << instance.getOrgNodeCount()
+              << std::setw(10) << instance.getOrgEdgeCount()
+              << std::setw(10) << instance.getNodeCount()
+              << std::setw(10) << instance.getEdgeCount()
+              << std::fixed << std::setprecision(4)
+              << std::setw(12) << best
+              << std::setw(12) << total / repeats << std::endl;
+
+    if (stats)
+    {
+      printRuleStatistics(instance.getRuleStatistics());
+    }
+
+    if (!outputDir.empty())
+    {
+      const std::string outputFilename = outputDir + "/"
+        + filename.substr(filename.find_last_of('/') + 1) + ".reduced";
+      std::ofstream out(outputFilename.c_str());
+      if (!out.good())
+      {
+        std::cerr << "Error: could not write to " << outputFilename << std::endl;
+        return 1;
+      }
+      writeReducedGraph(instance, out);
+    }
+  }
+
+  return 0;
+}
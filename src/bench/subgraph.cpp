@@ -0,0 +1,243 @@
+/*
+ *  subgraph.cpp
+ *
+ *   Created on: 17-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <sys/resource.h>
+#include <lemon/arg_parser.h>
+#include <lemon/time_measure.h>
+#include <lemon/adaptors.h>
+
+#include "parser/stpparser.h"
+#include "parser/stppcstparser.h"
+#include "mwcspreprocessedgraph.h"
+#include "mwcssubinstance.h"
+
+#include "utils.h"
+#include "config.h"
+
+using namespace nina;
+using namespace nina::mwcs;
+
+typedef StpParser<Graph> StpParserType;
+typedef StpPcstParser<Graph> StpPcstParserType;
+typedef MwcsPreprocessedGraph<Graph> MwcsPreprocessedGraphType;
+typedef MwcsSubInstance<Graph> SubInstanceType;
+typedef MwcsPreprocessedGraphType::NodeSet NodeSet;
+typedef MwcsPreprocessedGraphType::LabelNodeMap LabelNodeMap;
+typedef Graph::NodeMap<double> DoubleNodeMap;
+typedef Graph::NodeMap<bool> BoolNodeMap;
+typedef Graph::NodeMap<Graph::Node> NodeMap;
+typedef lemon::FilterNodes<const Graph, const BoolNodeMap> SubGraph;
+typedef std::vector<Graph::Node> NodeVector;
+typedef std::vector<NodeVector> NodeVectorVector;
+
+static bool load(const std::string& filename,
+                 bool pcst,
+                 MwcsPreprocessedGraphType& instance,
+                 NodeSet& rootNodes)
+{
+  if (pcst)
+  {
+    StpPcstParserType parser(filename);
+    if (!instance.init(&parser, false))
+      return false;
+    rootNodes = parser.getRootNodes();
+  }
+  else
+  {
+    StpParserType parser(filename);
+    if (!instance.init(&parser, false))
+      return false;
+  }
+
+  return true;
+}
+
+/// Peak resident set size of the process in MB
+static double peakRss()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024.;
+}
+
+/// Builds the solver subgraph of every component with its labels, as the
+/// enumeration solver did before subgraphs resolved labels through their
+/// parent: the labels are copied into the subgraph and again by init()
+static void buildLabelled(const MwcsPreprocessedGraphType& instance,
+                          const NodeVectorVector& nodesInComp)
+{
+  const Graph& g = instance.getGraph();
+  BoolNodeMap filter(g, false);
+  for (size_t i = 0; i < nodesInComp.size(); ++i)
+  {
+    const NodeVector& nodes = nodesInComp[i];
+    for (size_t j = 0; j < nodes.size(); ++j)
+    {
+      filter[nodes[j]] = true;
+    }
+
+    Graph subG;
+    DoubleNodeMap weightSubG(subG);
+    LabelNodeMap labelSubG(subG);
+    NodeMap mapToG(subG);
+    MwcsPreprocessedGraphType mwcsSubGraph;
+
+    SubGraph subTmpSameCompG(g, filter);
+    lemon::graphCopy(subTmpSameCompG, subG)
+      .nodeMap(instance.getScores(), weightSubG)
+      .nodeMap(instance.getLabels(), labelSubG)
+      .nodeCrossRef(mapToG)
+      .run();
+    mwcsSubGraph.init(&subG, &labelSubG, &weightSubG, NULL);
+
+    for (size_t j = 0; j < nodes.size(); ++j)
+    {
+      filter[nodes[j]] = false;
+    }
+  }
+}
+
+/// Builds the solver subgraph of every component without labels, returns
+/// false if a label resolved through the parent differs from the parent's
+static bool buildLabelFree(const MwcsPreprocessedGraphType& instance,
+                           const NodeVectorVector& nodesInComp,
+                           bool checkLabels)
+{
+  SubInstanceType subInstance(instance);
+  for (size_t i = 0; i < nodesInComp.size(); ++i)
+  {
+    subInstance.init(nodesInComp[i]);
+
+    Graph subG;
+    DoubleNodeMap weightSubG(subG);
+    NodeMap mapToG(subG);
+    MwcsPreprocessedGraphType mwcsSubGraph;
+    subInstance.materialize(subG, weightSubG, mapToG, mwcsSubGraph);
+
+    if (!checkLabels)
+      continue;
+
+    for (Graph::NodeIt v(subG); v != lemon::INVALID; ++v)
+    {
+      if (mwcsSubGraph.getLabel(v) != instance.getLabel(mapToG[v]))
+      {
+        std::cerr << "Error: subgraph node has label '" << mwcsSubGraph.getLabel(v)
+                  << "' instead of '" << instance.getLabel(mapToG[v]) << "'" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  int repeats = 5;
+  int verbosityLevel = 0;
+
+  lemon::ArgParser ap(argc, argv);
+  ap
+    .boolOption("version", "Show version number")
+    .boolOption("pcst", "Inputs are STP-PCST files, root nodes are kept")
+    .boolOption("labels", "Copy the labels into every subgraph")
+    .refOption("r", "Number of repetitions per file (default: 5)", repeats, false)
+    .refOption("v", "Specifies the verbosity level:\n"
+               "     0 - No output (default)\n"
+               "     1 - Only necessary output\n"
+               "     2 - More verbose output\n"
+               "     3 - Debug output", verbosityLevel, false)
+    .other("file", "STP input file(s)");
+  ap.parse();
+
+  if (ap.given("version"))
+  {
+    std::cout << "Version number: " << HEINZ_VERSION << std::endl;
+    return 0;
+  }
+
+  if (ap.files().empty() || repeats < 1)
+  {
+    std::cerr << "Usage: " << argv[0] << " [-pcst] [-labels] [-r <repeats>] <file> ..." << std::endl;
+    return 1;
+  }
+
+  g_verbosity = static_cast<VerbosityLevel>(verbosityLevel);
+  bool pcst = ap.given("pcst");
+  bool labels = ap.given("labels");
+
+  std::cout << std::left << std::setw(40) << "file"
+            << std::right << std::setw(10) << "nodes'"
+            << std::setw(10) << "edges'"
+            << std::setw(10) << "comps"
+            << std::setw(12) << "best s"
+            << std::setw(12) << "mean s"
+            << std::setw(12) << "peak MB" << std::endl;
+
+  for (size_t i = 0; i < ap.files().size(); ++i)
+  {
+    const std::string& filename = ap.files()[i];
+
+    MwcsPreprocessedGraphType instance;
+    NodeSet rootNodes;
+    if (!load(filename, pcst, instance, rootNodes))
+    {
+      std::cerr << "Error: could not parse " << filename << std::endl;
+      return 1;
+    }
+    instance.preprocess(rootNodes);
+
+    const Graph& g = instance.getGraph();
+    const Graph::NodeMap<int>& comp = instance.getComponentMap();
+    NodeVectorVector nodesInComp(instance.getComponentCount());
+    for (Graph::NodeIt v(g); v != lemon::INVALID; ++v)
+    {
+      nodesInComp[comp[v]].push_back(v);
+    }
+
+    double best = std::numeric_limits<double>::max();
+    double total = 0;
+    for (int r = 0; r < repeats; ++r)
+    {
+      lemon::Timer t;
+      if (labels)
+      {
+        buildLabelled(instance, nodesInComp);
+      }
+      else if (!buildLabelFree(instance, nodesInComp, false))
+      {
+        return 1;
+      }
+      double time = t.realTime();
+      best = std::min(best, time);
+      total += time;
+    }
+
+    // the labels are checked outside of the timed runs
+    if (!labels && !buildLabelFree(instance, nodesInComp, true))
+    {
+      return 1;
+    }
+
+    std::cout << std::left << std::setw(40) << filename
+              << std::right << std::setw(10) << instance.getNodeCount()
+              << std::setw(10) << instance.getEdgeCount()
+              << std::setw(10) << instance.getComponentCount()
+              << std::fixed << std::setprecision(4)
+              << std::setw(12) << best
+              << std::setw(12) << total / repeats
+              << std::setprecision(1)
+              << std::setw(12) << peakRss() << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,488 @@
+/*
+ * csrgraph.h
+ *
+ *  Created on: 16-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+
+#include <assert.h>
+#include <vector>
+#include <algorithm>
+#include <lemon/core.h>
+#include <lemon/bits/graph_extender.h>
+
+namespace nina {
+namespace mwcs {
+
+/// Base class of CsrGraph, an immutable undirected graph with the
+/// incident arcs of every node stored contiguously (compressed sparse row)
+///
+/// Ids are dense: nodes are 0..n-1, edges 0..m-1 and the two arcs
+/// of edge e are 2e (towards u) and 2e+1 (towards v), as in lemon::SmartGraph.
+class CsrGraphBase
+{
+public:
+  typedef CsrGraphBase Graph;
+
+  class Node;
+  class Arc;
+  class Edge;
+
+  class Node
+  {
+    friend class CsrGraphBase;
+
+  protected:
+    int _id;
+    explicit Node(int id) : _id(id) {}
+
+  public:
+    Node() {}
+    Node(lemon::Invalid) : _id(-1) {}
+    bool operator==(const Node& node) const { return _id == node._id; }
+    bool operator!=(const Node& node) const { return _id != node._id; }
+    bool operator<(const Node& node) const { return _id < node._id; }
+  };
+
+  class Edge
+  {
+    friend class CsrGraphBase;
+
+  protected:
+    int _id;
+    explicit Edge(int id) : _id(id) {}
+
+  public:
+    Edge() {}
+    Edge(lemon::Invalid) : _id(-1) {}
+    bool operator==(const Edge& edge) const { return _id == edge._id; }
+    bool operator!=(const Edge& edge) const { return _id != edge._id; }
+    bool operator<(const Edge& edge) const { return _id < edge._id; }
+  };
+
+  class Arc
+  {
+    friend class CsrGraphBase;
+
+  protected:
+    int _id;
+    explicit Arc(int id) : _id(id) {}
+
+  public:
+    operator Edge() const
+    {
+      return _id != -1 ? edgeFromId(_id / 2) : lemon::INVALID;
+    }
+
+    Arc() {}
+    Arc(lemon::Invalid) : _id(-1) {}
+    bool operator==(const Arc& arc) const { return _id == arc._id; }
+    bool operator!=(const Arc& arc) const { return _id != arc._id; }
+    bool operator<(const Arc& arc) const { return _id < arc._id; }
+  };
+
+  typedef lemon::True NodeNumTag;
+  typedef lemon::True EdgeNumTag;
+  typedef lemon::True ArcNumTag;
+  typedef lemon::True FindEdgeTag;
+  typedef lemon::True FindArcTag;
+
+protected:
+  CsrGraphBase()
+    : _built(false)
+    , _nodeNum(0)
+    , _edgeNum(0)
+    , _offset()
+    , _outArc()
+    , _arcPos()
+    , _arcTarget()
+  {
+  }
+
+  /// Builds the graph from graph, sets nodeRef and edgeRef
+  template<typename GR, typename NodeRefMap, typename EdgeRefMap>
+  void build(const GR& graph, NodeRefMap& nodeRef, EdgeRefMap& edgeRef)
+  {
+    typedef typename GR::NodeIt SourceNodeIt;
+
+    _nodeNum = lemon::countNodes(graph);
+
+    int i = 0;
+    for (SourceNodeIt v(graph); v != lemon::INVALID; ++v, ++i)
+    {
+      nodeRef[v] = Node(i);
+    }
+
+    buildArcs(graph, nodeRef, edgeRef);
+  }
+
+  /// Builds the graph from graph such that node v gets id index[v],
+  /// index must be a bijection onto 0..n-1; sets nodeRef and edgeRef
+  template<typename GR, typename IndexMap, typename NodeRefMap, typename EdgeRefMap>
+  void build(const GR& graph, const IndexMap& index,
+             NodeRefMap& nodeRef, EdgeRefMap& edgeRef)
+  {
+    typedef typename GR::NodeIt SourceNodeIt;
+
+    _nodeNum = lemon::countNodes(graph);
+
+    for (SourceNodeIt v(graph); v != lemon::INVALID; ++v)
+    {
+      assert(0 <= index[v] && index[v] < _nodeNum);
+      nodeRef[v] = Node(index[v]);
+    }
+
+    buildArcs(graph, nodeRef, edgeRef);
+  }
+
+  /// Makes this graph a copy of graph, with the same ids
+  void build(const CsrGraphBase& graph)
+  {
+    _built = true;
+    _nodeNum = graph._nodeNum;
+    _edgeNum = graph._edgeNum;
+    _offset = graph._offset;
+    _outArc = graph._outArc;
+    _arcPos = graph._arcPos;
+    _arcTarget = graph._arcTarget;
+  }
+
+  void clear()
+  {
+    _built = false;
+    _nodeNum = _edgeNum = 0;
+    _offset.clear();
+    _outArc.clear();
+    _arcPos.clear();
+    _arcTarget.clear();
+  }
+
+private:
+  /// Builds the arcs of graph, whose nodes have been numbered in nodeRef
+  template<typename GR, typename NodeRefMap, typename EdgeRefMap>
+  void buildArcs(const GR& graph, NodeRefMap& nodeRef, EdgeRefMap& edgeRef)
+  {
+    typedef typename GR::EdgeIt SourceEdgeIt;
+
+    _built = true;
+    _edgeNum = lemon::countEdges(graph);
+
+    // arc 2e points to u(e) and leaves v(e), arc 2e+1 the other way around
+    _arcTarget.resize(2 * _edgeNum);
+    _offset.assign(_nodeNum + 1, 0);
+    int j = 0;
+    for (SourceEdgeIt e(graph); e != lemon::INVALID; ++e, ++j)
+    {
+      const Node u = nodeRef[graph.u(e)];
+      const Node v = nodeRef[graph.v(e)];
+      edgeRef[e] = Edge(j);
+      _arcTarget[2 * j] = u._id;
+      _arcTarget[2 * j + 1] = v._id;
+      ++_offset[u._id + 1];
+      ++_offset[v._id + 1];
+    }
+
+    for (int k = 0; k < _nodeNum; ++k)
+    {
+      _offset[k + 1] += _offset[k];
+    }
+
+    std::vector<int> pos(_offset.begin(), _offset.end() - 1);
+    _outArc.resize(2 * _edgeNum);
+    for (int a = 0; a < 2 * _edgeNum; ++a)
+    {
+      _outArc[pos[_arcTarget[a ^ 1]]++] = a;
+    }
+
+    // sorted by target, such that findArc() is a binary search
+    _arcPos.resize(2 * _edgeNum);
+    for (int k = 0; k < _nodeNum; ++k)
+    {
+      std::sort(_outArc.begin() + _offset[k],
+                _outArc.begin() + _offset[k + 1],
+                TargetLess(_arcTarget));
+      for (int p = _offset[k]; p < _offset[k + 1]; ++p)
+      {
+        _arcPos[_outArc[p]] = p;
+      }
+    }
+  }
+
+public:
+  int nodeNum() const { return _nodeNum; }
+  int edgeNum() const { return _edgeNum; }
+  int arcNum() const { return 2 * _edgeNum; }
+
+  int maxNodeId() const { return _nodeNum - 1; }
+  int maxEdgeId() const { return _edgeNum - 1; }
+  int maxArcId() const { return 2 * _edgeNum - 1; }
+
+  Node source(Arc a) const { return Node(_arcTarget[a._id ^ 1]); }
+  Node target(Arc a) const { return Node(_arcTarget[a._id]); }
+
+  Node u(Edge e) const { return Node(_arcTarget[2 * e._id]); }
+  Node v(Edge e) const { return Node(_arcTarget[2 * e._id + 1]); }
+
+  static bool direction(Arc a)
+  {
+    return (a._id & 1) == 1;
+  }
+
+  static Arc direct(Edge e, bool d)
+  {
+    return Arc(e._id * 2 + (d ? 1 : 0));
+  }
+
+  void first(Node& node) const
+  {
+    node._id = _nodeNum - 1;
+  }
+
+  static void next(Node& node)
+  {
+    --node._id;
+  }
+
+  void first(Arc& arc) const
+  {
+    arc._id = 2 * _edgeNum - 1;
+  }
+
+  static void next(Arc& arc)
+  {
+    --arc._id;
+  }
+
+  void first(Edge& edge) const
+  {
+    edge._id = _edgeNum - 1;
+  }
+
+  static void next(Edge& edge)
+  {
+    --edge._id;
+  }
+
+  void firstOut(Arc& arc, const Node& v) const
+  {
+    const int p = _offset[v._id];
+    arc._id = p < _offset[v._id + 1] ? _outArc[p] : -1;
+  }
+
+  void nextOut(Arc& arc) const
+  {
+    const int p = _arcPos[arc._id] + 1;
+    arc._id = p < _offset[_arcTarget[arc._id ^ 1] + 1] ? _outArc[p] : -1;
+  }
+
+  void firstIn(Arc& arc, const Node& v) const
+  {
+    firstOut(arc, v);
+    if (arc._id != -1)
+      arc._id ^= 1;
+  }
+
+  void nextIn(Arc& arc) const
+  {
+    arc._id ^= 1;
+    nextOut(arc);
+    if (arc._id != -1)
+      arc._id ^= 1;
+  }
+
+  void firstInc(Edge& edge, bool& d, const Node& v) const
+  {
+    Arc arc;
+    firstOut(arc, v);
+    edge._id = arc._id != -1 ? arc._id / 2 : -1;
+    d = (arc._id & 1) == 1;
+  }
+
+  void nextInc(Edge& edge, bool& d) const
+  {
+    Arc arc = direct(edge, d);
+    nextOut(arc);
+    edge._id = arc._id != -1 ? arc._id / 2 : -1;
+    d = (arc._id & 1) == 1;
+  }
+
+  static int id(Node v) { return v._id; }
+  static int id(Arc a) { return a._id; }
+  static int id(Edge e) { return e._id; }
+
+  static Node nodeFromId(int id) { return Node(id); }
+  static Arc arcFromId(int id) { return Arc(id); }
+  static Edge edgeFromId(int id) { return Edge(id); }
+
+  bool valid(Node n) const
+  {
+    return n._id >= 0 && n._id < _nodeNum;
+  }
+
+  bool valid(Arc a) const
+  {
+    return a._id >= 0 && a._id < 2 * _edgeNum;
+  }
+
+  bool valid(Edge e) const
+  {
+    return e._id >= 0 && e._id < _edgeNum;
+  }
+
+  /// Degree of v, in constant time
+  int degree(Node v) const
+  {
+    return _offset[v._id + 1] - _offset[v._id];
+  }
+
+  Arc findArc(Node s, Node t, Arc prev = lemon::INVALID) const
+  {
+    const int end = _offset[s._id + 1];
+    int p = -1;
+    if (prev == lemon::INVALID)
+    {
+      p = static_cast<int>(std::lower_bound(_outArc.begin() + _offset[s._id],
+                                            _outArc.begin() + end,
+                                            t._id,
+                                            TargetBelow(_arcTarget)) - _outArc.begin());
+    }
+    else
+    {
+      p = _arcPos[prev._id] + 1;
+    }
+
+    if (p < end && _arcTarget[_outArc[p]] == t._id)
+      return Arc(_outArc[p]);
+    else
+      return lemon::INVALID;
+  }
+
+  Edge findEdge(Node u, Node v, Edge prev = lemon::INVALID) const
+  {
+    Arc arc = prev == lemon::INVALID ?
+      findArc(u, v) : findArc(u, v, direct(prev, this->u(prev) == u));
+
+    // both arcs of a loop leave u, report the loop only once
+    while (u == v && arc != lemon::INVALID && !direction(arc))
+    {
+      arc = findArc(u, v, arc);
+    }
+
+    return arc != lemon::INVALID ? Edge(arc._id / 2) : lemon::INVALID;
+  }
+
+private:
+  struct TargetLess
+  {
+    const std::vector<int>& _target;
+
+    TargetLess(const std::vector<int>& target)
+      : _target(target)
+    {
+    }
+
+    bool operator()(int a, int b) const
+    {
+      return _target[a] < _target[b];
+    }
+  };
+
+  struct TargetBelow
+  {
+    const std::vector<int>& _target;
+
+    TargetBelow(const std::vector<int>& target)
+      : _target(target)
+    {
+    }
+
+    bool operator()(int a, int t) const
+    {
+      return _target[a] < t;
+    }
+  };
+
+protected:
+  bool _built;
+  int _nodeNum;
+  int _edgeNum;
+  /// Out arcs of node v are at positions [_offset[v], _offset[v+1])
+  std::vector<int> _offset;
+  std::vector<int> _outArc;
+  /// Position of every arc in _outArc
+  std::vector<int> _arcPos;
+  std::vector<int> _arcTarget;
+};
+
+typedef lemon::GraphExtender<CsrGraphBase> ExtendedCsrGraphBase;
+
+/// Immutable undirected graph in compressed sparse row form
+///
+/// Satisfies the LEMON undirected graph concept; node, edge and arc maps
+/// are plain arrays without unused slots. The graph is built once from
+/// another graph (e.g. the graph that remains after preprocessing)
+/// and cannot be altered afterwards.
+class CsrGraph : public ExtendedCsrGraphBase
+{
+  typedef ExtendedCsrGraphBase Parent;
+
+private:
+  CsrGraph(const CsrGraph&) : Parent() {}
+  CsrGraph& operator=(const CsrGraph&) { return *this; }
+
+public:
+  CsrGraph() {}
+
+  /// Builds the graph from graph, nodeRef and edgeRef map the nodes
+  /// and edges of graph to the ones of this graph
+  template<typename GR, typename NodeRefMap, typename EdgeRefMap>
+  void build(const GR& graph, NodeRefMap& nodeRef, EdgeRefMap& edgeRef)
+  {
+    if (_built)
+      Parent::clear();
+    CsrGraphBase::build(graph, nodeRef, edgeRef);
+    notifier(Node()).build();
+    notifier(Edge()).build();
+    notifier(Arc()).build();
+  }
+
+  /// Same as above, node v of graph gets id index[v]
+  /// (index must be a bijection onto 0..n-1)
+  template<typename GR, typename IndexMap, typename NodeRefMap, typename EdgeRefMap>
+  void build(const GR& graph, const IndexMap& index,
+             NodeRefMap& nodeRef, EdgeRefMap& edgeRef)
+  {
+    if (_built)
+      Parent::clear();
+    CsrGraphBase::build(graph, index, nodeRef, edgeRef);
+    notifier(Node()).build();
+    notifier(Edge()).build();
+    notifier(Arc()).build();
+  }
+
+  /// Builds a copy of graph with the same node, edge and arc ids,
+  /// hence the maps of graph can be read with the items of this graph
+  void build(const CsrGraph& graph)
+  {
+    if (_built)
+      Parent::clear();
+    CsrGraphBase::build(graph);
+    notifier(Node()).build();
+    notifier(Edge()).build();
+    notifier(Arc()).build();
+  }
+
+  void clear()
+  {
+    if (_built)
+      Parent::clear();
+  }
+};
+
+} // namespace mwcs
+} // namespace nina
+
+#endif // CSRGRAPH_H
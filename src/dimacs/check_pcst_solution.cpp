@@ -6,6 +6,9 @@
  */
 
 #include <iostream>
+#include <cmath>
+#include <limits>
+#include <algorithm>
 #include <lemon/arg_parser.h>
 
 #include "parser/mwcsparser.h"
@@ -38,6 +41,7 @@ int main(int argc, char** argv)
   int verbosityLevel = 0;
   std::string stpFile;
   std::string dimacsFile;
+  double opt = 0;
 
   lemon::ArgParser ap(argc, argv);
   
@@ -49,7 +53,8 @@ int main(int argc, char** argv)
                "     1 - Only necessary output (default)\n"
                "     2 - More verbose output\n"
                "     3 - Debug output", verbosityLevel, false)
-    .refOption("s", "DIMACS solution file", dimacsFile, true);
+    .refOption("s", "DIMACS solution file", dimacsFile, true)
+    .refOption("opt", "Expected objective value", opt, false);
   ap.parse();
   
   if (ap.given("version"))
@@ -128,6 +133,42 @@ int main(int argc, char** argv)
     }
   }
   
+  // check the objective value, i.e. the edge costs plus the prizes
+  // of the nodes that are not in the solution
+  if (ap.given("opt"))
+  {
+    double weight = 0;
+    for (NodeIt v(g); v != lemon::INVALID; ++v)
+    {
+      weight += mwcsInput.getScore(*mwcsInput.getNodeByLabel(mwcsSolution.getLabel(v)).begin());
+    }
+    for (EdgeIt e(g); e != lemon::INVALID; ++e)
+    {
+      const std::string& label_u = mwcsSolution.getLabel(g.u(e));
+      const std::string& label_v = mwcsSolution.getLabel(g.v(e));
+
+      // the cheapest of parallel edges
+      NodeSet edgeNodes = mwcsInput.getNodeByLabel(label_u + "--" + label_v);
+      NodeSet revEdgeNodes = mwcsInput.getNodeByLabel(label_v + "--" + label_u);
+      edgeNodes.insert(revEdgeNodes.begin(), revEdgeNodes.end());
+
+      double score = -std::numeric_limits<double>::max();
+      for (NodeSetIt nodeIt = edgeNodes.begin(); nodeIt != edgeNodes.end(); ++nodeIt)
+      {
+        score = std::max(score, mwcsInput.getScore(*nodeIt));
+      }
+      weight += score;
+    }
+
+    double objective = pParserInput->getTotalNodeProfit() - weight;
+    if (fabs(objective - opt) > 1e-6 * std::max(1., fabs(opt)))
+    {
+      std::cerr << "Objective value " << objective
+                << " differs from the expected value " << opt << std::endl;
+      return 1;
+    }
+  }
+
   delete pParserInput;
   delete pParserSolution;
   return 0;
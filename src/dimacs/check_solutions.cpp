@@ -0,0 +1,383 @@
+/*
+ *  check_solutions.cpp
+ *
+ *   Created on: 16-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <atomic>
+#include <thread>
+#include <map>
+#include <vector>
+#include <cmath>
+#include <lemon/arg_parser.h>
+#include <lemon/connectivity.h>
+
+#include "parser/stpparser.h"
+#include "parser/stppcstparser.h"
+#include "parser/dimacsparser.h"
+
+#include "mwcs.h"
+#include "utils.h"
+#include "config.h"
+
+#include "mwcsgraph.h"
+#include "mwcsgraphparser.h"
+
+using namespace nina::mwcs;
+using namespace nina;
+
+typedef StpParser<Graph> StpParserType;
+typedef StpPcstParser<Graph> StpPcstParserType;
+typedef DimacsParser<Graph> DimacsParserType;
+typedef MwcsGraphParser<Graph> MwcsGraphType;
+typedef std::set<Node> NodeSet;
+typedef NodeSet::const_iterator NodeSetIt;
+
+/// An input instance, loaded once and shared (read-only) by all checks
+struct Instance
+{
+  Instance(const std::string& filename)
+    : _filename(filename)
+    , _loaded(false)
+    , _graph()
+    , _pArcLookUp(NULL)
+    , _roots()
+    , _totalNodeProfit(0)
+  {
+  }
+
+  ~Instance()
+  {
+    delete _pArcLookUp;
+  }
+
+  std::string _filename;
+  bool _loaded;
+  MwcsGraphType _graph;
+  lemon::ArcLookUp<Graph>* _pArcLookUp;
+  NodeSet _roots;
+  double _totalNodeProfit;
+};
+
+typedef std::vector<Instance*> InstanceVector;
+
+/// A solution file to be checked against an instance
+struct Check
+{
+  Check(int instance, const std::string& filename)
+    : _instance(instance)
+    , _filename(filename)
+    , _ok(false)
+    , _evaluated(false)
+    , _objective(0)
+    , _hasPrimal(false)
+    , _primal(0)
+    , _message()
+  {
+  }
+
+  int _instance;
+  std::string _filename;
+  bool _ok;
+  bool _evaluated;
+  double _objective;
+  bool _hasPrimal;
+  double _primal;
+  std::string _message;
+};
+
+typedef std::vector<Check> CheckVector;
+
+bool loadInstance(Instance& instance, bool pcst)
+{
+  if (pcst)
+  {
+    StpPcstParserType parser(instance._filename);
+    if (!instance._graph.init(&parser, false))
+      return false;
+    instance._roots = parser.getRootNodes();
+    instance._totalNodeProfit = parser.getTotalNodeProfit();
+  }
+  else
+  {
+    StpParserType parser(instance._filename);
+    if (!instance._graph.init(&parser, false))
+      return false;
+    instance._pArcLookUp = new lemon::ArcLookUp<Graph>(instance._graph.getGraph());
+  }
+
+  instance._loaded = true;
+  return true;
+}
+
+bool fail(Check& check, const std::string& message)
+{
+  check._ok = false;
+  check._message = message;
+  return false;
+}
+
+bool checkSolution(const Instance& instance, Check& check, bool pcst)
+{
+  if (!instance._loaded)
+    return fail(check, "could not parse instance");
+
+  DimacsParserType parser(check._filename);
+  MwcsGraphType solution;
+  if (!solution.init(&parser, false))
+    return fail(check, "could not parse solution");
+
+  check._hasPrimal = parser.hasPrimal();
+  check._primal = parser.getPrimal();
+
+  const MwcsGraphType& input = instance._graph;
+  const Graph& g = solution.getGraph();
+
+  // check if the solution graph is a subgraph of the input graph
+  Graph::NodeMap<Node> toInput(g, lemon::INVALID);
+  double objective = pcst ? instance._totalNodeProfit : 0;
+  for (NodeIt v(g); v != lemon::INVALID; ++v)
+  {
+    Node vv = input.getOrgNodeByLabel(solution.getLabel(v));
+    if (vv == lemon::INVALID)
+      return fail(check, "node " + solution.getLabel(v) + " missing in input file");
+
+    toInput[v] = vv;
+    // MWCS: node weight, PCST: the prize is no longer lost
+    objective += pcst ? -input.getOrgScore(vv) : input.getOrgScore(vv);
+  }
+
+  for (EdgeIt e(g); e != lemon::INVALID; ++e)
+  {
+    const std::string& label_u = solution.getLabel(g.u(e));
+    const std::string& label_v = solution.getLabel(g.v(e));
+
+    if (pcst)
+    {
+      // edges are subdivided by a node of weight minus the edge cost
+      Node uv = input.getOrgNodeByLabel(label_u + "--" + label_v);
+      if (uv == lemon::INVALID)
+        uv = input.getOrgNodeByLabel(label_v + "--" + label_u);
+      if (uv == lemon::INVALID)
+        return fail(check, "edge (" + label_u + "," + label_v + ") missing in input file");
+
+      objective -= input.getOrgScore(uv);
+    }
+    else if ((*instance._pArcLookUp)(toInput[g.u(e)], toInput[g.v(e)]) == lemon::INVALID)
+    {
+      return fail(check, "edge (" + label_u + "," + label_v + ") missing in input file");
+    }
+  }
+
+  // check if the solution graph is connected
+  if (!lemon::connected(g))
+    return fail(check, "solution graph is not connected");
+
+  // check if the solution graph contains the root nodes
+  for (NodeSetIt rootIt = instance._roots.begin(); rootIt != instance._roots.end(); ++rootIt)
+  {
+    const std::string& label = input.getOrgLabel(*rootIt);
+    if (solution.getOrgNodeByLabel(label) == lemon::INVALID)
+      return fail(check, "missing root node '" + label + "'");
+  }
+
+  // check the reported objective value, which is printed with the default precision
+  check._evaluated = true;
+  check._objective = objective;
+  if (check._hasPrimal &&
+      fabs(objective - check._primal) > 1e-5 * std::max(1.0, fabs(check._primal)))
+  {
+    std::stringstream ss;
+    ss << "objective " << objective << " differs from reported primal " << check._primal;
+    return fail(check, ss.str());
+  }
+
+  check._ok = true;
+  return true;
+}
+
+void checkWorker(const InstanceVector& instances,
+                 CheckVector& checks,
+                 std::atomic<size_t>& next,
+                 bool pcst)
+{
+  for (size_t i = next++; i < checks.size(); i = next++)
+  {
+    checkSolution(*instances[checks[i]._instance], checks[i], pcst);
+  }
+}
+
+bool readManifest(const std::string& filename,
+                  InstanceVector& instances,
+                  CheckVector& checks)
+{
+  std::ifstream in(filename.c_str());
+  if (!in.good())
+  {
+    std::cerr << "Error: could not open file " << filename << " for reading" << std::endl;
+    return false;
+  }
+
+  std::map<std::string, int> instanceIndex;
+
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(in, line))
+  {
+    ++lineNumber;
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    std::stringstream ss(line);
+    std::string instanceFile, solutionFile;
+    if (!(ss >> instanceFile >> solutionFile))
+    {
+      std::cerr << "Error at line " << lineNumber
+                << ": expected '<instance> <solution>'" << std::endl;
+      return false;
+    }
+
+    std::map<std::string, int>::const_iterator it = instanceIndex.find(instanceFile);
+    int idx = -1;
+    if (it == instanceIndex.end())
+    {
+      idx = instanceIndex[instanceFile] = static_cast<int>(instances.size());
+      instances.push_back(new Instance(instanceFile));
+    }
+    else
+    {
+      idx = it->second;
+    }
+
+    checks.push_back(Check(idx, solutionFile));
+  }
+
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  // parse command line arguments
+  int verbosityLevel = 0;
+  int threads = 1;
+  bool pcst = false;
+  std::string outputFile;
+
+  lemon::ArgParser ap(argc, argv);
+
+  ap
+    .boolOption("version", "Show version number")
+    .refOption("pcst", "Instances are (rooted) PCST instances, MWCS otherwise", pcst, false)
+    .refOption("t", "Number of threads (default: 1)", threads, false)
+    .refOption("o", "Summary output file (default: stdout)", outputFile, false)
+    .refOption("v", "Specifies the verbosity level:\n"
+               "     0 - No output\n"
+               "     1 - Only necessary output (default)\n"
+               "     2 - More verbose output\n"
+               "     3 - Debug output", verbosityLevel, false)
+    .other("manifest", "File with one '<instance> <solution>' pair per line");
+  ap.parse();
+
+  if (ap.given("version"))
+  {
+    std::cout << "Version number: " << HEINZ_VERSION << std::endl;
+    return 0;
+  }
+
+  if (ap.files().size() != 1)
+  {
+    std::cerr << "Please specify a manifest file" << std::endl;
+    return 1;
+  }
+
+  g_verbosity = static_cast<VerbosityLevel>(verbosityLevel);
+
+  InstanceVector instances;
+  CheckVector checks;
+  if (!readManifest(ap.files()[0], instances, checks))
+  {
+    return 1;
+  }
+
+  // every instance is parsed once, failures are reported per solution
+  for (size_t i = 0; i < instances.size(); ++i)
+  {
+    loadInstance(*instances[i], pcst);
+  }
+
+  // solution files are parsed and checked concurrently
+  threads = std::max(1, std::min(threads, static_cast<int>(checks.size())));
+  std::atomic<size_t> next(0);
+  if (threads == 1)
+  {
+    checkWorker(instances, checks, next, pcst);
+  }
+  else
+  {
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; ++i)
+    {
+      pool.push_back(std::thread(checkWorker, std::cref(instances),
+                                 std::ref(checks), std::ref(next), pcst));
+    }
+    for (int i = 0; i < threads; ++i)
+    {
+      pool[i].join();
+    }
+  }
+
+  std::ofstream outFile;
+  std::ostream* pOut = &std::cout;
+  if (!outputFile.empty())
+  {
+    outFile.open(outputFile.c_str());
+    if (!outFile.good())
+    {
+      std::cerr << "Error: could not open file " << outputFile << " for writing" << std::endl;
+      return 1;
+    }
+    pOut = &outFile;
+  }
+
+  // tab separated summary, one line per solution file
+  int nFailed = 0;
+  *pOut << "instance\tsolution\tstatus\tobjective\tprimal\tmessage" << std::endl;
+  for (size_t i = 0; i < checks.size(); ++i)
+  {
+    const Check& check = checks[i];
+    *pOut << instances[check._instance]->_filename << "\t"
+          << check._filename << "\t"
+          << (check._ok ? "OK" : "FAIL") << "\t";
+    if (check._evaluated)
+      *pOut << check._objective;
+    else
+      *pOut << "NA";
+    *pOut << "\t";
+    if (check._hasPrimal)
+      *pOut << check._primal;
+    else
+      *pOut << "NA";
+    *pOut << "\t" << check._message << "\n";
+
+    if (!check._ok)
+      ++nFailed;
+  }
+  pOut->flush();
+
+  if (g_verbosity >= VERBOSE_ESSENTIAL)
+  {
+    std::cerr << "// Checked " << checks.size() << " solution(s) against "
+              << instances.size() << " instance(s): " << nFailed << " failed" << std::endl;
+  }
+
+  for (size_t i = 0; i < instances.size(); ++i)
+  {
+    delete instances[i];
+  }
+
+  return nFailed == 0 ? 0 : 1;
+}
@@ -14,6 +14,7 @@
 #include "config.h"
 #include "parser/stpparser.h"
 #include "mwcspreprocessedgraph.h"
+#include "mwcsfrozengraph.h"
 
 #include "solver/solver.h"
 #include "solver/solverrooted.h"
@@ -30,21 +31,21 @@ using namespace nina::mwcs;
 
 typedef StpParser<Graph> StpParserType;
 typedef MwcsPreprocessedGraph<Graph> MwcsPreprocessedGraphType;
-typedef Solver<Graph> SolverType;
-typedef SolverUnrooted<Graph> SolverUnrootedType;
-typedef CplexSolverImpl<Graph> CplexSolverImplType;
+typedef MwcsFrozenGraph<Graph> MwcsFrozenGraphType;
+typedef Solver<CsrGraph> SolverType;
+typedef SolverUnrooted<CsrGraph> SolverUnrootedType;
+typedef CplexSolverImpl<CsrGraph> CplexSolverImplType;
 typedef CplexSolverImplType::Options Options;
-typedef CutSolverUnrootedImpl<Graph> CutSolverUnrootedImplType;
-typedef SolverType::NodeSet NodeSet;
+typedef CutSolverUnrootedImpl<CsrGraph> CutSolverUnrootedImplType;
 
 void printUsage(std::ostream& out, const char* argv0)
 {
-  out << "Usage: " << argv0 << " filename time threads outputfile" << std::endl;
+  out << "Usage: " << argv0 << " filename time threads outputfile [snapshotdir]" << std::endl;
 }
 
 int main(int argc, char** argv)
 {
-  if (argc != 5)
+  if (argc != 5 && argc != 6)
   {
     printUsage(std::cerr, argv[0]);
     return 1;
@@ -54,6 +55,7 @@ int main(int argc, char** argv)
   const int timelimit = atoi(argv[2]);
   const int threads = atoi(argv[3]);
   const std::string output = argv[4];
+  const std::string cacheDir = argc == 6 ? argv[5] : "";
   
   if (timelimit <= 0)
   {
@@ -91,11 +93,15 @@ int main(int argc, char** argv)
   StpParserType parser(input);
   
   MwcsPreprocessedGraphType instance;
-  if (!instance.init(&parser, false))
+  SnapshotInfo info;
+  if (!initSnapshotInstance(instance, parser, cacheDir, PROBLEM, false, info))
   {
     return 1;
   }
-  instance.preprocess(NodeSet());
+
+  // the reduced graph is immutable from here on
+  MwcsFrozenGraphType frozen;
+  frozen.freeze(instance);
   
   Options options(BackOff(1), // linear waiting
                   true,
@@ -105,18 +111,18 @@ int main(int argc, char** argv)
                   MEMORY_LIMIT,
                   false);
 
-  printCommentSection(parser.getName(), PROBLEM, METHOD, HEINZ_VERSION);
+  printCommentSection(info._name, PROBLEM, METHOD, HEINZ_VERSION);
   
   SolverUnrootedType solver(new CutSolverUnrootedImplType(options));
   
   *g_pOut << "SECTION Solutions" << std::endl;
-  solver.solve(instance);
+  solver.solve(frozen);
   *g_pOut << "End" << std::endl << std::endl;
   
   printRunSection(threads, solver.getSolutionWeight(), solver.getSolutionWeightUB());
   
   *g_pOut << "SECTION Finalsolution" << std::endl;
-  instance.printMwcsDimacs(solver.getSolutionModule(), *g_pOut);
+  instance.printMwcsDimacs(frozen.getSourceNodes(solver.getSolutionModule()), *g_pOut);
   *g_pOut << "End" << std::endl;
   
   if (!std_out_used)
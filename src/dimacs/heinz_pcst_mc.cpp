@@ -39,12 +39,12 @@ typedef SolverType::NodeSet NodeSet;
 
 void printUsage(std::ostream& out, const char* argv0)
 {
-  out << "Usage: " << argv0 << " filename time threads outputfile" << std::endl;
+  out << "Usage: " << argv0 << " filename time threads outputfile [snapshotdir]" << std::endl;
 }
 
 int main(int argc, char** argv)
 {
-  if (argc != 5)
+  if (argc != 5 && argc != 6)
   {
     printUsage(std::cerr, argv[0]);
     return 1;
@@ -54,6 +54,7 @@ int main(int argc, char** argv)
   const int timelimit = atoi(argv[2]);
   const int threads = atoi(argv[3]);
   const std::string output = argv[4];
+  const std::string cacheDir = argc == 6 ? argv[5] : "";
   
   if (timelimit <= 0)
   {
@@ -91,18 +92,18 @@ int main(int argc, char** argv)
   StpPcstParserType parser(input);
   
   MwcsPreprocessedGraphType instance;
-  if (!instance.init(&parser, false))
+  SnapshotInfo info;
+  if (!initSnapshotInstance(instance, parser, cacheDir, PROBLEM, false, info))
   {
     return 1;
   }
-  instance.preprocess(NodeSet());
   
   Options options(TreeHeuristicSolverImplType::EDGE_COST_RANDOM,
                   false,
                   -1,
                   timelimit - g_timer.realTime());
 
-  printCommentSection(parser.getName(), PROBLEM, METHOD, HEINZ_VERSION);
+  printCommentSection(info._name, PROBLEM, METHOD, HEINZ_VERSION);
   
   SolverUnrootedType solver(new TreeHeuristicSolverUnrootedImplType(options));
   
@@ -110,7 +111,7 @@ int main(int argc, char** argv)
   solver.solve(instance);
   *g_pOut << "End" << std::endl << std::endl;
   
-  printRunSection(1, -1 * solver.getSolutionWeight() + parser.getTotalNodeProfit(), -1);
+  printRunSection(1, -1 * solver.getSolutionWeight() + info._totalNodeProfit, -1);
   
   *g_pOut << "SECTION Finalsolution" << std::endl;
   instance.printPcstDimacs(solver.getSolutionModule(), *g_pOut);
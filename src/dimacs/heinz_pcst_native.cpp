@@ -0,0 +1,126 @@
+/*
+ *  heinz_pcst_native.cpp
+ *
+ *   Created on: 16-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include <iostream>
+#include <fstream>
+#include <lemon/arg_parser.h>
+#include <lemon/time_measure.h>
+
+#include "utils.h"
+#include "config.h"
+#include "parser/stppcstparser.h"
+#include "pcstgraph.h"
+
+#include "solver/solverpcst.h"
+#include "solver/impl/cplexsolverimpl.h"
+#include "solver/impl/cutsolverpcstimpl.h"
+#include "solver/impl/cplex_cut/backoff.h"
+
+#define PROBLEM "PCST"
+#define METHOD "heinz-pcst-native"
+
+using namespace nina::mwcs;
+
+typedef StpPcstParser<Graph> StpPcstParserType;
+typedef PcstGraph<Graph> PcstGraphType;
+typedef SolverPcst<Graph> SolverPcstType;
+typedef CplexSolverImpl<Graph> CplexSolverImplType;
+typedef CplexSolverImplType::Options Options;
+typedef CutSolverPcstImpl<Graph> CutSolverPcstImplType;
+typedef SolverPcstType::NodeSet NodeSet;
+
+void printUsage(std::ostream& out, const char* argv0)
+{
+  out << "Usage: " << argv0 << " filename time threads outputfile" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc != 5)
+  {
+    printUsage(std::cerr, argv[0]);
+    return 1;
+  }
+  
+  const std::string input = argv[1];
+  const int timelimit = atoi(argv[2]);
+  const int threads = atoi(argv[3]);
+  const std::string output = argv[4];
+  
+  if (timelimit <= 0)
+  {
+    std::cerr << "Invalid timelimit '" << timelimit << "'" << std::endl;
+    return 1;
+  }
+  
+  if (threads <= 0)
+  {
+    std::cerr << "Invalid thread count '" << threads << "'" << std::endl;
+    return 1;
+  }
+  
+  bool std_out_used = false;
+  if (output != "-")
+  {
+    g_pOut = new std::ofstream(output.c_str());
+    if (!g_pOut->good())
+    {
+      std::cerr << "Could not open file '" << output << "' for writing" << std::endl;
+      delete g_pOut;
+      return 1;
+    }
+  }
+  else
+  {
+    std_out_used = true;
+    g_pOut = &std::cout;
+  }
+  g_pOut->setf(std::ios_base::fixed);
+  g_pOut->precision(9);
+
+  g_verbosity = VERBOSE_NONE;
+  g_verbosity = VERBOSE_NON_ESSENTIAL;
+  StpPcstParserType parser(input);
+  parser.setSubdivide(false);
+  
+  PcstGraphType instance;
+  if (!instance.init(&parser, false))
+  {
+    return 1;
+  }
+  instance.preprocess(NodeSet());
+  
+  // options refer to backOff
+  BackOff backOff(1);
+  Options options(backOff, // linear waiting
+                  true,
+                  10,
+                  timelimit,
+                  threads,
+                  MEMORY_LIMIT,
+                  true);
+
+  printCommentSection(parser.getName(), PROBLEM, METHOD, HEINZ_VERSION);
+  
+  SolverPcstType solver(new CutSolverPcstImplType(options));
+  
+  *g_pOut << "SECTION Solutions" << std::endl;
+  solver.solve(instance, NodeSet());
+  *g_pOut << "End" << std::endl << std::endl;
+  
+  printRunSection(1, -1 * solver.getSolutionWeight() + parser.getTotalNodeProfit(),
+                  std::max(-1 * solver.getSolutionWeightUB() + parser.getTotalNodeProfit(), -1.e+20));
+  
+  *g_pOut << "SECTION Finalsolution" << std::endl;
+  instance.printPcstDimacs(solver.getSolutionModule(), solver.getSolutionEdges(), *g_pOut);
+  *g_pOut << "End" << std::endl;
+  
+  if (!std_out_used)
+    delete g_pOut;
+  
+  return 0;
+}
@@ -14,6 +14,7 @@
 #include "config.h"
 #include "parser/stppcstparser.h"
 #include "mwcspreprocessedgraph.h"
+#include "mwcsfrozengraph.h"
 
 #include "solver/solver.h"
 #include "solver/solverrooted.h"
@@ -31,22 +32,23 @@ using namespace nina::mwcs;
 
 typedef StpPcstParser<Graph> StpPcstParserType;
 typedef MwcsPreprocessedGraph<Graph> MwcsPreprocessedGraphType;
-typedef Solver<Graph> SolverType;
-typedef SolverRooted<Graph> SolverRootedType;
-typedef SolverUnrooted<Graph> SolverUnrootedType;
-typedef CplexSolverImpl<Graph> CplexSolverImplType;
+typedef MwcsFrozenGraph<Graph> MwcsFrozenGraphType;
+typedef Solver<CsrGraph> SolverType;
+typedef SolverRooted<CsrGraph> SolverRootedType;
+typedef SolverUnrooted<CsrGraph> SolverUnrootedType;
+typedef CplexSolverImpl<CsrGraph> CplexSolverImplType;
 typedef CplexSolverImplType::Options Options;
-typedef CutSolverRootedImpl<Graph> CutSolverRootedImplType;
-typedef SolverType::NodeSet NodeSet;
+typedef CutSolverRootedImpl<CsrGraph> CutSolverRootedImplType;
+typedef MwcsPreprocessedGraphType::NodeSet NodeSet;
 
 void printUsage(std::ostream& out, const char* argv0)
 {
-  out << "Usage: " << argv0 << " filename time threads outputfile" << std::endl;
+  out << "Usage: " << argv0 << " filename time threads outputfile [snapshotdir]" << std::endl;
 }
 
 int main(int argc, char** argv)
 {
-  if (argc != 5)
+  if (argc != 5 && argc != 6)
   {
     printUsage(std::cerr, argv[0]);
     return 1;
@@ -56,6 +58,7 @@ int main(int argc, char** argv)
   const int timelimit = atoi(argv[2]);
   const int threads = atoi(argv[3]);
   const std::string output = argv[4];
+  const std::string cacheDir = argc == 6 ? argv[5] : "";
   
   if (timelimit <= 0)
   {
@@ -93,12 +96,17 @@ int main(int argc, char** argv)
   StpPcstParserType parser(input);
   
   MwcsPreprocessedGraphType instance;
-  if (!instance.init(&parser, false))
+  SnapshotInfo info;
+  if (!initSnapshotInstance(instance, parser, cacheDir, PROBLEM, true, info))
   {
     return 1;
   }
-  assert(parser.getRootNodes().size() > 0);
-  instance.preprocess(parser.getRootNodes());
+  const NodeSet rootNodes = getSnapshotRootNodes(instance, info);
+  assert(rootNodes.size() > 0);
+
+  // the reduced graph is immutable from here on
+  MwcsFrozenGraphType frozen;
+  frozen.freeze(instance);
   
   Options options(BackOff(1), // linear waiting
                   true,
@@ -108,19 +116,19 @@ int main(int argc, char** argv)
                   MEMORY_LIMIT,
                   true);
 
-  printCommentSection(parser.getName(), PROBLEM, METHOD, HEINZ_VERSION);
+  printCommentSection(info._name, PROBLEM, METHOD, HEINZ_VERSION);
   
   SolverRootedType solver(new CutSolverRootedImplType(options));
   
   *g_pOut << "SECTION Solutions" << std::endl;
-  solver.solve(instance, instance.getPreNodes(parser.getRootNodes()));
+  solver.solve(frozen, frozen.getFrozenNodes(instance.getPreNodes(rootNodes)));
   *g_pOut << "End" << std::endl << std::endl;
   
-  printRunSection(1, -1 * solver.getSolutionWeight() + parser.getTotalNodeProfit(),
-                  -1 * solver.getSolutionWeightUB() + parser.getTotalNodeProfit());
+  printRunSection(1, -1 * solver.getSolutionWeight() + info._totalNodeProfit,
+                  -1 * solver.getSolutionWeightUB() + info._totalNodeProfit);
   
   *g_pOut << "SECTION Finalsolution" << std::endl;
-  instance.printPcstDimacs(solver.getSolutionModule(), *g_pOut);
+  instance.printPcstDimacs(frozen.getSourceNodes(solver.getSolutionModule()), *g_pOut);
   *g_pOut << "End" << std::endl;
   
   if (!std_out_used)
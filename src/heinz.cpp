@@ -0,0 +1,269 @@
+/*
+ *  heinz.cpp
+ *
+ *   Created on: 16-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include <stdio.h>
+#include <iostream>
+#include <vector>
+#include <memory>
+
+// ILOG stuff
+#include <ilconcert/iloalg.h>
+#include <ilcplex/ilocplex.h>
+
+#include "heinz.h"
+#include "mwcsgraphparser.h"
+#include "mwcspreprocessedgraph.h"
+
+#include "solver/solver.h"
+#include "solver/solverrooted.h"
+#include "solver/solverunrooted.h"
+#include "solver/enumsolverunrooted.h"
+#include "solver/impl/cplexsolverimpl.h"
+#include "solver/impl/cutsolverrootedimpl.h"
+#include "solver/impl/cutsolverunrootedimpl.h"
+#include "solver/impl/cplex_cut/backoff.h"
+
+#include "utils.h"
+
+namespace nina {
+namespace mwcs {
+
+typedef MwcsGraphParser<Graph> MwcsGraphType;
+typedef MwcsPreprocessedGraph<Graph> MwcsPreprocessedGraphType;
+typedef MwcsGraphType::NodeSet NodeSet;
+typedef MwcsGraphType::BoolVector BoolVector;
+
+typedef Solver<Graph> SolverType;
+typedef SolverRooted<Graph> SolverRootedType;
+typedef SolverUnrooted<Graph> SolverUnrootedType;
+typedef EnumSolverUnrooted<Graph> EnumSolverUnrootedType;
+typedef CplexSolverImpl<Graph> CplexSolverImplType;
+typedef CplexSolverImplType::Options Options;
+typedef CutSolverRootedImpl<Graph> CutSolverRootedImplType;
+typedef CutSolverUnrootedImpl<Graph> CutSolverUnrootedImplType;
+
+/// Whether the CSR arrays describe a valid graph on nNodes nodes
+static bool validInput(int nNodes,
+                       const int* pOffsets,
+                       const int* pTargets,
+                       const double* pScores,
+                       const HeinzOptions& options)
+{
+  if (nNodes < 0 || !pOffsets || !pScores || pOffsets[0] != 0)
+    return false;
+
+  for (int i = 0; i < nNodes; ++i)
+  {
+    if (pOffsets[i] > pOffsets[i + 1])
+      return false;
+  }
+
+  if (pOffsets[nNodes] > 0 && !pTargets)
+    return false;
+
+  for (int j = 0; j < pOffsets[nNodes]; ++j)
+  {
+    if (!(0 <= pTargets[j] && pTargets[j] < nNodes))
+      return false;
+  }
+
+  return -1 <= options._root && options._root < nNodes;
+}
+
+/// Adds the edges in the CSR arrays to g (whose nodes are 0, ..., nNodes - 1)
+///
+/// The edges are bucketed by their smaller end point, which removes
+/// repeated edges in linear time.
+static void addEdges(int nNodes,
+                     const int* pOffsets,
+                     const int* pTargets,
+                     Graph& g)
+{
+  const int nArcs = pOffsets[nNodes];
+
+  std::vector<int> bucketOffsets(nNodes + 1, 0);
+  for (int i = 0; i < nNodes; ++i)
+  {
+    for (int j = pOffsets[i]; j < pOffsets[i + 1]; ++j)
+    {
+      if (i != pTargets[j])
+        ++bucketOffsets[std::min(i, pTargets[j]) + 1];
+    }
+  }
+  for (int i = 0; i < nNodes; ++i)
+  {
+    bucketOffsets[i + 1] += bucketOffsets[i];
+  }
+
+  std::vector<int> buckets(bucketOffsets[nNodes]);
+  std::vector<int> pos(bucketOffsets.begin(), bucketOffsets.end() - 1);
+  for (int i = 0; i < nNodes; ++i)
+  {
+    for (int j = pOffsets[i]; j < pOffsets[i + 1]; ++j)
+    {
+      if (i != pTargets[j])
+        buckets[pos[std::min(i, pTargets[j])]++] = std::max(i, pTargets[j]);
+    }
+  }
+
+  g.reserveEdge(nArcs / 2);
+
+  std::vector<int> lastSeen(nNodes, -1);
+  for (int i = 0; i < nNodes; ++i)
+  {
+    Node u = g.nodeFromId(i);
+    for (int j = bucketOffsets[i]; j < bucketOffsets[i + 1]; ++j)
+    {
+      int k = buckets[j];
+      if (lastSeen[k] != i)
+      {
+        lastSeen[k] = i;
+        g.addEdge(u, g.nodeFromId(k));
+      }
+    }
+  }
+}
+
+bool solveMwcs(int nNodes,
+               const int* pOffsets,
+               const int* pTargets,
+               const double* pScores,
+               const char* const* pLabels,
+               const HeinzOptions& options,
+               std::vector<int>& module,
+               double& score)
+{
+  module.clear();
+  score = 0;
+
+  if (!validInput(nNodes, pOffsets, pTargets, pScores, options))
+  {
+    return false;
+  }
+
+  if (nNodes == 0)
+  {
+    return true;
+  }
+
+  g_verbosity = static_cast<VerbosityLevel>(options._verbosity);
+
+  // the instance refers to these, so they are declared first
+  Graph g;
+  Graph::NodeMap<std::string> label(g);
+  Graph::NodeMap<double> weight(g);
+
+  g.reserveNode(nNodes);
+  char buf[16];
+  for (int i = 0; i < nNodes; ++i)
+  {
+    Node v = g.addNode();
+    weight[v] = pScores[i];
+    if (pLabels)
+    {
+      label[v] = pLabels[i];
+    }
+    else
+    {
+      snprintf(buf, sizeof(buf), "%d", i);
+      label[v] = buf;
+    }
+  }
+  addEdges(nNodes, pOffsets, pTargets, g);
+
+  // owned here, so that an exception thrown by the solver leaks nothing
+  std::unique_ptr<MwcsGraphType> pMwcs;
+  MwcsPreprocessedGraphType* pPreprocessedMwcs = NULL;
+  if (options._preprocess)
+  {
+    pMwcs.reset(pPreprocessedMwcs = new MwcsPreprocessedGraphType());
+  }
+  else
+  {
+    pMwcs.reset(new MwcsGraphType());
+  }
+  pMwcs->init(&g, &label, &weight, NULL);
+
+  NodeSet rootNodeSet;
+  if (options._root != -1)
+  {
+    Node orgRoot = g.nodeFromId(options._root);
+    if (pPreprocessedMwcs)
+      rootNodeSet = pPreprocessedMwcs->getPreNodes(orgRoot);
+    else
+      rootNodeSet.insert(orgRoot);
+  }
+
+  if (pPreprocessedMwcs && (!options._enumerate || !rootNodeSet.empty()))
+  {
+    pPreprocessedMwcs->preprocess(rootNodeSet);
+    pPreprocessedMwcs->compact(rootNodeSet);
+  }
+
+  bool res = false;
+  try
+  {
+    BackOff backOff(BackOff::LinearWaiting);
+    Options solverOptions(backOff,
+                          true,
+                          options._maxNumberOfCuts,
+                          options._timeLimit,
+                          options._threads,
+                          options._memoryLimit,
+                          false);
+
+    // the solver owns its implementations and is owned before solving
+    std::unique_ptr<SolverType> pSolver;
+    if (!rootNodeSet.empty())
+    {
+      SolverRootedType* pSolverRooted = new SolverRootedType(new CutSolverRootedImplType(solverOptions));
+      pSolver.reset(pSolverRooted);
+      res = pSolverRooted->solve(*pMwcs, rootNodeSet);
+    }
+    else if (!options._enumerate)
+    {
+      SolverUnrootedType* pSolverUnrooted = new SolverUnrootedType(new CutSolverUnrootedImplType(solverOptions));
+      pSolver.reset(pSolverUnrooted);
+      res = pSolverUnrooted->solve(*pMwcs);
+    }
+    else
+    {
+      SolverUnrootedType* pSolverUnrooted = new EnumSolverUnrootedType(new CutSolverUnrootedImplType(solverOptions),
+                                                                       new CutSolverRootedImplType(solverOptions),
+                                                                       options._preprocess);
+      pSolver.reset(pSolverUnrooted);
+      res = pSolverUnrooted->solve(*pMwcs);
+    }
+
+    if (res)
+    {
+      // original node ids coincide with the node indices
+      BoolVector inModule;
+      pMwcs->projectModule(pSolver->getSolutionModule(), inModule);
+      for (int i = 0; i < nNodes; ++i)
+      {
+        if (inModule[i])
+          module.push_back(i);
+      }
+      score = pSolver->getSolutionWeight();
+    }
+  }
+  catch (IloException& e)
+  {
+    if (g_verbosity >= VERBOSE_ESSENTIAL)
+    {
+      std::cerr << "ILOG exception: " << e.getMessage() << std::endl;
+    }
+    e.end();
+    res = false;
+  }
+
+  return res;
+}
+
+} // namespace mwcs
+} // namespace nina
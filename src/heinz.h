@@ -0,0 +1,73 @@
+/*
+ * heinz.h
+ *
+ *  Created on: 16-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef HEINZ_H
+#define HEINZ_H
+
+#include <vector>
+
+namespace nina {
+namespace mwcs {
+
+/// Options of solveMwcs()
+struct HeinzOptions
+{
+  HeinzOptions()
+    : _timeLimit(-1)
+    , _memoryLimit(-1)
+    , _threads(1)
+    , _maxNumberOfCuts(3)
+    , _preprocess(true)
+    , _enumerate(true)
+    , _root(-1)
+    , _verbosity(0)
+  {
+  }
+
+  /// Time limit in seconds (-1: no limit)
+  int _timeLimit;
+  /// Memory limit in MB (-1: no limit)
+  int _memoryLimit;
+  /// Number of threads
+  int _threads;
+  /// Number of cut iterations per node in the B&B tree
+  int _maxNumberOfCuts;
+  /// Whether the instance is preprocessed
+  bool _preprocess;
+  /// Whether the enumerating solver is used (unrooted instances only)
+  bool _enumerate;
+  /// Index of the root node (-1: unrooted)
+  int _root;
+  /// Verbosity level, see VerbosityLevel (0: no output)
+  int _verbosity;
+};
+
+/// Solves the maximum-weight connected subgraph problem
+///
+/// The graph has nodes 0, ..., nNodes - 1 and is given in CSR form: the
+/// neighbors of node i are pTargets[pOffsets[i]], ...,
+/// pTargets[pOffsets[i + 1] - 1]. An edge may be listed at one or both of
+/// its end points; self-loops and repeated edges are ignored. The arrays
+/// are read in place. pLabels is optional; if NULL, node indices are used
+/// as labels.
+///
+/// On success, module holds the indices of the solution nodes in
+/// increasing order and score holds the solution weight. Returns false if
+/// the input is invalid or the solver failed.
+bool solveMwcs(int nNodes,
+               const int* pOffsets,
+               const int* pTargets,
+               const double* pScores,
+               const char* const* pLabels,
+               const HeinzOptions& options,
+               std::vector<int>& module,
+               double& score);
+
+} // namespace mwcs
+} // namespace nina
+
+#endif // HEINZ_H
@@ -194,12 +194,13 @@ int main (int argc, char** argv)
   // Solve
   lemon::Timer t;
 
-  const NodeSet rootNodeSet = pMwcs->getNodeByLabel(root);
+  NodeSet rootNodeSet = pMwcs->getNodeByLabel(root);
   assert(rootNodeSet.size() == 0 || rootNodeSet.size() == 1);
   
   if (pPreprocessedMwcs)
   {
     pPreprocessedMwcs->preprocess(rootNodeSet);
+    pPreprocessedMwcs->compact(rootNodeSet);
   }
   
   SolverType* pSolver = NULL;
@@ -220,7 +221,6 @@ int main (int argc, char** argv)
   {
     std::ofstream outFile(outputFile.c_str());
     pMwcs->printHeinz(pSolver->getSolutionModule(), outFile);
-    pMwcs->printModule(pSolver->getSolutionModule(), std::cout, true);
   }
   else if (outputFile == "-")
   {
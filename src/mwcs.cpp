@@ -11,6 +11,8 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <sstream>
+#include <iomanip>
 
 
 // ILOG stuff
@@ -24,14 +26,18 @@
 #include "mwcsgraph.h"
 #include "mwcsgraphparser.h"
 #include "mwcspreprocessedgraph.h"
+#include "pcstgraph.h"
+#include "snapshot.h"
 
 #include "solver/solver.h"
 #include "solver/solverrooted.h"
 #include "solver/solverunrooted.h"
 #include "solver/enumsolverunrooted.h"
+#include "solver/solverpcst.h"
 #include "solver/impl/cplexsolverimpl.h"
 #include "solver/impl/cutsolverrootedimpl.h"
 #include "solver/impl/cutsolverunrootedimpl.h"
+#include "solver/impl/cutsolverpcstimpl.h"
 #include "solver/impl/cplex_cut/backoff.h"
 
 #include "mwcs.h"
@@ -48,6 +54,7 @@ typedef StpPcstParser<Graph> StpPcstParserType;
 
 typedef MwcsGraphParser<Graph> MwcsGraphType;
 typedef MwcsPreprocessedGraph<Graph> MwcsPreprocessedGraphType;
+typedef PcstGraph<Graph> PcstGraphType;
 
 typedef Solver<Graph> SolverType;
 typedef SolverRooted<Graph> SolverRootedType;
@@ -57,6 +64,8 @@ typedef CplexSolverImpl<Graph> CplexSolverImplType;
 typedef CplexSolverImplType::Options Options;
 typedef CutSolverRootedImpl<Graph> CutSolverRootedImplType;
 typedef CutSolverUnrootedImpl<Graph> CutSolverUnrootedImplType;
+typedef SolverPcst<Graph> SolverPcstType;
+typedef CutSolverPcstImpl<Graph> CutSolverPcstImplType;
 typedef SolverType::NodeSet NodeSet;
 
 BackOff createBackOff(int function, int period)
@@ -71,6 +80,59 @@ BackOff createBackOff(int function, int period)
   }
 }
 
+/// Solves a PCST instance without subdividing its edges
+int solvePcstNative(const std::string& stpPcstFile,
+                    const std::string& root,
+                    const std::string& outputFile,
+                    bool noPreprocess,
+                    const Options& options)
+{
+  StpPcstParserType parser(stpPcstFile);
+  parser.setSubdivide(false);
+
+  PcstGraphType pcst;
+  if (!pcst.init(&parser, false))
+  {
+    return 1;
+  }
+
+  const NodeSet rootNodeSet = pcst.getNodeByLabel(root);
+  if (rootNodeSet.size() == 0 && !root.empty())
+  {
+    std::cerr << "No node with label '" << root
+    << "' present. Defaulting to unrooted formulation." << std::endl;
+  }
+
+  if (!noPreprocess)
+  {
+    pcst.preprocess(rootNodeSet);
+  }
+
+  try {
+    SolverPcstType solver(new CutSolverPcstImplType(options));
+    if (solver.solve(pcst, rootNodeSet))
+    {
+      std::cerr << "// PCST objective: "
+                << parser.getTotalNodeProfit() - solver.getSolutionWeight() << std::endl;
+    }
+
+    if (outputFile != "-" && !outputFile.empty())
+    {
+      std::ofstream outFile(outputFile.c_str());
+      pcst.printPcstDimacs(solver.getSolutionModule(), solver.getSolutionEdges(), outFile);
+    }
+    else
+    {
+      pcst.printPcstDimacs(solver.getSolutionModule(), solver.getSolutionEdges(), std::cout);
+    }
+  } catch (IloException &e) {
+    std::cerr << "ILOG exception: "<< e.getMessage() << std::endl;
+    e.end();
+  }
+
+  return 0;
+}
+
 int main(int argc, char** argv)
 {
   // parse command line arguments
@@ -92,6 +154,9 @@ int main(int argc, char** argv)
   std::string stpPcstFile;
   std::string nodeFile;
   std::string edgeFile;
+  std::string cacheDir;
+  bool native = false;
+  bool names = false;
   
   lemon::ArgParser ap(argc, argv);
   
@@ -112,6 +177,8 @@ int main(int argc, char** argv)
   .refOption("no-enum", "Disable enumerator", noEnum, false)
   .refOption("stp", "STP file", stpFile, false)
   .refOption("stp-pcst", "STP-PCST file", stpPcstFile, false)
+  .refOption("native", "Solve the STP-PCST file without subdividing edges\n"
+             "     (costs stay on the edges)", native, false)
   .refOption("v", "Specifies the verbosity level:\n"
              "     0 - No output\n"
              "     1 - Only necessary output\n"
@@ -124,6 +191,9 @@ int main(int argc, char** argv)
   .refOption("lambda", "Specifies lambda", lambda, false)
   .refOption("a", "Specifies a", a, false)
   .refOption("FDR", "Specifies fdr", fdr, false)
+  .refOption("names", "Name the CPLEX variables after the node labels (for debugging)", names, false)
+  .refOption("cache", "Snapshot cache directory: the parsed and preprocessed\n"
+             "     instance is loaded from or stored in this directory (optional)", cacheDir, false)
   .refOption("maxCuts", "Specifies the number of cut iterations per node in the B&B tree (default: 3)\n",
              maxNumberOfCuts, false);
   ap.parse();
@@ -163,6 +233,30 @@ int main(int argc, char** argv)
   
   g_verbosity = static_cast<VerbosityLevel>(verbosityLevel);
   
+  if (native)
+  {
+    if (stpPcstFile.empty())
+    {
+      std::cerr << "Option '-native' requires '-stp-pcst'" << std::endl;
+      return 1;
+    }
+    
+    // options refer to backOff
+    BackOff backOff = createBackOff(backOffFunction, backOffPeriod);
+    Options options(backOff,
+                    true,
+                    maxNumberOfCuts,
+                    timeLimit,
+                    multiThreading,
+                    memoryLimit,
+                    true,
+                    names);
+    
+    int res = solvePcstNative(stpPcstFile, root, outputFile, noPreprocess, options);
+    std::cerr << "Time: " << g_timer.realTime() << "s" << std::endl;
+    return res;
+  }
+  
   // Construct parser
   ParserType* pParser = NULL;
   if (!stpFile.empty())
@@ -175,7 +269,9 @@ int main(int argc, char** argv)
   }
   else
   {
-    pParser = new MwcsParserType(nodeFile, edgeFile);
+    MwcsParserType* pMwcsParser = new MwcsParserType(nodeFile, edgeFile);
+    pMwcsParser->setThreads(multiThreading);
+    pParser = pMwcsParser;
   }
   
   // Parse the input graph file and preprocess
@@ -184,34 +280,89 @@ int main(int argc, char** argv)
   if (!noPreprocess)
   {
     pMwcs = pPreprocessedMwcs = new MwcsPreprocessedGraphType();
+    pPreprocessedMwcs->setThreads(multiThreading);
   }
   else
   {
     pMwcs = new MwcsGraphType();
   }
   
-  if (!pMwcs->init(pParser, pval))
+  // Snapshots are keyed by the input files and all settings
+  // that affect parsing, scoring and preprocessing
+  std::string snapshotFile;
+  uint64_t snapshotKey = 0;
+  if (!cacheDir.empty() && pPreprocessedMwcs)
   {
-    delete pParser;
-    return 1;
+    std::vector<std::string> inputFiles;
+    std::stringstream settings;
+    settings << std::setprecision(17);
+    if (!stpFile.empty())
+    {
+      inputFiles.push_back(stpFile);
+      settings << "stp";
+    }
+    else if (!stpPcstFile.empty())
+    {
+      inputFiles.push_back(stpPcstFile);
+      settings << "stp-pcst";
+    }
+    else
+    {
+      inputFiles.push_back(nodeFile);
+      inputFiles.push_back(edgeFile);
+      settings << "mwcs";
+    }
+    if (pval)
+    {
+      settings << ";FDR=" << fdr;
+      if (ap.given("a") && ap.given("lambda"))
+        settings << ";lambda=" << lambda << ";a=" << a;
+    }
+    settings << ";root=" << root << ";no-enum=" << noEnum;
+    // with more than one thread the components are reduced on their own,
+    // each with its own lower bound
+    settings << ";threads=" << multiThreading;
+
+    snapshotKey = Snapshot::key(cacheDir, inputFiles, settings.str());
+    if (snapshotKey != 0)
+      snapshotFile = Snapshot::filename(cacheDir, snapshotKey);
   }
   
-  // compute scores
-  if (pval)
+  SnapshotInfo snapshotInfo;
+  bool fromSnapshot = !snapshotFile.empty()
+    && pPreprocessedMwcs->readSnapshot(snapshotFile, snapshotKey, snapshotInfo);
+  
+  if (!fromSnapshot)
   {
-    if (ap.given("a") && ap.given("lambda"))
-      pMwcs->computeScores(lambda, a, fdr);
-    else
-      pMwcs->computeScores(fdr);
+    if (!pMwcs->init(pParser, pval))
+    {
+      delete pParser;
+      return 1;
+    }
+    
+    // compute scores
+    if (pval)
+    {
+      if (ap.given("a") && ap.given("lambda"))
+        pMwcs->computeScores(lambda, a, fdr);
+      else
+        pMwcs->computeScores(fdr);
+    }
   }
   
   // Solve
-  const NodeSet rootNodeSet = pMwcs->getNodeByLabel(root);
+  NodeSet rootNodeSet = pMwcs->getNodeByLabel(root);
   assert(rootNodeSet.size() == 0 || rootNodeSet.size() == 1);
   
-  if (pPreprocessedMwcs && (noEnum || rootNodeSet.size() > 0))
+  if (!fromSnapshot && pPreprocessedMwcs && (noEnum || rootNodeSet.size() > 0))
   {
     pPreprocessedMwcs->preprocess(rootNodeSet);
+    pPreprocessedMwcs->compact(rootNodeSet);
+  }
+  
+  if (!fromSnapshot && !snapshotFile.empty())
+  {
+    pPreprocessedMwcs->writeSnapshot(snapshotFile, snapshotKey, snapshotInfo);
   }
   
   try {
@@ -224,7 +375,8 @@ int main(int argc, char** argv)
                     timeLimit,
                     multiThreading,
                     memoryLimit,
-                    !stpPcstFile.empty());
+                    !stpPcstFile.empty(),
+                    names);
     
     if (rootNodeSet.size() == 0 && !root.empty())
     {
@@ -257,7 +409,6 @@ int main(int argc, char** argv)
     {
       std::ofstream outFile(outputFile.c_str());
       pMwcs->printHeinz(pSolver->getSolutionModule(), outFile);
-      pMwcs->printModule(pSolver->getSolutionModule(), std::cout, false);
     }
     else if (outputFile == "-")
     {
@@ -8,23 +8,17 @@
 
 #include <Rcpp.h>
 
-// ILOG stuff
-#include <ilconcert/iloalg.h>
-#include <ilcplex/ilocplex.h>
+#include <string>
+#include <vector>
 
-#include "io/input/lgfparser.h"
-#include "io/input/identityparser.h"
-#include "mwcsparser.h"
-#include "mwcsgraph.h"
-#include "mwcsscfsolver.h"
-#include "mwcsmcfsolver.h"
+#include "parser/labelmap.h"
+#include "heinz.h"
 #include "utils.h"
 
-// make -f Makefile.R mwcsR.so
-typedef IdentityParser<Graph> ParserType;
-typedef LgfParser<Graph> LgfParserType;
-typedef MwcsParser<Graph> MwcsParserType;
+using namespace nina::mwcs;
+using namespace nina;
 
+// links against libheinz
 RcppExport SEXP solveMWCS(SEXP nodesR, SEXP nodeWeightsR,
                           SEXP sourcesR, SEXP targetsR, SEXP edgeWeightsR)
 {
@@ -32,59 +26,64 @@ RcppExport SEXP solveMWCS(SEXP nodesR, SEXP nodeWeightsR,
   Rcpp::CharacterVector xsources(sourcesR);
   Rcpp::CharacterVector xtargets(targetsR);
   Rcpp::NumericVector xnodeWeights(nodeWeightsR);
-  Rcpp::NumericVector xedgeWeights(edgeWeightsR);
 
-  Graph g;
-  g.reserveNode(static_cast<int>(xnodes.size()));
-  g.reserveEdge(static_cast<int>(xsources.size()));
-
-  g_verbosity = VERBOSE_ESSENTIAL;
-
-  // the LEMON node/edge maps
-  ParserType::IdNodeMap label(g);
-  ParserType::WeightNodeMap weight(g);
-  ParserType::WeightEdgeMap weightEdge(g);
-
-  // let's construct the graph, starting with the nodes
-  ParserType::InvIdNodeMap invNodeMap;
-  for (int i = 0; i < xnodes.size(); i++)
+  const int nNodes = static_cast<int>(xnodes.size());
+  const int nEdges = static_cast<int>(xsources.size());
+  if (nNodes == 0)
   {
-    Node n = g.addNode();
-    std::string nodeLabel = (std::string) xnodes[i];
-
-    invNodeMap[nodeLabel] = n;
-    label[n] = nodeLabel;
-    weight[n] = xnodeWeights[i];
+    return Rcpp::wrap(std::vector<bool>());
   }
 
-  // and now the edges
-  std::vector<Edge> edgeMap;
-  for (int i = 0; i < xsources.size(); i++)
+  // node indices by label
+  std::vector<const char*> labels(nNodes);
+  LabelMap<int> invNodeMap;
+  invNodeMap.reserve(nNodes);
+  for (int i = 0; i < nNodes; i++)
   {
-    Edge e = g.addEdge(invNodeMap[(std::string)xsources[i]],
-                       invNodeMap[(std::string)xtargets[i]]);
-
-    edgeMap.push_back(e);
-    weightEdge[e] = xedgeWeights[i];
+    labels[i] = xnodes[i];
+    invNodeMap.set(labels[i], i);
   }
 
-  // now solve the instance
-  ParserType parser(g, &weight, &weightEdge, &label);
+  // every edge is listed at its source, edge weights are not supported
+  std::vector<int> offsets(nNodes + 1, 0);
+  std::vector<int> sources(nEdges), targets(nEdges);
+  for (int i = 0; i < nEdges; i++)
+  {
+    sources[i] = invNodeMap.get(std::string(xsources[i]), -1);
+    targets[i] = invNodeMap.get(std::string(xtargets[i]), -1);
+    if (sources[i] == -1 || targets[i] == -1)
+    {
+      Rcpp::stop("edge with unspecified node");
+    }
+    ++offsets[sources[i] + 1];
+  }
+  for (int i = 0; i < nNodes; i++)
+  {
+    offsets[i + 1] += offsets[i];
+  }
+  std::vector<int> csrTargets(nEdges);
+  std::vector<int> pos(offsets.begin(), offsets.end() - 1);
+  for (int i = 0; i < nEdges; i++)
+  {
+    csrTargets[pos[sources[i]]++] = targets[i];
+  }
 
-  MwcsGraph mwcsGraph;
-  mwcsGraph.init(&parser);
+  HeinzOptions options;
+  options._verbosity = VERBOSE_ESSENTIAL;
 
-  MwcsSCFSolver solver(mwcsGraph);
-  solver.init();
-  solver.solve();
+  std::vector<int> module;
+  double score = 0;
+  if (!solveMwcs(nNodes, &offsets.front(), csrTargets.empty() ? NULL : &csrTargets.front(),
+                 &xnodeWeights[0], &labels.front(), options, module, score))
+  {
+    Rcpp::stop("failed to solve the instance");
+  }
 
   // construct the solution
-  std::vector<bool> solution;
-  for (int i = 0; i < xnodes.size(); i++)
+  std::vector<bool> solution(nNodes, false);
+  for (size_t i = 0; i < module.size(); i++)
   {
-    std::string nodeLabel = (std::string) xnodes[i];
-    Node n = parser.getNodeRefMap()[invNodeMap[nodeLabel]];
-    solution.push_back(solver.isNodeInSolution(n));
+    solution[module[i]] = true;
   }
 
   return Rcpp::wrap(solution);
@@ -0,0 +1,187 @@
+/*
+ * mwcsfrozengraph.h
+ *
+ *  Created on: 16-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef MWCSFROZENGRAPH_H
+#define MWCSFROZENGRAPH_H
+
+#include <assert.h>
+#include <set>
+#include <string>
+#include <vector>
+#include <lemon/core.h>
+#include "csrgraph.h"
+#include "mwcsgraph.h"
+
+namespace nina {
+namespace mwcs {
+
+/// Owns the CSR graph and its maps; a base class of MwcsFrozenGraph
+/// such that the graph outlives the maps allocated by MwcsGraph
+template<typename GR>
+struct MwcsFrozenGraphStorage
+{
+  typedef CsrGraph::NodeMap<typename GR::Node> SourceNodeMap;
+
+  MwcsFrozenGraphStorage()
+    : _g()
+    , _pScore(NULL)
+    , _pSourceNode(NULL)
+  {
+  }
+
+  ~MwcsFrozenGraphStorage()
+  {
+    clearMaps();
+  }
+
+  void clearMaps()
+  {
+    delete _pScore;
+    delete _pSourceNode;
+    _pScore = NULL;
+    _pSourceNode = NULL;
+  }
+
+  CsrGraph _g;
+  CsrGraph::NodeMap<double>* _pScore;
+  SourceNodeMap* _pSourceNode;
+};
+
+/// Immutable copy of an instance in compressed sparse row form
+///
+/// Once preprocessing is done, the reduced graph is frozen into a CsrGraph
+/// before the model is built, such that separation iterates over
+/// contiguous adjacency arrays. Solutions are mapped back to the source
+/// instance with getSourceNodes(). Labels are not copied, getLabel()
+/// resolves them through the source instance.
+template<typename GR,
+         typename NWGHT = typename GR::template NodeMap<double>,
+         typename NLBL = typename GR::template NodeMap<std::string>,
+         typename EWGHT = typename GR::template EdgeMap<double> >
+class MwcsFrozenGraph : private MwcsFrozenGraphStorage<GR>
+                      , public MwcsGraph<CsrGraph>
+{
+public:
+  typedef CsrGraph Graph;
+  typedef MwcsGraph<Graph> Parent;
+  typedef MwcsFrozenGraphStorage<GR> Storage;
+  typedef typename Parent::WeightNodeMap WeightNodeMap;
+  typedef typename Parent::LabelNodeMap LabelNodeMap;
+
+  typedef GR SourceGraph;
+  typedef MwcsGraph<SourceGraph, NWGHT, NLBL, EWGHT> SourceMwcsGraphType;
+  typedef typename SourceGraph::Node SourceNode;
+  typedef typename SourceGraph::NodeIt SourceNodeIt;
+  typedef std::set<SourceNode> SourceNodeSet;
+  typedef typename SourceNodeSet::const_iterator SourceNodeSetIt;
+
+  TEMPLATE_GRAPH_TYPEDEFS(Graph);
+
+  typedef typename Parent::NodeSet NodeSet;
+  typedef typename Parent::NodeSetIt NodeSetIt;
+
+private:
+  using Storage::_g;
+  using Storage::_pScore;
+  using Storage::_pSourceNode;
+
+public:
+  MwcsFrozenGraph()
+    : Storage()
+    , Parent()
+    , _pSource(NULL)
+    , _frozenNode()
+  {
+  }
+
+  virtual ~MwcsFrozenGraph()
+  {
+  }
+
+  /// Freezes the current graph of source, which must outlive this object
+  bool freeze(const SourceMwcsGraphType& source)
+  {
+    const SourceGraph& sourceG = source.getGraph();
+
+    typename SourceGraph::template NodeMap<Node> nodeRef(sourceG);
+    typename SourceGraph::template EdgeMap<Edge> edgeRef(sourceG);
+
+    Storage::clearMaps();
+    _g.build(sourceG, nodeRef, edgeRef);
+
+    _pScore = new WeightNodeMap(_g);
+    _pSourceNode = new typename Storage::SourceNodeMap(_g);
+
+    _frozenNode.assign(sourceG.maxNodeId() + 1, lemon::INVALID);
+    for (SourceNodeIt v(sourceG); v != lemon::INVALID; ++v)
+    {
+      const Node w = nodeRef[v];
+      (*_pScore)[w] = source.getScore(v);
+      (*_pSourceNode)[w] = v;
+      _frozenNode[sourceG.id(v)] = w;
+    }
+
+    _pSource = &source;
+    return Parent::init(&_g, NULL, _pScore, NULL);
+  }
+
+  /// Total node profit of the original (unfrozen) PCST instance
+  virtual double getTotalNodeProfitPCST() const
+  {
+    assert(_pSource);
+    return _pSource->getTotalNodeProfitPCST();
+  }
+
+  SourceNode getSourceNode(Node v) const
+  {
+    assert(v != lemon::INVALID);
+    return (*_pSourceNode)[v];
+  }
+
+  Node getFrozenNode(SourceNode v) const
+  {
+    assert(_pSource && v != lemon::INVALID);
+    return _frozenNode[_pSource->getGraph().id(v)];
+  }
+
+  SourceNodeSet getSourceNodes(const NodeSet& nodes) const
+  {
+    SourceNodeSet res;
+    for (NodeSetIt nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt)
+    {
+      res.insert(getSourceNode(*nodeIt));
+    }
+    return res;
+  }
+
+  NodeSet getFrozenNodes(const SourceNodeSet& nodes) const
+  {
+    NodeSet res;
+    for (SourceNodeSetIt nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt)
+    {
+      res.insert(getFrozenNode(*nodeIt));
+    }
+    return res;
+  }
+
+protected:
+  virtual std::string resolveOrgLabel(Node n) const
+  {
+    assert(_pSource);
+    return _pSource->getLabel(getSourceNode(n));
+  }
+
+private:
+  const SourceMwcsGraphType* _pSource;
+  /// Frozen node of every source node, indexed by source node id
+  std::vector<Node> _frozenNode;
+};
+
+} // namespace mwcs
+} // namespace nina
+
+#endif // MWCSFROZENGRAPH_H
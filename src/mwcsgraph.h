@@ -14,6 +14,7 @@
 #include <sstream>
 #include <vector>
 #include <set>
+#include <algorithm>
 #include <lemon/core.h>
 #include <lemon/lgf_writer.h>
 #include <lemon/connectivity.h>
@@ -42,12 +43,13 @@ public:
   /// Parser type
   typedef Parser<Graph, WeightNodeMap, LabelNodeMap, WeightEdgeMap> ParserType;
   typedef typename ParserType::InvIdNodeMap InvLabelNodeMap;
-  typedef typename InvLabelNodeMap::const_iterator InvLabelNodeMapIt;
 
   typedef typename std::set<Node> NodeSet;
   typedef typename NodeSet::const_iterator NodeSetIt;
   typedef typename std::vector<NodeSet> NodeSetVector;
   typedef typename NodeSetVector::const_iterator NodeSetVectorIt;
+  typedef std::vector<bool> BoolVector;
+  typedef std::vector<Edge> EdgeVector;
   
 public:
   MwcsGraph();
@@ -64,6 +66,8 @@ public:
     }
   }
   virtual bool init(ParserType* pParser, bool pval);
+  /// Initializes the instance with maps that are not owned, pLabel may be
+  /// NULL in which case labels are resolved by resolveOrgLabel()
   virtual bool init(Graph* pG,
                     LabelNodeMap* pLabel,
                     WeightNodeMap* pScore,
@@ -75,6 +79,9 @@ private:
   WeightNodeMap* _pPVal;
   WeightNodeMap* _pScore;
   InvLabelNodeMap _invLabel;
+  /// Derived from the labels on first use unless recorded by the parser
+  mutable NodeKindMap _nodeKind;
+  mutable bool _nodeKindInit;
   IntNodeMap* _pComp;
   int _nNodes;
   int _nEdges;
@@ -92,6 +99,75 @@ protected:
   {
   }
 
+  /// Label of original node n of an instance without labels,
+  /// see init(Graph*, LabelNodeMap*, WeightNodeMap*, WeightNodeMap*)
+  virtual std::string resolveOrgLabel(Node n) const
+  {
+    return std::string();
+  }
+
+  /// Allocates fresh (empty) original graph members, these are then
+  /// to be filled in by the derived class (e.g. from a snapshot)
+  void initOrgMembers()
+  {
+    if (_parserInit)
+    {
+      delete _pLabel;
+      delete _pPVal;
+      delete _pScore;
+      delete _pG;
+    }
+
+    delete _pComp;
+    _pComp = NULL;
+    _invLabel.clear();
+    _nodeKind.clear();
+    _nodeKindInit = false;
+
+    _parserInit = true;
+    initParserMembers(_pG, _pLabel, _pPVal, _pScore);
+  }
+
+  /// Updates the counts, inverse label map and components
+  /// after the original graph members have been filled in
+  void updateOrgMembers()
+  {
+    _nNodes = lemon::countNodes(*_pG);
+    _nEdges = lemon::countEdges(*_pG);
+    _nArcs = lemon::countArcs(*_pG);
+
+    _invLabel.clear();
+    _invLabel.reserve(_nNodes);
+    for (int i = 0; i <= _pG->maxNodeId(); ++i)
+    {
+      Node v = _pG->nodeFromId(i);
+      if (_pG->valid(v))
+      {
+        // as in the parsers, the first node with a given label is kept
+        _invLabel.insert((*_pLabel)[v], v);
+      }
+    }
+    _nodeKind.clear();
+    _nodeKindInit = false;
+
+    delete _pComp;
+    _pComp = new IntNodeMap(*_pG, -1);
+    _nComponents = lemon::connectedComponents(*_pG, *_pComp);
+  }
+
+  /// Derives the node kinds from the original labels, used when the
+  /// graph was not obtained from a parser that records them
+  void initNodeKinds() const
+  {
+    _nodeKind.clear();
+    _nodeKind.reserve(_pG->maxNodeId() + 1);
+    for (NodeIt v(*_pG); v != lemon::INVALID; ++v)
+    {
+      _nodeKind.setFromLabel(_pG->id(v), getOrgLabel(v));
+    }
+    _nodeKindInit = true;
+  }
+
 public:
   virtual const Graph& getGraph() const
   {
@@ -131,6 +207,16 @@ public:
     return result;
   }
 
+  /// Projects module onto the original graph
+  ///
+  /// Sets orgModule to a bitmap indexed by original node id and
+  /// returns the number of original nodes in the module
+  virtual int projectModule(const NodeSet& module,
+                            BoolVector& orgModule) const
+  {
+    return getBitmap(getOrgGraph(), module, orgModule);
+  }
+
   virtual const WeightNodeMap& getScores() const
   {
     return getOrgScores();
@@ -213,13 +299,22 @@ public:
     return *_pG;
   }
 
+  /// Returns whether the original labels are stored, if not
+  /// getOrgLabels() must not be used and getOrgLabel() resolves them
+  bool hasOrgLabels() const
+  {
+    return _pLabel != NULL;
+  }
+
   const LabelNodeMap& getOrgLabels() const
   {
+    assert(_pLabel);
     return *_pLabel;
   }
 
   LabelNodeMap& getOrgLabels()
   {
+    assert(_pLabel);
     return *_pLabel;
   }
 
@@ -274,10 +369,23 @@ public:
     return *_pComp;
   }
 
+  /// Kinds of the original nodes, indexed by original node id
+  ///
+  /// Only PCST instances need them; unless the parser recorded them,
+  /// the first call derives them from the labels and is not thread-safe
+  const NodeKindMap& getOrgNodeKinds() const
+  {
+    if (!_nodeKindInit)
+    {
+      initNodeKinds();
+    }
+    return _nodeKind;
+  }
+
   std::string getOrgLabel(Node n) const
   {
     assert(n != lemon::INVALID);
-    return (*_pLabel)[n];
+    return _pLabel ? (*_pLabel)[n] : resolveOrgLabel(n);
   }
 
   double getOrgScore(Node n) const
@@ -301,12 +409,7 @@ public:
 
   Node getOrgNodeByLabel(const std::string& label) const
   {
-    InvLabelNodeMapIt it = _invLabel.find(label);
-
-    if (it != _invLabel.end())
-      return it->second;
-    else
-      return lemon::INVALID;
+    return _invLabel.get(label, lemon::INVALID);
   }
   
   bool allNodesNegative() const
@@ -322,7 +425,7 @@ public:
     return true;
   }
   
-  double getTotalNodeProfitPCST() const;
+  virtual double getTotalNodeProfitPCST() const;
   
   virtual void printNodeList(std::ostream& out,
                              bool orig = false) const;
@@ -351,6 +454,52 @@ public:
                                std::ostream& out) const;
   virtual void computeScores(double lambda, double a, double FDR) {}
   virtual void computeScores(double tau) {}
+
+protected:
+  /// Sets bitmap to the nodes of g in module (indexed by node id),
+  /// returns the number of nodes
+  static int getBitmap(const Graph& g,
+                       const NodeSet& module,
+                       BoolVector& bitmap)
+  {
+    bitmap.assign(g.maxNodeId() + 1, false);
+
+    int n = 0;
+    for (NodeSetIt nodeIt = module.begin(); nodeIt != module.end(); ++nodeIt)
+    {
+      if (!bitmap[g.id(*nodeIt)])
+      {
+        bitmap[g.id(*nodeIt)] = true;
+        ++n;
+      }
+    }
+    return n;
+  }
+
+  /// Returns the edges of g induced by bitmap, ordered by id
+  static EdgeVector getInducedEdges(const Graph& g,
+                                    const BoolVector& bitmap)
+  {
+    EdgeVector edges;
+    for (int i = 0; i < static_cast<int>(bitmap.size()); ++i)
+    {
+      if (!bitmap[i])
+        continue;
+
+      Node u = g.nodeFromId(i);
+      for (IncEdgeIt e(g, u); e != lemon::INVALID; ++e)
+      {
+        // every edge is taken from its u end point only
+        if (g.u(e) == u && bitmap[g.id(g.v(e))])
+        {
+          edges.push_back(e);
+        }
+      }
+    }
+
+    std::sort(edges.begin(), edges.end());
+    return edges;
+  }
 };
 
 template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
@@ -360,6 +509,8 @@ inline MwcsGraph<GR, NWGHT, NLBL, EWGHT>::MwcsGraph()
   , _pPVal(NULL)
   , _pScore(NULL)
   , _invLabel()
+  , _nodeKind()
+  , _nodeKindInit(false)
   , _pComp(NULL)
   , _nNodes(0)
   , _nEdges(0)
@@ -395,9 +546,13 @@ inline bool MwcsGraph<GR, NWGHT, NLBL, EWGHT>::init(ParserType* pParser, bool pv
     pParser->setWeightNodeMap(_pScore);
 
   pParser->setInvIdNodeMap(&_invLabel);
+  _nodeKind.clear();
+  pParser->setNodeKindMap(&_nodeKind);
 
   if (pParser->parse())
   {
+    _nodeKindInit = !_nodeKind.empty();
+
     _nNodes = pParser->getNodeCount();
     _nEdges = pParser->getEdgeCount();
 
@@ -442,7 +597,7 @@ inline void MwcsGraph<GR, NWGHT, NLBL, EWGHT>::printModule(const BoolNodeMap& mo
     }
   }
 
-  printModule(nodes, out);
+  printModule(nodes, out, orig);
 }
 
 template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
@@ -451,21 +606,20 @@ inline void MwcsGraph<GR, NWGHT, NLBL, EWGHT>::printNodeList(std::ostream& out,
 {
   const Graph& g = orig ? getOrgGraph() : getGraph();
   const WeightNodeMap& weight = orig ? getOrgScores() : getScores();
-  const LabelNodeMap& label = orig ? getOrgLabels() : getLabels();
   const WeightNodeMap* pPVal = orig ? getOrgPValues() : NULL;
   
   for (NodeIt n(g); n != lemon::INVALID; ++n)
   {
     out << g.id(n) << " " << weight[n];
     
-    out << " " << label[n];
+    out << " " << (orig ? getOrgLabel(n) : getLabel(n));
     
     if (pPVal)
     {
       out << " " << (*_pPVal)[n];
     }
     
-    out << std::endl;
+    out << "\n";
   }
 }
   
@@ -495,7 +649,6 @@ inline void MwcsGraph<GR, NWGHT, NLBL, EWGHT>::print(std::ostream& out,
 {
   const Graph& g = orig ? getOrgGraph() : getGraph();
   const WeightNodeMap& weight = orig ? getOrgScores() : getScores();
-  const LabelNodeMap& label = orig ? getOrgLabels() : getLabels();
   const WeightNodeMap* pPVal = orig ? getOrgPValues() : NULL;
 
   // header
@@ -507,7 +660,7 @@ inline void MwcsGraph<GR, NWGHT, NLBL, EWGHT>::print(std::ostream& out,
   for (NodeIt n(g); n != lemon::INVALID; ++n)
   {
     out << "\t" << g.id(n) << " [label=\""
-       << label[n] << "\\n"
+       << (orig ? getOrgLabel(n) : getLabel(n)) << "\\n"
        << weight[n] << "\\n";
 
     if (pPVal)
@@ -518,13 +671,13 @@ inline void MwcsGraph<GR, NWGHT, NLBL, EWGHT>::print(std::ostream& out,
     out << g.id(n)
        << "\""
        << (weight[n] < 0 ? ",shape=box" : "")
-       << "]" << std::endl;
+       << "]\n";
   }
 
   // edges
   for (EdgeIt e(g); e != lemon::INVALID; ++e)
   {
-    out << "\t" << g.id(g.u(e)) << " -- " << g.id(g.v(e)) << std::endl;
+    out << "\t" << g.id(g.u(e)) << " -- " << g.id(g.v(e)) << "\n";
   }
 
   // footer
@@ -538,22 +691,22 @@ inline void MwcsGraph<GR, NWGHT, NLBL, EWGHT>::printModule(const NodeSet& module
 {
   const Graph& g = orig ? getOrgGraph() : getGraph();
   const WeightNodeMap& weight = orig ? getOrgScores() : getScores();
-  const LabelNodeMap& label = orig ? getOrgLabels() : getLabels();
   const WeightNodeMap* pPVal = orig ? getOrgPValues() : NULL;
 
-  std::vector<Edge> edges;
+  BoolVector inModule;
+  getBitmap(g, module, inModule);
 
   // print header
-  out << "graph G {" << std::endl;
-  out << "\toverlap=scale" << std::endl;
-  out << "\tlayout=neato" << std::endl;
+  out << "graph G {\n";
+  out << "\toverlap=scale\n";
+  out << "\tlayout=neato\n";
 
   double totalWeight = 0;
   for (NodeSetIt nodeIt1 = module.begin(); nodeIt1 != module.end(); nodeIt1++)
   {
     totalWeight += weight[*nodeIt1];
     out << "\t" << g.id(*nodeIt1) << " [label=\""
-        << label[*nodeIt1] << "\\n"
+        << (orig ? getOrgLabel(*nodeIt1) : getLabel(*nodeIt1)) << "\\n"
         << weight[*nodeIt1] << "\\n";
 
     if (pPVal)
@@ -564,21 +717,17 @@ inline void MwcsGraph<GR, NWGHT, NLBL, EWGHT>::printModule(const NodeSet& module
     out << g.id(*nodeIt1)
         << "\""
         << (weight[*nodeIt1] < 0 ? ",shape=box" : "")
-        << "]" << std::endl;
+        << "]\n";
   }
 
-  out << "\tlabel=\"Total weight: " << totalWeight << '"' << std::endl;
+  out << "\tlabel=\"Total weight: " << totalWeight << "\"\n";
 
   // print edges
-  for (EdgeIt e(g); e != lemon::INVALID; ++e)
+  const EdgeVector edges = getInducedEdges(g, inModule);
+  for (typename EdgeVector::const_iterator edgeIt = edges.begin();
+       edgeIt != edges.end(); ++edgeIt)
   {
-    Node u = g.u(e);
-    Node v = g.v(e);
-    
-    if (module.find(u) != module.end() && module.find(v) != module.end())
-    {
-      out << "\t" << g.id(u) << " -- " << g.id(v) << std::endl;
-    }
+    out << "\t" << g.id(g.u(*edgeIt)) << " -- " << g.id(g.v(*edgeIt)) << "\n";
   }
 
   // print footer
@@ -591,19 +740,21 @@ inline void MwcsGraph<GR, NWGHT, NLBL, EWGHT>::printHeinzOrg(const NodeSet& modu
 {
   const Graph& g = getOrgGraph();
 
-  out << "#label\tscore" << std::endl;
+  BoolVector inModule;
+  getBitmap(g, module, inModule);
+
+  out << "#label\tscore\n";
   double score = 0;
   for (NodeIt v(g); v != lemon::INVALID; ++v)
   {
-    bool inSolution = (module.find(v) != module.end());
-    if (inSolution)
+    if (inModule[g.id(v)])
     {
       score += getOrgScore(v);
-      out << getOrgLabel(v) << "\t" << getOrgScore(v) << std::endl;
+      out << getOrgLabel(v) << "\t" << getOrgScore(v) << "\n";
     }
     else
     {
-      out << getOrgLabel(v) << "\tNaN" << std::endl;
+      out << getOrgLabel(v) << "\tNaN\n";
     }
   }
   out << "#total score\t" << score << std::endl;
@@ -615,25 +766,21 @@ inline void MwcsGraph<GR, NWGHT, NLBL, EWGHT>::printHeinz(const NodeSet& module,
 {
   const Graph& g = getOrgGraph();
 
-  out << "#label\tscore" << std::endl;
+  BoolVector inModule;
+  projectModule(module, inModule);
+
+  out << "#label\tscore\n";
   double score = 0;
   for (NodeIt v(g); v != lemon::INVALID; ++v)
   {
-    NodeSet preNodes = this->getPreNodes(v);
-    bool inSolution = false;
-    for (NodeSetIt preNodeIt = preNodes.begin(); preNodeIt != preNodes.end(); ++preNodeIt)
-    {
-      inSolution |= module.find(*preNodeIt) != module.end();
-    }
-    
-    if (inSolution)
+    if (inModule[g.id(v)])
     {
       score += getOrgScore(v);
-      out << getOrgLabel(v) << "\t" << getOrgScore(v) << std::endl;
+      out << getOrgLabel(v) << "\t" << getOrgScore(v) << "\n";
     }
     else
     {
-      out << getOrgLabel(v) << "\tNaN" << std::endl;
+      out << getOrgLabel(v) << "\tNaN\n";
     }
   }
   out << "#total score\t" << score << std::endl;
@@ -643,45 +790,30 @@ template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
 inline void MwcsGraph<GR, NWGHT, NLBL, EWGHT>::printMwcsDimacs(const NodeSet& module,
                                                                std::ostream& out) const
 {
-  // determine vertices
-  int n = 0;
-  for (NodeSetIt nodeIt = module.begin(); nodeIt != module.end(); ++nodeIt)
-  {
-    n += getOrgNodes(*nodeIt).size();
-  }
-  out << "Vertices " << n << std::endl;
-  
-  std::set<Node> nodes;
-  for (NodeSetIt nodeIt = module.begin(); nodeIt != module.end(); ++nodeIt)
-  {
-    NodeSet orgNodes = getOrgNodes(*nodeIt);
-    for (NodeSetIt nodeIt2 = orgNodes.begin(); nodeIt2 != orgNodes.end(); ++nodeIt2)
-    {
-      nodes.insert(*nodeIt2);
-      out << "V " << getOrgLabel(*nodeIt2) << std::endl;
-    }
-  }
-  
-  // determine edges
-  std::set<Edge> edges;
   const Graph& g = getOrgGraph();
-  for (EdgeIt e(g); e != lemon::INVALID; ++e)
+
+  BoolVector inModule;
+  const int n = projectModule(module, inModule);
+
+  // vertices
+  out << "Vertices " << n << "\n";
+  for (int i = 0; i < static_cast<int>(inModule.size()); ++i)
   {
-    Node u = g.u(e);
-    Node v = g.v(e);
-    
-    if (nodes.find(u) != nodes.end() && nodes.find(v) != nodes.end())
+    if (inModule[i])
     {
-      edges.insert(e);
+      out << "V " << getOrgLabel(g.nodeFromId(i)) << "\n";
     }
   }
-  
-  out << "Edges " << edges.size() << std::endl;
-  for (typename std::set<Edge>::const_iterator edgeIt = edges.begin();
+
+  // edges
+  const EdgeVector edges = getInducedEdges(g, inModule);
+  out << "Edges " << edges.size() << "\n";
+  for (typename EdgeVector::const_iterator edgeIt = edges.begin();
        edgeIt != edges.end(); ++edgeIt)
   {
-    out << "E " << getOrgLabel(g.u(*edgeIt)) << " " << getOrgLabel(g.v(*edgeIt)) << std::endl;
+    out << "E " << getOrgLabel(g.u(*edgeIt)) << " " << getOrgLabel(g.v(*edgeIt)) << "\n";
   }
+  out.flush();
 }
   
 template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
@@ -694,43 +826,45 @@ inline void MwcsGraph<GR, NWGHT, NLBL, EWGHT>::printPcstDimacs(const NodeSet& mo
   typedef std::vector<int> IntVector;
   typedef IntVector::const_iterator IntVectorIt;
   
+  BoolVector inModule;
+  projectModule(module, inModule);
+
   IntVector vertices;
   IntPairVector edges;
+  const NodeKindMap& kinds = getOrgNodeKinds();
   
   // determine vertices and edges
-  for (NodeSetIt nodeIt = module.begin(); nodeIt != module.end(); ++nodeIt)
+  for (int i = 0; i < static_cast<int>(inModule.size()); ++i)
   {
-    NodeSet orgNodes = getOrgNodes(*nodeIt);
-    for (NodeSetIt nodeIt2 = orgNodes.begin(); nodeIt2 != orgNodes.end(); ++nodeIt2)
+    if (!inModule[i])
+      continue;
+
+    switch (kinds.kind(i))
     {
-      const std::string& label = getOrgLabel(*nodeIt2);
-      int u = -1, v = -1;
-      if (sscanf(label.c_str(), "%d--%d", &u, &v) == 2)
-      {
-        edges.push_back(std::make_pair(u, v));
-      }
-      else if (sscanf(label.c_str(), "%d", &u) == 1)
-      {
-        vertices.push_back(u);
-      }
-      else
-      {
+      case NODE_KIND_EDGE:
+        edges.push_back(std::make_pair(kinds.u(i), kinds.v(i)));
+        break;
+      case NODE_KIND_VERTEX:
+        vertices.push_back(kinds.u(i));
+        break;
+      default:
         assert(false);
-      }
+        break;
     }
   }
   
-  out << "Vertices " << vertices.size() << std::endl;
+  out << "Vertices " << vertices.size() << "\n";
   for (IntVectorIt nodeIt = vertices.begin(); nodeIt != vertices.end(); ++nodeIt)
   {
-    out << "V " << *nodeIt << std::endl;
+    out << "V " << *nodeIt << "\n";
   }
   
-  out << "Edges " << edges.size() << std::endl;
+  out << "Edges " << edges.size() << "\n";
   for (IntPairVectorIt edgeIt = edges.begin(); edgeIt != edges.end(); ++edgeIt)
   {
-    out << "E " << edgeIt->first << " " << edgeIt->second << std::endl;
+    out << "E " << edgeIt->first << " " << edgeIt->second << "\n";
   }
+  out.flush();
 }
   
 template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
@@ -765,7 +899,7 @@ inline void MwcsGraph<GR, NWGHT, NLBL, EWGHT>::printSTP(const std::string& name,
   
   for (EdgeIt e(g); e != lemon::INVALID; ++e)
   {
-    out << "E " << id[g.u(e)] << " " << id[g.v(e)] << std::endl;
+    out << "E " << id[g.u(e)] << " " << id[g.v(e)] << "\n";
   }
   out << "END" << std::endl;
   out << std::endl;
@@ -774,7 +908,7 @@ inline void MwcsGraph<GR, NWGHT, NLBL, EWGHT>::printSTP(const std::string& name,
   out << "Terminals " << getNodeCount() << std::endl;
   for (NodeIt v(g); v != lemon::INVALID; ++v)
   {
-    out << "T " << id[v] << " " << weight[v] << std::endl;
+    out << "T " << id[v] << " " << weight[v] << "\n";
   }
   out << "END" << std::endl;
   out << std::endl;
@@ -805,6 +939,9 @@ inline bool MwcsGraph<GR, NWGHT, NLBL, EWGHT>::init(Graph* pG,
   _nEdges = lemon::countEdges(*_pG);
   _nArcs = lemon::countArcs(*_pG);
 
+  _nodeKind.clear();
+  _nodeKindInit = false;
+
   // determine the components
   _pComp = new IntNodeMap(*_pG, -1);
   _nComponents = lemon::connectedComponents(*_pG, *_pComp);
@@ -820,13 +957,10 @@ inline double MwcsGraph<GR, NWGHT, NLBL, EWGHT>::getTotalNodeProfitPCST() const
   double res = 0;
   
   const Graph& orgG = getOrgGraph();
+  const NodeKindMap& kinds = getOrgNodeKinds();
   for (NodeIt v(orgG); v != lemon::INVALID; ++v)
   {
-    const std::string& label = getOrgLabel(v);
-    
-    int idU = -1;
-    char c = '\0';
-    if (sscanf(label.c_str(), "%d%c", &idU, &c) == 1)
+    if (kinds.isVertex(orgG.id(v)))
     {
       res += getOrgScore(v);
     }
@@ -43,7 +43,6 @@ public:
 public:
   typedef typename Parent::ParserType ParserType;
   typedef typename Parent::InvLabelNodeMap InvLabelNodeMap;
-  typedef typename Parent::InvLabelNodeMapIt InvLabelNodeMapIt;
 
   typedef typename Parent::NodeSet NodeSet;
   typedef typename Parent::NodeSetIt NodeSetIt;
@@ -9,11 +9,15 @@
 #define MWCSPREPROCESSEDGRAPH_H
 
 #include "mwcsgraphparser.h"
+#include "snapshot.h"
 #include "preprocessing/rule.h"
 #include <set>
 #include <vector>
 #include <algorithm>
+#include <thread>
+#include <atomic>
 #include <lemon/core.h>
+#include <lemon/time_measure.h>
 
 #include "preprocessing/negdeg01.h"
 #include "preprocessing/posedge.h"
@@ -42,16 +46,22 @@ public:
   typedef EWGHT WeightEdgeMap;
 
   typedef MwcsGraphParser<GR, NWGHT, NLBL, EWGHT> Parent;
+  typedef MwcsGraph<GR, NWGHT, NLBL, EWGHT> MwcsGraphType;
   typedef Rule<GR, NWGHT> RuleType;
   typedef typename Parent::ParserType ParserType;
   typedef typename Parent::InvLabelNodeMap InvLabelNodeMap;
-  typedef typename Parent::InvLabelNodeMapIt InvLabelNodeMapIt;
+  typedef typename Parent::BoolVector BoolVector;
   typedef typename RuleType::DegreeNodeMap DegreeNodeMap;
-  typedef typename RuleType::DegreeNodeSetVector DegreeNodeSetVector;
+  typedef typename RuleType::DegreeNodeBuckets DegreeNodeBuckets;
   typedef typename RuleType::NodeMap NodeMap;
   typedef typename RuleType::NodeSet NodeSet;
   typedef typename RuleType::NodeSetIt NodeSetIt;
+  typedef typename RuleType::CompactNodeSetType CompactNodeSetType;
+  typedef typename RuleType::CompactNodeSetIt CompactNodeSetIt;
   typedef typename RuleType::NodeSetMap NodeSetMap;
+  typedef typename RuleType::ProvenanceForestType ProvenanceForestType;
+  typedef typename RuleType::ChangeLogType ChangeLogType;
+  typedef typename ProvenanceForestType::OrgNodeIt OrgNodeIt;
   
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
   
@@ -70,10 +80,38 @@ public:
   using Parent::getOrgLabels;
   using Parent::getOrgNodeByLabel;
   using Parent::getOrgNodeCount;
+  using Parent::getOrgPValues;
   using Parent::getOrgScore;
   using Parent::getOrgScores;
+  using Parent::hasOrgLabels;
   using Parent::_parserInit;
 
+  /// Statistics of a preprocessing rule over the last call of preprocess()
+  struct RuleStatistics
+  {
+    std::string _name;
+    int _phase;
+    /// Number of invocations
+    int _nInvocations;
+    /// Number of invocations that changed the graph
+    int _nEffective;
+    int _nRemovedNodes;
+    /// Total time in seconds, summed over all threads
+    double _time;
+
+    RuleStatistics(const std::string& name, int phase)
+      : _name(name)
+      , _phase(phase)
+      , _nInvocations(0)
+      , _nEffective(0)
+      , _nRemovedNodes(0)
+      , _time(0)
+    {
+    }
+  };
+
+  typedef std::vector<RuleStatistics> RuleStatisticsVector;
+
 private:
   typedef std::vector<RuleType*> RuleVector;
   typedef typename RuleVector::const_iterator RuleVectorIt;
@@ -84,7 +122,47 @@ public:
   MwcsPreprocessedGraph();
   virtual ~MwcsPreprocessedGraph();
   virtual bool init(ParserType* pParser, bool pval);
+  /// Applies the reduction rules until none of them applies
+  ///
+  /// Rules are grouped in phases: the rules of a phase are applied until
+  /// they no longer change the graph, upon a change by a later phase the
+  /// preprocessing falls back to the first phase. Every rule only
+  /// re-examines the nodes changed since its previous invocation.
+  ///
+  /// With more than one thread and no root nodes, the connected components
+  /// are first reduced independently on a pool of threads, see setThreads().
   void preprocess(const NodeSet& rootNodes);
+  /// Statistics of every rule, in phase order, over the last preprocess()
+  const RuleStatisticsVector& getRuleStatistics() const
+  {
+    return _ruleStatistics;
+  }
+  /// Time in seconds spent by the last preprocess()
+  double getPreprocessingTime() const
+  {
+    return _preprocessingTime;
+  }
+  /// Renumbers the preprocessed graph into dense ids
+  ///
+  /// Preprocessing leaves the surviving nodes scattered over the ids of
+  /// the original graph, hence node maps allocated afterwards are mostly
+  /// dead space. The graph is rebuilt in place in breadth-first order, such
+  /// that every component occupies a contiguous id range and adjacent nodes
+  /// tend to have nearby ids. The provenance is renumbered accordingly.
+  /// Nodes, edges and external node maps of getGraph() are invalidated,
+  /// except for nodes, which is updated to the renumbered nodes.
+  void compact(NodeSet& nodes);
+  void compact()
+  {
+    NodeSet nodes;
+    compact(nodes);
+  }
+  bool writeSnapshot(const std::string& filename,
+                     uint64_t key,
+                     const SnapshotInfo& info) const;
+  bool readSnapshot(const std::string& filename,
+                    uint64_t key,
+                    SnapshotInfo& info);
   void updateComponentMap()
   {
     _pGraph->_nComponents = lemon::connectedComponents(*_pGraph->_pG, *_pGraph->_pComp);
@@ -109,21 +187,19 @@ private:
     LabelNodeMap* _pLabel;
     WeightNodeMap* _pScore;
     IntNodeMap* _pComp;
-    NodeSetMap* _pPreOrigNodes;
-    NodeSetMap* _pMapToPre;
+    ProvenanceForestType* _pProvenance;
     int _nNodes;
     int _nEdges;
     int _nArcs;
     int _nComponents;
 
     // constructor
-    GraphStruct(const Graph& orgG)
+    GraphStruct()
       : _pG(new Graph())
       , _pLabel(new LabelNodeMap(*_pG))
       , _pScore(new WeightNodeMap(*_pG))
       , _pComp(new IntNodeMap(*_pG))
-      , _pPreOrigNodes(new NodeSetMap(*_pG))
-      , _pMapToPre(new NodeSetMap(orgG))
+      , _pProvenance(new ProvenanceForestType())
       , _nNodes(0)
       , _nEdges(0)
       , _nArcs(0)
@@ -134,8 +210,7 @@ private:
     // destructor
     ~GraphStruct()
     {
-      delete _pPreOrigNodes;
-      delete _pMapToPre;
+      delete _pProvenance;
       delete _pComp;
       delete _pScore;
       delete _pLabel;
@@ -147,6 +222,14 @@ private:
   GraphStruct* _pGraph;
   GraphStruct* _pBackupGraph;
   RuleMatrix _rules;
+  int _nThreads;
+  RuleStatisticsVector _ruleStatistics;
+  double _preprocessingTime;
+  /// Instance and node map resolving the labels of an instance without labels
+  const MwcsGraphType* _pLabelSource;
+  const NodeMap* _pLabelSourceNode;
+  /// Whether the preprocessed graph may differ from the original graph
+  bool _modified;
 
 protected:
   virtual void initParserMembers(Graph*& pG,
@@ -155,7 +238,16 @@ protected:
                                  WeightNodeMap*& pPVal)
   {
     Parent::initParserMembers(pG, pLabel, pScore, pPVal);
-    _pGraph = new GraphStruct(*pG);
+    _pGraph = new GraphStruct();
+  }
+
+  using Parent::initOrgMembers;
+  using Parent::updateOrgMembers;
+
+  virtual std::string resolveOrgLabel(Node n) const
+  {
+    assert(_pLabelSource && _pLabelSourceNode);
+    return _pLabelSource->getLabel((*_pLabelSourceNode)[n]);
   }
 
 public:
@@ -171,22 +263,52 @@ public:
 
   virtual NodeSet getOrgNodes(Node node) const
   {
-    return (*_pGraph->_pPreOrigNodes)[node];
+    NodeSet result;
+    _pGraph->_pProvenance->getOrgNodes(node, result);
+    return result;
   }
 
   virtual NodeSet getOrgNodes(const NodeSet& nodes) const
   {
     NodeSet result;
-    const NodeSetMap& preOrigNodes = *_pGraph->_pPreOrigNodes;
+    const ProvenanceForestType& provenance = *_pGraph->_pProvenance;
 
     for (NodeSetIt nodeIt = nodes.begin(); nodeIt != nodes.end(); nodeIt++)
     {
-      result.insert(preOrigNodes[*nodeIt].begin(), preOrigNodes[*nodeIt].end());
+      provenance.getOrgNodes(*nodeIt, result);
     }
 
     return result;
   }
 
+  virtual int projectModule(const NodeSet& module,
+                            BoolVector& orgModule) const
+  {
+    const Graph& orgG = getOrgGraph();
+    const ProvenanceForestType& provenance = *_pGraph->_pProvenance;
+
+    orgModule.assign(orgG.maxNodeId() + 1, false);
+
+    int n = 0;
+    for (NodeSetIt nodeIt = module.begin(); nodeIt != module.end(); ++nodeIt)
+    {
+      for (OrgNodeIt orgNodeIt(provenance, *nodeIt); orgNodeIt != lemon::INVALID; ++orgNodeIt)
+      {
+        if (!orgModule[orgG.id(orgNodeIt)])
+        {
+          orgModule[orgG.id(orgNodeIt)] = true;
+          ++n;
+        }
+      }
+    }
+    return n;
+  }
+
+  /// Labels of the nodes as maintained by the reduction rules
+  ///
+  /// Merged nodes keep the label of one original node and the labels of
+  /// an instance without labels are empty; anything that presents labels
+  /// must use getLabel() instead
   virtual const LabelNodeMap& getLabels() const
   {
     return *_pGraph->_pLabel;
@@ -249,7 +371,7 @@ public:
     Node orgNode = getOrgNodeByLabel(label);
     if (orgNode != lemon::INVALID)
     {
-      return (*_pGraph->_pMapToPre)[orgNode];
+      return getPreNodes(orgNode);
     }
     
     return NodeSet();
@@ -260,13 +382,55 @@ public:
     while (static_cast<int>(_rules.size()) < phase)
       _rules.push_back(RuleVector());
     
+    pRule->setThreads(_nThreads);
     _rules[phase - 1].push_back(pRule);
   }
 
+  /// Sets the number of threads used by the preprocessing
+  void setThreads(int nThreads)
+  {
+    _nThreads = std::max(nThreads, 1);
+    for (size_t i = 0; i < _rules.size(); ++i)
+    {
+      for (RuleVectorIt it = _rules[i].begin(); it != _rules[i].end(); it++)
+      {
+        (*it)->setThreads(_nThreads);
+      }
+    }
+  }
+
+  int getThreads() const
+  {
+    return _nThreads;
+  }
+
+  /// Returns the labels of the original nodes of n, separated by '_'
+  ///
+  /// Merged nodes only keep the label of one original node in
+  /// getLabels(); the full label is rendered here on demand.
   virtual std::string getLabel(Node n) const
   {
     assert(n != lemon::INVALID);
-    return (*_pGraph->_pLabel)[n];
+    const NodeSet orgNodes = getOrgNodes(n);
+    if (orgNodes.empty())
+    {
+      return (*_pGraph->_pLabel)[n];
+    }
+    else if (orgNodes.size() == 1)
+    {
+      return getOrgLabel(*orgNodes.begin());
+    }
+
+    std::string res;
+    for (NodeSetIt nodeIt = orgNodes.begin(); nodeIt != orgNodes.end(); ++nodeIt)
+    {
+      if (nodeIt != orgNodes.begin())
+      {
+        res += "_";
+      }
+      res += getOrgLabel(*nodeIt);
+    }
+    return res;
   }
 
   virtual bool init(Graph* pG,
@@ -274,34 +438,54 @@ public:
                     WeightNodeMap* pScore,
                     WeightNodeMap* pPVal);
 
+  /// Initializes the instance without labels, the label of an original
+  /// node v is resolved on demand as labelSource.getLabel(labelSourceNode[v])
+  ///
+  /// Meant for the subgraphs built while solving, labelSource and
+  /// labelSourceNode must remain valid as long as labels are queried.
+  bool init(Graph* pG,
+            WeightNodeMap* pScore,
+            const MwcsGraphType& labelSource,
+            const NodeMap& labelSourceNode);
+
   virtual void computeScores(double lambda, double a, double FDR);
 
   virtual void computeScores(double tau);
 
   virtual NodeSet getPreNodes(Node orgNode) const
   {
-    assert(_pGraph->_pMapToPre);
-    return (*_pGraph->_pMapToPre)[orgNode];
+    assert(_pGraph->_pProvenance);
+    NodeSet res;
+    _pGraph->_pProvenance->getPreNodes(orgNode, res);
+    return res;
   }
   
   virtual NodeSet getPreNodes(const NodeSet orgNodes) const
   {
-    assert(_pGraph->_pMapToPre);
+    assert(_pGraph->_pProvenance);
     NodeSet res;
     for (NodeSetIt nodeIt = orgNodes.begin(); nodeIt != orgNodes.end(); ++nodeIt)
     {
-      const NodeSet& preNodes = (*_pGraph->_pMapToPre)[*nodeIt];
-      res.insert(preNodes.begin(), preNodes.end());
+      _pGraph->_pProvenance->getPreNodes(*nodeIt, res);
     }
     return res;
   }
   
   
+  /// Resets the preprocessed graph to the original graph
+  ///
+  /// Nothing is copied if the preprocessed graph has not changed since the
+  /// previous reset, e.g. if no rule applied in preprocess(). Changes are
+  /// tracked by the member functions of this class only.
   void clear()
   {
     if (!_pGraph)
     {
-      _pGraph = new GraphStruct(getOrgGraph());
+      _pGraph = new GraphStruct();
+    }
+    else if (!_modified)
+    {
+      return;
     }
     
     _pGraph->_pG->clear();
@@ -312,21 +496,25 @@ public:
     
     NodeMap nodeRef(getOrgGraph());
 
-    lemon::graphCopy(getOrgGraph(), *_pGraph->_pG)
-        .nodeMap(getOrgScores(), *_pGraph->_pScore)
-        .nodeMap(getOrgLabels(), *_pGraph->_pLabel)
+    lemon::GraphCopy<Graph, Graph> copy(getOrgGraph(), *_pGraph->_pG);
+    copy.nodeMap(getOrgScores(), *_pGraph->_pScore)
         .nodeMap(getOrgComponentMap(), *_pGraph->_pComp)
-        .nodeRef(nodeRef)
-        .run();
+        .nodeRef(nodeRef);
+    if (hasOrgLabels())
+    {
+      // without labels getLabel() resolves them from the original nodes
+      copy.nodeMap(getOrgLabels(), *_pGraph->_pLabel);
+    }
+    copy.run();
 
+    ProvenanceForestType& provenance = *_pGraph->_pProvenance;
+    provenance.clear();
+    provenance.reserve(getOrgNodeCount());
     for (NodeIt n(getOrgGraph()); n != lemon::INVALID; ++n)
     {
-      Node preNode = nodeRef[n];
-      (*_pGraph->_pPreOrigNodes)[preNode].clear();
-      (*_pGraph->_pPreOrigNodes)[preNode].insert(n);
-      (*_pGraph->_pMapToPre)[n].clear();
-      (*_pGraph->_pMapToPre)[n].insert(preNode);
+      provenance.add(n, nodeRef[n]);
     }
+    _modified = false;
   }
   
   void remove(Node node)
@@ -342,17 +530,12 @@ public:
       isolated = false;
     }
     
-    // update mapToPre
-    const NodeSet& orgNodes = (*_pGraph->_pPreOrigNodes)[node];
-    for (NodeSetIt orgNodeIt = orgNodes.begin(); orgNodeIt != orgNodes.end(); ++orgNodeIt)
-    {
-      // unmap
-      Node orgNode = *orgNodeIt;
-      (*_pGraph->_pMapToPre)[orgNode].erase(node);
-    }
+    // unmap the original nodes
+    _pGraph->_pProvenance->remove(node);
     
     g.erase(node);
     --_pGraph->_nNodes;
+    _modified = true;
   }
   
   Edge addEdge(Node u, Node v)
@@ -364,6 +547,7 @@ public:
     
     ++_pGraph->_nEdges;
     _pGraph->_nArcs += 2;
+    _modified = true;
     
     return g.addEdge(u, v);
   }
@@ -376,6 +560,7 @@ public:
     
     _pGraph->_nEdges--;
     _pGraph->_nArcs -= 2;
+    _modified = true;
     
     g.erase(e);
   }
@@ -436,20 +621,12 @@ public:
     (*_pGraph->_pScore)[v] += (*_pGraph->_pScore)[u];
     
     // update set of original nodes corresponding to v
-    const NodeSet& uOrgNodeSet = (*_pGraph->_pPreOrigNodes)[u];
-    for (NodeSetIt nodeIt = uOrgNodeSet.begin(); nodeIt != uOrgNodeSet.end(); ++nodeIt)
-    {
-      (*_pGraph->_pPreOrigNodes)[v].insert(*nodeIt);
-      (*_pGraph->_pMapToPre)[*nodeIt].erase(u);
-      (*_pGraph->_pMapToPre)[*nodeIt].insert(v);
-    }
-    
-    // merge the labels
-    (*_pGraph->_pLabel)[v] += "_" + (*_pGraph->_pLabel)[u];
+    _pGraph->_pProvenance->merge(u, v);
 
     // erase minNode
     g.contract(v, u, true);
     --_pGraph->_nNodes;
+    _modified = true;
     
     assert(lemon::simpleGraph(g));
     
@@ -494,41 +671,84 @@ public:
     Graph& g = *_pGraph->_pG;
     Node res = g.addNode();
     ++_pGraph->_nNodes;
+    _modified = true;
     
     (*_pGraph->_pScore)[res] = 0;
+    if (!nodes.empty())
+    {
+      // the full label is rendered by getLabel()
+      (*_pGraph->_pLabel)[res] = (*_pGraph->_pLabel)[*nodes.begin()];
+    }
     
-    bool first = true;
     for (NodeSetIt nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt)
     {
       Node v = *nodeIt;
-      const NodeSet& orgNodes = (*_pGraph->_pPreOrigNodes)[v];
       
       (*_pGraph->_pScore)[res] += (*_pGraph->_pScore)[v];
-      
-      if (!first)
-      {
-        (*_pGraph->_pLabel)[res] += "_";
-      }
-      else
-      {
-        first = false;
-      }
-      (*_pGraph->_pLabel)[res] += (*_pGraph->_pLabel)[v];
-      (*_pGraph->_pPreOrigNodes)[res].insert(orgNodes.begin(), orgNodes.end());
-      
-      for (NodeSetIt orgNodeIt = orgNodes.begin(); orgNodeIt != orgNodes.end(); ++orgNodeIt)
-      {
-        (*_pGraph->_pMapToPre)[*orgNodeIt].insert(res);
-      }
+      _pGraph->_pProvenance->copy(v, res);
     }
     
     return res;
   }
 
 protected:
-  void constructDegreeMap(DegreeNodeMap& degree,
-                          DegreeNodeSetVector& degreeVector) const;
-  void constructNeighborMap(NodeSetMap& neighbors) const;
+  static void constructDegreeMap(const Graph& g,
+                                 DegreeNodeMap& degree,
+                                 DegreeNodeBuckets& degreeBuckets);
+  static void constructNeighborMap(const Graph& g,
+                                   NodeSetMap& neighbors);
+
+private:
+  typedef std::vector<Node> NodeVector;
+  typedef std::vector<NodeVector> NodeMatrix;
+  typedef std::vector<GraphStruct*> GraphStructVector;
+  typedef std::vector<double> DoubleVector;
+
+  struct SizeGreater
+  {
+    bool operator()(const NodeVector& a, const NodeVector& b) const
+    {
+      return a.size() > b.size();
+    }
+  };
+
+  static void initRuleStatistics(const RuleMatrix& rules,
+                                 RuleStatisticsVector& ruleStatistics);
+  /// Applies the rules to graph until none of them applies, starting from
+  /// the nodes in log; the rules are detached from log afterwards
+  static void reduce(GraphStruct& graph,
+                     const RuleMatrix& rules,
+                     const NodeSet& rootNodes,
+                     ChangeLogType& log,
+                     double& LB,
+                     RuleStatisticsVector& ruleStatistics,
+                     bool verbose);
+  /// Reduces every connected component with more than one node on its own,
+  /// on up to getThreads() threads, and puts the results back into the graph;
+  /// returns false (and does nothing) if there are fewer than two of them
+  bool preprocessComponents(double& LB);
+  /// Reduces the components handed out by next, with clones of the rules
+  void preprocessComponentWorker(const NodeMatrix& components,
+                                 const IntNodeMap& index,
+                                 std::atomic<size_t>& next,
+                                 int nRuleThreads,
+                                 GraphStructVector& result,
+                                 DoubleVector& resultLB,
+                                 RuleStatisticsVector& ruleStatistics) const;
+
+  static void denseNodes(const Graph& g,
+                         IntNodeMap& index,
+                         NodeVector& nodes);
+  static void writeEdges(const Graph& g,
+                         const IntNodeMap& index,
+                         SnapshotWriter& writer);
+  void writeLabels(bool orig,
+                   const NodeVector& nodes,
+                   SnapshotWriter& writer) const;
+  static void writeOrgNodeSets(const ProvenanceForestType& provenance,
+                               const NodeVector& nodes,
+                               const IntNodeMap& orgIndex,
+                               SnapshotWriter& writer);
 };
 
 template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
@@ -537,6 +757,12 @@ inline MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::MwcsPreprocessedGraph()
   , _pGraph(NULL)
   , _pBackupGraph(NULL)
   , _rules()
+  , _nThreads(1)
+  , _ruleStatistics()
+  , _preprocessingTime(0)
+  , _pLabelSource(NULL)
+  , _pLabelSourceNode(NULL)
+  , _modified(true)
 {
   addPreprocessRule(1, new NegDeg01Type());
   addPreprocessRule(1, new PosEdgeType());
@@ -569,18 +795,47 @@ inline MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::~MwcsPreprocessedGraph()
 }
 
 template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
-inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::preprocess(const NodeSet& rootNodes)
+inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::initRuleStatistics(const RuleMatrix& rules,
+                                                                              RuleStatisticsVector& ruleStatistics)
 {
-  DegreeNodeMap degree(*_pGraph->_pG);
-  DegreeNodeSetVector degreeVector;
-  NodeSetMap neighbors(*_pGraph->_pG);
-  
-  constructDegreeMap(degree, degreeVector);
-  constructNeighborMap(neighbors);
+  ruleStatistics.clear();
+  for (size_t phase = 0; phase < rules.size(); ++phase)
+  {
+    for (RuleVectorIt ruleIt = rules[phase].begin(); ruleIt != rules[phase].end(); ruleIt++)
+    {
+      ruleStatistics.push_back(RuleStatistics((*ruleIt)->name(), static_cast<int>(phase) + 1));
+    }
+  }
+}
 
-  // determine max score
-  double LB = std::max((*_pGraph->_pScore)[lemon::mapMax(*_pGraph->_pG, *_pGraph->_pScore)], 0.);
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::reduce(GraphStruct& graph,
+                                                                  const RuleMatrix& rules,
+                                                                  const NodeSet& rootNodes,
+                                                                  ChangeLogType& log,
+                                                                  double& LB,
+                                                                  RuleStatisticsVector& ruleStatistics,
+                                                                  bool verbose)
+{
+  Graph& g = *graph._pG;
+
+  DegreeNodeMap degree(g);
+  DegreeNodeBuckets degreeBuckets;
+  NodeSetMap neighbors(g);
   
+  constructDegreeMap(g, degree, degreeBuckets);
+  constructNeighborMap(g, neighbors);
+
+  std::vector<size_t> ruleOffset(rules.size(), 0);
+  for (size_t phase = 0; phase < rules.size(); ++phase)
+  {
+    ruleOffset[phase] = phase == 0 ? 0 : ruleOffset[phase - 1] + rules[phase - 1].size();
+    for (RuleVectorIt ruleIt = rules[phase].begin(); ruleIt != rules[phase].end(); ruleIt++)
+    {
+      (*ruleIt)->init(&log);
+    }
+  }
+
   // now let's preprocess the graph
   // in phases: first do phase 0 until no more change
   // then move on to phase 1 upon change fallback to phase 0
@@ -589,27 +844,36 @@ inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::preprocess(const Node
   do
   {
     uberTotRemovedNodes = 0;
-    for (size_t phase = 0; phase < _rules.size(); ++phase)
+    for (size_t phase = 0; phase < rules.size(); ++phase)
     {
       int totRemovedNodes;
       do
       {
         totRemovedNodes = 0;
-        for (RuleVectorIt ruleIt = _rules[phase].begin(); ruleIt != _rules[phase].end(); ruleIt++)
+        for (RuleVectorIt ruleIt = rules[phase].begin(); ruleIt != rules[phase].end(); ruleIt++)
         {
-          int removedNodes = (*ruleIt)->apply(*_pGraph->_pG, rootNodes,
-                                              *_pGraph->_pLabel,
-                                              *_pGraph->_pScore, *_pGraph->_pMapToPre,
-                                              *_pGraph->_pPreOrigNodes, neighbors,
-                                              _pGraph->_nNodes, _pGraph->_nArcs, _pGraph->_nEdges,
-                                              degree, degreeVector, LB);
+          RuleStatistics& stats = ruleStatistics[ruleOffset[phase] + (ruleIt - rules[phase].begin())];
+          lemon::Timer ruleTimer;
+          int removedNodes = (*ruleIt)->apply(g, rootNodes,
+                                              *graph._pLabel,
+                                              *graph._pScore, *graph._pProvenance,
+                                              neighbors,
+                                              graph._nNodes, graph._nArcs, graph._nEdges,
+                                              degree, degreeBuckets, LB);
+          stats._time += ruleTimer.realTime();
+          ++stats._nInvocations;
+          if (removedNodes > 0)
+          {
+            ++stats._nEffective;
+            stats._nRemovedNodes += removedNodes;
+          }
           
-          assert(lemon::countNodes(*_pGraph->_pG) == _pGraph->_nNodes);
-          assert(lemon::countEdges(*_pGraph->_pG) == _pGraph->_nEdges);
+          assert(lemon::countNodes(g) == graph._nNodes);
+          assert(lemon::countEdges(g) == graph._nEdges);
           
           totRemovedNodes += removedNodes;
 
-          if (g_verbosity >= VERBOSE_DEBUG && removedNodes > 0)
+          if (verbose && g_verbosity >= VERBOSE_DEBUG && removedNodes > 0)
           {
             std::cout << "// Phase " << phase + 1
                       << ": applied rule '" << (*ruleIt)->name()
@@ -627,18 +891,426 @@ inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::preprocess(const Node
     }
   } while (uberTotRemovedNodes > 0);
 
+  for (size_t phase = 0; phase < rules.size(); ++phase)
+  {
+    for (RuleVectorIt ruleIt = rules[phase].begin(); ruleIt != rules[phase].end(); ruleIt++)
+    {
+      (*ruleIt)->init(NULL);
+    }
+  }
+
+#ifdef DEBUG
+  // the worklist must reach the fixpoint of a full scan: detached rules
+  // examine all nodes, and none of them may apply anymore
+  double fullScanLB = LB;
+  for (size_t phase = 0; phase < rules.size(); ++phase)
+  {
+    for (RuleVectorIt ruleIt = rules[phase].begin(); ruleIt != rules[phase].end(); ruleIt++)
+    {
+      int removedNodes = (*ruleIt)->apply(g, rootNodes,
+                                          *graph._pLabel,
+                                          *graph._pScore, *graph._pProvenance,
+                                          neighbors,
+                                          graph._nNodes, graph._nArcs, graph._nEdges,
+                                          degree, degreeBuckets, fullScanLB);
+      if (removedNodes > 0)
+      {
+        std::cerr << "Error: rule '" << (*ruleIt)->name()
+                  << "' removed " << removedNodes
+                  << " node(s) after the worklist reached its fixpoint" << std::endl;
+      }
+      assert(removedNodes == 0);
+    }
+  }
+#endif
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::preprocessComponentWorker(const NodeMatrix& components,
+                                                                                     const IntNodeMap& index,
+                                                                                     std::atomic<size_t>& next,
+                                                                                     int nRuleThreads,
+                                                                                     GraphStructVector& result,
+                                                                                     DoubleVector& resultLB,
+                                                                                     RuleStatisticsVector& ruleStatistics) const
+{
+  const Graph& g = *_pGraph->_pG;
+  const NodeSet rootNodes;
+
+  // every worker has rules of its own
+  RuleMatrix rules(_rules.size());
+  for (size_t phase = 0; phase < _rules.size(); ++phase)
+  {
+    for (RuleVectorIt ruleIt = _rules[phase].begin(); ruleIt != _rules[phase].end(); ruleIt++)
+    {
+      RuleType* pRule = (*ruleIt)->clone();
+      pRule->setThreads(nRuleThreads);
+      rules[phase].push_back(pRule);
+    }
+  }
+
+  for (size_t i = next++; i < components.size(); i = next++)
+  {
+    const NodeVector& nodes = components[i];
+    const int n = static_cast<int>(nodes.size());
+
+    // copy the component, its original nodes are the nodes of g
+    GraphStruct* pComp = new GraphStruct();
+    Graph& compG = *pComp->_pG;
+    compG.reserveNode(n);
+
+    NodeVector compNodes(n);
+    for (int j = 0; j < n; ++j)
+    {
+      Node v = compNodes[j] = compG.addNode();
+      (*pComp->_pScore)[v] = (*_pGraph->_pScore)[nodes[j]];
+      (*pComp->_pLabel)[v] = (*_pGraph->_pLabel)[nodes[j]];
+      pComp->_pProvenance->add(nodes[j], v);
+    }
+    for (int j = 0; j < n; ++j)
+    {
+      for (IncEdgeIt e(g, nodes[j]); e != lemon::INVALID; ++e)
+      {
+        const int k = index[g.oppositeNode(nodes[j], e)];
+        if (j < k)
+        {
+          compG.addEdge(compNodes[j], compNodes[k]);
+          ++pComp->_nEdges;
+        }
+      }
+    }
+    pComp->_nNodes = n;
+    pComp->_nArcs = 2 * pComp->_nEdges;
+
+    ChangeLogType log;
+    for (int j = 0; j < n; ++j)
+    {
+      log.mark(compNodes[j]);
+    }
+    reduce(*pComp, rules, rootNodes, log, resultLB[i], ruleStatistics, false);
+
+    result[i] = pComp;
+  }
+
+  for (size_t phase = 0; phase < rules.size(); ++phase)
+  {
+    for (RuleVectorIt ruleIt = rules[phase].begin(); ruleIt != rules[phase].end(); ruleIt++)
+    {
+      delete *ruleIt;
+    }
+  }
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline bool MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::preprocessComponents(double& LB)
+{
+  Graph& g = *_pGraph->_pG;
+
+  IntNodeMap comp(g);
+  const int nComponents = lemon::connectedComponents(g, comp);
+
+  NodeMatrix allComponents(nComponents);
+  for (NodeIt v(g); v != lemon::INVALID; ++v)
+  {
+    allComponents[comp[v]].push_back(v);
+  }
+
+  // isolated nodes are left to the subsequent pass over the whole graph,
+  // the largest components are handed out first
+  NodeMatrix components;
+  for (int i = 0; i < nComponents; ++i)
+  {
+    if (allComponents[i].size() > 1)
+    {
+      components.push_back(NodeVector());
+      components.back().swap(allComponents[i]);
+    }
+  }
+  if (components.size() < 2)
+    return false;
+
+  std::sort(components.begin(), components.end(), SizeGreater());
+
+  IntNodeMap index(g, -1);
+  for (size_t i = 0; i < components.size(); ++i)
+  {
+    for (size_t j = 0; j < components[i].size(); ++j)
+    {
+      index[components[i][j]] = static_cast<int>(j);
+    }
+  }
+
+  const int nWorkers = std::min(_nThreads, static_cast<int>(components.size()));
+  const int nRuleThreads = std::max(1, _nThreads / nWorkers);
+
+  if (g_verbosity >= VERBOSE_DEBUG)
+  {
+    std::cout << "// Preprocessing " << components.size()
+              << " component(s) on " << nWorkers << " thread(s)" << std::endl;
+  }
+
+  GraphStructVector result(components.size(), NULL);
+  DoubleVector resultLB(components.size(), LB);
+  std::vector<RuleStatisticsVector> ruleStatistics(nWorkers);
+  for (int t = 0; t < nWorkers; ++t)
+  {
+    initRuleStatistics(_rules, ruleStatistics[t]);
+  }
+
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nWorkers; ++t)
+  {
+    threads.push_back(std::thread(&MwcsPreprocessedGraph::preprocessComponentWorker, this,
+                                  std::cref(components), std::cref(index), std::ref(next),
+                                  nRuleThreads, std::ref(result), std::ref(resultLB),
+                                  std::ref(ruleStatistics[t])));
+  }
+  for (int t = 0; t < nWorkers; ++t)
+  {
+    threads[t].join();
+  }
+
+  for (int t = 0; t < nWorkers; ++t)
+  {
+    for (size_t i = 0; i < _ruleStatistics.size(); ++i)
+    {
+      RuleStatistics& stats = _ruleStatistics[i];
+      const RuleStatistics& workerStats = ruleStatistics[t][i];
+      stats._nInvocations += workerStats._nInvocations;
+      stats._nEffective += workerStats._nEffective;
+      stats._nRemovedNodes += workerStats._nRemovedNodes;
+      stats._time += workerStats._time;
+    }
+  }
+
+  // stitch the reduced components back into g, the provenance is rebuilt
+  // with respect to the original nodes of the nodes of the components
+  const ProvenanceForestType& oldProvenance = *_pGraph->_pProvenance;
+  ProvenanceForestType* pProvenance = new ProvenanceForestType();
+  pProvenance->reserve(getOrgNodeCount());
+
+  for (NodeIt v(g); v != lemon::INVALID; ++v)
+  {
+    if (index[v] == -1)
+    {
+      for (OrgNodeIt orgNodeIt(oldProvenance, v); orgNodeIt != lemon::INVALID; ++orgNodeIt)
+      {
+        pProvenance->add(orgNodeIt, v);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < components.size(); ++i)
+  {
+    GraphStruct* pComp = result[i];
+    const Graph& compG = *pComp->_pG;
+    WeightNodeMap& compScore = *pComp->_pScore;
+    LabelNodeMap& compLabel = *pComp->_pLabel;
+
+    for (size_t j = 0; j < components[i].size(); ++j)
+    {
+      g.erase(components[i][j]);
+    }
+    _pGraph->_nNodes += pComp->_nNodes - static_cast<int>(components[i].size());
+
+    NodeMap compToG(compG);
+    for (NodeIt c(compG); c != lemon::INVALID; ++c)
+    {
+      Node v = compToG[c] = g.addNode();
+      (*_pGraph->_pScore)[v] = compScore[c];
+      std::swap((*_pGraph->_pLabel)[v], compLabel[c]);
+
+      for (OrgNodeIt nodeIt(*pComp->_pProvenance, c); nodeIt != lemon::INVALID; ++nodeIt)
+      {
+        for (OrgNodeIt orgNodeIt(oldProvenance, nodeIt); orgNodeIt != lemon::INVALID; ++orgNodeIt)
+        {
+          pProvenance->add(orgNodeIt, v);
+        }
+      }
+    }
+    for (EdgeIt e(compG); e != lemon::INVALID; ++e)
+    {
+      g.addEdge(compToG[compG.u(e)], compToG[compG.v(e)]);
+    }
+
+    LB = std::max(LB, resultLB[i]);
+    delete pComp;
+  }
+
+  delete _pGraph->_pProvenance;
+  _pGraph->_pProvenance = pProvenance;
+  _pGraph->_nEdges = lemon::countEdges(g);
+  _pGraph->_nArcs = 2 * _pGraph->_nEdges;
+
+  assert(lemon::countNodes(g) == _pGraph->_nNodes);
+  return true;
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::preprocess(const NodeSet& rootNodes)
+{
+  lemon::Timer timer;
+
+  initRuleStatistics(_rules, _ruleStatistics);
+
+  // determine max score
+  double LB = std::max((*_pGraph->_pScore)[lemon::mapMax(*_pGraph->_pG, *_pGraph->_pScore)], 0.);
+
+  const int nNodes = _pGraph->_nNodes;
+  const int nEdges = _pGraph->_nEdges;
+
+  ChangeLogType log;
+  if (_nThreads > 1 && rootNodes.empty() && preprocessComponents(LB))
+  {
+    // the components have been rebuilt and reduced with their own LB,
+    // only isolated nodes may be affected by the LB of the other components
+    _modified = true;
+    for (NodeIt v(*_pGraph->_pG); v != lemon::INVALID; ++v)
+    {
+      if (IncEdgeIt(*_pGraph->_pG, v) == lemon::INVALID)
+        log.mark(v);
+    }
+  }
+  else
+  {
+    // initially all nodes need to be examined by all rules
+    for (NodeIt v(*_pGraph->_pG); v != lemon::INVALID; ++v)
+    {
+      log.mark(v);
+    }
+  }
+
+  reduce(*_pGraph, _rules, rootNodes, log, LB, _ruleStatistics, true);
+  _modified = _modified || _pGraph->_nNodes != nNodes || _pGraph->_nEdges != nEdges;
+
   // determine the connected components
   updateComponentMap();
 
+  _preprocessingTime = timer.realTime();
+
+  if (g_verbosity >= VERBOSE_DEBUG)
+  {
+    for (size_t i = 0; i < _ruleStatistics.size(); ++i)
+    {
+      const RuleStatistics& stats = _ruleStatistics[i];
+      std::cout << "// Phase " << stats._phase
+                << ": rule '" << stats._name
+                << "' invoked " << stats._nInvocations
+                << " time(s), " << stats._nEffective
+                << " effective, removed " << stats._nRemovedNodes
+                << " node(s) in " << stats._time << " s" << std::endl;
+    }
+  }
+
   if (g_verbosity >= VERBOSE_ESSENTIAL)
   {
-    std::cout << "// Preprocessing successfully applied"
+    std::cout << "// Preprocessing successfully applied in "
+              << _preprocessingTime << " s"
               << ": " << _pGraph->_nNodes << " nodes, "
               << _pGraph->_nEdges << " edges and "
               << _pGraph->_nComponents << " component(s) remaining" << std::endl;
   }
 }
 
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::compact(NodeSet& nodes)
+{
+  typedef typename WeightNodeMap::Value Weight;
+  typedef typename LabelNodeMap::Value Label;
+  typedef std::pair<int, int> IntPair;
+
+  Graph& g = *_pGraph->_pG;
+  LabelNodeMap& label = *_pGraph->_pLabel;
+  WeightNodeMap& score = *_pGraph->_pScore;
+
+  // breadth-first order
+  NodeVector order;
+  order.reserve(_pGraph->_nNodes);
+  IntNodeMap index(g, -1);
+  for (NodeIt s(g); s != lemon::INVALID; ++s)
+  {
+    if (index[s] != -1)
+      continue;
+
+    size_t head = order.size();
+    index[s] = static_cast<int>(order.size());
+    order.push_back(s);
+    while (head < order.size())
+    {
+      Node v = order[head++];
+      for (IncEdgeIt e(g, v); e != lemon::INVALID; ++e)
+      {
+        Node w = g.oppositeNode(v, e);
+        if (index[w] == -1)
+        {
+          index[w] = static_cast<int>(order.size());
+          order.push_back(w);
+        }
+      }
+    }
+  }
+
+  // save nodes and edges in terms of their new indices
+  const int n = static_cast<int>(order.size());
+  std::vector<Weight> scores(n);
+  std::vector<Label> labels(n);
+  std::vector<int> oldIds(n);
+  std::vector<IntPair> edges;
+  edges.reserve(_pGraph->_nEdges);
+  for (int i = 0; i < n; ++i)
+  {
+    Node v = order[i];
+    scores[i] = score[v];
+    std::swap(labels[i], label[v]);
+    oldIds[i] = g.id(v);
+    for (IncEdgeIt e(g, v); e != lemon::INVALID; ++e)
+    {
+      int j = index[g.oppositeNode(v, e)];
+      if (i < j)
+        edges.push_back(IntPair(i, j));
+    }
+  }
+
+  std::vector<int> nodeIndices;
+  for (NodeSetIt nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt)
+  {
+    nodeIndices.push_back(index[*nodeIt]);
+  }
+
+  // rebuild the graph, which keeps its maps
+  std::vector<int> newId(g.maxNodeId() + 1, -1);
+  g.clear();
+  g.reserveNode(n);
+  g.reserveEdge(static_cast<int>(edges.size()));
+
+  NodeVector newNodes(n);
+  for (int i = 0; i < n; ++i)
+  {
+    Node v = newNodes[i] = g.addNode();
+    score[v] = scores[i];
+    std::swap(label[v], labels[i]);
+    newId[oldIds[i]] = g.id(v);
+  }
+  for (size_t i = 0; i < edges.size(); ++i)
+  {
+    g.addEdge(newNodes[edges[i].first], newNodes[edges[i].second]);
+  }
+
+  _pGraph->_pProvenance->renumber(newId);
+  _modified = true;
+
+  nodes.clear();
+  for (size_t i = 0; i < nodeIndices.size(); ++i)
+  {
+    nodes.insert(newNodes[nodeIndices[i]]);
+  }
+
+  assert(lemon::countNodes(g) == _pGraph->_nNodes);
+  assert(lemon::countEdges(g) == _pGraph->_nEdges);
+  updateComponentMap();
+}
+
 template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
 inline bool MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::init(ParserType* pParser, bool pval)
 {
@@ -646,6 +1318,7 @@ inline bool MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::init(ParserType* pPar
     return false;
 
   // start by making a copy of the graph
+  _modified = true;
   clear();
 
   return true;
@@ -661,18 +1334,31 @@ inline bool MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::init(Graph* pG,
     return false;
 
   // start by making a copy of the graph
+  _modified = true;
   clear();
 
   return true;
 }
 
 template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
-inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::constructNeighborMap(NodeSetMap& neighbors) const
+inline bool MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::init(Graph* pG,
+                                                                WeightNodeMap* pScore,
+                                                                const MwcsGraphType& labelSource,
+                                                                const NodeMap& labelSourceNode)
+{
+  _pLabelSource = &labelSource;
+  _pLabelSourceNode = &labelSourceNode;
+
+  return init(pG, NULL, pScore, NULL);
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::constructNeighborMap(const Graph& g,
+                                                                                NodeSetMap& neighbors)
 {
-  const Graph& g = *_pGraph->_pG;
   for (NodeIt n(g); n != lemon::INVALID; ++n)
   {
-    NodeSet& neighborSet = neighbors[n];
+    CompactNodeSetType& neighborSet = neighbors[n];
     neighborSet.clear();
     for (IncEdgeIt e(g, n); e != lemon::INVALID; ++e)
     {
@@ -683,25 +1369,296 @@ inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::constructNeighborMap(
   
 template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
 inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::constructDegreeMap(
+    const Graph& g,
     DegreeNodeMap& degree,
-    DegreeNodeSetVector& degreeVector) const
+    DegreeNodeBuckets& degreeBuckets)
 {
-  for (NodeIt n(*_pGraph->_pG); n != lemon::INVALID; ++n)
+  degreeBuckets.clear();
+  degreeBuckets.reserve(g.maxNodeId());
+  for (NodeIt n(g); n != lemon::INVALID; ++n)
   {
     int d = 0;
-    for (IncEdgeIt e(*_pGraph->_pG, n); e != lemon::INVALID; ++e, d++) ;
+    for (IncEdgeIt e(g, n); e != lemon::INVALID; ++e, d++) ;
 
     degree[n] = d;
-    if (degreeVector.size() <= static_cast<size_t>(d))
+    degreeBuckets.insert(n, d);
+  }
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::denseNodes(const Graph& g,
+                                                                      IntNodeMap& index,
+                                                                      NodeVector& nodes)
+{
+  // in id order, such that loading reproduces the ids of a graph without holes
+  nodes.clear();
+  for (int i = 0; i <= g.maxNodeId(); ++i)
+  {
+    Node v = g.nodeFromId(i);
+    if (g.valid(v))
+    {
+      index[v] = static_cast<int>(nodes.size());
+      nodes.push_back(v);
+    }
+  }
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::writeEdges(const Graph& g,
+                                                                      const IntNodeMap& index,
+                                                                      SnapshotWriter& writer)
+{
+  std::vector<int32_t> endpoints;
+  for (int i = 0; i <= g.maxEdgeId(); ++i)
+  {
+    Edge e = g.edgeFromId(i);
+    if (g.valid(e))
     {
-      // add node sets to degreeVector
-      int len = d - degreeVector.size() + 1;
-      for (int i = 0; i < len; i++)
-        degreeVector.push_back(NodeSet());
+      endpoints.push_back(index[g.u(e)]);
+      endpoints.push_back(index[g.v(e)]);
     }
+  }
+  writer.write(endpoints);
+}
 
-    degreeVector[d].insert(n);
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::writeLabels(bool orig,
+                                                                       const NodeVector& nodes,
+                                                                       SnapshotWriter& writer) const
+{
+  // original labels may have to be resolved (see resolveOrgLabel())
+  std::vector<uint64_t> offsets(1, 0);
+  std::string chars;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    chars += orig ? getOrgLabel(nodes[i]) : (*_pGraph->_pLabel)[nodes[i]];
+    offsets.push_back(chars.size());
   }
+  writer.write(offsets);
+  writer.write(chars.data(), chars.size());
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::writeOrgNodeSets(const ProvenanceForestType& provenance,
+                                                                            const NodeVector& nodes,
+                                                                            const IntNodeMap& orgIndex,
+                                                                            SnapshotWriter& writer)
+{
+  // the sets are materialized one at a time; the preprocessed nodes of
+  // the original nodes are not stored, readSnapshot() derives them
+  std::vector<uint64_t> offsets(1, 0);
+  std::vector<int32_t> elements;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    NodeSet nodeSet;
+    provenance.getOrgNodes(nodes[i], nodeSet);
+
+    for (NodeSetIt nodeIt = nodeSet.begin(); nodeIt != nodeSet.end(); ++nodeIt)
+    {
+      elements.push_back(orgIndex[*nodeIt]);
+    }
+    offsets.push_back(elements.size());
+  }
+  writer.write(offsets);
+  writer.write(elements);
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline bool MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::writeSnapshot(const std::string& filename,
+                                                                         uint64_t key,
+                                                                         const SnapshotInfo& info) const
+{
+  const Graph& orgG = getOrgGraph();
+  const Graph& g = *_pGraph->_pG;
+  const WeightNodeMap* pPVal = getOrgPValues();
+
+  IntNodeMap orgIndex(orgG, -1);
+  NodeVector orgNodes;
+  denseNodes(orgG, orgIndex, orgNodes);
+
+  IntNodeMap index(g, -1);
+  NodeVector nodes;
+  denseNodes(g, index, nodes);
+
+  SnapshotWriter writer;
+  Snapshot::initHeader(writer.header(), key);
+  writer.header()._flags = pPVal ? Snapshot::HAS_PVALUES : 0;
+  writer.header()._nOrgNodes = static_cast<int32_t>(orgNodes.size());
+  writer.header()._nOrgEdges = lemon::countEdges(orgG);
+  writer.header()._nNodes = static_cast<int32_t>(nodes.size());
+  writer.header()._nEdges = lemon::countEdges(g);
+  writer.header()._nRootNodes = static_cast<int32_t>(info._rootNodes.size());
+  writer.header()._nameLength = static_cast<int32_t>(info._name.size());
+  writer.header()._totalNodeProfit = info._totalNodeProfit;
+
+  writer.write(info._name.data(), info._name.size());
+  writer.write(info._rootNodes);
+
+  // original graph
+  std::vector<double> weights(orgNodes.size());
+  for (size_t i = 0; i < orgNodes.size(); ++i)
+    weights[i] = getOrgScore(orgNodes[i]);
+  writer.write(weights);
+  if (pPVal)
+  {
+    for (size_t i = 0; i < orgNodes.size(); ++i)
+      weights[i] = (*pPVal)[orgNodes[i]];
+    writer.write(weights);
+  }
+  writeLabels(true, orgNodes, writer);
+  writeEdges(orgG, orgIndex, writer);
+
+  // preprocessed graph and its provenance
+  weights.resize(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i)
+    weights[i] = (*_pGraph->_pScore)[nodes[i]];
+  writer.write(weights);
+  writeLabels(false, nodes, writer);
+  writeEdges(g, index, writer);
+  writeOrgNodeSets(*_pGraph->_pProvenance, nodes, orgIndex, writer);
+
+  if (!writer.save(filename))
+  {
+    std::cerr << "Error: could not write snapshot '" << filename << "'" << std::endl;
+    return false;
+  }
+
+  if (g_verbosity >= VERBOSE_NON_ESSENTIAL)
+  {
+    std::cout << "// Wrote snapshot '" << filename << "'" << std::endl;
+  }
+
+  return true;
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline bool MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::readSnapshot(const std::string& filename,
+                                                                        uint64_t key,
+                                                                        SnapshotInfo& info)
+{
+  SnapshotReader reader;
+  if (!reader.open(filename, key))
+  {
+    return false;
+  }
+
+  const Snapshot::Header& header = reader.header();
+  const int nOrgNodes = header._nOrgNodes;
+  const int nOrgEdges = header._nOrgEdges;
+  const int nNodes = header._nNodes;
+  const int nEdges = header._nEdges;
+
+  // map all arrays and validate them before touching any state
+  const char* pName = reader.read<char>(header._nameLength);
+  const int32_t* pRootNodes = reader.read<int32_t>(header._nRootNodes);
+
+  const double* pOrgScore = reader.read<double>(nOrgNodes);
+  const double* pOrgPVal = header._flags & Snapshot::HAS_PVALUES ?
+    reader.read<double>(nOrgNodes) : NULL;
+  const uint64_t* pOrgLabelOffsets = reader.read<uint64_t>(nOrgNodes + 1);
+  const char* pOrgLabels = SnapshotReader::validOffsets(pOrgLabelOffsets, nOrgNodes) ?
+    reader.read<char>(pOrgLabelOffsets[nOrgNodes]) : NULL;
+  const int32_t* pOrgEdges = reader.read<int32_t>(2 * static_cast<size_t>(nOrgEdges));
+
+  const double* pScore = reader.read<double>(nNodes);
+  const uint64_t* pLabelOffsets = reader.read<uint64_t>(nNodes + 1);
+  const char* pLabels = SnapshotReader::validOffsets(pLabelOffsets, nNodes) ?
+    reader.read<char>(pLabelOffsets[nNodes]) : NULL;
+  const int32_t* pEdges = reader.read<int32_t>(2 * static_cast<size_t>(nEdges));
+
+  const uint64_t* pPreOrigOffsets = reader.read<uint64_t>(nNodes + 1);
+  const int32_t* pPreOrig = SnapshotReader::validOffsets(pPreOrigOffsets, nNodes) ?
+    reader.read<int32_t>(pPreOrigOffsets[nNodes]) : NULL;
+
+  if (!reader.good() || !pOrgLabels || !pLabels || !pPreOrig
+      || !SnapshotReader::validIndices(pRootNodes, header._nRootNodes, nOrgNodes)
+      || !SnapshotReader::validIndices(pOrgEdges, 2 * static_cast<size_t>(nOrgEdges), nOrgNodes)
+      || !SnapshotReader::validIndices(pEdges, 2 * static_cast<size_t>(nEdges), nNodes)
+      || !SnapshotReader::validIndices(pPreOrig, pPreOrigOffsets[nNodes], nOrgNodes))
+  {
+    std::cerr << "Error: snapshot '" << filename << "' is corrupt" << std::endl;
+    return false;
+  }
+
+  // original graph
+  delete _pGraph;
+  _pGraph = NULL;
+  initOrgMembers();
+
+  Graph& orgG = getOrgGraph();
+  LabelNodeMap& orgLabel = getOrgLabels();
+  WeightNodeMap& orgScore = getOrgScores();
+  WeightNodeMap* pOrgPValMap = getOrgPValues();
+
+  NodeVector orgNodes(nOrgNodes);
+  orgG.reserveNode(nOrgNodes);
+  orgG.reserveEdge(nOrgEdges);
+  for (int i = 0; i < nOrgNodes; ++i)
+  {
+    Node v = orgNodes[i] = orgG.addNode();
+    orgScore[v] = pOrgScore[i];
+    if (pOrgPVal && pOrgPValMap)
+      (*pOrgPValMap)[v] = pOrgPVal[i];
+    orgLabel[v].assign(pOrgLabels + pOrgLabelOffsets[i], pOrgLabels + pOrgLabelOffsets[i + 1]);
+  }
+  for (int i = 0; i < nOrgEdges; ++i)
+  {
+    orgG.addEdge(orgNodes[pOrgEdges[2 * i]], orgNodes[pOrgEdges[2 * i + 1]]);
+  }
+  updateOrgMembers();
+
+  // preprocessed graph
+  Graph& g = *_pGraph->_pG;
+  LabelNodeMap& label = *_pGraph->_pLabel;
+  WeightNodeMap& score = *_pGraph->_pScore;
+  ProvenanceForestType& provenance = *_pGraph->_pProvenance;
+
+  NodeVector nodes(nNodes);
+  g.reserveNode(nNodes);
+  g.reserveEdge(nEdges);
+  for (int i = 0; i < nNodes; ++i)
+  {
+    Node v = nodes[i] = g.addNode();
+    score[v] = pScore[i];
+    label[v].assign(pLabels + pLabelOffsets[i], pLabels + pLabelOffsets[i + 1]);
+  }
+  for (int i = 0; i < nEdges; ++i)
+  {
+    g.addEdge(nodes[pEdges[2 * i]], nodes[pEdges[2 * i + 1]]);
+  }
+
+  // the preprocessed nodes of every original node follow from
+  // the original nodes of the preprocessed nodes
+  provenance.clear();
+  provenance.reserve(static_cast<int>(pPreOrigOffsets[nNodes]));
+  for (int i = 0; i < nNodes; ++i)
+  {
+    for (uint64_t j = pPreOrigOffsets[i]; j < pPreOrigOffsets[i + 1]; ++j)
+      provenance.add(orgNodes[pPreOrig[j]], nodes[i]);
+  }
+
+  _pGraph->_nNodes = nNodes;
+  _pGraph->_nEdges = nEdges;
+  _pGraph->_nArcs = 2 * nEdges;
+  updateComponentMap();
+  _modified = true;
+
+  info._name.assign(pName, pName + header._nameLength);
+  info._totalNodeProfit = header._totalNodeProfit;
+  info._rootNodes.assign(pRootNodes, pRootNodes + header._nRootNodes);
+
+  if (g_verbosity >= VERBOSE_ESSENTIAL)
+  {
+    std::cout << "// Loaded snapshot '" << filename
+              << "': contains " << getOrgNodeCount() << " nodes, "
+              << getOrgEdgeCount() << " edges and "
+              << getOrgComponentCount() << " component(s); "
+              << _pGraph->_nNodes << " nodes, "
+              << _pGraph->_nEdges << " edges and "
+              << _pGraph->_nComponents << " component(s) after preprocessing" << std::endl;
+  }
+
+  return true;
 }
 
 template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
@@ -710,6 +1667,7 @@ inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::computeScores(double
                                                                          double FDR)
 {
   Parent::computeScores(lambda, a, FDR);
+  _modified = true;
   clear();
 }
 
@@ -717,6 +1675,7 @@ template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
 inline void MwcsPreprocessedGraph<GR, NWGHT, NLBL, EWGHT>::computeScores(double tau)
 {
   Parent::computeScores(tau);
+  _modified = true;
   clear();
 }
 
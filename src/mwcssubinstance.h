@@ -0,0 +1,238 @@
+/*
+ * mwcssubinstance.h
+ *
+ *  Created on: 17-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef MWCSSUBINSTANCE_H
+#define MWCSSUBINSTANCE_H
+
+#include <assert.h>
+#include <algorithm>
+#include <vector>
+#include <lemon/core.h>
+#include "mwcsgraph.h"
+#include "mwcspreprocessedgraph.h"
+
+namespace nina {
+namespace mwcs {
+
+/// Node-induced subinstance of a parent instance, as a view
+///
+/// The nodes of the subinstance are numbered densely from 0 in the order
+/// in which they are given, and the subinstance has its own copy of their
+/// scores. The parent graph is not copied: edges are enumerated through
+/// the parent and a node of the parent belongs to the subinstance if its
+/// local index refers back to it. Hence (re)initializing takes time linear
+/// in the size of the subinstance, not of the parent, and a single object
+/// can be reused for all components or blocks of the parent.
+///
+/// Only a subinstance that is going to be preprocessed or solved needs to
+/// be materialized into a graph, see materialize().
+template<typename GR,
+         typename NWGHT = typename GR::template NodeMap<double>,
+         typename NLBL = typename GR::template NodeMap<std::string>,
+         typename EWGHT = typename GR::template EdgeMap<double> >
+class MwcsSubInstance
+{
+public:
+  typedef GR Graph;
+  typedef NWGHT WeightNodeMap;
+  typedef NLBL LabelNodeMap;
+  typedef EWGHT WeightEdgeMap;
+
+  typedef MwcsGraph<Graph, WeightNodeMap, LabelNodeMap, WeightEdgeMap> MwcsGraphType;
+  typedef MwcsPreprocessedGraph<Graph, WeightNodeMap, LabelNodeMap, WeightEdgeMap> MwcsPreGraphType;
+  typedef typename MwcsGraphType::NodeSet NodeSet;
+  typedef typename MwcsGraphType::NodeSetIt NodeSetIt;
+  typedef typename Graph::template NodeMap<typename Graph::Node> NodeMap;
+
+  TEMPLATE_GRAPH_TYPEDEFS(Graph);
+
+  typedef std::vector<Node> NodeVector;
+  typedef std::vector<double> DoubleVector;
+
+  MwcsSubInstance(const MwcsGraphType& parent)
+    : _parent(parent)
+    , _index(parent.getGraph(), -1)
+    , _nodes()
+    , _score()
+    , _nEdges(0)
+  {
+  }
+
+  /// Restricts the subinstance to the given nodes of the parent
+  void init(const NodeVector& nodes)
+  {
+    _nodes = nodes;
+    init();
+  }
+
+  /// Restricts the subinstance to the given nodes of the parent
+  void init(const NodeSet& nodes)
+  {
+    _nodes.assign(nodes.begin(), nodes.end());
+    init();
+  }
+
+  const MwcsGraphType& getParent() const
+  {
+    return _parent;
+  }
+
+  int getNodeCount() const
+  {
+    return static_cast<int>(_nodes.size());
+  }
+
+  int getEdgeCount() const
+  {
+    return _nEdges;
+  }
+
+  /// Node of the parent with local index i
+  Node getNode(int i) const
+  {
+    assert(0 <= i && i < getNodeCount());
+    return _nodes[i];
+  }
+
+  const NodeVector& getNodes() const
+  {
+    return _nodes;
+  }
+
+  /// Local index of node v of the parent, -1 if v is not in the subinstance
+  int getIndex(Node v) const
+  {
+    const int i = _index[v];
+    return 0 <= i && i < getNodeCount() && _nodes[i] == v ? i : -1;
+  }
+
+  bool contains(Node v) const
+  {
+    return getIndex(v) != -1;
+  }
+
+  double getScore(int i) const
+  {
+    assert(0 <= i && i < getNodeCount());
+    return _score[i];
+  }
+
+  void setScore(int i, double score)
+  {
+    assert(0 <= i && i < getNodeCount());
+    _score[i] = score;
+  }
+
+  /// Minimum node score, 0 if there are no nodes
+  double getMinScore() const
+  {
+    return _score.empty() ? 0 : *std::min_element(_score.begin(), _score.end());
+  }
+
+  /// Maximum node score, 0 if there are no nodes
+  double getMaxScore() const
+  {
+    return _score.empty() ? 0 : *std::max_element(_score.begin(), _score.end());
+  }
+
+  /// Copies the subinstance into subG and initializes mwcsSubGraph on it
+  ///
+  /// The nodes of subG are added in the order of their local indices.
+  /// Labels are not copied, mwcsSubGraph resolves them through the parent.
+  void materialize(Graph& subG,
+                   DoubleNodeMap& weightSubG,
+                   NodeMap& mapToG,
+                   MwcsPreGraphType& mwcsSubGraph) const
+  {
+    copy(subG, weightSubG, mapToG, NULL);
+    mwcsSubGraph.init(&subG, &weightSubG, _parent, mapToG);
+  }
+
+  /// Same as above, in addition mapToSubG maps the nodes of the subinstance
+  /// to the nodes of subG; mapToSubG is a node map of the parent graph
+  void materialize(Graph& subG,
+                   DoubleNodeMap& weightSubG,
+                   NodeMap& mapToG,
+                   NodeMap& mapToSubG,
+                   MwcsPreGraphType& mwcsSubGraph) const
+  {
+    copy(subG, weightSubG, mapToG, &mapToSubG);
+    mwcsSubGraph.init(&subG, &weightSubG, _parent, mapToG);
+  }
+
+private:
+  const MwcsGraphType& _parent;
+  /// Local index of every node of the parent, only meaningful for the
+  /// nodes of the subinstance, see getIndex()
+  IntNodeMap _index;
+  /// Node of the parent of every local index
+  NodeVector _nodes;
+  /// Score of every local index
+  DoubleVector _score;
+  int _nEdges;
+
+  void init()
+  {
+    const Graph& g = _parent.getGraph();
+    const int n = getNodeCount();
+
+    _score.resize(n);
+    for (int i = 0; i < n; ++i)
+    {
+      _index[_nodes[i]] = i;
+      _score[i] = _parent.getScore(_nodes[i]);
+    }
+
+    _nEdges = 0;
+    for (int i = 0; i < n; ++i)
+    {
+      for (IncEdgeIt e(g, _nodes[i]); e != lemon::INVALID; ++e)
+      {
+        if (i < getIndex(g.oppositeNode(_nodes[i], e)))
+          ++_nEdges;
+      }
+    }
+  }
+
+  void copy(Graph& subG,
+            DoubleNodeMap& weightSubG,
+            NodeMap& mapToG,
+            NodeMap* pMapToSubG) const
+  {
+    const Graph& g = _parent.getGraph();
+    const int n = getNodeCount();
+
+    subG.clear();
+    subG.reserveNode(n);
+    subG.reserveEdge(_nEdges);
+
+    NodeVector subNodes(n);
+    for (int i = 0; i < n; ++i)
+    {
+      Node v = subNodes[i] = subG.addNode();
+      weightSubG[v] = _score[i];
+      mapToG[v] = _nodes[i];
+      if (pMapToSubG)
+        (*pMapToSubG)[_nodes[i]] = v;
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+      for (IncEdgeIt e(g, _nodes[i]); e != lemon::INVALID; ++e)
+      {
+        const int j = getIndex(g.oppositeNode(_nodes[i], e));
+        if (i < j)
+          subG.addEdge(subNodes[i], subNodes[j]);
+      }
+    }
+  }
+};
+
+} // namespace mwcs
+} // namespace nina
+
+#endif // MWCSSUBINSTANCE_H
@@ -0,0 +1,455 @@
+/*
+ * compressedfile.h
+ *
+ *  Created on: 16-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef COMPRESSEDFILE_H
+#define COMPRESSEDFILE_H
+
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <streambuf>
+#include <zlib.h>
+#ifdef HEINZ_ZSTD
+#include <zstd.h>
+#endif
+
+namespace nina {
+
+/// Sequential reader that decompresses gzip (and, if available, zstd)
+/// files on the fly; other files are read as is.
+///
+/// The format is detected from the magic bytes, not from the extension.
+class CompressedFile
+{
+public:
+  enum Format
+  {
+    PLAIN,
+    GZIP,
+    ZSTD
+  };
+
+  CompressedFile()
+    : _format(PLAIN)
+    , _fd(-1)
+    , _gzFile(NULL)
+#ifdef HEINZ_ZSTD
+    , _pZstd(NULL)
+    , _zstdIn()
+    , _zstdInPos(0)
+    , _zstdInSize(0)
+    , _zstdEof(false)
+    , _zstdHint(0)
+#endif
+    , _error(false)
+  {
+  }
+
+  ~CompressedFile()
+  {
+    close();
+  }
+
+  /// Returns the format of filename, PLAIN if it cannot be read
+  static Format format(const std::string& filename)
+  {
+    unsigned char magic[4] = { 0, 0, 0, 0 };
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+      return PLAIN;
+    ssize_t n = ::read(fd, magic, sizeof(magic));
+    ::close(fd);
+
+    if (n >= 2 && magic[0] == 0x1f && magic[1] == 0x8b)
+      return GZIP;
+    if (n == 4 && magic[0] == 0x28 && magic[1] == 0xb5
+        && magic[2] == 0x2f && magic[3] == 0xfd)
+      return ZSTD;
+    return PLAIN;
+  }
+
+  static bool isCompressed(const std::string& filename)
+  {
+    return format(filename) != PLAIN;
+  }
+
+  bool open(const std::string& filename)
+  {
+    close();
+
+    _format = format(filename);
+    _fd = ::open(filename.c_str(), O_RDONLY);
+    if (_fd == -1)
+      return false;
+
+    switch (_format)
+    {
+      case PLAIN:
+        return true;
+      case GZIP:
+        _gzFile = gzdopen(_fd, "rb");
+        if (!_gzFile)
+        {
+          close();
+          return false;
+        }
+        // the descriptor is owned by _gzFile from here on
+        _fd = -1;
+        gzbuffer(_gzFile, BLOCK_SIZE);
+        return true;
+      case ZSTD:
+#ifdef HEINZ_ZSTD
+        _pZstd = ZSTD_createDStream();
+        if (!_pZstd || ZSTD_isError(ZSTD_initDStream(_pZstd)))
+        {
+          close();
+          return false;
+        }
+        _zstdIn.resize(ZSTD_DStreamInSize());
+        _zstdHint = 1;
+        return true;
+#else
+        std::cerr << "Error: " << filename
+                  << " is zstd compressed, but heinz was built without zstd support"
+                  << std::endl;
+        close();
+        return false;
+#endif
+    }
+
+    return false;
+  }
+
+  void close()
+  {
+    if (_gzFile)
+    {
+      gzclose(_gzFile);
+      _gzFile = NULL;
+    }
+    if (_fd != -1)
+    {
+      ::close(_fd);
+      _fd = -1;
+    }
+#ifdef HEINZ_ZSTD
+    if (_pZstd)
+    {
+      ZSTD_freeDStream(_pZstd);
+      _pZstd = NULL;
+    }
+    _zstdIn.clear();
+    _zstdInPos = _zstdInSize = 0;
+    _zstdEof = false;
+    _zstdHint = 0;
+#endif
+    _error = false;
+  }
+
+  /// Reads at most n decompressed bytes into pBuf
+  ///
+  /// Returns the number of bytes read, 0 at end-of-file or on error.
+  size_t read(char* pBuf, size_t n)
+  {
+    if (_error || n == 0)
+      return 0;
+
+    switch (_format)
+    {
+      case PLAIN:
+        return readPlain(pBuf, n);
+      case GZIP:
+        return readGzip(pBuf, n);
+      case ZSTD:
+#ifdef HEINZ_ZSTD
+        return readZstd(pBuf, n);
+#else
+        break;
+#endif
+    }
+
+    _error = true;
+    return 0;
+  }
+
+  /// Whether reading or decompressing failed
+  bool error() const
+  {
+    return _error;
+  }
+
+  Format getFormat() const
+  {
+    return _format;
+  }
+
+  /// Size of the blocks in which input is decompressed
+  static const size_t BLOCK_SIZE = 1 << 18;
+
+private:
+  Format _format;
+  int _fd;
+  gzFile _gzFile;
+#ifdef HEINZ_ZSTD
+  ZSTD_DStream* _pZstd;
+  std::vector<char> _zstdIn;
+  size_t _zstdInPos;
+  size_t _zstdInSize;
+  bool _zstdEof;
+  /// Last return value of ZSTD_decompressStream, 0 at the end of a frame
+  size_t _zstdHint;
+#endif
+  bool _error;
+
+  CompressedFile(const CompressedFile&);
+  CompressedFile& operator=(const CompressedFile&);
+
+  size_t readPlain(char* pBuf, size_t n)
+  {
+    ssize_t res;
+    do
+    {
+      res = ::read(_fd, pBuf, n);
+    } while (res < 0 && errno == EINTR);
+
+    if (res < 0)
+    {
+      _error = true;
+      return 0;
+    }
+    return static_cast<size_t>(res);
+  }
+
+  size_t readGzip(char* pBuf, size_t n)
+  {
+    // gzread takes an unsigned count
+    unsigned int m = n > (1u << 30) ? (1u << 30) : static_cast<unsigned int>(n);
+    int res = gzread(_gzFile, pBuf, m);
+    if (res < 0)
+    {
+      _error = true;
+      return 0;
+    }
+    if (res == 0)
+    {
+      // a truncated stream ends without error from gzread
+      int errnum = Z_OK;
+      gzerror(_gzFile, &errnum);
+      if (errnum != Z_OK && errnum != Z_STREAM_END)
+        _error = true;
+    }
+    return static_cast<size_t>(res);
+  }
+
+#ifdef HEINZ_ZSTD
+  size_t readZstd(char* pBuf, size_t n)
+  {
+    ZSTD_outBuffer out = { pBuf, n, 0 };
+    while (out.pos == 0)
+    {
+      if (_zstdInPos == _zstdInSize && !_zstdEof)
+      {
+        _zstdInSize = readPlain(&_zstdIn.front(), _zstdIn.size());
+        _zstdInPos = 0;
+        if (_error)
+          return 0;
+        _zstdEof = _zstdInSize == 0;
+      }
+
+      // the last frame has been decoded and flushed completely
+      if (_zstdEof && _zstdInPos == _zstdInSize && _zstdHint == 0)
+        return 0;
+
+      // with no input left, this flushes what the decoder still holds
+      ZSTD_inBuffer in = { &_zstdIn.front(), _zstdInSize, _zstdInPos };
+      _zstdHint = ZSTD_decompressStream(_pZstd, &out, &in);
+      _zstdInPos = in.pos;
+      if (ZSTD_isError(_zstdHint))
+      {
+        _error = true;
+        return 0;
+      }
+
+      if (out.pos == 0 && _zstdEof && _zstdInPos == _zstdInSize && _zstdHint != 0)
+      {
+        // input ended in the middle of a frame
+        _error = true;
+        return 0;
+      }
+    }
+    return out.pos;
+  }
+#endif
+};
+
+/// Input stream over a (possibly compressed) file
+///
+/// Decompresses in blocks of CompressedFile::BLOCK_SIZE bytes as the
+/// stream is consumed.
+class CompressedInputStream : public std::istream
+{
+public:
+  explicit CompressedInputStream(const std::string& filename)
+    : std::istream(NULL)
+    , _buf()
+  {
+    init(&_buf);
+    if (!_buf.open(filename))
+      setstate(std::ios::failbit);
+  }
+
+  /// Whether reading or decompressing failed
+  bool error() const
+  {
+    return _buf.error();
+  }
+
+private:
+  class Buffer : public std::streambuf
+  {
+  public:
+    Buffer()
+      : _file()
+      , _block(CompressedFile::BLOCK_SIZE)
+    {
+      setg(&_block.front(), &_block.front(), &_block.front());
+    }
+
+    bool open(const std::string& filename)
+    {
+      return _file.open(filename);
+    }
+
+    bool error() const
+    {
+      return _file.error();
+    }
+
+  protected:
+    int_type underflow()
+    {
+      if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+
+      size_t n = _file.read(&_block.front(), _block.size());
+      if (n == 0)
+        return traits_type::eof();
+
+      setg(&_block.front(), &_block.front(), &_block.front() + n);
+      return traits_type::to_int_type(*gptr());
+    }
+
+  private:
+    CompressedFile _file;
+    std::vector<char> _block;
+  };
+
+  Buffer _buf;
+};
+
+/// Reads a (possibly compressed) file as a sequence of blocks
+/// that each consist of whole lines
+///
+/// Line endings are LF, CR or CRLF; a block never ends between the CR and
+/// the LF of a CRLF. Only the final block may lack a line ending. Lines
+/// longer than the block size make the block grow.
+class LineBlockReader
+{
+public:
+  LineBlockReader()
+    : _file()
+    , _block(CompressedFile::BLOCK_SIZE)
+    , _size(0)
+    , _next(0)
+    , _eof(false)
+  {
+  }
+
+  bool open(const std::string& filename)
+  {
+    _size = _next = 0;
+    _eof = false;
+    return _file.open(filename);
+  }
+
+  /// Returns the next block in [begin, end), false at end-of-file
+  ///
+  /// The block remains valid until the next call.
+  bool nextBlock(const char*& begin, const char*& end)
+  {
+    // keep the partial line at the end of the previous block
+    if (_next > 0)
+    {
+      memmove(&_block.front(), &_block.front() + _next, _size - _next);
+      _size -= _next;
+      _next = 0;
+    }
+
+    size_t scanned = 0;
+    for (;;)
+    {
+      size_t cut = findCut(scanned);
+      if (cut > 0 || (_eof && _size > 0))
+      {
+        _next = cut > 0 ? cut : _size;
+        begin = &_block.front();
+        end = begin + _next;
+        return true;
+      }
+      if (_eof)
+        return false;
+
+      if (_size == _block.size())
+        _block.resize(2 * _block.size());
+
+      // a CR at the very end may still be followed by an LF
+      scanned = _size > 0 ? _size - 1 : 0;
+      size_t n = _file.read(&_block.front() + _size, _block.size() - _size);
+      _size += n;
+      _eof = n == 0;
+    }
+  }
+
+  /// Whether reading or decompressing failed
+  bool error() const
+  {
+    return _file.error();
+  }
+
+private:
+  CompressedFile _file;
+  std::vector<char> _block;
+  /// Number of valid bytes in _block
+  size_t _size;
+  /// Start of the bytes that have not been handed out yet
+  size_t _next;
+  bool _eof;
+
+  /// Returns the position after the last complete line ending
+  /// in [from, _size), 0 if there is none
+  size_t findCut(size_t from) const
+  {
+    for (size_t i = _size; i > from; --i)
+    {
+      char c = _block[i - 1];
+      if (c == '\n')
+        return i;
+      if (c == '\r' && (i < _size || _eof))
+        return i;
+    }
+    return 0;
+  }
+};
+
+} // namespace nina
+
+#endif // COMPRESSEDFILE_H
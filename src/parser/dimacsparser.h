@@ -15,6 +15,7 @@
 #include <limits>
 #include <lemon/core.h>
 #include "parser.h"
+#include "compressedfile.h"
 #include "utils.h"
 
 namespace nina {
@@ -62,14 +63,31 @@ public:
   {
     return _name;
   }
+
+  /// Whether the run section reports a primal objective value
+  bool hasPrimal() const
+  {
+    return _hasPrimal;
+  }
+
+  /// Primal objective value reported in the run section
+  double getPrimal() const
+  {
+    return _primal;
+  }
   
 protected:
   std::string _name;
+  bool _hasPrimal;
+  double _primal;
 };
 
 template<typename GR>
 inline DimacsParser<GR>::DimacsParser(const std::string& filename)
   : Parent(filename)
+  , _name()
+  , _hasPrimal(false)
+  , _primal(0)
 {
 }
 
@@ -148,9 +166,17 @@ inline bool DimacsParser<GR>::parseGraph(std::istream& in, int& lineNumber)
   }
   _name = line.substr(5);
 
-  // skip until "SECTION Finalsolution"
+  // skip until "SECTION Finalsolution", picking up the primal value
+  _hasPrimal = false;
   while (safeGetline(in, line) && line != "SECTION Finalsolution")
+  {
     lineNumber++;
+    if (line.substr(0, 7) == "Primal ")
+    {
+      std::stringstream ss(line.substr(7));
+      _hasPrimal = static_cast<bool>(ss >> _primal);
+    }
+  }
 
   if (line != "SECTION Finalsolution")
   {
@@ -221,9 +247,9 @@ inline bool DimacsParser<GR>::parseNode(std::istream& in, int& lineNumber)
     Node u = _pG->addNode();
     _pWeightNodeMap->set(u, 0);
     
-    snprintf(buf, 1024, "%d", idU);
+    int len = snprintf(buf, 1024, "%d", idU);
     _pIdNodeMap->set(u, buf);
-    (*_pInvIdNodeMap)[buf] = u;
+    _pInvIdNodeMap->set(buf, buf + len, u);
 
     return true;
   }
@@ -255,8 +281,8 @@ inline bool DimacsParser<GR>::parseEdge(std::istream& in, int& lineNumber)
     std::string idU, idV ;
     ss >> idU >> idV;
 
-    Node u = (*_pInvIdNodeMap)[idU];
-    Node v = (*_pInvIdNodeMap)[idV];
+    Node u = _pInvIdNodeMap->get(idU, lemon::INVALID);
+    Node v = _pInvIdNodeMap->get(idV, lemon::INVALID);
     
     if (u == lemon::INVALID)
     {
@@ -286,7 +312,7 @@ inline bool DimacsParser<GR>::parse()
   if (!_pG)
     return false;
 
-  std::ifstream in(_filename.c_str());
+  CompressedInputStream in(_filename);
   if (!in.good())
   {
     std::cerr << "Error: could not open file "
@@ -297,7 +323,13 @@ inline bool DimacsParser<GR>::parse()
   _pG->clear();
 
   int lineNumber = 0;
-  return parseGraph(in, lineNumber);
+  bool res = parseGraph(in, lineNumber);
+  if (in.error())
+  {
+    std::cerr << "Error: could not decompress file " << _filename << std::endl;
+    return false;
+  }
+  return res;
 }
 
 } // namespace mwcs
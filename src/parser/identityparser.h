@@ -134,7 +134,7 @@ inline bool IdentityParser<GR>::parse()
     {
       for (NodeIt n(*_pG); n != lemon::INVALID; ++n)
       {
-        (*_pInvIdNodeMap)[(*_pIdNodeMap)[n]] = n;
+        _pInvIdNodeMap->set((*_pIdNodeMap)[n], n);
       }
     }
     else
@@ -148,7 +148,7 @@ inline bool IdentityParser<GR>::parse()
         std::string str(buf);
 
         _pIdNodeMap->set(n, str);
-        (*_pInvIdNodeMap)[str] = n;
+        _pInvIdNodeMap->set(str, n);
       }
     }
   }
@@ -0,0 +1,230 @@
+/*
+ * labelmap.h
+ *
+ *  Created on: 16-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef LABELMAP_H
+#define LABELMAP_H
+
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace nina {
+
+/// Interned label to value map
+///
+/// Labels are stored back to back in a single character arena and are
+/// identified by small integer ids (in order of insertion). Lookups go
+/// through an open-addressing hash table with linear probing.
+template<typename T>
+class LabelMap
+{
+public:
+  typedef T Value;
+
+  LabelMap()
+    : _arena()
+    , _entries()
+    , _values()
+    , _slots(16, -1)
+    , _mask(15)
+  {
+  }
+
+  void clear()
+  {
+    _arena.clear();
+    _entries.clear();
+    _values.clear();
+    _slots.assign(16, -1);
+    _mask = 15;
+  }
+
+  /// Reserves space for n labels with a total length of nChars
+  void reserve(int n, size_t nChars = 0)
+  {
+    _entries.reserve(n);
+    _values.reserve(n);
+    _arena.reserve(nChars);
+    if (2 * static_cast<size_t>(n) > _slots.size())
+    {
+      rehash(2 * static_cast<size_t>(n));
+    }
+  }
+
+  /// Number of labels
+  int size() const
+  {
+    return static_cast<int>(_entries.size());
+  }
+
+  bool empty() const
+  {
+    return _entries.empty();
+  }
+
+  /// Returns the id of the label [begin, end), -1 if absent
+  int find(const char* begin, const char* end) const
+  {
+    uint32_t h = hash(begin, end);
+    return _slots[probe(begin, end, h)];
+  }
+
+  /// Returns the id of label, -1 if absent
+  int find(const std::string& label) const
+  {
+    return find(label.data(), label.data() + label.size());
+  }
+
+  /// Returns the id of the label [begin, end); if absent the label is
+  /// interned with the given value
+  int insert(const char* begin, const char* end, const T& value)
+  {
+    uint32_t h = hash(begin, end);
+    size_t slot = probe(begin, end, h);
+    if (_slots[slot] != -1)
+    {
+      return _slots[slot];
+    }
+
+    int id = static_cast<int>(_entries.size());
+    Entry entry;
+    entry._offset = _arena.size();
+    entry._length = static_cast<uint32_t>(end - begin);
+    entry._hash = h;
+    _arena.insert(_arena.end(), begin, end);
+    _entries.push_back(entry);
+    _values.push_back(value);
+    _slots[slot] = id;
+
+    // keep the load factor at most 1/2
+    if (2 * _entries.size() > _slots.size())
+    {
+      rehash(2 * _slots.size());
+    }
+
+    return id;
+  }
+
+  int insert(const std::string& label, const T& value)
+  {
+    return insert(label.data(), label.data() + label.size(), value);
+  }
+
+  /// Sets the value of the label [begin, end), interning it if absent;
+  /// returns its id
+  int set(const char* begin, const char* end, const T& value)
+  {
+    int id = insert(begin, end, value);
+    _values[id] = value;
+    return id;
+  }
+
+  int set(const std::string& label, const T& value)
+  {
+    return set(label.data(), label.data() + label.size(), value);
+  }
+
+  /// Returns the value of label, defaultValue if absent
+  T get(const std::string& label, const T& defaultValue) const
+  {
+    int id = find(label);
+    return id == -1 ? defaultValue : _values[id];
+  }
+
+  const T& value(int id) const
+  {
+    assert(0 <= id && id < size());
+    return _values[id];
+  }
+
+  T& value(int id)
+  {
+    assert(0 <= id && id < size());
+    return _values[id];
+  }
+
+  /// Returns the label with the given id
+  std::string label(int id) const
+  {
+    assert(0 <= id && id < size());
+    const Entry& entry = _entries[id];
+    return std::string(_arena.begin() + entry._offset,
+                       _arena.begin() + entry._offset + entry._length);
+  }
+
+private:
+  struct Entry
+  {
+    size_t _offset;
+    uint32_t _length;
+    uint32_t _hash;
+  };
+
+  /// Label characters, back to back
+  std::vector<char> _arena;
+  /// Arena location and hash of every label, indexed by id
+  std::vector<Entry> _entries;
+  /// Value of every label, indexed by id
+  std::vector<T> _values;
+  /// Hash table of ids, -1 denotes an empty slot
+  std::vector<int> _slots;
+  size_t _mask;
+
+  static uint32_t hash(const char* begin, const char* end)
+  {
+    // 64-bit FNV-1a, folded to 32 bits
+    uint64_t h = 14695981039346656037ULL;
+    for (const char* p = begin; p != end; ++p)
+    {
+      h ^= static_cast<unsigned char>(*p);
+      h *= 1099511628211ULL;
+    }
+    return static_cast<uint32_t>(h ^ (h >> 32));
+  }
+
+  /// Returns the slot of the label, or the empty slot where it would go
+  size_t probe(const char* begin, const char* end, uint32_t h) const
+  {
+    const size_t length = static_cast<size_t>(end - begin);
+    for (size_t slot = h & _mask;; slot = (slot + 1) & _mask)
+    {
+      int id = _slots[slot];
+      if (id == -1)
+        return slot;
+
+      const Entry& entry = _entries[id];
+      if (entry._hash == h && entry._length == length
+          && (length == 0 || memcmp(&_arena[entry._offset], begin, length) == 0))
+      {
+        return slot;
+      }
+    }
+  }
+
+  void rehash(size_t minSlots)
+  {
+    size_t nSlots = _slots.size();
+    while (nSlots < minSlots)
+      nSlots *= 2;
+
+    _slots.assign(nSlots, -1);
+    _mask = nSlots - 1;
+    for (size_t id = 0; id < _entries.size(); ++id)
+    {
+      size_t slot = _entries[id]._hash & _mask;
+      while (_slots[slot] != -1)
+        slot = (slot + 1) & _mask;
+      _slots[slot] = static_cast<int>(id);
+    }
+  }
+};
+
+} // namespace nina
+
+#endif // LABELMAP_H
@@ -0,0 +1,419 @@
+/*
+ * mappedfile.h
+ *
+ *  Created on: 16-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include "compressedfile.h"
+
+namespace nina {
+
+/// Read-only view of a file, memory mapped whenever possible.
+///
+/// Falls back to reading the file into a private buffer when it
+/// cannot be mapped (e.g. pipes or empty files).
+class MappedFile
+{
+public:
+  MappedFile()
+    : _pData(NULL)
+    , _size(0)
+    , _mapped(false)
+    , _buffer()
+  {
+  }
+
+  ~MappedFile()
+  {
+    close();
+  }
+
+  bool open(const std::string& filename)
+  {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+      return false;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+      void* p = mmap(NULL, static_cast<size_t>(st.st_size),
+                     PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p != MAP_FAILED)
+      {
+#ifdef MADV_SEQUENTIAL
+        madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+#endif
+        _pData = static_cast<const char*>(p);
+        _size = static_cast<size_t>(st.st_size);
+        _mapped = true;
+        ::close(fd);
+        return true;
+      }
+    }
+
+    // fall back to reading the whole file
+    char buf[65536];
+    ssize_t n;
+    while ((n = ::read(fd, buf, sizeof(buf))) > 0)
+    {
+      _buffer.insert(_buffer.end(), buf, buf + n);
+    }
+    ::close(fd);
+    if (n < 0)
+    {
+      _buffer.clear();
+      return false;
+    }
+
+    _pData = _buffer.empty() ? NULL : &_buffer.front();
+    _size = _buffer.size();
+    return true;
+  }
+
+  void close()
+  {
+    if (_mapped)
+    {
+      munmap(const_cast<char*>(_pData), _size);
+    }
+    _pData = NULL;
+    _size = 0;
+    _mapped = false;
+    _buffer.clear();
+  }
+
+  const char* begin() const
+  {
+    return _pData;
+  }
+
+  const char* end() const
+  {
+    return _pData + _size;
+  }
+
+  size_t size() const
+  {
+    return _size;
+  }
+
+  bool isMapped() const
+  {
+    return _mapped;
+  }
+
+private:
+  const char* _pData;
+  size_t _size;
+  bool _mapped;
+  std::vector<char> _buffer;
+
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+};
+
+/// Line-oriented tokenizer that works in place on a character range.
+///
+/// Line endings are handled as in Parser::safeGetline (LF, CR and CRLF).
+/// Tokens and numbers are scanned from the current line without copying;
+/// numbers are scanned the way operator>> would scan them, i.e. the longest
+/// valid prefix is consumed.
+class LineTokenizer
+{
+public:
+  LineTokenizer(const char* begin, const char* end)
+    : _pReader(NULL)
+    , _pNext(begin)
+    , _pEnd(end)
+    , _pLineBegin(begin)
+    , _pLineEnd(begin)
+    , _pPos(begin)
+  {
+  }
+
+  /// Tokenizes the blocks of reader as they are read; the current line
+  /// remains valid until the next call to nextLine()
+  LineTokenizer(LineBlockReader& reader)
+    : _pReader(&reader)
+    , _pNext(NULL)
+    , _pEnd(NULL)
+    , _pLineBegin(NULL)
+    , _pLineEnd(NULL)
+    , _pPos(NULL)
+  {
+  }
+
+  /// Advance to the next line, returns false at end-of-file
+  bool nextLine()
+  {
+    if (_pNext == NULL || _pNext == _pEnd)
+    {
+      // blocks consist of whole lines
+      if (!_pReader || !_pReader->nextBlock(_pNext, _pEnd))
+        return false;
+    }
+
+    const char* p = _pNext;
+    while (p != _pEnd && *p != '\n' && *p != '\r')
+      ++p;
+
+    _pLineBegin = _pPos = _pNext;
+    _pLineEnd = p;
+
+    if (p != _pEnd)
+    {
+      if (*p == '\r' && p + 1 != _pEnd && *(p + 1) == '\n')
+        ++p;
+      ++p;
+    }
+    _pNext = p;
+
+    return true;
+  }
+
+  const char* lineBegin() const
+  {
+    return _pLineBegin;
+  }
+
+  const char* lineEnd() const
+  {
+    return _pLineEnd;
+  }
+
+  size_t lineSize() const
+  {
+    return static_cast<size_t>(_pLineEnd - _pLineBegin);
+  }
+
+  /// Whether the current line equals str
+  bool lineEquals(const char* str) const
+  {
+    size_t n = strlen(str);
+    return lineSize() == n && memcmp(_pLineBegin, str, n) == 0;
+  }
+
+  /// Whether the current line starts with str
+  bool lineStartsWith(const char* str) const
+  {
+    size_t n = strlen(str);
+    return lineSize() >= n && memcmp(_pLineBegin, str, n) == 0;
+  }
+
+  /// Returns the current line starting at position pos
+  std::string lineSubstr(size_t pos) const
+  {
+    if (pos >= lineSize())
+      return std::string();
+    return std::string(_pLineBegin + pos, _pLineEnd);
+  }
+
+  /// Scan the next whitespace-delimited token of the current line
+  bool nextToken(const char*& tokenBegin, const char*& tokenEnd)
+  {
+    skipSpace();
+    if (_pPos == _pLineEnd)
+      return false;
+
+    tokenBegin = _pPos;
+    while (_pPos != _pLineEnd && !isSpace(*_pPos))
+      ++_pPos;
+    tokenEnd = _pPos;
+
+    return true;
+  }
+
+  /// Scan the next token of the current line and compare it to str
+  bool nextTokenEquals(const char* str)
+  {
+    const char* b = NULL;
+    const char* e = NULL;
+    return nextToken(b, e) && equals(b, e, str);
+  }
+
+  /// Whether the character range [b, e) equals str
+  static bool equals(const char* b, const char* e, const char* str)
+  {
+    size_t n = strlen(str);
+    return static_cast<size_t>(e - b) == n && memcmp(b, str, n) == 0;
+  }
+
+  /// Scan an integer from the current line
+  bool scanInt(int& value)
+  {
+    skipSpace();
+
+    const char* p = _pPos;
+    bool negative = false;
+    if (p != _pLineEnd && (*p == '-' || *p == '+'))
+    {
+      negative = *p == '-';
+      ++p;
+    }
+
+    if (p == _pLineEnd || !isDigit(*p))
+      return false;
+
+    int64_t v = 0;
+    const int64_t limit = negative ? static_cast<int64_t>(2147483648LL)
+                                   : static_cast<int64_t>(2147483647LL);
+    for (; p != _pLineEnd && isDigit(*p); ++p)
+    {
+      v = 10 * v + (*p - '0');
+      if (v > limit)
+        return false;
+    }
+
+    value = static_cast<int>(negative ? -v : v);
+    _pPos = p;
+    return true;
+  }
+
+  /// Scan a real number from the current line
+  ///
+  /// Decimal numbers with at most 15 significant digits and a small
+  /// exponent are converted exactly (a single correctly rounded IEEE
+  /// operation); anything else is handed to strtod.
+  bool scanDouble(double& value)
+  {
+    skipSpace();
+
+    const char* p = _pPos;
+    const char* start = p;
+    bool negative = false;
+    if (p != _pLineEnd && (*p == '-' || *p == '+'))
+    {
+      negative = *p == '-';
+      ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int nDigits = 0;
+    int nSeen = 0;
+    int exponent = 0;
+
+    for (; p != _pLineEnd && isDigit(*p); ++p, ++nSeen)
+    {
+      if (nDigits == 0 && *p == '0')
+        continue;
+      if (nDigits < 19)
+        mantissa = 10 * mantissa + static_cast<uint64_t>(*p - '0');
+      else
+        ++exponent;
+      ++nDigits;
+    }
+
+    if (p != _pLineEnd && *p == '.')
+    {
+      ++p;
+      for (; p != _pLineEnd && isDigit(*p); ++p, ++nSeen)
+      {
+        if (nDigits == 0 && *p == '0')
+        {
+          --exponent;
+          continue;
+        }
+        if (nDigits < 19)
+        {
+          mantissa = 10 * mantissa + static_cast<uint64_t>(*p - '0');
+          --exponent;
+        }
+        ++nDigits;
+      }
+    }
+
+    if (nSeen == 0)
+      return false;
+
+    if (p != _pLineEnd && (*p == 'e' || *p == 'E'))
+    {
+      const char* q = p + 1;
+      bool expNegative = false;
+      if (q != _pLineEnd && (*q == '-' || *q == '+'))
+      {
+        expNegative = *q == '-';
+        ++q;
+      }
+      if (q != _pLineEnd && isDigit(*q))
+      {
+        int e = 0;
+        for (; q != _pLineEnd && isDigit(*q); ++q)
+        {
+          if (e < 100000)
+            e = 10 * e + (*q - '0');
+        }
+        exponent += expNegative ? -e : e;
+        p = q;
+      }
+    }
+
+    if (nDigits <= 15 && -22 <= exponent && exponent <= 22)
+    {
+      static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+        1e21, 1e22
+      };
+
+      double d = static_cast<double>(mantissa);
+      if (exponent < 0)
+        d /= pow10[-exponent];
+      else
+        d *= pow10[exponent];
+      value = negative ? -d : d;
+    }
+    else
+    {
+      // slow path: only the scanned extent is handed to strtod
+      std::string buf(start, p);
+      value = strtod(buf.c_str(), NULL);
+    }
+
+    _pPos = p;
+    return true;
+  }
+
+private:
+  LineBlockReader* _pReader;
+  const char* _pNext;
+  const char* _pEnd;
+  const char* _pLineBegin;
+  const char* _pLineEnd;
+  const char* _pPos;
+
+  static bool isSpace(char c)
+  {
+    return c == ' ' || c == '\t' || c == '\v' || c == '\f';
+  }
+
+  static bool isDigit(char c)
+  {
+    return '0' <= c && c <= '9';
+  }
+
+  void skipSpace()
+  {
+    while (_pPos != _pLineEnd && isSpace(*_pPos))
+      ++_pPos;
+  }
+};
+
+} // namespace nina
+
+#endif // MAPPEDFILE_H
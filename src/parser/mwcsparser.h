@@ -10,10 +10,16 @@
 
 #include <assert.h>
 #include <string.h>
-#include <map>
+#include <stdint.h>
+#include <algorithm>
 #include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 #include <lemon/core.h>
 #include "parser.h"
+#include "mappedfile.h"
 #include "utils.h"
 
 namespace nina {
@@ -48,13 +54,78 @@ public:
   using Parent::_nEdges;
 
 private:
+  /// Edge line resolved to the label ids of its end points
+  struct ParsedEdge
+  {
+    int _lineNumber;
+    int _id1;
+    int _id2;
+  };
+
+  enum WarningType
+  {
+    TRAILING_CHARACTERS,
+    UNSPECIFIED_NODE,
+    SELF_LOOP
+  };
+
+  /// Warning issued while parsing the edge file
+  struct EdgeWarning
+  {
+    int _lineNumber;
+    WarningType _type;
+    std::string _label;
+  };
+
+  /// Result of parsing a range of lines of the edge file,
+  /// line numbers are relative to the start of the range
+  struct EdgeChunk
+  {
+    int _nLines;
+    std::vector<ParsedEdge> _edges;
+    std::vector<EdgeWarning> _warnings;
+    int _errorLine;
+    std::string _error;
+
+    EdgeChunk()
+      : _nLines(0)
+      , _edges()
+      , _warnings()
+      , _errorLine(-1)
+      , _error()
+    {
+    }
+  };
+
   const std::string _filenameEdges;
+  int _nThreads;
   bool parseNodes();
   bool parseEdges();
+  bool parseMappedEdges(std::vector<EdgeChunk>& chunks) const;
+  bool parseCompressedEdges(std::vector<EdgeChunk>& chunks) const;
+  void parseEdgeChunk(const char* begin,
+                      const char* end,
+                      EdgeChunk& chunk) const;
+  static void addWarning(EdgeChunk& chunk,
+                         WarningType type,
+                         const char* labelBegin = NULL,
+                         const char* labelEnd = NULL);
+  static void printWarning(const EdgeWarning& warning, int lineOffset);
 
 public:
   MwcsParser(const std::string &fNodes, const std::string &fEdges);
   bool parse();
+
+  int getThreads() const
+  {
+    return _nThreads;
+  }
+
+  /// Sets the number of threads used for parsing the edge file
+  void setThreads(int nThreads)
+  {
+    _nThreads = nThreads;
+  }
 };
 
 template<typename GR>
@@ -62,6 +133,7 @@ inline MwcsParser<GR>::MwcsParser(const std::string &fNodes,
                                   const std::string &fEdges)
   : Parent(fNodes)
   , _filenameEdges(fEdges)
+  , _nThreads(1)
 {
 }
 
@@ -81,7 +153,7 @@ inline bool MwcsParser<GR>::parseNodes()
 {
   assert(_pG);
 
-  std::ifstream inFile(_filename.c_str());
+  CompressedInputStream inFile(_filename);
   if (!inFile.good())
   {
     std::cerr << "Error: could not open file "
@@ -131,7 +203,7 @@ inline bool MwcsParser<GR>::parseNodes()
       }
     }
 
-    if (_pInvIdNodeMap->find(label) != _pInvIdNodeMap->end())
+    if (_pInvIdNodeMap->find(label) != -1)
     {
       if (g_verbosity >= VERBOSE_DEBUG)
       {
@@ -144,21 +216,129 @@ inline bool MwcsParser<GR>::parseNodes()
 
     if (_pIdNodeMap) _pIdNodeMap->set(x, label);
     if (_pWeightNodeMap) _pWeightNodeMap->set(x, score);
-    (*_pInvIdNodeMap)[label] = x;
+    _pInvIdNodeMap->insert(label, x);
 
     _nNodes++;
   }
 
+  if (inFile.error())
+  {
+    std::cerr << "Error: could not decompress file " << _filename << std::endl;
+    return false;
+  }
+
   return true;
 }
 
 template<typename GR>
-inline bool MwcsParser<GR>::parseEdges()
+inline void MwcsParser<GR>::addWarning(EdgeChunk& chunk,
+                                       WarningType type,
+                                       const char* labelBegin,
+                                       const char* labelEnd)
 {
-  assert(_pG);
+  EdgeWarning warning;
+  warning._lineNumber = chunk._nLines;
+  warning._type = type;
+  if (labelBegin)
+    warning._label.assign(labelBegin, labelEnd);
+  chunk._warnings.push_back(warning);
+}
 
-  std::ifstream inFile(_filenameEdges.c_str());
-  if (!inFile.good())
+template<typename GR>
+inline void MwcsParser<GR>::printWarning(const EdgeWarning& warning,
+                                         int lineOffset)
+{
+  const int lineNumber = lineOffset + warning._lineNumber;
+  switch (warning._type)
+  {
+    case TRAILING_CHARACTERS:
+      std::cout << "Warning: trailing characters at line "
+              << lineNumber << std::endl;
+      break;
+    case UNSPECIFIED_NODE:
+      std::cout << "Warning: node with label " << warning._label
+              << " at line " << lineNumber
+              << " not specified. The edge is skipped." << std::endl;
+      break;
+    case SELF_LOOP:
+      std::cout << "Warning: node with label " << warning._label
+              << " at line " << lineNumber
+              << " has a self-loop. The edge is skipped." << std::endl;
+      break;
+  }
+}
+
+template<typename GR>
+inline void MwcsParser<GR>::parseEdgeChunk(const char* begin,
+                                           const char* end,
+                                           EdgeChunk& chunk) const
+{
+  LineTokenizer in(begin, end);
+
+  while (in.nextLine())
+  {
+    ++chunk._nLines;
+    if (in.lineSize() == 0 || *in.lineBegin() == '#')
+      continue;
+
+    const char* label1Begin = NULL;
+    const char* label1End = NULL;
+    const char* label2Begin = NULL;
+    const char* label2End = NULL;
+    const char* trailBegin = NULL;
+    const char* trailEnd = NULL;
+
+    if (!in.nextToken(label1Begin, label1End) || label1End == in.lineEnd())
+    {
+      chunk._errorLine = chunk._nLines;
+      chunk._error = "first label is wrong";
+      return;
+    }
+    if (!in.nextToken(label2Begin, label2End))
+    {
+      chunk._errorLine = chunk._nLines;
+      chunk._error = "second label is wrong";
+      return;
+    }
+
+    if (in.nextToken(trailBegin, trailEnd))
+    {
+      addWarning(chunk, TRAILING_CHARACTERS);
+    }
+
+    int id1 = _pInvIdNodeMap->find(label1Begin, label1End);
+    if (id1 == -1)
+    {
+      addWarning(chunk, UNSPECIFIED_NODE, label1Begin, label1End);
+      continue;
+    }
+
+    int id2 = _pInvIdNodeMap->find(label2Begin, label2End);
+    if (id2 == -1)
+    {
+      addWarning(chunk, UNSPECIFIED_NODE, label2Begin, label2End);
+      continue;
+    }
+
+    if (id1 == id2)
+    {
+      addWarning(chunk, SELF_LOOP, label1Begin, label1End);
+      continue;
+    }
+
+    ParsedEdge edge;
+    edge._lineNumber = chunk._nLines;
+    edge._id1 = id1;
+    edge._id2 = id2;
+    chunk._edges.push_back(edge);
+  }
+}
+
+template<typename GR>
+inline bool MwcsParser<GR>::parseMappedEdges(std::vector<EdgeChunk>& chunks) const
+{
+  MappedFile file;
+  if (!file.open(_filenameEdges))
   {
     if (g_verbosity >= VERBOSE_ESSENTIAL)
     {
@@ -168,87 +348,161 @@ inline bool MwcsParser<GR>::parseEdges()
     return false;
   }
 
-  std::string line;
-
-  int lineNumber = 0;
+  // split the file at line boundaries, at least 1MB per chunk
+  const size_t minChunkSize = 1 << 20;
+  size_t nChunks = std::max<size_t>(1, std::min<size_t>(std::max(_nThreads, 1),
+                                                        file.size() / minChunkSize));
 
-  while (safeGetline(inFile, line))
+  std::vector<const char*> bounds(nChunks + 1, file.begin());
+  bounds[nChunks] = file.end();
+  for (size_t i = 1; i < nChunks; ++i)
   {
-    ++lineNumber;
-    if ((!line.empty() && line[0] == '#') || line.empty())
-      continue;
-
-    std::stringstream lineStream(line);
-
-    std::string label1, label2, trail;
+    const char* p = std::max(bounds[i - 1], file.begin() + i * (file.size() / nChunks));
+    while (p != file.end() && *p != '\n' && *p != '\r')
+      ++p;
+    if (p != file.end())
+    {
+      if (*p == '\r' && p + 1 != file.end() && *(p + 1) == '\n')
+        ++p;
+      ++p;
+    }
+    bounds[i] = p;
+  }
 
-    lineStream >> label1;
-    if (!lineStream.good())
+  // tokenize and resolve labels, the label map is only read from here on
+  chunks.resize(nChunks);
+  if (nChunks == 1)
+  {
+    parseEdgeChunk(bounds[0], bounds[1], chunks[0]);
+  }
+  else
+  {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < nChunks; ++i)
     {
-      if (g_verbosity >= VERBOSE_ESSENTIAL)
-      {
-        std::cout << "File error: first label is wrong at line " << lineNumber << std::endl;
-      }
-      return false;
+      threads.push_back(std::thread(&MwcsParser::parseEdgeChunk, this,
+                                    bounds[i], bounds[i + 1], std::ref(chunks[i])));
     }
-    lineStream >> label2;
-    if (lineStream.bad() || lineStream.fail())
+    for (size_t i = 0; i < nChunks; ++i)
     {
-      if (g_verbosity >= VERBOSE_ESSENTIAL)
-      {
-        std::cout << "File error: second label is wrong at line " << lineNumber << std::endl;
-      }
-      return false;
+      threads[i].join();
     }
+  }
+
+  return true;
+}
 
-    lineStream >> trail;
-    if (!trail.empty())
+template<typename GR>
+inline bool MwcsParser<GR>::parseCompressedEdges(std::vector<EdgeChunk>& chunks) const
+{
+  LineBlockReader reader;
+  if (!reader.open(_filenameEdges))
+  {
+    if (g_verbosity >= VERBOSE_ESSENTIAL)
     {
-      if (g_verbosity >= VERBOSE_DEBUG)
-      {
-        std::cout << "Warning: trailing characters at line "
-                << lineNumber << std::endl;
-      }
+      std::cerr << "Error: could not open file "
+              << _filenameEdges << " for reading" << std::endl;
     }
+    return false;
+  }
 
-    if (_pInvIdNodeMap->find(label1) == _pInvIdNodeMap->end())
+  // decompression is sequential, every block of lines becomes a chunk
+  const char* begin = NULL;
+  const char* end = NULL;
+  while (reader.nextBlock(begin, end))
+  {
+    chunks.push_back(EdgeChunk());
+    parseEdgeChunk(begin, end, chunks.back());
+    if (chunks.back()._errorLine != -1)
+      break;
+  }
+
+  if (reader.error())
+  {
+    if (g_verbosity >= VERBOSE_ESSENTIAL)
     {
-      if (g_verbosity >= VERBOSE_DEBUG)
+      std::cerr << "Error: could not decompress file " << _filenameEdges << std::endl;
+    }
+    return false;
+  }
+
+  return true;
+}
+
+template<typename GR>
+inline bool MwcsParser<GR>::parseEdges()
+{
+  assert(_pG);
+
+  std::vector<EdgeChunk> chunks;
+  if (CompressedFile::isCompressed(_filenameEdges))
+  {
+    if (!parseCompressedEdges(chunks))
+      return false;
+  }
+  else if (!parseMappedEdges(chunks))
+  {
+    return false;
+  }
+  const size_t nChunks = chunks.size();
+
+  // merge in file order, skipping duplicate and reversed edges
+  size_t nParsedEdges = 0;
+  for (size_t i = 0; i < nChunks; ++i)
+  {
+    nParsedEdges += chunks[i]._edges.size();
+  }
+
+  std::unordered_set<uint64_t> edgeSet;
+  edgeSet.reserve(nParsedEdges);
+
+  int lineOffset = 0;
+  for (size_t i = 0; i < nChunks; ++i)
+  {
+    const EdgeChunk& chunk = chunks[i];
+
+    if (g_verbosity >= VERBOSE_DEBUG)
+    {
+      for (size_t j = 0; j < chunk._warnings.size(); ++j)
       {
-        std::cout << "Warning: node with label " << label1
-                << " at line " << lineNumber
-                << " not specified. The edge is skipped." << std::endl;
+        printWarning(chunk._warnings[j], lineOffset);
       }
-      continue;
     }
 
-    if (_pInvIdNodeMap->find(label2) == _pInvIdNodeMap->end())
+    for (size_t j = 0; j < chunk._edges.size(); ++j)
     {
-      if (g_verbosity >= VERBOSE_DEBUG)
+      const ParsedEdge& edge = chunk._edges[j];
+      uint64_t key = (static_cast<uint64_t>(std::min(edge._id1, edge._id2)) << 32)
+          | static_cast<uint64_t>(std::max(edge._id1, edge._id2));
+
+      if (!edgeSet.insert(key).second)
       {
-        std::cout << "Warning: node with label " << label2
-                << " at line " << lineNumber
-                << " not specified. The edge is skipped." << std::endl;
+        if (g_verbosity >= VERBOSE_DEBUG)
+        {
+          std::cout << "Warning: duplicate edge ("
+                    << _pInvIdNodeMap->label(edge._id1) << ", "
+                    << _pInvIdNodeMap->label(edge._id2) << ") at line "
+                    << lineOffset + edge._lineNumber
+                    << ". The edge is skipped." << std::endl;
+        }
+        continue;
       }
-      continue;
-    }
 
-    Node node1 = (*_pInvIdNodeMap)[label1];
-    Node node2 = (*_pInvIdNodeMap)[label2];
+      _pG->addEdge(_pInvIdNodeMap->value(edge._id1), _pInvIdNodeMap->value(edge._id2));
+      _nEdges++;
+    }
 
-    if (node1 == node2)
+    if (chunk._errorLine != -1)
     {
-      if (g_verbosity >= VERBOSE_DEBUG)
+      if (g_verbosity >= VERBOSE_ESSENTIAL)
       {
-        std::cout << "Warning: node with label " << label1
-                << " at line " << lineNumber
-                << " has a self-loop. The edge is skipped." << std::endl;
+        std::cout << "File error: " << chunk._error << " at line "
+                  << lineOffset + chunk._errorLine << std::endl;
       }
-      continue;
+      return false;
     }
 
-    _pG->addEdge((*_pInvIdNodeMap)[label1], (*_pInvIdNodeMap)[label2]);
-    _nEdges++;
+    lineOffset += chunk._nLines;
   }
 
   return true;
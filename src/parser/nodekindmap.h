@@ -0,0 +1,142 @@
+/*
+ * nodekindmap.h
+ *
+ *  Created on: 16-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef NODEKINDMAP_H
+#define NODEKINDMAP_H
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace nina {
+
+/// Node kinds distinguished by the PCST bookkeeping
+enum NodeKind
+{
+  NODE_KIND_OTHER = 0,  ///< Label is not a DIMACS id
+  NODE_KIND_VERTEX = 1, ///< Original vertex
+  NODE_KIND_EDGE = 2    ///< Node subdividing an original edge
+};
+
+/// Node kinds and original DIMACS endpoint ids, indexed by node id
+///
+/// Kept as parallel arrays such that passes over the original graph
+/// (e.g. PCST objective re-evaluation) do not have to parse labels.
+/// For a vertex, u is its DIMACS id and v is -1;
+/// for a subdivided edge, u and v are the DIMACS ids of its endpoints.
+class NodeKindMap
+{
+public:
+  NodeKindMap()
+    : _kind()
+    , _u()
+    , _v()
+  {
+  }
+
+  void clear()
+  {
+    _kind.clear();
+    _u.clear();
+    _v.clear();
+  }
+
+  void reserve(int n)
+  {
+    _kind.reserve(n);
+    _u.reserve(n);
+    _v.reserve(n);
+  }
+
+  bool empty() const
+  {
+    return _kind.empty();
+  }
+
+  /// Number of node ids covered
+  int size() const
+  {
+    return static_cast<int>(_kind.size());
+  }
+
+  void set(int id, NodeKind kind, int u, int v = -1)
+  {
+    assert(0 <= id);
+    if (id >= size())
+    {
+      _kind.resize(id + 1, NODE_KIND_OTHER);
+      _u.resize(id + 1, -1);
+      _v.resize(id + 1, -1);
+    }
+    _kind[id] = static_cast<uint8_t>(kind);
+    _u[id] = u;
+    _v[id] = v;
+  }
+
+  /// Sets the kind of id by parsing label ("u" or "u--v")
+  void setFromLabel(int id, const std::string& label)
+  {
+    int u = -1, v = -1;
+    char c = '\0';
+    if (sscanf(label.c_str(), "%d--%d%c", &u, &v, &c) == 2)
+    {
+      set(id, NODE_KIND_EDGE, u, v);
+    }
+    else if (sscanf(label.c_str(), "%d%c", &u, &c) == 1)
+    {
+      set(id, NODE_KIND_VERTEX, u);
+    }
+    else
+    {
+      set(id, NODE_KIND_OTHER, -1);
+    }
+  }
+
+  NodeKind kind(int id) const
+  {
+    return id < size() ? static_cast<NodeKind>(_kind[id]) : NODE_KIND_OTHER;
+  }
+
+  bool isVertex(int id) const
+  {
+    return kind(id) == NODE_KIND_VERTEX;
+  }
+
+  bool isEdge(int id) const
+  {
+    return kind(id) == NODE_KIND_EDGE;
+  }
+
+  int u(int id) const
+  {
+    assert(id < size());
+    return _u[id];
+  }
+
+  int v(int id) const
+  {
+    assert(id < size());
+    return _v[id];
+  }
+
+  /// Raw kind array, indexed by node id
+  const std::vector<uint8_t>& kinds() const
+  {
+    return _kind;
+  }
+
+private:
+  std::vector<uint8_t> _kind;
+  std::vector<int> _u;
+  std::vector<int> _v;
+};
+
+} // namespace nina
+
+#endif // NODEKINDMAP_H
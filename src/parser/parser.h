@@ -15,6 +15,8 @@
 #include <string>
 #include <lemon/core.h>
 #include <fstream>
+#include "labelmap.h"
+#include "nodekindmap.h"
 
 namespace nina {
 
@@ -31,7 +33,7 @@ protected:
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
 
 public:
-  typedef std::map<std::string, typename Graph::Node> InvIdNodeMap;
+  typedef LabelMap<typename Graph::Node> InvIdNodeMap;
   typedef NLBL IdNodeMap;
   typedef NWGHT WeightNodeMap;
   typedef EWGHT WeightEdgeMap;
@@ -43,6 +45,7 @@ protected:
   WeightNodeMap* _pWeightNodeMap;
   WeightEdgeMap* _pWeightEdgeMap;
   InvIdNodeMap* _pInvIdNodeMap;
+  NodeKindMap* _pNodeKindMap;
   int _nNodes;
   int _nEdges;
   
@@ -56,6 +59,7 @@ public:
     , _pWeightNodeMap(NULL)
     , _pWeightEdgeMap(NULL)
     , _pInvIdNodeMap(NULL)
+    , _pNodeKindMap(NULL)
     , _nNodes(0)
     , _nEdges(0)
   {
@@ -153,6 +157,22 @@ public:
   {
     _pInvIdNodeMap = pInvIdNodeMap;
   }
+
+  const NodeKindMap* getNodeKindMap() const
+  {
+    return _pNodeKindMap;
+  }
+
+  NodeKindMap* getNodeKindMap()
+  {
+    return _pNodeKindMap;
+  }
+
+  /// Optional, parsers that know the kinds of their nodes fill it in
+  void setNodeKindMap(NodeKindMap* pNodeKindMap)
+  {
+    _pNodeKindMap = pNodeKindMap;
+  }
 };
 
 template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
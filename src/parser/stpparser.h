@@ -15,6 +15,7 @@
 #include <limits>
 #include <lemon/core.h>
 #include "parser.h"
+#include "mappedfile.h"
 #include "utils.h"
 
 namespace nina {
@@ -38,7 +39,6 @@ public:
   typedef typename Parent::WeightNodeMap WeightNodeMap;
   typedef typename Parent::WeightEdgeMap WeightEdgeMap;
 
-  using Parent::safeGetline;
   using Parent::_filename;
   using Parent::_pG;
   using Parent::_pIdNodeMap;
@@ -49,13 +49,13 @@ public:
   using Parent::_nEdges;
 
 private:
-  bool parseHeader(std::istream& in, int& lineNumber);
-  bool parseGraph(std::istream& in, int& lineNumber);
-  bool parseNrNodes(std::istream& in, int& lineNumber);
-  bool parseNrEdges(std::istream& in, int& lineNumber);
-  bool parseNrTerminals(std::istream& in, int& lineNumber);
-  bool parseEdge(std::istream& in, int& lineNumber);
-  bool parseTerminal(std::istream& in, int& lineNumber);
+  bool parseHeader(LineTokenizer& in, int& lineNumber);
+  bool parseGraph(LineTokenizer& in, int& lineNumber);
+  bool parseNrNodes(LineTokenizer& in, int& lineNumber);
+  bool parseNrEdges(LineTokenizer& in, int& lineNumber);
+  bool parseNrTerminals(LineTokenizer& in, int& lineNumber);
+  bool parseEdge(LineTokenizer& in, int& lineNumber);
+  bool parseTerminal(LineTokenizer& in, int& lineNumber);
 
 public:
   StpParser(const std::string& filename);
@@ -64,25 +64,39 @@ public:
   {
     return _name;
   }
+
+  /// Whether uncompressed input is memory mapped rather than
+  /// read one block at a time; either way it is tokenized in place
+  bool getMapped() const
+  {
+    return _mapped;
+  }
+
+  void setMapped(bool mapped)
+  {
+    _mapped = mapped;
+  }
   
 protected:
   std::string _name;
+  bool _mapped;
 };
 
 template<typename GR>
 inline StpParser<GR>::StpParser(const std::string& filename)
   : Parent(filename)
+  , _name()
+  , _mapped(true)
 {
 }
 
 template<typename GR>
-inline bool StpParser<GR>::parseHeader(std::istream& in, int& lineNumber)
+inline bool StpParser<GR>::parseHeader(LineTokenizer& in, int& lineNumber)
 {
-  std::string line;
-  if (safeGetline(in, line))
+  if (in.nextLine())
   {
     lineNumber++;
-    return line.substr(0, 8) == "33D32945";
+    return in.lineStartsWith("33D32945");
   }
   else
   {
@@ -91,25 +105,20 @@ inline bool StpParser<GR>::parseHeader(std::istream& in, int& lineNumber)
 }
 
 template<typename GR>
-inline bool StpParser<GR>::parseNrTerminals(std::istream& in, int& lineNumber)
+inline bool StpParser<GR>::parseNrTerminals(LineTokenizer& in, int& lineNumber)
 {
-  std::string line;
-
-  if (safeGetline(in, line))
+  if (in.nextLine())
   {
-    std::string text;
-    std::stringstream ss(line);
     lineNumber++;
-    ss >> text;
 
-    if (text != "Terminals")
+    if (!in.nextTokenEquals("Terminals"))
     {
       std::cerr << "Error at line " << lineNumber << ": expected 'Terminals'" << std::endl;
       return false;
     }
 
     int nTerminals = -1;
-    ss >> nTerminals;
+    in.scanInt(nTerminals);
     if (nTerminals != _nNodes)
     {
       std::cerr << "Error at line " << lineNumber << ": terminal count must match node count" << std::endl;
@@ -125,24 +134,23 @@ inline bool StpParser<GR>::parseNrTerminals(std::istream& in, int& lineNumber)
 }
 
 template<typename GR>
-inline bool StpParser<GR>::parseNrNodes(std::istream& in, int& lineNumber)
+inline bool StpParser<GR>::parseNrNodes(LineTokenizer& in, int& lineNumber)
 {
-  std::string line;
-
-  if (safeGetline(in, line))
+  if (in.nextLine())
   {
-    std::string text;
-    std::stringstream ss(line);
     lineNumber++;
-    ss >> text;
 
-    if (text != "Nodes")
+    if (!in.nextTokenEquals("Nodes"))
     {
       std::cerr << "Error at line " << lineNumber << ": expected 'Nodes'" << std::endl;
       return false;
     }
 
-    ss >> _nNodes;
+    if (!in.scanInt(_nNodes) || _nNodes < 0)
+    {
+      std::cerr << "Error at line " << lineNumber << ": expected node count" << std::endl;
+      return false;
+    }
     _pG->reserveNode(_nNodes);
     return true;
   }
@@ -154,24 +162,23 @@ inline bool StpParser<GR>::parseNrNodes(std::istream& in, int& lineNumber)
 }
 
 template<typename GR>
-inline bool StpParser<GR>::parseNrEdges(std::istream& in, int& lineNumber)
+inline bool StpParser<GR>::parseNrEdges(LineTokenizer& in, int& lineNumber)
 {
-  std::string line;
-
-  if (safeGetline(in, line))
+  if (in.nextLine())
   {
-    std::string text;
-    std::stringstream ss(line);
     lineNumber++;
-    ss >> text;
 
-    if (text != "Edges")
+    if (!in.nextTokenEquals("Edges"))
     {
       std::cerr << "Error at line " << lineNumber << ": expected 'Edges'" << std::endl;
       return false;
     }
 
-    ss >> _nEdges;
+    if (!in.scanInt(_nEdges) || _nEdges < 0)
+    {
+      std::cerr << "Error at line " << lineNumber << ": expected edge count" << std::endl;
+      return false;
+    }
     _pG->reserveEdge(_nEdges);
     
     return true;
@@ -184,26 +191,26 @@ inline bool StpParser<GR>::parseNrEdges(std::istream& in, int& lineNumber)
 }
 
 template<typename GR>
-inline bool StpParser<GR>::parseGraph(std::istream& in, int& lineNumber)
+inline bool StpParser<GR>::parseGraph(LineTokenizer& in, int& lineNumber)
 {
-  std::string line;
-  
+  bool ok = false;
+
   // skip until "Name"
-  while (safeGetline(in, line) && line.substr(0, 4) != "Name")
+  while ((ok = in.nextLine()) && !in.lineStartsWith("Name"))
     lineNumber++;
   
-  if (line.size() < 6)
+  if (!ok || in.lineSize() < 6)
   {
     std::cerr << "Error: missing 'Name'" << std::endl;
     return false;
   }
-  _name = line.substr(5);
+  _name = in.lineSubstr(5);
 
   // skip until "SECTION Graph"
-  while (safeGetline(in, line) && line != "SECTION Graph")
+  while ((ok = in.nextLine()) && !in.lineEquals("SECTION Graph"))
     lineNumber++;
 
-  if (line != "SECTION Graph")
+  if (!ok)
   {
     std::cerr << "Error: missing 'SECTION Graph'" << std::endl;
     return false;
@@ -230,10 +237,10 @@ inline bool StpParser<GR>::parseGraph(std::istream& in, int& lineNumber)
   }
 
   // skip until "SECTION Terminals"
-  while (safeGetline(in, line) && line != "SECTION Terminals")
+  while ((ok = in.nextLine()) && !in.lineEquals("SECTION Terminals"))
     lineNumber++;
 
-  if (line != "SECTION Terminals")
+  if (!ok)
   {
     std::cerr << "Error: missing 'SECTION Terminals'" << std::endl;
     return false;
@@ -256,25 +263,21 @@ inline bool StpParser<GR>::parseGraph(std::istream& in, int& lineNumber)
 }
 
 template<typename GR>
-inline bool StpParser<GR>::parseEdge(std::istream& in, int& lineNumber)
+inline bool StpParser<GR>::parseEdge(LineTokenizer& in, int& lineNumber)
 {
-  std::string line;
-
-  if (safeGetline(in, line))
+  if (in.nextLine())
   {
-    std::string text;
-    std::stringstream ss(line);
     lineNumber++;
-    ss >> text;
 
-    if (text != "E")
+    if (!in.nextTokenEquals("E"))
     {
       std::cerr << "Error at line " << lineNumber << ": expected 'E'" << std::endl;
       return false;
     }
 
     int idU = -1, idV = -1;
-    ss >> idU >> idV;
+    if (in.scanInt(idU))
+      in.scanInt(idV);
 
     if (!(0 < idU && idU <= _nNodes) || !(0 < idV && idV <= _nNodes))
     {
@@ -297,19 +300,15 @@ inline bool StpParser<GR>::parseEdge(std::istream& in, int& lineNumber)
 }
 
 template<typename GR>
-inline bool StpParser<GR>::parseTerminal(std::istream& in, int& lineNumber)
+inline bool StpParser<GR>::parseTerminal(LineTokenizer& in, int& lineNumber)
 {
-  std::string line;
   char buf[1024];
 
-  if (safeGetline(in, line))
+  if (in.nextLine())
   {
-    std::string text;
-    std::stringstream ss(line);
     lineNumber++;
-    ss >> text;
 
-    if (text != "T")
+    if (!in.nextTokenEquals("T"))
     {
       std::cerr << "Error at line " << lineNumber << ": expected 'T'" << std::endl;
       return false;
@@ -318,7 +317,8 @@ inline bool StpParser<GR>::parseTerminal(std::istream& in, int& lineNumber)
     int idU = -1;
     double weightU = -std::numeric_limits<double>::max();
 
-    ss >> idU >> weightU;
+    if (in.scanInt(idU))
+      in.scanDouble(weightU);
 
     if (!(0 < idU && idU <= _nNodes))
     {
@@ -337,9 +337,9 @@ inline bool StpParser<GR>::parseTerminal(std::istream& in, int& lineNumber)
     Node u = _pG->nodeFromId(idU - 1);
     _pWeightNodeMap->set(u, weightU);
     
-    snprintf(buf, 1024, "%d", idU);
+    int len = snprintf(buf, 1024, "%d", idU);
     _pIdNodeMap->set(u, buf);
-    (*_pInvIdNodeMap)[buf] = u;
+    _pInvIdNodeMap->set(buf, buf + len, u);
 
     return true;
   }
@@ -356,8 +356,26 @@ inline bool StpParser<GR>::parse()
   if (!_pG)
     return false;
 
-  std::ifstream in(_filename.c_str());
-  if (!in.good())
+  int lineNumber = 0;
+  if (_mapped && !CompressedFile::isCompressed(_filename))
+  {
+    MappedFile file;
+    if (!file.open(_filename))
+    {
+      std::cerr << "Error: could not open file "
+                << _filename << " for reading" << std::endl;
+      return false;
+    }
+
+    _pG->clear();
+
+    LineTokenizer in(file.begin(), file.end());
+    return parseHeader(in, lineNumber) && parseGraph(in, lineNumber);
+  }
+
+  // tokenize in place, one (decompressed) block at a time
+  LineBlockReader reader;
+  if (!reader.open(_filename))
   {
     std::cerr << "Error: could not open file "
               << _filename << " for reading" << std::endl;
@@ -366,8 +384,14 @@ inline bool StpParser<GR>::parse()
 
   _pG->clear();
 
-  int lineNumber = 0;
-  return parseHeader(in, lineNumber) && parseGraph(in, lineNumber);
+  LineTokenizer in(reader);
+  bool res = parseHeader(in, lineNumber) && parseGraph(in, lineNumber);
+  if (reader.error())
+  {
+    std::cerr << "Error: could not decompress file " << _filename << std::endl;
+    return false;
+  }
+  return res;
 }
 
 } // namespace mwcs
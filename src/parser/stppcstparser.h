@@ -16,6 +16,7 @@
 #include <lemon/core.h>
 #include <set>
 #include "parser.h"
+#include "mappedfile.h"
 #include "utils.h"
 
 namespace nina {
@@ -43,24 +44,24 @@ public:
   typedef typename Parent::WeightNodeMap WeightNodeMap;
   typedef typename Parent::WeightEdgeMap WeightEdgeMap;
 
-  using Parent::safeGetline;
   using Parent::_filename;
   using Parent::_pG;
   using Parent::_pIdNodeMap;
   using Parent::_pInvIdNodeMap;
+  using Parent::_pNodeKindMap;
   using Parent::_pWeightNodeMap;
   using Parent::_pWeightEdgeMap;
   using Parent::_nNodes;
   using Parent::_nEdges;
 
 private:
-  bool parseHeader(std::istream& in, int& lineNumber);
-  bool parseGraph(std::istream& in, int& lineNumber);
-  bool parseNrNodes(std::istream& in, int& lineNumber);
-  bool parseNrEdges(std::istream& in, int& lineNumber);
-  bool parseNrTerminals(std::istream& in, int& lineNumber);
-  bool parseEdge(std::istream& in, int& lineNumber);
-  bool parseTerminal(std::istream& in, int& lineNumber);
+  bool parseHeader(LineTokenizer& in, int& lineNumber);
+  bool parseGraph(LineTokenizer& in, int& lineNumber);
+  bool parseNrNodes(LineTokenizer& in, int& lineNumber);
+  bool parseNrEdges(LineTokenizer& in, int& lineNumber);
+  bool parseNrTerminals(LineTokenizer& in, int& lineNumber);
+  bool parseEdge(LineTokenizer& in, int& lineNumber);
+  bool parseTerminal(LineTokenizer& in, int& lineNumber);
   
 public:
   StpPcstParser(const std::string& filename);
@@ -79,6 +80,31 @@ public:
   {
     return _pV;
   }
+
+  /// Whether uncompressed input is memory mapped rather than
+  /// read one block at a time; either way it is tokenized in place
+  bool getMapped() const
+  {
+    return _mapped;
+  }
+
+  void setMapped(bool mapped)
+  {
+    _mapped = mapped;
+  }
+
+  /// Whether every edge is subdivided by a node whose weight is minus
+  /// the edge cost; otherwise edges are kept and their costs are stored
+  /// in the edge weight map, which must then be set
+  bool getSubdivide() const
+  {
+    return _subdivide;
+  }
+
+  void setSubdivide(bool subdivide)
+  {
+    _subdivide = subdivide;
+  }
   
 protected:
   std::string _name;
@@ -87,6 +113,10 @@ protected:
   int _nTerminals;
   NodeSet _rootNodes;
   double _pV;
+  bool _mapped;
+  bool _subdivide;
+
+  bool addEdge(int idU, int idV, double costUV, int lineNumber);
 };
 
 template<typename GR>
@@ -97,17 +127,62 @@ inline StpPcstParser<GR>::StpPcstParser(const std::string& filename)
   , _nOrgEdges(0)
   , _nTerminals(0)
   , _rootNodes()
+  , _pV(0)
+  , _mapped(true)
+  , _subdivide(true)
+{
+}
+
+template<typename GR>
+inline bool StpPcstParser<GR>::addEdge(int idU, int idV, double costUV, int lineNumber)
 {
+  if (!(0 < idU && idU <= _nOrgNodes) || !(0 < idV && idV <= _nOrgNodes))
+  {
+    std::cerr << "Error at line " << lineNumber << ": expected node id in [1, "
+              << _nOrgNodes << "]" << std::endl;
+    return false;
+  }
+
+  if (costUV == std::numeric_limits<double>::max())
+  {
+    std::cerr << "Error at line " << lineNumber << ": expected real-valued edge cost"
+              << std::endl;
+    return false;
+  }
+
+  Node u = _pG->nodeFromId(idU - 1);
+  Node v = _pG->nodeFromId(idV - 1);
+
+  if (!_subdivide)
+  {
+    assert(_pWeightEdgeMap);
+    Edge e = _pG->addEdge(u, v);
+    _pWeightEdgeMap->set(e, costUV);
+    return true;
+  }
+
+  char buf[1024];
+  Node uv = _pG->addNode();
+  _pG->addEdge(u, uv);
+  _pG->addEdge(uv, v);
+
+  _pWeightNodeMap->set(uv, -costUV);
+  int len = snprintf(buf, 1024, "%d--%d", idU, idV);
+  _pIdNodeMap->set(uv, buf);
+  _pInvIdNodeMap->set(buf, buf + len, uv);
+  if (_pNodeKindMap)
+    _pNodeKindMap->set(_pG->id(uv), NODE_KIND_EDGE, idU, idV);
+
+  return true;
 }
 
 template<typename GR>
-inline bool StpPcstParser<GR>::parseHeader(std::istream& in, int& lineNumber)
+inline bool StpPcstParser<GR>::parseHeader(LineTokenizer& in, int& lineNumber)
 {
-  std::string line;
-  if (safeGetline(in, line))
+  if (in.nextLine())
   {
     lineNumber++;
-    return line.substr(0, 8) == "33D32945";
+    return in.lineStartsWith("33D32945");
   }
   else
   {
@@ -116,25 +191,20 @@ inline bool StpPcstParser<GR>::parseHeader(std::istream& in, int& lineNumber)
 }
 
 template<typename GR>
-inline bool StpPcstParser<GR>::parseNrTerminals(std::istream& in, int& lineNumber)
+inline bool StpPcstParser<GR>::parseNrTerminals(LineTokenizer& in, int& lineNumber)
 {
-  std::string line;
-
-  if (safeGetline(in, line))
+  if (in.nextLine())
   {
-    std::string text;
-    std::stringstream ss(line);
     lineNumber++;
-    ss >> text;
 
-    if (text != "Terminals")
+    if (!in.nextTokenEquals("Terminals"))
     {
       std::cerr << "Error at line " << lineNumber << ": expected 'Terminals'" << std::endl;
       return false;
     }
 
     _nTerminals = -1;
-    ss >> _nTerminals;
+    in.scanInt(_nTerminals);
     if (_nTerminals < 0)
     {
       std::cerr << "Error at line " << lineNumber << ": terminal count must be nonnegative" << std::endl;
@@ -150,24 +220,23 @@ inline bool StpPcstParser<GR>::parseNrTerminals(std::istream& in, int& lineNumbe
 }
 
 template<typename GR>
-inline bool StpPcstParser<GR>::parseNrNodes(std::istream& in, int& lineNumber)
+inline bool StpPcstParser<GR>::parseNrNodes(LineTokenizer& in, int& lineNumber)
 {
-  std::string line;
-
-  if (safeGetline(in, line))
+  if (in.nextLine())
   {
-    std::string text;
-    std::stringstream ss(line);
     lineNumber++;
-    ss >> text;
 
-    if (text != "Nodes")
+    if (!in.nextTokenEquals("Nodes"))
     {
       std::cerr << "Error at line " << lineNumber << ": expected 'Nodes'" << std::endl;
       return false;
     }
 
-    ss >> _nOrgNodes;
+    if (!in.scanInt(_nOrgNodes) || _nOrgNodes < 0)
+    {
+      std::cerr << "Error at line " << lineNumber << ": expected node count" << std::endl;
+      return false;
+    }
     return true;
   }
   else
@@ -178,29 +247,36 @@ inline bool StpPcstParser<GR>::parseNrNodes(std::istream& in, int& lineNumber)
 }
 
 template<typename GR>
-inline bool StpPcstParser<GR>::parseNrEdges(std::istream& in, int& lineNumber)
+inline bool StpPcstParser<GR>::parseNrEdges(LineTokenizer& in, int& lineNumber)
 {
-  std::string line;
-
-  if (safeGetline(in, line))
+  if (in.nextLine())
   {
-    std::string text;
-    std::stringstream ss(line);
     lineNumber++;
-    ss >> text;
 
-    if (text != "Edges")
+    if (!in.nextTokenEquals("Edges"))
     {
       std::cerr << "Error at line " << lineNumber << ": expected 'Edges'" << std::endl;
       return false;
     }
 
-    ss >> _nOrgEdges;
+    if (!in.scanInt(_nOrgEdges) || _nOrgEdges < 0)
+    {
+      std::cerr << "Error at line " << lineNumber << ": expected edge count" << std::endl;
+      return false;
+    }
     
-    // because of the transformation every edge becomes a node of itself
-    _nNodes = _nOrgNodes + _nOrgEdges;
-    // duplicate edges because of transformation
-    _nEdges = 2 * _nOrgEdges;
+    if (_subdivide)
+    {
+      // because of the transformation every edge becomes a node of itself
+      _nNodes = _nOrgNodes + _nOrgEdges;
+      // duplicate edges because of transformation
+      _nEdges = 2 * _nOrgEdges;
+    }
+    else
+    {
+      _nNodes = _nOrgNodes;
+      _nEdges = _nOrgEdges;
+    }
 
     _pG->reserveNode(_nNodes);
     _pG->reserveEdge(_nEdges);
@@ -215,27 +291,27 @@ inline bool StpPcstParser<GR>::parseNrEdges(std::istream& in, int& lineNumber)
 }
 
 template<typename GR>
-inline bool StpPcstParser<GR>::parseGraph(std::istream& in, int& lineNumber)
+inline bool StpPcstParser<GR>::parseGraph(LineTokenizer& in, int& lineNumber)
 {
-  std::string line;
+  bool ok = false;
   char buf[1024];
   
   // skip until "Name"
-  while (safeGetline(in, line) && line.substr(0, 4) != "Name")
+  while ((ok = in.nextLine()) && !in.lineStartsWith("Name"))
     lineNumber++;
   
-  if (line.size() < 6)
+  if (!ok || in.lineSize() < 6)
   {
     std::cerr << "Error: missing 'Name'" << std::endl;
     return false;
   }
-  _name = line.substr(5);
+  _name = in.lineSubstr(5);
 
   // skip until "SECTION Graph"
-  while (safeGetline(in, line) && line != "SECTION Graph")
+  while ((ok = in.nextLine()) && !in.lineEquals("SECTION Graph"))
     lineNumber++;
 
-  if (line != "SECTION Graph")
+  if (!ok)
   {
     std::cerr << "Error: missing 'SECTION Graph'" << std::endl;
     return false;
@@ -246,15 +322,25 @@ inline bool StpPcstParser<GR>::parseGraph(std::istream& in, int& lineNumber)
     return false;
   }
 
+  // one label per node and one per subdivided edge
+  _pInvIdNodeMap->reserve(_nNodes);
+  if (_pNodeKindMap)
+  {
+    _pNodeKindMap->clear();
+    _pNodeKindMap->reserve(_nNodes);
+  }
+
   // add nodes
   for (int i = 0; i < _nOrgNodes; i++)
   {
     Node u = _pG->addNode();
     _pWeightNodeMap->set(u, 0);
     
-    snprintf(buf, 1024, "%d", _pG->id(u) + 1);
+    int len = snprintf(buf, 1024, "%d", _pG->id(u) + 1);
     _pIdNodeMap->set(u, buf);
-    (*_pInvIdNodeMap)[buf] = u;
+    _pInvIdNodeMap->set(buf, buf + len, u);
+    if (_pNodeKindMap)
+      _pNodeKindMap->set(_pG->id(u), NODE_KIND_VERTEX, _pG->id(u) + 1);
   }
 
   // add edges
@@ -267,10 +353,10 @@ inline bool StpPcstParser<GR>::parseGraph(std::istream& in, int& lineNumber)
   }
 
   // skip until "SECTION Terminals"
-  while (safeGetline(in, line) && line != "SECTION Terminals")
+  while ((ok = in.nextLine()) && !in.lineEquals("SECTION Terminals"))
     lineNumber++;
 
-  if (line != "SECTION Terminals")
+  if (!ok)
   {
     std::cerr << "Error: missing 'SECTION Terminals'" << std::endl;
     return false;
@@ -294,19 +380,13 @@ inline bool StpPcstParser<GR>::parseGraph(std::istream& in, int& lineNumber)
 }
 
 template<typename GR>
-inline bool StpPcstParser<GR>::parseEdge(std::istream& in, int& lineNumber)
+inline bool StpPcstParser<GR>::parseEdge(LineTokenizer& in, int& lineNumber)
 {
-  std::string line;
-  char buf[1024];
-
-  if (safeGetline(in, line))
+  if (in.nextLine())
   {
-    std::string text;
-    std::stringstream ss(line);
     lineNumber++;
-    ss >> text;
 
-    if (text != "E")
+    if (!in.nextTokenEquals("E"))
     {
       std::cerr << "Error at line " << lineNumber << ": expected 'E'" << std::endl;
       return false;
@@ -314,34 +394,10 @@ inline bool StpPcstParser<GR>::parseEdge(std::istream& in, int& lineNumber)
 
     int idU = -1, idV = -1;
     double costUV = std::numeric_limits<double>::max();
-    ss >> idU >> idV >> costUV;
+    if (in.scanInt(idU) && in.scanInt(idV))
+      in.scanDouble(costUV);
 
-    if (!(0 < idU && idU <= _nNodes) || !(0 < idV && idV <= _nNodes))
-    {
-      std::cerr << "Error at line " << lineNumber << ": expected node id in [1, "
-                << _nNodes << "]" << std::endl;
-      return false;
-    }
-    
-    if (costUV == std::numeric_limits<double>::max())
-    {
-      std::cerr << "Error at line " << lineNumber << ": expected real-valued edge cost"
-                << std::endl;
-      return false;
-    }
-
-    Node u = _pG->nodeFromId(idU - 1);
-    Node v = _pG->nodeFromId(idV - 1);
-    Node uv = _pG->addNode();
-    _pG->addEdge(u, uv);
-    _pG->addEdge(uv, v);
-    
-    _pWeightNodeMap->set(uv, -costUV);
-    snprintf(buf, 1024, "%d--%d", idU, idV);
-    _pIdNodeMap->set(uv, buf);
-    (*_pInvIdNodeMap)[buf] = uv;
-
-    return true;
+    return addEdge(idU, idV, costUV, lineNumber);
   }
   else
   {
@@ -351,18 +407,18 @@ inline bool StpPcstParser<GR>::parseEdge(std::istream& in, int& lineNumber)
 }
 
 template<typename GR>
-inline bool StpPcstParser<GR>::parseTerminal(std::istream& in, int& lineNumber)
+inline bool StpPcstParser<GR>::parseTerminal(LineTokenizer& in, int& lineNumber)
 {
-  std::string line;
-
-  if (safeGetline(in, line))
+  if (in.nextLine())
   {
-    std::string text;
-    std::stringstream ss(line);
     lineNumber++;
-    ss >> text;
 
-    if (text != "TP" && text != "RootP")
+    const char* textBegin = NULL;
+    const char* textEnd = NULL;
+    in.nextToken(textBegin, textEnd);
+
+    bool root = LineTokenizer::equals(textBegin, textEnd, "RootP");
+    if (!root && !LineTokenizer::equals(textBegin, textEnd, "TP"))
     {
       std::cerr << "Error at line " << lineNumber << ": expected 'TP' or 'RootP'" << std::endl;
       return false;
@@ -371,19 +427,20 @@ inline bool StpPcstParser<GR>::parseTerminal(std::istream& in, int& lineNumber)
     int idU = -1;
     double weightU = -std::numeric_limits<double>::max();
 
-    ss >> idU >> weightU;
+    if (in.scanInt(idU))
+      in.scanDouble(weightU);
     
-    if (text == "RootP")
+    if (root)
     {
       Node u = _pG->nodeFromId(idU - 1);
       _rootNodes.insert(u);
     }
     else
     {
-      if (!(0 < idU && idU <= _nNodes))
+      if (!(0 < idU && idU <= _nOrgNodes))
       {
         std::cerr << "Error at line " << lineNumber << ": expected node id in [1, "
-                  << _nNodes << "]" << std::endl;
+                  << _nOrgNodes << "]" << std::endl;
         return false;
       }
 
@@ -414,8 +471,26 @@ inline bool StpPcstParser<GR>::parse()
   if (!_pG)
     return false;
 
-  std::ifstream in(_filename.c_str());
-  if (!in.good())
+  int lineNumber = 0;
+  if (_mapped && !CompressedFile::isCompressed(_filename))
+  {
+    MappedFile file;
+    if (!file.open(_filename))
+    {
+      std::cerr << "Error: could not open file "
+                << _filename << " for reading" << std::endl;
+      return false;
+    }
+
+    _pG->clear();
+
+    LineTokenizer in(file.begin(), file.end());
+    return parseHeader(in, lineNumber) && parseGraph(in, lineNumber);
+  }
+
+  // tokenize in place, one (decompressed) block at a time
+  LineBlockReader reader;
+  if (!reader.open(_filename))
   {
     std::cerr << "Error: could not open file "
               << _filename << " for reading" << std::endl;
@@ -424,8 +499,14 @@ inline bool StpPcstParser<GR>::parse()
 
   _pG->clear();
 
-  int lineNumber = 0;
-  return parseHeader(in, lineNumber) && parseGraph(in, lineNumber);
+  LineTokenizer in(reader);
+  bool res = parseHeader(in, lineNumber) && parseGraph(in, lineNumber);
+  if (reader.error())
+  {
+    std::cerr << "Error: could not decompress file " << _filename << std::endl;
+    return false;
+  }
+  return res;
 }
 
 } // namespace mwcs
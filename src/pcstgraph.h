@@ -0,0 +1,774 @@
+/*
+ * pcstgraph.h
+ *
+ *  Created on: 16-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef PCSTGRAPH_H
+#define PCSTGRAPH_H
+
+#include "mwcsgraphparser.h"
+#include <set>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <lemon/core.h>
+
+namespace nina {
+namespace mwcs {
+
+/// Prize-collecting Steiner tree instance with costs on the edges
+///
+/// Unlike the MWCS transformation, edges are not subdivided: node scores
+/// are prizes and edge costs are kept in an edge map. The original graph
+/// is read by a parser that stores edge costs (see
+/// StpPcstParser::setSubdivide()). Preprocessing works on a copy, the
+/// pre graph, of which every node and edge keeps track of the original
+/// nodes and edges it represents.
+template<typename GR,
+         typename NWGHT = typename GR::template NodeMap<double>,
+         typename NLBL = typename GR::template NodeMap<std::string>,
+         typename EWGHT = typename GR::template EdgeMap<double> >
+class PcstGraph : public MwcsGraphParser<GR, NWGHT, NLBL, EWGHT>
+{
+public:
+  typedef GR Graph;
+  typedef NWGHT WeightNodeMap;
+  typedef NLBL LabelNodeMap;
+  typedef EWGHT WeightEdgeMap;
+
+  typedef MwcsGraphParser<GR, NWGHT, NLBL, EWGHT> Parent;
+  typedef typename Parent::ParserType ParserType;
+  typedef typename Parent::NodeSet NodeSet;
+  typedef typename Parent::NodeSetIt NodeSetIt;
+  typedef typename Parent::BoolVector BoolVector;
+  typedef typename Parent::EdgeVector EdgeVector;
+
+  TEMPLATE_GRAPH_TYPEDEFS(Graph);
+
+  typedef std::set<Edge> EdgeSet;
+  typedef typename EdgeSet::const_iterator EdgeSetIt;
+  typedef std::vector<Node> NodeVector;
+  typedef typename NodeVector::const_iterator NodeVectorIt;
+  typedef typename EdgeVector::const_iterator EdgeVectorIt;
+  typedef typename Graph::template NodeMap<NodeVector> NodeVectorNodeMap;
+  typedef typename Graph::template NodeMap<EdgeVector> EdgeVectorNodeMap;
+  typedef typename Graph::template EdgeMap<NodeVector> NodeVectorEdgeMap;
+  typedef typename Graph::template EdgeMap<EdgeVector> EdgeVectorEdgeMap;
+  typedef typename Graph::template NodeMap<Node> NodeNodeMap;
+
+  using Parent::getOrgGraph;
+  using Parent::getOrgLabel;
+  using Parent::getOrgLabels;
+  using Parent::getOrgNodeByLabel;
+  using Parent::getOrgScores;
+
+public:
+  PcstGraph();
+  virtual ~PcstGraph();
+
+  /// Parses the instance, pParser must store edge costs
+  virtual bool init(ParserType* pParser, bool pval);
+
+  /// Applies the edge-aware reduction tests
+  ///
+  /// rootNodes are nodes of the pre graph and are never removed.
+  void preprocess(const NodeSet& rootNodes);
+
+  const WeightEdgeMap& getCosts() const
+  {
+    return *_pGraph->_pCost;
+  }
+
+  double getCost(Edge e) const
+  {
+    assert(e != lemon::INVALID);
+    return (*_pGraph->_pCost)[e];
+  }
+
+  const WeightEdgeMap& getOrgCosts() const
+  {
+    return *_pOrgCost;
+  }
+
+  double getOrgCost(Edge e) const
+  {
+    assert(e != lemon::INVALID);
+    return (*_pOrgCost)[e];
+  }
+
+  /// Returns the sum of the positive original prizes
+  double getTotalPrize() const
+  {
+    double res = 0;
+    const Graph& orgG = getOrgGraph();
+    for (NodeIt v(orgG); v != lemon::INVALID; ++v)
+    {
+      res += std::max(getOrgScores()[v], 0.);
+    }
+    return res;
+  }
+
+  /// Projects the tree with the given nodes and edges of the pre graph
+  /// onto the original graph
+  ///
+  /// Sets orgNodes and orgEdges to bitmaps indexed by original node and
+  /// edge id, and returns the number of original nodes
+  int projectSolution(const NodeSet& nodes,
+                      const EdgeSet& edges,
+                      BoolVector& orgNodes,
+                      BoolVector& orgEdges) const;
+
+  /// Prints the solution tree in the DIMACS PCST format
+  void printPcstDimacs(const NodeSet& nodes,
+                       const EdgeSet& edges,
+                       std::ostream& out) const;
+
+  using Parent::printPcstDimacs;
+
+protected:
+  virtual void initParserMembers(Graph*& pG,
+                                 LabelNodeMap*& pLabel,
+                                 WeightNodeMap*& pScore,
+                                 WeightNodeMap*& pPVal)
+  {
+    Parent::initParserMembers(pG, pLabel, pScore, pPVal);
+
+    delete _pOrgCost;
+    _pOrgCost = new WeightEdgeMap(*pG);
+    if (_pParser)
+    {
+      _pParser->setWeightEdgeMap(_pOrgCost);
+    }
+  }
+
+private:
+  typedef std::deque<Node> NodeQueue;
+
+  typedef struct GraphStruct
+  {
+    Graph* _pG;
+    LabelNodeMap* _pLabel;
+    WeightNodeMap* _pScore;
+    WeightEdgeMap* _pCost;
+    IntNodeMap* _pComp;
+    /// Original nodes and edges represented by a node
+    NodeVectorNodeMap* _pNodeOrgNodes;
+    EdgeVectorNodeMap* _pNodeOrgEdges;
+    /// Original nodes and edges represented by an edge
+    NodeVectorEdgeMap* _pEdgeOrgNodes;
+    EdgeVectorEdgeMap* _pEdgeOrgEdges;
+    /// Node of the pre graph that an original node belongs to,
+    /// INVALID if it has been removed or is part of an edge
+    NodeNodeMap* _pMapToPre;
+    int _nNodes;
+    int _nEdges;
+    int _nComponents;
+
+    GraphStruct(const Graph& orgG)
+      : _pG(new Graph())
+      , _pLabel(new LabelNodeMap(*_pG))
+      , _pScore(new WeightNodeMap(*_pG))
+      , _pCost(new WeightEdgeMap(*_pG))
+      , _pComp(new IntNodeMap(*_pG))
+      , _pNodeOrgNodes(new NodeVectorNodeMap(*_pG))
+      , _pNodeOrgEdges(new EdgeVectorNodeMap(*_pG))
+      , _pEdgeOrgNodes(new NodeVectorEdgeMap(*_pG))
+      , _pEdgeOrgEdges(new EdgeVectorEdgeMap(*_pG))
+      , _pMapToPre(new NodeNodeMap(orgG, lemon::INVALID))
+      , _nNodes(0)
+      , _nEdges(0)
+      , _nComponents(0)
+    {
+    }
+
+    ~GraphStruct()
+    {
+      delete _pMapToPre;
+      delete _pEdgeOrgEdges;
+      delete _pEdgeOrgNodes;
+      delete _pNodeOrgEdges;
+      delete _pNodeOrgNodes;
+      delete _pComp;
+      delete _pCost;
+      delete _pScore;
+      delete _pLabel;
+      delete _pG;
+    }
+  } GraphStruct;
+
+  WeightEdgeMap* _pOrgCost;
+  /// Parser that is being read from, only set during init()
+  ParserType* _pParser;
+  GraphStruct* _pGraph;
+
+  void clear();
+  void remove(Node v);
+  void absorb(Node u, Node v, Edge e);
+  Edge contract(Node v);
+  void removeParallelEdges(Node v,
+                           std::vector<int>& index,
+                           NodeQueue& queue,
+                           BoolVector& queued,
+                           int& nEdges);
+  void push(Node v, NodeQueue& queue, BoolVector& queued) const;
+  void updateMapToPre();
+
+public:
+  virtual const Graph& getGraph() const
+  {
+    return *_pGraph->_pG;
+  }
+
+  virtual Graph& getGraph()
+  {
+    return *_pGraph->_pG;
+  }
+
+  virtual const LabelNodeMap& getLabels() const
+  {
+    return *_pGraph->_pLabel;
+  }
+
+  virtual LabelNodeMap& getLabels()
+  {
+    return *_pGraph->_pLabel;
+  }
+
+  virtual const WeightNodeMap& getScores() const
+  {
+    return *_pGraph->_pScore;
+  }
+
+  virtual WeightNodeMap& getScores()
+  {
+    return *_pGraph->_pScore;
+  }
+
+  virtual int getNodeCount() const
+  {
+    return _pGraph->_nNodes;
+  }
+
+  virtual int getEdgeCount() const
+  {
+    return _pGraph->_nEdges;
+  }
+
+  virtual int getArcCount() const
+  {
+    return 2 * _pGraph->_nEdges;
+  }
+
+  virtual int getComponentCount() const
+  {
+    return _pGraph->_nComponents;
+  }
+
+  virtual int getComponent(Node n) const
+  {
+    assert(n != lemon::INVALID);
+    return (*_pGraph->_pComp)[n];
+  }
+
+  virtual const IntNodeMap& getComponentMap() const
+  {
+    return *_pGraph->_pComp;
+  }
+
+  virtual std::string getLabel(Node n) const
+  {
+    assert(n != lemon::INVALID);
+    return (*_pGraph->_pLabel)[n];
+  }
+
+  virtual double getScore(Node n) const
+  {
+    assert(n != lemon::INVALID);
+    return (*_pGraph->_pScore)[n];
+  }
+
+  virtual NodeSet getOrgNodes(Node node) const
+  {
+    const NodeVector& orgNodes = (*_pGraph->_pNodeOrgNodes)[node];
+    return NodeSet(orgNodes.begin(), orgNodes.end());
+  }
+
+  virtual NodeSet getOrgNodes(const NodeSet& nodes) const
+  {
+    NodeSet result;
+    for (NodeSetIt nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt)
+    {
+      const NodeVector& orgNodes = (*_pGraph->_pNodeOrgNodes)[*nodeIt];
+      result.insert(orgNodes.begin(), orgNodes.end());
+    }
+    return result;
+  }
+
+  /// Projects the nodes of module onto the original graph, the nodes
+  /// on contracted edges between them are not included
+  virtual int projectModule(const NodeSet& module,
+                            BoolVector& orgModule) const
+  {
+    BoolVector orgEdges;
+    return projectSolution(module, EdgeSet(), orgModule, orgEdges);
+  }
+
+  virtual NodeSet getPreNodes(Node orgNode) const
+  {
+    NodeSet res;
+    Node preNode = (*_pGraph->_pMapToPre)[orgNode];
+    if (preNode != lemon::INVALID)
+    {
+      res.insert(preNode);
+    }
+    return res;
+  }
+
+  virtual NodeSet getNodeByLabel(const std::string& label) const
+  {
+    Node orgNode = getOrgNodeByLabel(label);
+    if (orgNode != lemon::INVALID)
+    {
+      return getPreNodes(orgNode);
+    }
+    return NodeSet();
+  }
+};
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline PcstGraph<GR, NWGHT, NLBL, EWGHT>::PcstGraph()
+  : Parent()
+  , _pOrgCost(NULL)
+  , _pParser(NULL)
+  , _pGraph(NULL)
+{
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline PcstGraph<GR, NWGHT, NLBL, EWGHT>::~PcstGraph()
+{
+  delete _pGraph;
+  delete _pOrgCost;
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline bool PcstGraph<GR, NWGHT, NLBL, EWGHT>::init(ParserType* pParser, bool pval)
+{
+  _pParser = pParser;
+  bool res = Parent::init(pParser, pval);
+  _pParser = NULL;
+
+  if (!res)
+    return false;
+
+  // start by making a copy of the graph
+  clear();
+
+  return true;
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void PcstGraph<GR, NWGHT, NLBL, EWGHT>::clear()
+{
+  const Graph& orgG = getOrgGraph();
+
+  delete _pGraph;
+  _pGraph = new GraphStruct(orgG);
+
+  Graph& g = *_pGraph->_pG;
+  g.reserveNode(lemon::countNodes(orgG));
+  g.reserveEdge(lemon::countEdges(orgG));
+
+  NodeNodeMap& mapToPre = *_pGraph->_pMapToPre;
+  for (NodeIt v(orgG); v != lemon::INVALID; ++v)
+  {
+    Node preV = g.addNode();
+    mapToPre[v] = preV;
+    _pGraph->_pLabel->set(preV, getOrgLabel(v));
+    _pGraph->_pScore->set(preV, getOrgScores()[v]);
+    (*_pGraph->_pNodeOrgNodes)[preV].push_back(v);
+    ++_pGraph->_nNodes;
+  }
+
+  for (EdgeIt e(orgG); e != lemon::INVALID; ++e)
+  {
+    Edge preE = g.addEdge(mapToPre[orgG.u(e)], mapToPre[orgG.v(e)]);
+    _pGraph->_pCost->set(preE, (*_pOrgCost)[e]);
+    (*_pGraph->_pEdgeOrgEdges)[preE].push_back(e);
+    ++_pGraph->_nEdges;
+  }
+
+  _pGraph->_nComponents = lemon::connectedComponents(g, *_pGraph->_pComp);
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void PcstGraph<GR, NWGHT, NLBL, EWGHT>::remove(Node v)
+{
+  Graph& g = *_pGraph->_pG;
+  for (IncEdgeIt e(g, v); e != lemon::INVALID; ++e)
+  {
+    --_pGraph->_nEdges;
+  }
+  g.erase(v);
+  --_pGraph->_nNodes;
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void PcstGraph<GR, NWGHT, NLBL, EWGHT>::absorb(Node u, Node v, Edge e)
+{
+  // u takes over v and e
+  NodeVector& orgNodes = (*_pGraph->_pNodeOrgNodes)[u];
+  EdgeVector& orgEdges = (*_pGraph->_pNodeOrgEdges)[u];
+
+  const NodeVector& vOrgNodes = (*_pGraph->_pNodeOrgNodes)[v];
+  const EdgeVector& vOrgEdges = (*_pGraph->_pNodeOrgEdges)[v];
+  const NodeVector& eOrgNodes = (*_pGraph->_pEdgeOrgNodes)[e];
+  const EdgeVector& eOrgEdges = (*_pGraph->_pEdgeOrgEdges)[e];
+
+  orgNodes.insert(orgNodes.end(), vOrgNodes.begin(), vOrgNodes.end());
+  orgNodes.insert(orgNodes.end(), eOrgNodes.begin(), eOrgNodes.end());
+  orgEdges.insert(orgEdges.end(), vOrgEdges.begin(), vOrgEdges.end());
+  orgEdges.insert(orgEdges.end(), eOrgEdges.begin(), eOrgEdges.end());
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline typename PcstGraph<GR, NWGHT, NLBL, EWGHT>::Edge
+PcstGraph<GR, NWGHT, NLBL, EWGHT>::contract(Node v)
+{
+  Graph& g = *_pGraph->_pG;
+
+  IncEdgeIt e1(g, v);
+  Edge e = e1;
+  Edge f = ++e1;
+  assert(e != lemon::INVALID && f != lemon::INVALID);
+
+  Node u = g.oppositeNode(v, e);
+  Node w = g.oppositeNode(v, f);
+  assert(u != w);
+
+  // the path u - v - w becomes a single edge uw
+  Edge uw = g.addEdge(u, w);
+  ++_pGraph->_nEdges;
+  _pGraph->_pCost->set(uw, getCost(e) + getCost(f) - getScore(v));
+
+  NodeVector& orgNodes = (*_pGraph->_pEdgeOrgNodes)[uw];
+  EdgeVector& orgEdges = (*_pGraph->_pEdgeOrgEdges)[uw];
+  for (int i = 0; i < 2; ++i)
+  {
+    Edge g_i = i == 0 ? e : f;
+    const NodeVector& iOrgNodes = (*_pGraph->_pEdgeOrgNodes)[g_i];
+    const EdgeVector& iOrgEdges = (*_pGraph->_pEdgeOrgEdges)[g_i];
+    orgNodes.insert(orgNodes.end(), iOrgNodes.begin(), iOrgNodes.end());
+    orgEdges.insert(orgEdges.end(), iOrgEdges.begin(), iOrgEdges.end());
+  }
+
+  const NodeVector& vOrgNodes = (*_pGraph->_pNodeOrgNodes)[v];
+  const EdgeVector& vOrgEdges = (*_pGraph->_pNodeOrgEdges)[v];
+  orgNodes.insert(orgNodes.end(), vOrgNodes.begin(), vOrgNodes.end());
+  orgEdges.insert(orgEdges.end(), vOrgEdges.begin(), vOrgEdges.end());
+
+  remove(v);
+  return uw;
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void PcstGraph<GR, NWGHT, NLBL, EWGHT>::push(Node v,
+                                                    NodeQueue& queue,
+                                                    BoolVector& queued) const
+{
+  const Graph& g = *_pGraph->_pG;
+  if (!queued[g.id(v)])
+  {
+    queued[g.id(v)] = true;
+    queue.push_back(v);
+  }
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void PcstGraph<GR, NWGHT, NLBL, EWGHT>::removeParallelEdges(Node v,
+                                                                   std::vector<int>& index,
+                                                                   NodeQueue& queue,
+                                                                   BoolVector& queued,
+                                                                   int& nEdges)
+{
+  Graph& g = *_pGraph->_pG;
+
+  // keep the cheapest edge to every neighbor, index maps a neighbor
+  // to its position in cheapest and is -1 for all nodes in between calls
+  EdgeVector cheapest;
+  EdgeVector removed;
+  NodeVector neighbors;
+  for (IncEdgeIt e(g, v); e != lemon::INVALID; ++e)
+  {
+    Node u = g.oppositeNode(v, e);
+    if (u == v)
+    {
+      // self-loops never pay off, they are listed twice
+      if (std::find(removed.begin(), removed.end(), Edge(e)) == removed.end())
+        removed.push_back(e);
+      continue;
+    }
+
+    int& idx = index[g.id(u)];
+    if (idx == -1)
+    {
+      idx = static_cast<int>(cheapest.size());
+      cheapest.push_back(e);
+      neighbors.push_back(u);
+    }
+    else if (getCost(e) < getCost(cheapest[idx]))
+    {
+      removed.push_back(cheapest[idx]);
+      cheapest[idx] = e;
+    }
+    else
+    {
+      removed.push_back(e);
+    }
+  }
+
+  for (NodeVectorIt nodeIt = neighbors.begin(); nodeIt != neighbors.end(); ++nodeIt)
+  {
+    index[g.id(*nodeIt)] = -1;
+  }
+
+  for (EdgeVectorIt edgeIt = removed.begin(); edgeIt != removed.end(); ++edgeIt)
+  {
+    Node u = g.oppositeNode(v, *edgeIt);
+    g.erase(*edgeIt);
+    --_pGraph->_nEdges;
+    ++nEdges;
+    if (u != v)
+      push(u, queue, queued);
+  }
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void PcstGraph<GR, NWGHT, NLBL, EWGHT>::preprocess(const NodeSet& rootNodes)
+{
+  Graph& g = *_pGraph->_pG;
+  WeightNodeMap& score = *_pGraph->_pScore;
+  const bool rooted = !rootNodes.empty();
+
+  int nRemovedEdges = 0;
+  int nRemovedNodes = 0;
+  int nAbsorbedNodes = 0;
+  int nContractedNodes = 0;
+
+  // without a root, the isolated node with the largest prize is kept
+  // as a solution by itself, all other isolated nodes are dominated by it
+  Node best = lemon::INVALID;
+
+  NodeQueue queue;
+  BoolVector queued(g.maxNodeId() + 1, false);
+  std::vector<int> index(g.maxNodeId() + 1, -1);
+  for (NodeIt v(g); v != lemon::INVALID; ++v)
+  {
+    push(v, queue, queued);
+  }
+
+  while (!queue.empty())
+  {
+    Node v = queue.front();
+    queue.pop_front();
+    queued[g.id(v)] = false;
+
+    removeParallelEdges(v, index, queue, queued, nRemovedEdges);
+    if (rootNodes.find(v) != rootNodes.end())
+      continue;
+
+    IncEdgeIt e1(g, v);
+    int deg = 0;
+    for (IncEdgeIt e(g, v); e != lemon::INVALID && deg < 3; ++e)
+      ++deg;
+
+    if (deg == 0)
+    {
+      // an isolated node is a solution by itself, at best
+      if (score[v] <= 0 || rooted)
+      {
+        remove(v);
+        ++nRemovedNodes;
+      }
+      else if (best == lemon::INVALID)
+      {
+        best = v;
+      }
+      else if (score[v] <= score[best])
+      {
+        remove(v);
+        ++nRemovedNodes;
+      }
+      else
+      {
+        remove(best);
+        ++nRemovedNodes;
+        best = v;
+      }
+    }
+    else if (deg == 1)
+    {
+      Edge e = e1;
+      Node u = g.oppositeNode(v, e);
+      if (score[v] <= getCost(e) && (rooted || score[v] <= 0))
+      {
+        // a leaf that does not pay for its edge
+        remove(v);
+        ++nRemovedNodes;
+        push(u, queue, queued);
+      }
+      else if (score[v] <= getCost(e))
+      {
+        // without a root v may still be a solution by itself,
+        // only its edge is never worth taking
+        g.erase(e);
+        --_pGraph->_nEdges;
+        ++nRemovedEdges;
+        push(v, queue, queued);
+        push(u, queue, queued);
+      }
+      else if (rooted)
+      {
+        // a leaf that pays for its edge is in every solution with u,
+        // without a root v could be a solution by itself
+        score[u] += score[v] - getCost(e);
+        absorb(u, v, e);
+        remove(v);
+        ++nAbsorbedNodes;
+        push(u, queue, queued);
+      }
+    }
+    else if (deg == 2 && score[v] <= 0)
+    {
+      // a node without prize is never a leaf of a solution
+      Edge uw = contract(v);
+      ++nContractedNodes;
+      push(g.u(uw), queue, queued);
+      push(g.v(uw), queue, queued);
+    }
+  }
+
+  updateMapToPre();
+  _pGraph->_nComponents = lemon::connectedComponents(g, *_pGraph->_pComp);
+
+  if (g_verbosity >= VERBOSE_DEBUG)
+  {
+    std::cout << "// Removed " << nRemovedEdges << " edge(s) and "
+              << nRemovedNodes << " node(s), absorbed "
+              << nAbsorbedNodes << " leaves and contracted "
+              << nContractedNodes << " node(s) of degree 2" << std::endl;
+  }
+
+  if (g_verbosity >= VERBOSE_ESSENTIAL)
+  {
+    std::cout << "// Preprocessing successfully applied"
+              << ": " << _pGraph->_nNodes << " nodes, "
+              << _pGraph->_nEdges << " edges and "
+              << _pGraph->_nComponents << " component(s) remaining" << std::endl;
+  }
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void PcstGraph<GR, NWGHT, NLBL, EWGHT>::updateMapToPre()
+{
+  const Graph& g = *_pGraph->_pG;
+  NodeNodeMap& mapToPre = *_pGraph->_pMapToPre;
+
+  lemon::mapFill(getOrgGraph(), mapToPre, lemon::INVALID);
+  for (NodeIt v(g); v != lemon::INVALID; ++v)
+  {
+    const NodeVector& orgNodes = (*_pGraph->_pNodeOrgNodes)[v];
+    for (NodeVectorIt nodeIt = orgNodes.begin(); nodeIt != orgNodes.end(); ++nodeIt)
+    {
+      mapToPre[*nodeIt] = v;
+    }
+  }
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline int PcstGraph<GR, NWGHT, NLBL, EWGHT>::projectSolution(const NodeSet& nodes,
+                                                              const EdgeSet& edges,
+                                                              BoolVector& orgNodes,
+                                                              BoolVector& orgEdges) const
+{
+  const Graph& orgG = getOrgGraph();
+
+  orgNodes.assign(orgG.maxNodeId() + 1, false);
+  orgEdges.assign(orgG.maxEdgeId() + 1, false);
+
+  int n = 0;
+  for (NodeSetIt nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt)
+  {
+    const NodeVector& vOrgNodes = (*_pGraph->_pNodeOrgNodes)[*nodeIt];
+    const EdgeVector& vOrgEdges = (*_pGraph->_pNodeOrgEdges)[*nodeIt];
+    for (NodeVectorIt it = vOrgNodes.begin(); it != vOrgNodes.end(); ++it)
+    {
+      if (!orgNodes[orgG.id(*it)])
+      {
+        orgNodes[orgG.id(*it)] = true;
+        ++n;
+      }
+    }
+    for (EdgeVectorIt it = vOrgEdges.begin(); it != vOrgEdges.end(); ++it)
+    {
+      orgEdges[orgG.id(*it)] = true;
+    }
+  }
+
+  for (EdgeSetIt edgeIt = edges.begin(); edgeIt != edges.end(); ++edgeIt)
+  {
+    const NodeVector& eOrgNodes = (*_pGraph->_pEdgeOrgNodes)[*edgeIt];
+    const EdgeVector& eOrgEdges = (*_pGraph->_pEdgeOrgEdges)[*edgeIt];
+    for (NodeVectorIt it = eOrgNodes.begin(); it != eOrgNodes.end(); ++it)
+    {
+      if (!orgNodes[orgG.id(*it)])
+      {
+        orgNodes[orgG.id(*it)] = true;
+        ++n;
+      }
+    }
+    for (EdgeVectorIt it = eOrgEdges.begin(); it != eOrgEdges.end(); ++it)
+    {
+      orgEdges[orgG.id(*it)] = true;
+    }
+  }
+
+  return n;
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void PcstGraph<GR, NWGHT, NLBL, EWGHT>::printPcstDimacs(const NodeSet& nodes,
+                                                               const EdgeSet& edges,
+                                                               std::ostream& out) const
+{
+  const Graph& orgG = getOrgGraph();
+
+  BoolVector orgNodes, orgEdges;
+  int n = projectSolution(nodes, edges, orgNodes, orgEdges);
+
+  out << "Vertices " << n << "\n";
+  for (int i = 0; i < static_cast<int>(orgNodes.size()); ++i)
+  {
+    if (orgNodes[i])
+      out << "V " << getOrgLabel(orgG.nodeFromId(i)) << "\n";
+  }
+
+  int m = static_cast<int>(std::count(orgEdges.begin(), orgEdges.end(), true));
+  out << "Edges " << m << "\n";
+  for (int i = 0; i < static_cast<int>(orgEdges.size()); ++i)
+  {
+    if (!orgEdges[i])
+      continue;
+
+    Edge e = orgG.edgeFromId(i);
+    out << "E " << getOrgLabel(orgG.u(e)) << " " << getOrgLabel(orgG.v(e)) << "\n";
+  }
+  out.flush();
+}
+
+} // namespace mwcs
+} // namespace nina
+
+#endif // PCSTGRAPH_H
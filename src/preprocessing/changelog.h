@@ -0,0 +1,83 @@
+/*
+ * changelog.h
+ *
+ *  Created on: 17-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef CHANGELOG_H
+#define CHANGELOG_H
+
+#include <assert.h>
+#include <vector>
+#include <lemon/core.h>
+
+namespace nina {
+namespace mwcs {
+
+/// Log of the nodes changed by the preprocessing rules
+///
+/// A node is appended whenever its degree, score or set of neighbors
+/// changes. Every rule keeps its own position in the log, the nodes after
+/// that position are the ones it has to re-examine (its worklist). The log
+/// only grows during a run of the preprocessing; entries may refer to nodes
+/// that have been removed since, which is checked when they are read.
+/// Node ids are obtained with the static GR::id() and GR::nodeFromId().
+template<typename GR>
+class ChangeLog
+{
+public:
+  typedef GR Graph;
+  typedef typename Graph::Node Node;
+
+  ChangeLog()
+    : _log()
+    , _nMerges(0)
+  {
+  }
+
+  void clear()
+  {
+    _log.clear();
+    _nMerges = 0;
+  }
+
+  /// Records that the degree, score or neighbors of v changed
+  void mark(Node v)
+  {
+    assert(v != lemon::INVALID);
+    _log.push_back(Graph::id(v));
+  }
+
+  /// Records a merge, which may shorten paths anywhere in the graph
+  void markMerge()
+  {
+    ++_nMerges;
+  }
+
+  int size() const
+  {
+    return static_cast<int>(_log.size());
+  }
+
+  Node operator[](int i) const
+  {
+    assert(0 <= i && i < size());
+    return Graph::nodeFromId(_log[i]);
+  }
+
+  /// Number of merges recorded so far
+  int getMergeCount() const
+  {
+    return _nMerges;
+  }
+
+private:
+  std::vector<int> _log;
+  int _nMerges;
+};
+
+} // namespace mwcs
+} // namespace nina
+
+#endif // CHANGELOG_H
@@ -0,0 +1,378 @@
+/*
+ * compactnodeset.h
+ *
+ *  Created on: 16-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef COMPACTNODESET_H
+#define COMPACTNODESET_H
+
+#include <assert.h>
+#include <string.h>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <lemon/core.h>
+
+namespace nina {
+namespace mwcs {
+
+/// Ordered set of nodes used by the preprocessing rules
+///
+/// Small sets are sorted arrays stored inline, larger ones sorted arrays on
+/// the heap. Iteration is in increasing id order, as with std::set<Node>.
+/// Node ids are obtained with the static GR::id().
+///
+/// Unlike std::set, insert() invalidates all iterators and erase(Node)
+/// invalidates iterators to the erased node and the nodes after it.
+/// Use erase(const_iterator) to erase while iterating.
+template<typename GR>
+class CompactNodeSet
+{
+public:
+  typedef GR Graph;
+  typedef typename Graph::Node Node;
+
+  /// Number of nodes stored without heap allocation
+  static const int INLINE_CAPACITY = 4;
+
+  class const_iterator
+  {
+    friend class CompactNodeSet;
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Node value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Node* pointer;
+    typedef const Node& reference;
+
+    const_iterator()
+      : _pSet(NULL)
+      , _pos(0)
+      , _node(lemon::INVALID)
+    {
+    }
+
+    reference operator*() const
+    {
+      return _node;
+    }
+
+    pointer operator->() const
+    {
+      return &_node;
+    }
+
+    const_iterator& operator++()
+    {
+      ++_pos;
+      load();
+      return *this;
+    }
+
+    const_iterator operator++(int)
+    {
+      const_iterator res = *this;
+      ++*this;
+      return res;
+    }
+
+    bool operator==(const const_iterator& other) const
+    {
+      return _pos == other._pos;
+    }
+
+    bool operator!=(const const_iterator& other) const
+    {
+      return _pos != other._pos;
+    }
+
+  private:
+    const_iterator(const CompactNodeSet* pSet, int pos)
+      : _pSet(pSet)
+      , _pos(pos)
+      , _node(lemon::INVALID)
+    {
+      load();
+    }
+
+    /// Sets _node to the element at array index _pos, if any
+    void load()
+    {
+      if (_pos < _pSet->_size)
+        _node = _pSet->_pData[_pos];
+    }
+
+    const CompactNodeSet* _pSet;
+    int _pos;
+    Node _node;
+  };
+
+  typedef const_iterator iterator;
+
+  CompactNodeSet()
+    : _size(0)
+    , _capacity(INLINE_CAPACITY)
+    , _pData(_inline)
+  {
+  }
+
+  CompactNodeSet(const CompactNodeSet& other)
+    : _size(0)
+    , _capacity(INLINE_CAPACITY)
+    , _pData(_inline)
+  {
+    assign(other);
+  }
+
+  CompactNodeSet(CompactNodeSet&& other) noexcept
+    : _size(0)
+    , _capacity(INLINE_CAPACITY)
+    , _pData(_inline)
+  {
+    swap(other);
+  }
+
+  ~CompactNodeSet()
+  {
+    release();
+  }
+
+  CompactNodeSet& operator=(const CompactNodeSet& other)
+  {
+    if (this != &other)
+    {
+      clear();
+      assign(other);
+    }
+    return *this;
+  }
+
+  CompactNodeSet& operator=(CompactNodeSet&& other) noexcept
+  {
+    swap(other);
+    return *this;
+  }
+
+  void swap(CompactNodeSet& other)
+  {
+    // inline elements cannot be swapped by pointer
+    Node tmp[INLINE_CAPACITY];
+    std::copy(_inline, _inline + INLINE_CAPACITY, tmp);
+    std::copy(other._inline, other._inline + INLINE_CAPACITY, _inline);
+    std::copy(tmp, tmp + INLINE_CAPACITY, other._inline);
+
+    const bool thisInline = _pData == _inline;
+    const bool otherInline = other._pData == other._inline;
+    std::swap(_pData, other._pData);
+    if (otherInline)
+      _pData = _inline;
+    if (thisInline)
+      other._pData = other._inline;
+
+    std::swap(_size, other._size);
+    std::swap(_capacity, other._capacity);
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(this, 0);
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator(this, _size);
+  }
+
+  size_t size() const
+  {
+    return static_cast<size_t>(_size);
+  }
+
+  bool empty() const
+  {
+    return _size == 0;
+  }
+
+  void clear()
+  {
+    release();
+    _size = 0;
+  }
+
+  bool contains(Node node) const
+  {
+    const int id = Graph::id(node);
+    const int pos = lowerBound(id);
+    return pos < _size && Graph::id(_pData[pos]) == id;
+  }
+
+  size_t count(Node node) const
+  {
+    return contains(node) ? 1 : 0;
+  }
+
+  /// Inserts node, returns false if it was already present
+  bool insert(Node node)
+  {
+    const int id = Graph::id(node);
+    assert(id >= 0);
+
+    const int pos = lowerBound(id);
+    if (pos < _size && Graph::id(_pData[pos]) == id)
+      return false;
+
+    if (_size == _capacity)
+      grow(2 * _capacity);
+    insertAt(pos, node);
+    return true;
+  }
+
+  template<typename IT>
+  void insert(IT first, IT last)
+  {
+    for (; first != last; ++first)
+      insert(*first);
+  }
+
+  /// Inserts all nodes of other, linear unless the result fits inline
+  void insert(const CompactNodeSet& other)
+  {
+    if (other.empty() || this == &other)
+      return;
+
+    if (_size + other._size <= _capacity)
+    {
+      insert(other.begin(), other.end());
+      return;
+    }
+
+    // merge two sorted arrays into a fresh one
+    Node* pMerged = new Node[_size + other._size];
+    Node* pEnd = std::set_union(_pData, _pData + _size,
+                                other._pData, other._pData + other._size,
+                                pMerged, IdLess());
+    const int n = static_cast<int>(pEnd - pMerged);
+
+    release();
+    _pData = pMerged;
+    _capacity = _size + other._size;
+    _size = n;
+  }
+
+  /// Erases node, returns false if it was not present
+  bool erase(Node node)
+  {
+    const int id = Graph::id(node);
+    const int pos = lowerBound(id);
+    if (pos == _size || Graph::id(_pData[pos]) != id)
+      return false;
+
+    eraseAt(pos);
+    return true;
+  }
+
+  /// Erases the node at it, returns an iterator to the next node
+  const_iterator erase(const_iterator it)
+  {
+    assert(it._pSet == this && it._pos < _size);
+    eraseAt(it._pos);
+    return const_iterator(this, it._pos);
+  }
+
+  bool operator==(const CompactNodeSet& other) const
+  {
+    if (_size != other._size)
+      return false;
+
+    for (int i = 0; i < _size; ++i)
+    {
+      if (_pData[i] != other._pData[i])
+        return false;
+    }
+    return true;
+  }
+
+  bool operator!=(const CompactNodeSet& other) const
+  {
+    return !(*this == other);
+  }
+
+private:
+  struct IdLess
+  {
+    bool operator()(const Node& a, const Node& b) const
+    {
+      return Graph::id(a) < Graph::id(b);
+    }
+  };
+
+  int lowerBound(int id) const
+  {
+    int lo = 0, hi = _size;
+    while (lo < hi)
+    {
+      const int mid = (lo + hi) / 2;
+      if (Graph::id(_pData[mid]) < id)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return lo;
+  }
+
+  void eraseAt(int pos)
+  {
+    assert(pos < _size);
+    memmove(_pData + pos, _pData + pos + 1, (_size - pos - 1) * sizeof(Node));
+    --_size;
+  }
+
+  void insertAt(int pos, Node node)
+  {
+    assert(_size < _capacity);
+    memmove(_pData + pos + 1, _pData + pos, (_size - pos) * sizeof(Node));
+    _pData[pos] = node;
+    ++_size;
+  }
+
+  void grow(int capacity)
+  {
+    Node* pData = new Node[capacity];
+    std::copy(_pData, _pData + _size, pData);
+    if (_pData != _inline)
+      delete[] _pData;
+    _pData = pData;
+    _capacity = capacity;
+  }
+
+  void assign(const CompactNodeSet& other)
+  {
+    assert(_size == 0);
+    if (other._size > _capacity)
+      grow(other._size);
+    std::copy(other._pData, other._pData + other._size, _pData);
+    _size = other._size;
+  }
+
+  void release()
+  {
+    if (_pData != _inline)
+      delete[] _pData;
+    _pData = _inline;
+    _capacity = INLINE_CAPACITY;
+  }
+
+  int _size;
+  /// Capacity of _pData, which points to _inline or to the heap
+  int _capacity;
+  Node* _pData;
+  Node _inline[INLINE_CAPACITY];
+};
+
+} // namespace mwcs
+} // namespace nina
+
+#endif // COMPACTNODESET_H
@@ -0,0 +1,190 @@
+/*
+ * degreebuckets.h
+ *
+ *  Created on: 16-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef DEGREEBUCKETS_H
+#define DEGREEBUCKETS_H
+
+#include <assert.h>
+#include <vector>
+#include <lemon/core.h>
+
+namespace nina {
+namespace mwcs {
+
+/// Nodes bucketed by degree, used by the preprocessing rules
+///
+/// Every bucket is a doubly linked list threaded through arrays indexed by
+/// node id, hence inserting, erasing and moving a node between buckets take
+/// constant time and iterating over a bucket does not allocate.
+/// Within a bucket, the most recently inserted node comes first.
+/// Node ids are obtained with the static GR::id() and GR::nodeFromId().
+template<typename GR>
+class DegreeBuckets
+{
+public:
+  typedef GR Graph;
+  typedef typename Graph::Node Node;
+
+  /// Iterates over the nodes of one bucket, in the style of LEMON iterators
+  ///
+  /// Moving or erasing the current node invalidates the iterator.
+  class NodeIt : public Node
+  {
+  public:
+    NodeIt(lemon::Invalid)
+      : Node(lemon::INVALID)
+      , _pBuckets(NULL)
+    {
+    }
+
+    NodeIt(const DegreeBuckets& buckets, int d)
+      : Node(buckets.first(d))
+      , _pBuckets(&buckets)
+    {
+    }
+
+    NodeIt& operator++()
+    {
+      Node::operator=(_pBuckets->next(*this));
+      return *this;
+    }
+
+  private:
+    const DegreeBuckets* _pBuckets;
+  };
+
+  DegreeBuckets()
+    : _next()
+    , _prev()
+    , _bucket()
+    , _head()
+    , _size()
+  {
+  }
+
+  void clear()
+  {
+    _next.clear();
+    _prev.clear();
+    _bucket.clear();
+    _head.clear();
+    _size.clear();
+  }
+
+  /// Reserves space for nodes with ids up to maxNodeId
+  void reserve(int maxNodeId)
+  {
+    _next.reserve(maxNodeId + 1);
+    _prev.reserve(maxNodeId + 1);
+    _bucket.reserve(maxNodeId + 1);
+  }
+
+  /// Number of buckets, all degrees d >= bucketCount() have empty buckets
+  int bucketCount() const
+  {
+    return static_cast<int>(_head.size());
+  }
+
+  /// Number of nodes of degree d
+  int size(int d) const
+  {
+    return d < bucketCount() ? _size[d] : 0;
+  }
+
+  bool empty(int d) const
+  {
+    return size(d) == 0;
+  }
+
+  /// Returns whether v is in bucket d
+  bool contains(Node v, int d) const
+  {
+    const int id = Graph::id(v);
+    return id < static_cast<int>(_bucket.size()) && _bucket[id] == d;
+  }
+
+  /// Inserts v, which must not be present, into bucket d
+  void insert(Node v, int d)
+  {
+    const int id = Graph::id(v);
+    assert(id >= 0 && d >= 0);
+
+    if (id >= static_cast<int>(_bucket.size()))
+    {
+      _next.resize(id + 1, -1);
+      _prev.resize(id + 1, -1);
+      _bucket.resize(id + 1, -1);
+    }
+    assert(_bucket[id] == -1);
+
+    if (d >= bucketCount())
+    {
+      _head.resize(d + 1, -1);
+      _size.resize(d + 1, 0);
+    }
+
+    _bucket[id] = d;
+    _prev[id] = -1;
+    _next[id] = _head[d];
+    if (_head[d] != -1)
+      _prev[_head[d]] = id;
+    _head[d] = id;
+    ++_size[d];
+  }
+
+  /// Erases v, which must be present
+  void erase(Node v)
+  {
+    const int id = Graph::id(v);
+    assert(0 <= id && id < static_cast<int>(_bucket.size()) && _bucket[id] != -1);
+
+    const int d = _bucket[id];
+    if (_prev[id] != -1)
+      _next[_prev[id]] = _next[id];
+    else
+      _head[d] = _next[id];
+    if (_next[id] != -1)
+      _prev[_next[id]] = _prev[id];
+
+    _bucket[id] = -1;
+    --_size[d];
+  }
+
+  /// Moves v, which must be present, to bucket d
+  void move(Node v, int d)
+  {
+    erase(v);
+    insert(v, d);
+  }
+
+private:
+  Node first(int d) const
+  {
+    return d < bucketCount() && _head[d] != -1 ?
+      Graph::nodeFromId(_head[d]) : Node(lemon::INVALID);
+  }
+
+  Node next(Node v) const
+  {
+    const int id = _next[Graph::id(v)];
+    return id != -1 ? Graph::nodeFromId(id) : Node(lemon::INVALID);
+  }
+
+  /// Next and previous node in the same bucket, indexed by node id
+  std::vector<int> _next;
+  std::vector<int> _prev;
+  /// Bucket of every node, -1 if absent
+  std::vector<int> _bucket;
+  /// First node of every bucket
+  std::vector<int> _head;
+  std::vector<int> _size;
+};
+
+} // namespace mwcs
+} // namespace nina
+
+#endif // DEGREEBUCKETS_H
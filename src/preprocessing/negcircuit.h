@@ -28,9 +28,13 @@ public:
   typedef typename Parent::NodeMap NodeMap;
   typedef typename Parent::NodeSet NodeSet;
   typedef typename Parent::NodeSetIt NodeSetIt;
+  typedef typename Parent::CompactNodeSetType CompactNodeSetType;
+  typedef typename Parent::CompactNodeSetIt CompactNodeSetIt;
   typedef typename Parent::NodeSetMap NodeSetMap;
+  typedef typename Parent::ProvenanceForestType ProvenanceForestType;
   typedef typename Parent::DegreeNodeMap DegreeNodeMap;
-  typedef typename Parent::DegreeNodeSetVector DegreeNodeSetVector;
+  typedef typename Parent::DegreeNodeBuckets DegreeNodeBuckets;
+  typedef typename Parent::DegreeNodeIt DegreeNodeIt;
   typedef typename Parent::LabelNodeMap LabelNodeMap;
 
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
@@ -44,17 +48,18 @@ public:
                     const NodeSet& rootNodes,
                     LabelNodeMap& label,
                     WeightNodeMap& score,
-                    NodeSetMap& mapToPre,
-                    NodeSetMap& preOrigNodes,
+                    ProvenanceForestType& provenance,
                     NodeSetMap& neighbors,
                     int& nNodes,
                     int& nArcs,
                     int& nEdges,
                     DegreeNodeMap& degree,
-                    DegreeNodeSetVector& degreeVector,
+                    DegreeNodeBuckets& degreeBuckets,
                     double& LB);
 
   virtual std::string name() const { return "NegCircuit"; }
+
+  virtual Parent* clone() const { return new NegCircuit(*this); }
 };
 
 template<typename GR, typename WGHT>
@@ -68,27 +73,24 @@ inline int NegCircuit<GR, WGHT>::apply(Graph& g,
                                        const NodeSet& rootNodes,
                                        LabelNodeMap& label,
                                        WeightNodeMap& score,
-                                       NodeSetMap& mapToPre,
-                                       NodeSetMap& preOrigNodes,
+                                       ProvenanceForestType& provenance,
                                        NodeSetMap& neighbors,
                                        int& nNodes,
                                        int& nArcs,
                                        int& nEdges,
                                        DegreeNodeMap& degree,
-                                       DegreeNodeSetVector& degreeVector,
+                                       DegreeNodeBuckets& degreeBuckets,
                                        double& LB)
 {
-  if (degreeVector.size() <= 2)
+  if (degreeBuckets.empty(2))
   {
     // nothing to remove, there are no degree 2 nodes
     return 0;
   }
   
-  const NodeSet& nodes = degreeVector[2];
-  
-  for (NodeSetIt nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt)
+  for (DegreeNodeIt nodeIt(degreeBuckets, 2); nodeIt != lemon::INVALID; ++nodeIt)
   {
-    Node v = *nodeIt;
+    Node v = nodeIt;
     if (score[v] <= 0 && rootNodes.find(v) == rootNodes.end())
     {
       assert(degree[v] == 2);
@@ -97,12 +99,12 @@ inline int NegCircuit<GR, WGHT>::apply(Graph& g,
 
       Node u = g.oppositeNode(v, e1);
       Node w = g.oppositeNode(v, e2);
-      if (neighbors[u].find(w) != neighbors[u].end())
+      if (neighbors[u].contains(w))
       {
         remove(g,
-               mapToPre, preOrigNodes, neighbors,
+               provenance, neighbors,
                nNodes, nArcs, nEdges,
-               degree, degreeVector, v);
+               degree, degreeBuckets, v);
         return 1;
       }
     }
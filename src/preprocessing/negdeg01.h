@@ -28,14 +28,20 @@ public:
   typedef typename Parent::NodeMap NodeMap;
   typedef typename Parent::NodeSet NodeSet;
   typedef typename Parent::NodeSetIt NodeSetIt;
+  typedef typename Parent::CompactNodeSetType CompactNodeSetType;
+  typedef typename Parent::CompactNodeSetIt CompactNodeSetIt;
   typedef typename Parent::NodeSetMap NodeSetMap;
+  typedef typename Parent::ProvenanceForestType ProvenanceForestType;
   typedef typename Parent::DegreeNodeMap DegreeNodeMap;
-  typedef typename Parent::DegreeNodeSetVector DegreeNodeSetVector;
+  typedef typename Parent::DegreeNodeBuckets DegreeNodeBuckets;
+  typedef typename Parent::DegreeNodeIt DegreeNodeIt;
   typedef typename Parent::LabelNodeMap LabelNodeMap;
+  typedef typename Parent::NodeVector NodeVector;
 
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
 
   using Parent::remove;
+  using Parent::collectDirty;
 
   NegDeg01();
   virtual ~NegDeg01() {}
@@ -43,37 +49,27 @@ public:
                     const NodeSet& rootNodes,
                     LabelNodeMap& label,
                     WeightNodeMap& score,
-                    NodeSetMap& mapToPre,
-                    NodeSetMap& preOrigNodes,
+                    ProvenanceForestType& provenance,
                     NodeSetMap& neighbors,
                     int& nNodes,
                     int& nArcs,
                     int& nEdges,
                     DegreeNodeMap& degree,
-                    DegreeNodeSetVector& degreeVector,
+                    DegreeNodeBuckets& degreeBuckets,
                     double& LB);
 
   virtual std::string name() const { return "NegDeg01"; }
 
-protected:
-  int apply(Graph& g,
-            const NodeSet& rootNodes,
-            LabelNodeMap& label,
-            WeightNodeMap& score,
-            NodeSetMap& mapToPre,
-            NodeSetMap& preOrigNodes,
-            NodeSetMap& neighbors,
-            int& nNodes,
-            int& nArcs,
-            int& nEdges,
-            DegreeNodeMap& degree,
-            DegreeNodeSetVector& degreeVector,
-            int d);
+  virtual Parent* clone() const { return new NegDeg01(*this); }
+
+private:
+  NodeVector _dirty;
 };
 
 template<typename GR, typename WGHT>
 inline NegDeg01<GR, WGHT>::NegDeg01()
   : Parent()
+  , _dirty()
 {
 }
 
@@ -82,67 +78,34 @@ inline int NegDeg01<GR, WGHT>::apply(Graph& g,
                                      const NodeSet& rootNodes,
                                      LabelNodeMap& label,
                                      WeightNodeMap& score,
-                                     NodeSetMap& mapToPre,
-                                     NodeSetMap& preOrigNodes,
+                                     ProvenanceForestType& provenance,
                                      NodeSetMap& neighbors,
                                      int& nNodes,
                                      int& nArcs,
                                      int& nEdges,
                                      DegreeNodeMap& degree,
-                                     DegreeNodeSetVector& degreeVector,
+                                     DegreeNodeBuckets& degreeBuckets,
                                      double& LB)
 {
-  return apply(g, rootNodes,
-               label, score,
-               mapToPre, preOrigNodes, neighbors,
-               nNodes, nArcs, nEdges,
-               degree, degreeVector, 0)
-      + apply(g, rootNodes,
-              label, score,
-              mapToPre, preOrigNodes, neighbors,
-              nNodes, nArcs, nEdges,
-              degree, degreeVector, 1);
-}
-
-template<typename GR, typename WGHT>
-inline int NegDeg01<GR, WGHT>::apply(Graph& g,
-                                     const NodeSet& rootNodes,
-                                     LabelNodeMap& label,
-                                     WeightNodeMap& score,
-                                     NodeSetMap& mapToPre,
-                                     NodeSetMap& preOrigNodes,
-                                     NodeSetMap& neighbors,
-                                     int& nNodes,
-                                     int& nArcs,
-                                     int& nEdges,
-                                     DegreeNodeMap& degree,
-                                     DegreeNodeSetVector& degreeVector,
-                                     int d)
-{
-  if (static_cast<int>(degreeVector.size()) <= d)
-    return 0;
+  int res = 0;
 
-  const NodeSet& nodes = degreeVector[d];
-
-  for (NodeSetIt nodeIt = nodes.begin(); nodeIt != nodes.end();)
+  // only nodes whose degree or score changed can have become applicable,
+  // the neighbors of removed nodes are examined by the next invocation
+  collectDirty(g, _dirty);
+  for (size_t i = 0; i < _dirty.size(); ++i)
   {
-    NodeSetIt nextNodeIt = nodeIt;
-    nextNodeIt++;
-    
-    Node v = *nodeIt;
-    // remove if negative and not the root node
-    if (score[v] < 0 && rootNodes.find(v) == rootNodes.end())
+    Node v = _dirty[i];
+    // remove if of degree 0 or 1, negative and not the root node
+    if (degree[v] <= 1 && score[v] < 0 && rootNodes.find(v) == rootNodes.end())
     {
-      remove(g, mapToPre, preOrigNodes, neighbors,
+      remove(g, provenance, neighbors,
              nNodes, nArcs, nEdges,
-             degree, degreeVector, v);
-      return 1;
+             degree, degreeBuckets, v);
+      ++res;
     }
-
-    nodeIt = nextNodeIt;
   }
 
-  return 0;
+  return res;
 }
 
 } // namespace mwcs
@@ -28,9 +28,13 @@ public:
   typedef typename Parent::NodeMap NodeMap;
   typedef typename Parent::NodeSet NodeSet;
   typedef typename Parent::NodeSetIt NodeSetIt;
+  typedef typename Parent::CompactNodeSetType CompactNodeSetType;
+  typedef typename Parent::CompactNodeSetIt CompactNodeSetIt;
   typedef typename Parent::NodeSetMap NodeSetMap;
+  typedef typename Parent::ProvenanceForestType ProvenanceForestType;
   typedef typename Parent::DegreeNodeMap DegreeNodeMap;
-  typedef typename Parent::DegreeNodeSetVector DegreeNodeSetVector;
+  typedef typename Parent::DegreeNodeBuckets DegreeNodeBuckets;
+  typedef typename Parent::DegreeNodeIt DegreeNodeIt;
   typedef typename Parent::LabelNodeMap LabelNodeMap;
 
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
@@ -44,17 +48,18 @@ public:
                     const NodeSet& rootNodes,
                     LabelNodeMap& label,
                     WeightNodeMap& score,
-                    NodeSetMap& mapToPre,
-                    NodeSetMap& preOrigNodes,
+                    ProvenanceForestType& provenance,
                     NodeSetMap& neighbors,
                     int& nNodes,
                     int& nArcs,
                     int& nEdges,
                     DegreeNodeMap& degree,
-                    DegreeNodeSetVector& degreeVector,
+                    DegreeNodeBuckets& degreeBuckets,
                     double& LB);
 
   virtual std::string name() const { return "NegDiamond"; }
+
+  virtual Parent* clone() const { return new NegDiamond(*this); }
 };
 
 template<typename GR, typename WGHT>
@@ -68,14 +73,13 @@ inline int NegDiamond<GR, WGHT>::apply(Graph& g,
                                        const NodeSet& rootNodes,
                                        LabelNodeMap& label,
                                        WeightNodeMap& score,
-                                       NodeSetMap& mapToPre,
-                                       NodeSetMap& preOrigNodes,
+                                       ProvenanceForestType& provenance,
                                        NodeSetMap& neighbors,
                                        int& nNodes,
                                        int& nArcs,
                                        int& nEdges,
                                        DegreeNodeMap& degree,
-                                       DegreeNodeSetVector& degreeVector,
+                                       DegreeNodeBuckets& degreeBuckets,
                                        double& LB)
 {
   typedef std::pair<double, Node> WeightNodePair;
@@ -89,16 +93,15 @@ inline int NegDiamond<GR, WGHT>::apply(Graph& g,
   NodePairMap map;
   NodePairMap posMap;
 
-  if (degreeVector.size() <= 2)
+  if (degreeBuckets.empty(2))
   {
     // nothing to remove, there are no degree 2 nodes
     return 0;
   }
   
-  const NodeSet& nodes = degreeVector[2];
-  for (NodeSetIt nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt)
+  for (DegreeNodeIt nodeIt(degreeBuckets, 2); nodeIt != lemon::INVALID; ++nodeIt)
   {
-    Node v = *nodeIt;
+    Node v = nodeIt;
     
     assert(degree[v] == 2);
     Edge e1 = IncEdgeIt(g, v);
@@ -143,9 +146,9 @@ inline int NegDiamond<GR, WGHT>::apply(Graph& g,
       
       if (rootNodes.find(v) == rootNodes.end())
       {
-        remove(g, mapToPre, preOrigNodes, neighbors,
+        remove(g, provenance, neighbors,
                nNodes, nArcs, nEdges,
-               degree, degreeVector, it->second);
+               degree, degreeBuckets, it->second);
         ++res;
       }
     }
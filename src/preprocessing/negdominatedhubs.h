@@ -24,9 +24,13 @@ namespace nina {
       typedef typename Parent::NodeMap NodeMap;
       typedef typename Parent::NodeSet NodeSet;
       typedef typename Parent::NodeSetIt NodeSetIt;
+      typedef typename Parent::CompactNodeSetType CompactNodeSetType;
+      typedef typename Parent::CompactNodeSetIt CompactNodeSetIt;
       typedef typename Parent::NodeSetMap NodeSetMap;
+      typedef typename Parent::ProvenanceForestType ProvenanceForestType;
       typedef typename Parent::DegreeNodeMap DegreeNodeMap;
-      typedef typename Parent::DegreeNodeSetVector DegreeNodeSetVector;
+      typedef typename Parent::DegreeNodeBuckets DegreeNodeBuckets;
+      typedef typename Parent::DegreeNodeIt DegreeNodeIt;
       typedef typename Parent::LabelNodeMap LabelNodeMap;
       
       TEMPLATE_GRAPH_TYPEDEFS(Graph);
@@ -40,17 +44,18 @@ namespace nina {
                         const NodeSet& rootNodes,
                         LabelNodeMap& label,
                         WeightNodeMap& score,
-                        NodeSetMap& mapToPre,
-                        NodeSetMap& preOrigNodes,
+                        ProvenanceForestType& provenance,
                         NodeSetMap& neighbors,
                         int& nNodes,
                         int& nArcs,
                         int& nEdges,
                         DegreeNodeMap& degree,
-                        DegreeNodeSetVector& degreeVector,
+                        DegreeNodeBuckets& degreeBuckets,
                         double& LB);
       
       virtual std::string name() const { return "NegDominatedHubs"; }
+      
+      virtual Parent* clone() const { return new NegDominatedHubs(*this); }
     };
     
     template<typename GR, typename WGHT>
@@ -64,14 +69,13 @@ namespace nina {
                                                   const NodeSet& rootNodes,
                                                   LabelNodeMap& label,
                                                   WeightNodeMap& score,
-                                                  NodeSetMap& mapToPre,
-                                                  NodeSetMap& preOrigNodes,
+                                                  ProvenanceForestType& provenance,
                                                   NodeSetMap& neighbors,
                                                   int& nNodes,
                                                   int& nArcs,
                                                   int& nEdges,
                                                   DegreeNodeMap& degree,
-                                                  DegreeNodeSetVector& degreeVector,
+                                                  DegreeNodeBuckets& degreeBuckets,
                                                   double& LB)
     {
       NodeSet negHubsToRemove;
@@ -86,7 +90,8 @@ namespace nina {
           if (degree[u] > degree[v]) continue;
           
           // now check subset:
-          const NodeSet& neighbors_u = neighbors[u], neighbors_v = neighbors[v];
+          const CompactNodeSetType& neighbors_u = neighbors[u];
+          const CompactNodeSetType& neighbors_v = neighbors[v];
           if (std::includes(neighbors_v.begin(), neighbors_v.end(),
                             neighbors_u.begin(), neighbors_u.end()))
             negHubsToRemove.insert(u);
@@ -104,9 +109,9 @@ namespace nina {
         Node v = *nodeIt;
         
         assert(rootNodes.find(v) == rootNodes.end());
-        remove(g, mapToPre, preOrigNodes, neighbors,
+        remove(g, provenance, neighbors,
                nNodes, nArcs, nEdges,
-               degree, degreeVector, v);
+               degree, degreeBuckets, v);
       }
       
       return static_cast<int>(negHubsToRemove.size());
@@ -28,15 +28,21 @@ public:
   typedef typename Parent::NodeMap NodeMap;
   typedef typename Parent::NodeSet NodeSet;
   typedef typename Parent::NodeSetIt NodeSetIt;
+  typedef typename Parent::CompactNodeSetType CompactNodeSetType;
+  typedef typename Parent::CompactNodeSetIt CompactNodeSetIt;
   typedef typename Parent::NodeSetMap NodeSetMap;
+  typedef typename Parent::ProvenanceForestType ProvenanceForestType;
   typedef typename Parent::DegreeNodeMap DegreeNodeMap;
-  typedef typename Parent::DegreeNodeSetVector DegreeNodeSetVector;
+  typedef typename Parent::DegreeNodeBuckets DegreeNodeBuckets;
+  typedef typename Parent::DegreeNodeIt DegreeNodeIt;
   typedef typename Parent::LabelNodeMap LabelNodeMap;
+  typedef typename Parent::NodeVector NodeVector;
 
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
 
   using Parent::remove;
   using Parent::merge;
+  using Parent::collectDirty;
 
   NegEdge();
   virtual ~NegEdge() {}
@@ -44,22 +50,27 @@ public:
                     const NodeSet& rootNodes,
                     LabelNodeMap& label,
                     WeightNodeMap& score,
-                    NodeSetMap& mapToPre,
-                    NodeSetMap& preOrigNodes,
+                    ProvenanceForestType& provenance,
                     NodeSetMap& neighbors,
                     int& nNodes,
                     int& nArcs,
                     int& nEdges,
                     DegreeNodeMap& degree,
-                    DegreeNodeSetVector& degreeVector,
+                    DegreeNodeBuckets& degreeBuckets,
                     double& LB);
 
   virtual std::string name() const { return "NegEdge"; }
+
+  virtual Parent* clone() const { return new NegEdge(*this); }
+
+private:
+  NodeVector _dirty;
 };
 
 template<typename GR, typename WGHT>
 inline NegEdge<GR, WGHT>::NegEdge()
   : Parent()
+  , _dirty()
 {
 }
 
@@ -68,42 +79,51 @@ inline int NegEdge<GR, WGHT>::apply(Graph& g,
                                     const NodeSet& rootNodes,
                                     LabelNodeMap& label,
                                     WeightNodeMap& score,
-                                    NodeSetMap& mapToPre,
-                                    NodeSetMap& preOrigNodes,
+                                    ProvenanceForestType& provenance,
                                     NodeSetMap& neighbors,
                                     int& nNodes,
                                     int& nArcs,
                                     int& nEdges,
                                     DegreeNodeMap& degree,
-                                    DegreeNodeSetVector& degreeVector,
+                                    DegreeNodeBuckets& degreeBuckets,
                                     double& LB)
 {
   int res = 0;
 
-  for (EdgeIt e(g); e != lemon::INVALID; ++e)
+  // an edge can only have become applicable if one of its end points
+  // changed, the merged node is examined by the next invocation
+  collectDirty(g, _dirty);
+  for (size_t i = 0; i < _dirty.size(); ++i)
   {
-    Node u = g.u(e);
-    Node v = g.v(e);
+    Node u = _dirty[i];
+    // u may have been merged into another node by now
+    if (!g.valid(u) || score[u] > 0 || degree[u] != 2)
+      continue;
 
-    if (score[u] <= 0 && score[v] <= 0 && degree[u] == 2 && degree[v] == 2)
+    for (IncEdgeIt e(g, u); e != lemon::INVALID; ++e)
     {
+      Node v = g.oppositeNode(u, e);
+      if (score[v] > 0 || degree[v] != 2)
+        continue;
+
       // don't merge if both u and v are root nodes
       // otherwise ensure that root node is kept
       if (rootNodes.find(u) == rootNodes.end() && rootNodes.find(v) == rootNodes.end())
       {
         res++;
         merge(g, label, score,
-              mapToPre, preOrigNodes, neighbors,
+              provenance, neighbors,
               nNodes, nArcs, nEdges,
-              degree, degreeVector, u, v, LB);
+              degree, degreeBuckets, u, v, LB);
+        break;
       }
 //      else if (rootNodes.find(u) != rootNodes.end() && rootNodes.find(v) == rootNodes.end())
 //      {
 //        res++;
 //        merge(g, arcLookUp, label, score,
-//              mapToPre, preOrigNodes, neighbors,
+//              provenance, neighbors,
 //              nNodes, nArcs, nEdges,
-//              degree, degreeVector, v, u, LB);
+//              degree, degreeBuckets, v, u, LB);
 //      }
     }
   }
@@ -8,6 +8,10 @@
 #ifndef NEGMIRROREDHUBS_H
 #define NEGMIRROREDHUBS_H
 
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include <unordered_map>
 #include "rule.h"
 
 namespace nina {
@@ -24,15 +28,23 @@ namespace nina {
       typedef typename Parent::NodeMap NodeMap;
       typedef typename Parent::NodeSet NodeSet;
       typedef typename Parent::NodeSetIt NodeSetIt;
+      typedef typename Parent::CompactNodeSetType CompactNodeSetType;
+      typedef typename Parent::CompactNodeSetIt CompactNodeSetIt;
       typedef typename Parent::NodeSetMap NodeSetMap;
+      typedef typename Parent::ProvenanceForestType ProvenanceForestType;
       typedef typename Parent::DegreeNodeMap DegreeNodeMap;
-      typedef typename Parent::DegreeNodeSetVector DegreeNodeSetVector;
+      typedef typename Parent::DegreeNodeBuckets DegreeNodeBuckets;
+      typedef typename Parent::DegreeNodeIt DegreeNodeIt;
       typedef typename Parent::LabelNodeMap LabelNodeMap;
+      typedef typename Parent::NodeVector NodeVector;
+      typedef typename Parent::ChangeLogType ChangeLogType;
       
       TEMPLATE_GRAPH_TYPEDEFS(Graph);
       
       using Parent::remove;
       using Parent::merge;
+      using Parent::collectDirty;
+      using Parent::_pLog;
       
       NegMirroredHubs();
       virtual ~NegMirroredHubs() {}
@@ -40,22 +52,123 @@ namespace nina {
                         const NodeSet& rootNodes,
                         LabelNodeMap& label,
                         WeightNodeMap& score,
-                        NodeSetMap& mapToPre,
-                        NodeSetMap& preOrigNodes,
+                        ProvenanceForestType& provenance,
                         NodeSetMap& neighbors,
                         int& nNodes,
                         int& nArcs,
                         int& nEdges,
                         DegreeNodeMap& degree,
-                        DegreeNodeSetVector& degreeVector,
+                        DegreeNodeBuckets& degreeBuckets,
                         double& LB);
       
       virtual std::string name() const { return "NegMirroredHubs"; }
+      
+      virtual Parent* clone() const { return new NegMirroredHubs(*this); }
+      
+      virtual void init(ChangeLogType* pLog)
+      {
+        Parent::init(pLog);
+        clearIndex();
+      }
+      
+    private:
+      typedef std::unordered_map<uint64_t, NodeVector> SignatureMap;
+      typedef typename SignatureMap::iterator SignatureMapIt;
+      
+      NodeVector _dirty;
+      /// Nodes that may be removed (score <= 0, degree >= 3) by the
+      /// signature of their neighbors; removed nodes are dropped lazily
+      SignatureMap _index;
+      /// Signature of every indexed node id
+      std::vector<uint64_t> _signature;
+      /// Whether every node id is indexed
+      std::vector<bool> _indexed;
+      
+      void clearIndex()
+      {
+        _index.clear();
+        _signature.clear();
+        _indexed.clear();
+      }
+      
+      static uint64_t mix(uint64_t h)
+      {
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+      }
+      
+      /// Hash of the (sorted) neighbors of a node
+      static uint64_t signature(const CompactNodeSetType& neighbors)
+      {
+        uint64_t h = mix(neighbors.size());
+        for (CompactNodeSetIt it = neighbors.begin(); it != neighbors.end(); ++it)
+        {
+          h = mix(h + static_cast<uint64_t>(Graph::id(*it)));
+        }
+        return h;
+      }
+      
+      void unindex(int id)
+      {
+        if (id >= static_cast<int>(_indexed.size()) || !_indexed[id])
+          return;
+        
+        NodeVector& bucket = _index[_signature[id]];
+        for (size_t i = 0; i < bucket.size(); ++i)
+        {
+          if (Graph::id(bucket[i]) == id)
+          {
+            bucket[i] = bucket.back();
+            bucket.pop_back();
+            break;
+          }
+        }
+        if (bucket.empty())
+          _index.erase(_signature[id]);
+        
+        _indexed[id] = false;
+      }
+      
+      void reindex(Node v,
+                   const WeightNodeMap& score,
+                   const NodeSetMap& neighbors,
+                   const DegreeNodeMap& degree)
+      {
+        const int id = Graph::id(v);
+        if (id >= static_cast<int>(_indexed.size()))
+        {
+          _indexed.resize(id + 1, false);
+          _signature.resize(id + 1, 0);
+        }
+        
+        if (score[v] > 0 || degree[v] < 3)
+        {
+          unindex(id);
+          return;
+        }
+        
+        const uint64_t h = signature(neighbors[v]);
+        if (_indexed[id] && _signature[id] == h)
+          return;
+        
+        unindex(id);
+        _index[h].push_back(v);
+        _signature[id] = h;
+        _indexed[id] = true;
+      }
     };
     
     template<typename GR, typename WGHT>
     inline NegMirroredHubs<GR, WGHT>::NegMirroredHubs()
     : Parent()
+    , _dirty()
+    , _index()
+    , _signature()
+    , _indexed()
     {
     }
     
@@ -64,52 +177,61 @@ namespace nina {
                                                 const NodeSet& rootNodes,
                                                 LabelNodeMap& label,
                                                 WeightNodeMap& score,
-                                                NodeSetMap& mapToPre,
-                                                NodeSetMap& preOrigNodes,
+                                                ProvenanceForestType& provenance,
                                                 NodeSetMap& neighbors,
                                                 int& nNodes,
                                                 int& nArcs,
                                                 int& nEdges,
                                                 DegreeNodeMap& degree,
-                                                DegreeNodeSetVector& degreeVector,
+                                                DegreeNodeBuckets& degreeBuckets,
                                                 double& LB)
     {
-      typedef std::pair<double, Node> WeightNodePair;
-      typedef std::set<WeightNodePair> WeightNodePairSet;
-      typedef typename WeightNodePairSet::const_iterator WeightNodePairSetIt;
+      // mirrors have the same neighbors, hence the same signature; nodes
+      // are indexed by their signature and a set of mirrors can only have
+      // changed if one of its nodes changed. Without a log all nodes are
+      // examined and the index is rebuilt
+      collectDirty(g, _dirty);
+      if (!_pLog)
+        clearIndex();
       
-      typedef std::pair<Node, Node> NodePair;
-      typedef std::map<NodePair, WeightNodePairSet> NodePairMap;
-      typedef typename NodePairMap::const_iterator NodePairMapIt;
+      for (size_t i = 0; i < _dirty.size(); ++i)
+      {
+        reindex(_dirty[i], score, neighbors, degree);
+      }
       
       NodeSet negHubsToRemove;
-      for (size_t d = 3; d < degreeVector.size(); ++d)
+      for (size_t i = 0; i < _dirty.size(); ++i)
       {
-        const NodeSet& nodes = degreeVector[d];
-        if (nodes.size() > 1000) continue;
-        for (NodeSetIt nodeIt1 = nodes.begin(); nodeIt1 != nodes.end(); ++nodeIt1)
+        Node u = _dirty[i];
+        const int id = Graph::id(u);
+        if (!_indexed[id] || negHubsToRemove.find(u) != negHubsToRemove.end())
+          continue;
+        
+        // all mirrors but the one of maximum score need to go
+        const CompactNodeSetType& neighbors_u = neighbors[u];
+        const NodeVector& bucket = _index[_signature[id]];
+        Node keep = u;
+        bool mirrored = false;
+        for (size_t j = 0; j < bucket.size(); ++j)
         {
-          Node u = *nodeIt1;
-          if (score[u] > 0) continue;
-          
-          const NodeSet& neighbors_u = neighbors[u];
+          Node v = bucket[j];
+          if (u == v || !g.valid(v)) continue;
+          if (degree[v] != degree[u]) continue;
           
-          for (NodeSetIt nodeIt2 = nodeIt1; nodeIt2 != nodes.end(); ++nodeIt2)
+          if (neighbors_u == neighbors[v])
           {
-            Node v = *nodeIt2;
-            if (u == v) continue;
-            if (score[v] > 0) continue; // we could also comment this out
-            
-            if (neighbors_u == neighbors[v])
-            {
-              // either u or v needs to go
-              if (score[u] < score[v])
-                negHubsToRemove.insert(u);
-              else
-                negHubsToRemove.insert(v);
-            }
+            mirrored = true;
+            negHubsToRemove.insert(v);
+            if (score[keep] < score[v] || (score[keep] == score[v] && v < keep))
+              keep = v;
           }
         }
+        
+        if (mirrored)
+        {
+          negHubsToRemove.insert(u);
+          negHubsToRemove.erase(keep);
+        }
       }
       
       for (NodeSetIt nodeIt = rootNodes.begin(); nodeIt != rootNodes.end(); ++nodeIt)
@@ -124,9 +246,10 @@ namespace nina {
         Node v = *nodeIt;
         
         assert(rootNodes.find(v) == rootNodes.end());
-        remove(g, mapToPre, preOrigNodes, neighbors,
+        unindex(Graph::id(v));
+        remove(g, provenance, neighbors,
                nNodes, nArcs, nEdges,
-               degree, degreeVector, v);
+               degree, degreeBuckets, v);
       }
       
       return static_cast<int>(negHubsToRemove.size());
@@ -12,6 +12,8 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <limits>
+#include <algorithm>
 #include "rule.h"
 
 namespace nina {
@@ -28,16 +30,23 @@ public:
   typedef typename Parent::NodeMap NodeMap;
   typedef typename Parent::NodeSet NodeSet;
   typedef typename Parent::NodeSetIt NodeSetIt;
+  typedef typename Parent::CompactNodeSetType CompactNodeSetType;
+  typedef typename Parent::CompactNodeSetIt CompactNodeSetIt;
   typedef typename Parent::NodeSetMap NodeSetMap;
+  typedef typename Parent::ProvenanceForestType ProvenanceForestType;
   typedef typename Parent::DegreeNodeMap DegreeNodeMap;
-  typedef typename Parent::DegreeNodeSetVector DegreeNodeSetVector;
+  typedef typename Parent::DegreeNodeBuckets DegreeNodeBuckets;
+  typedef typename Parent::DegreeNodeIt DegreeNodeIt;
   typedef typename Parent::LabelNodeMap LabelNodeMap;
+  typedef typename Parent::NodeVector NodeVector;
+  typedef typename Parent::ChangeLogType ChangeLogType;
 
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
 
   using Parent::remove;
   using Parent::merge;
   using Parent::extract;
+  using Parent::collectDirty;
 
   PosDeg01();
   virtual ~PosDeg01() {}
@@ -45,22 +54,36 @@ public:
                     const NodeSet& rootNodes,
                     LabelNodeMap& label,
                     WeightNodeMap& score,
-                    NodeSetMap& mapToPre,
-                    NodeSetMap& preOrigNodes,
+                    ProvenanceForestType& provenance,
                     NodeSetMap& neighbors,
                     int& nNodes,
                     int& nArcs,
                     int& nEdges,
                     DegreeNodeMap& degree,
-                    DegreeNodeSetVector& degreeVector,
+                    DegreeNodeBuckets& degreeBuckets,
                     double& LB);
 
   virtual std::string name() const { return "PosDeg01"; }
+
+  virtual Parent* clone() const { return new PosDeg01(*this); }
+
+  virtual void init(ChangeLogType* pLog)
+  {
+    Parent::init(pLog);
+    _LB = -std::numeric_limits<double>::max();
+  }
+
+private:
+  NodeVector _dirty;
+  /// Value of LB at the previous invocation
+  double _LB;
 };
 
 template<typename GR, typename WGHT>
 inline PosDeg01<GR, WGHT>::PosDeg01()
   : Parent()
+  , _dirty()
+  , _LB(-std::numeric_limits<double>::max())
 {
 }
 
@@ -69,71 +92,73 @@ inline int PosDeg01<GR, WGHT>::apply(Graph& g,
                                      const NodeSet& rootNodes,
                                      LabelNodeMap& label,
                                      WeightNodeMap& score,
-                                     NodeSetMap& mapToPre,
-                                     NodeSetMap& preOrigNodes,
+                                     ProvenanceForestType& provenance,
                                      NodeSetMap& neighbors,
                                      int& nNodes,
                                      int& nArcs,
                                      int& nEdges,
                                      DegreeNodeMap& degree,
-                                     DegreeNodeSetVector& degreeVector,
+                                     DegreeNodeBuckets& degreeBuckets,
                                      double& LB)
 {
-  if (degreeVector.size() == 0)
-  {
-    // nothing to remove, there are no degree 0 nodes
-    return 0;
-  }
+  int res = 0;
   
-  // positive deg 0 nodes smaller than LB are to be removed
-  const NodeSet& nodes0 = degreeVector[0];
-  for (NodeSetIt nodeIt = nodes0.begin(); nodeIt != nodes0.end(); ++nodeIt)
+  // only nodes whose degree or score changed can have become applicable,
+  // unless LB has increased: then all positive deg 0 nodes are examined
+  collectDirty(g, _dirty);
+  if (_LB < LB)
   {
-    Node v = *nodeIt;
-    if (0 <= score[v] && score[v] < LB && rootNodes.find(v) == rootNodes.end())
+    for (DegreeNodeIt nodeIt(degreeBuckets, 0); nodeIt != lemon::INVALID; ++nodeIt)
     {
-      assert(IncEdgeIt(g, v) == lemon::INVALID);
-      remove(g, mapToPre, preOrigNodes, neighbors,
-             nNodes, nArcs, nEdges,
-             degree, degreeVector, v);
-      return 1;
+      _dirty.push_back(nodeIt);
     }
+    std::sort(_dirty.begin(), _dirty.end());
+    _dirty.erase(std::unique(_dirty.begin(), _dirty.end()), _dirty.end());
   }
+  _LB = LB;
   
-  if (degreeVector.size() <= 1)
+  for (size_t i = 0; i < _dirty.size(); ++i)
   {
-    // nothing to remove, there are no degree 1 nodes
-    return 0;
-  }
-  
-  const NodeSet& nodes1 = degreeVector[1];
-  for (NodeSetIt nodeIt = nodes1.begin(); nodeIt != nodes1.end(); ++nodeIt)
-  {
-    Node v = *nodeIt;
+    Node v = _dirty[i];
+    
+    // v may have been merged into another node by now
+    if (!g.valid(v) || score[v] < 0 || rootNodes.find(v) != rootNodes.end())
+      continue;
     
-    if (score[v] >= 0 && rootNodes.find(v) == rootNodes.end())
+    if (degree[v] == 0)
+    {
+      // positive deg 0 nodes smaller than LB are to be removed
+      if (score[v] < LB)
+      {
+        assert(IncEdgeIt(g, v) == lemon::INVALID);
+        remove(g, provenance, neighbors,
+               nNodes, nArcs, nEdges,
+               degree, degreeBuckets, v);
+        ++res;
+      }
+    }
+    else if (degree[v] == 1)
     {
       if (score[v] >= LB && rootNodes.empty())
       {
         extract(g, label, score,
-                mapToPre, preOrigNodes, neighbors,
+                provenance, neighbors,
                 nNodes, nArcs, nEdges,
-                degree, degreeVector, v);
+                degree, degreeBuckets, v);
       }
-        
+      
       Node u = g.oppositeNode(v, IncEdgeIt(g, v));
       
       // u may be a root node, that's why we should keep it!
       merge(g, label, score,
-            mapToPre, preOrigNodes, neighbors,
+            provenance, neighbors,
             nNodes, nArcs, nEdges,
-            degree, degreeVector, v, u, LB);
-
-      return 1;
+            degree, degreeBuckets, v, u, LB);
+      ++res;
     }
   }
 
-  return 0;
+  return res;
 }
 
 } // namespace mwcs
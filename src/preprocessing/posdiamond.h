@@ -28,15 +28,21 @@ public:
   typedef typename Parent::NodeMap NodeMap;
   typedef typename Parent::NodeSet NodeSet;
   typedef typename Parent::NodeSetIt NodeSetIt;
+  typedef typename Parent::CompactNodeSetType CompactNodeSetType;
+  typedef typename Parent::CompactNodeSetIt CompactNodeSetIt;
   typedef typename Parent::NodeSetMap NodeSetMap;
+  typedef typename Parent::ProvenanceForestType ProvenanceForestType;
   typedef typename Parent::DegreeNodeMap DegreeNodeMap;
-  typedef typename Parent::DegreeNodeSetVector DegreeNodeSetVector;
+  typedef typename Parent::DegreeNodeBuckets DegreeNodeBuckets;
+  typedef typename Parent::DegreeNodeIt DegreeNodeIt;
   typedef typename Parent::LabelNodeMap LabelNodeMap;
+  typedef typename Parent::NodeVector NodeVector;
 
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
 
   using Parent::remove;
   using Parent::merge;
+  using Parent::collectDirty;
 
   PosDiamond();
   virtual ~PosDiamond() {}
@@ -44,22 +50,39 @@ public:
                     const NodeSet& rootNodes,
                     LabelNodeMap& label,
                     WeightNodeMap& score,
-                    NodeSetMap& mapToPre,
-                    NodeSetMap& preOrigNodes,
+                    ProvenanceForestType& provenance,
                     NodeSetMap& neighbors,
                     int& nNodes,
                     int& nArcs,
                     int& nEdges,
                     DegreeNodeMap& degree,
-                    DegreeNodeSetVector& degreeVector,
+                    DegreeNodeBuckets& degreeBuckets,
                     double& LB);
 
   virtual std::string name() const { return "PosDiamond"; }
+
+  virtual Parent* clone() const { return new PosDiamond(*this); }
+
+private:
+  typedef std::pair<Node, Node> NodePair;
+  typedef std::set<NodePair> NodePairSet;
+  typedef typename NodePairSet::const_iterator NodePairSetIt;
+
+  NodeVector _dirty;
+
+  /// Adds the pair of neighbors of v if v is a positive degree 2 node
+  /// with non-positive neighbors
+  static void addPair(const Graph& g,
+                      const WeightNodeMap& score,
+                      const DegreeNodeMap& degree,
+                      Node v,
+                      NodePairSet& pairs);
 };
 
 template<typename GR, typename WGHT>
 inline PosDiamond<GR, WGHT>::PosDiamond()
   : Parent()
+  , _dirty()
 {
 }
 
@@ -68,94 +91,69 @@ inline int PosDiamond<GR, WGHT>::apply(Graph& g,
                                        const NodeSet& rootNodes,
                                        LabelNodeMap& label,
                                        WeightNodeMap& score,
-                                       NodeSetMap& mapToPre,
-                                       NodeSetMap& preOrigNodes,
+                                       ProvenanceForestType& provenance,
                                        NodeSetMap& neighbors,
                                        int& nNodes,
                                        int& nArcs,
                                        int& nEdges,
                                        DegreeNodeMap& degree,
-                                       DegreeNodeSetVector& degreeVector,
+                                       DegreeNodeBuckets& degreeBuckets,
                                        double& LB)
 {
-  typedef std::pair<double, Node> WeightNodePair;
-  typedef std::set<WeightNodePair> WeightNodePairSet;
-  typedef typename WeightNodePairSet::const_iterator WeightNodePairSetIt;
-  
-  typedef std::pair<Node, Node> NodePair;
-  typedef std::map<NodePair, WeightNodePairSet> NodePairMap;
-  typedef typename NodePairMap::const_iterator NodePairMapIt;
-
-  if (degreeVector.size() <= 2)
+  if (degreeBuckets.empty(2))
   {
     // nothing to remove, there are no degree 2 nodes
     return 0;
   }
   
-  NodePairMap posMap;
-  const NodeSet& nodes = degreeVector[2];
-  for (NodeSetIt nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt)
+  // a pair u, w of non-positive nodes is applicable if all neighbors of
+  // both are positive degree 2 nodes adjacent to u and w. This can only
+  // have changed if u, w or one of their neighbors changed, hence we
+  // examine the pairs of the positive degree 2 nodes in the dirty nodes
+  // and their neighbors
+  collectDirty(g, _dirty);
+  NodePairSet pairs;
+  for (size_t i = 0; i < _dirty.size(); ++i)
   {
-    Node v = *nodeIt;
-    
-    assert(degree[v] == 2);
-    Edge e1 = IncEdgeIt(g, v);
-    Edge e2 = ++IncEdgeIt(g, v);
-    
-    Node u = g.oppositeNode(v, e1);
-    Node w = g.oppositeNode(v, e2);
-    if (score[v] >= 0 && score[u] <= 0 && score[w] <= 0)
+    Node x = _dirty[i];
+    addPair(g, score, degree, x, pairs);
+    for (IncEdgeIt e(g, x); e != lemon::INVALID; ++e)
     {
-      if (u < w)
-      {
-        posMap[std::make_pair(u, w)].insert(std::make_pair(score[v], v));
-      }
-      else
-      {
-        posMap[std::make_pair(w, u)].insert(std::make_pair(score[v], v));
-      }
+      addPair(g, score, degree, g.oppositeNode(x, e), pairs);
     }
   }
   
   int res = 0;
-  for (NodePairMapIt it = posMap.begin(); it != posMap.end(); ++it)
+  for (NodePairSetIt it = pairs.begin(); it != pairs.end(); ++it)
   {
-    const WeightNodePairSet& set = it->second;
-    Node u = it->first.first;
-    Node w = it->first.second;
+    Node u = it->first;
+    Node w = it->second;
+    
+    // an earlier removal may have invalidated the pair
+    if (!g.valid(u) || !g.valid(w) || degree[u] == 0 || degree[u] != degree[w])
+      continue;
     
-    int set_size = static_cast<int>(set.size());
-//    if (degree[u] == set_size && degree[w] != set_size
-//        && rootNodes.find(u) == rootNodes.end())
-//    {
-//      remove(g, comp, mapToPre, preOrigNodes, neighbors,
-//             nNodes, nArcs, nEdges, nComponents,
-//             degree, degreeVector, u);
-//      ++res;
-//    }
-//    else if (degree[u] != set_size && degree[w] == set_size
-//             && rootNodes.find(w) == rootNodes.end())
-//    {
-//      remove(g, comp, mapToPre, preOrigNodes, neighbors,
-//             nNodes, nArcs, nEdges, nComponents,
-//             degree, degreeVector, w);
-//      ++res;
-//    }
-//    else
-    if (degree[u] == set_size && degree[w] == set_size)
+    bool mirrored = true;
+    for (IncEdgeIt e(g, u); mirrored && e != lemon::INVALID; ++e)
+    {
+      Node v = g.oppositeNode(u, e);
+      mirrored = degree[v] == 2 && score[v] >= 0 && neighbors[v].contains(w);
+    }
+    
+    if (mirrored)
     {
       if (score[u] < score[w] && rootNodes.find(u) == rootNodes.end())
       {
-        remove(g, mapToPre, preOrigNodes, neighbors,
+        remove(g, provenance, neighbors,
                nNodes, nArcs, nEdges,
-               degree, degreeVector, u);
+               degree, degreeBuckets, u);
         ++res;
       }
       else if (rootNodes.find(w) == rootNodes.end())
       {
-        remove(g, mapToPre, preOrigNodes, neighbors,
+        remove(g, provenance, neighbors,
                nNodes, nArcs, nEdges,
-               degree, degreeVector, w);
+               degree, degreeBuckets, w);
         ++res;
       }
     }
@@ -164,6 +162,34 @@ inline int PosDiamond<GR, WGHT>::apply(Graph& g,
   return res;
 }
 
+template<typename GR, typename WGHT>
+inline void PosDiamond<GR, WGHT>::addPair(const Graph& g,
+                                          const WeightNodeMap& score,
+                                          const DegreeNodeMap& degree,
+                                          Node v,
+                                          NodePairSet& pairs)
+{
+  if (degree[v] != 2 || score[v] < 0)
+    return;
+  
+  Edge e1 = IncEdgeIt(g, v);
+  Edge e2 = ++IncEdgeIt(g, v);
+  
+  Node u = g.oppositeNode(v, e1);
+  Node w = g.oppositeNode(v, e2);
+  if (score[u] <= 0 && score[w] <= 0)
+  {
+    if (u < w)
+    {
+      pairs.insert(std::make_pair(u, w));
+    }
+    else
+    {
+      pairs.insert(std::make_pair(w, u));
+    }
+  }
+}
+
 } // namespace mwcs
 } // namespace nina
 
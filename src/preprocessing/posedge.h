@@ -28,15 +28,21 @@ public:
   typedef typename Parent::NodeMap NodeMap;
   typedef typename Parent::NodeSet NodeSet;
   typedef typename Parent::NodeSetIt NodeSetIt;
+  typedef typename Parent::CompactNodeSetType CompactNodeSetType;
+  typedef typename Parent::CompactNodeSetIt CompactNodeSetIt;
   typedef typename Parent::NodeSetMap NodeSetMap;
+  typedef typename Parent::ProvenanceForestType ProvenanceForestType;
   typedef typename Parent::DegreeNodeMap DegreeNodeMap;
-  typedef typename Parent::DegreeNodeSetVector DegreeNodeSetVector;
+  typedef typename Parent::DegreeNodeBuckets DegreeNodeBuckets;
+  typedef typename Parent::DegreeNodeIt DegreeNodeIt;
   typedef typename Parent::LabelNodeMap LabelNodeMap;
+  typedef typename Parent::NodeVector NodeVector;
 
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
 
   using Parent::remove;
   using Parent::merge;
+  using Parent::collectDirty;
 
   PosEdge();
   virtual ~PosEdge() {}
@@ -44,22 +50,27 @@ public:
                     const NodeSet& rootNodes,
                     LabelNodeMap& label,
                     WeightNodeMap& score,
-                    NodeSetMap& mapToPre,
-                    NodeSetMap& preOrigNodes,
+                    ProvenanceForestType& provenance,
                     NodeSetMap& neighbors,
                     int& nNodes,
                     int& nArcs,
                     int& nEdges,
                     DegreeNodeMap& degree,
-                    DegreeNodeSetVector& degreeVector,
+                    DegreeNodeBuckets& degreeBuckets,
                     double& LB);
 
   virtual std::string name() const { return "PosEdge"; }
+
+  virtual Parent* clone() const { return new PosEdge(*this); }
+
+private:
+  NodeVector _dirty;
 };
 
 template<typename GR, typename WGHT>
 inline PosEdge<GR, WGHT>::PosEdge()
   : Parent()
+  , _dirty()
 {
 }
 
@@ -68,33 +79,42 @@ inline int PosEdge<GR, WGHT>::apply(Graph& g,
                                     const NodeSet& rootNodes,
                                     LabelNodeMap& label,
                                     WeightNodeMap& score,
-                                    NodeSetMap& mapToPre,
-                                    NodeSetMap& preOrigNodes,
+                                    ProvenanceForestType& provenance,
                                     NodeSetMap& neighbors,
                                     int& nNodes,
                                     int& nArcs,
                                     int& nEdges,
                                     DegreeNodeMap& degree,
-                                    DegreeNodeSetVector& degreeVector,
+                                    DegreeNodeBuckets& degreeBuckets,
                                     double& LB)
 {
-  for (EdgeIt e(g); e != lemon::INVALID; ++e)
+  int res = 0;
+
+  // an edge can only have become applicable if one of its end points
+  // changed, the merged node is examined by the next invocation
+  collectDirty(g, _dirty);
+  for (size_t i = 0; i < _dirty.size(); ++i)
   {
-    Node u = g.u(e);
-    Node v = g.v(e);
+    Node u = _dirty[i];
+    // u may have been merged into another node by now
+    if (!g.valid(u) || score[u] < 0 || rootNodes.find(u) != rootNodes.end())
+      continue;
 
-    if (score[u] >= 0 && score[v] >= 0
-        && rootNodes.find(u) == rootNodes.end()
-        && rootNodes.find(v) == rootNodes.end())
+    for (IncEdgeIt e(g, u); e != lemon::INVALID; ++e)
     {
-      merge(g, label, score,
-            mapToPre, preOrigNodes, neighbors,
-            nNodes, nArcs, nEdges,
-            degree, degreeVector, u, v, LB);
-      return 1;
+      Node v = g.oppositeNode(u, e);
+      if (score[v] >= 0 && rootNodes.find(v) == rootNodes.end())
+      {
+        merge(g, label, score,
+              provenance, neighbors,
+              nNodes, nArcs, nEdges,
+              degree, degreeBuckets, u, v, LB);
+        ++res;
+        break;
+      }
     }
   }
-  return 0;
+  return res;
 }
 
 } // namespace mwcs
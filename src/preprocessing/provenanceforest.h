@@ -0,0 +1,316 @@
+/*
+ * provenanceforest.h
+ *
+ *  Created on: 17-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef PROVENANCEFOREST_H
+#define PROVENANCEFOREST_H
+
+#include <assert.h>
+#include <set>
+#include <vector>
+#include <algorithm>
+#include <lemon/core.h>
+
+namespace nina {
+namespace mwcs {
+
+/// Original nodes of the preprocessed nodes, as a union-find forest
+///
+/// Every element stands for one original node; the elements of a
+/// preprocessed node form a set of the forest, which is owned by that node.
+/// Merging two preprocessed nodes is a union (by size, with path compression)
+/// and removing one only drops the ownership of its set, hence both take
+/// (almost) constant time irrespective of the number of original nodes.
+/// The members of every set are kept in a circular list for enumeration.
+///
+/// An original node has more than one element once a preprocessed node
+/// is copied (extract()); its preprocessed nodes are the owners of the sets
+/// of its elements. Lookups are resolved on demand and do not alter the
+/// forest, so concurrent reads are safe.
+/// Node ids are obtained with the static GR::id() and GR::nodeFromId().
+template<typename GR>
+class ProvenanceForest
+{
+public:
+  typedef GR Graph;
+  typedef typename Graph::Node Node;
+  typedef std::set<Node> NodeSet;
+
+  /// Iterates over the original nodes of a preprocessed node,
+  /// in the style of LEMON iterators
+  class OrgNodeIt : public Node
+  {
+  public:
+    OrgNodeIt(lemon::Invalid)
+      : Node(lemon::INVALID)
+      , _pForest(NULL)
+      , _first(-1)
+      , _element(-1)
+    {
+    }
+
+    OrgNodeIt(const ProvenanceForest& forest, Node preNode)
+      : Node(lemon::INVALID)
+      , _pForest(&forest)
+      , _first(forest.element(preNode))
+      , _element(_first)
+    {
+      load();
+    }
+
+    OrgNodeIt& operator++()
+    {
+      _element = _pForest->_next[_element];
+      if (_element == _first)
+        _element = -1;
+      load();
+      return *this;
+    }
+
+  private:
+    void load()
+    {
+      Node::operator=(_element != -1 ?
+        Graph::nodeFromId(_pForest->_org[_element]) : Node(lemon::INVALID));
+    }
+
+    const ProvenanceForest* _pForest;
+    int _first;
+    int _element;
+  };
+
+  ProvenanceForest()
+    : _parent()
+    , _size()
+    , _next()
+    , _org()
+    , _nextCopy()
+    , _owner()
+    , _firstCopy()
+    , _element()
+  {
+  }
+
+  void clear()
+  {
+    _parent.clear();
+    _size.clear();
+    _next.clear();
+    _org.clear();
+    _nextCopy.clear();
+    _owner.clear();
+    _firstCopy.clear();
+    _element.clear();
+  }
+
+  /// Reserves space for the given number of elements
+  void reserve(int n)
+  {
+    _parent.reserve(n);
+    _size.reserve(n);
+    _next.reserve(n);
+    _org.reserve(n);
+    _nextCopy.reserve(n);
+    _owner.reserve(n);
+  }
+
+  /// Adds orgNode to the original nodes of preNode
+  void add(Node orgNode, Node preNode)
+  {
+    const int e = newElement(orgNode, Graph::id(preNode));
+    const int preId = Graph::id(preNode);
+    if (preId >= static_cast<int>(_element.size()))
+      _element.resize(preId + 1, -1);
+
+    if (_element[preId] == -1)
+      _element[preId] = e;
+    else
+      unite(e, find(_element[preId]), preId);
+  }
+
+  /// Moves the original nodes of node to target, node is left without any
+  void merge(Node node, Node target)
+  {
+    const int e = element(node);
+    if (e == -1 || node == target)
+      return;
+
+    const int targetId = Graph::id(target);
+    _element[Graph::id(node)] = -1;
+
+    if (element(target) == -1)
+    {
+      if (targetId >= static_cast<int>(_element.size()))
+        _element.resize(targetId + 1, -1);
+      _element[targetId] = e;
+      _owner[find(e)] = targetId;
+    }
+    else
+    {
+      unite(find(e), find(_element[targetId]), targetId);
+    }
+  }
+
+  /// Adds copies of the original nodes of node to target
+  void copy(Node node, Node target)
+  {
+    std::vector<Node> orgNodes;
+    for (OrgNodeIt orgNodeIt(*this, node); orgNodeIt != lemon::INVALID; ++orgNodeIt)
+    {
+      orgNodes.push_back(orgNodeIt);
+    }
+
+    for (size_t i = 0; i < orgNodes.size(); ++i)
+    {
+      add(orgNodes[i], target);
+    }
+  }
+
+  /// Detaches the original nodes of node, which are then no longer
+  /// mapped to node
+  void remove(Node node)
+  {
+    const int e = element(node);
+    if (e == -1)
+      return;
+
+    _owner[find(e)] = -1;
+    _element[Graph::id(node)] = -1;
+  }
+
+  /// Renumbers the preprocessed nodes, the node with id i gets id newId[i]
+  ///
+  /// Every node that has original nodes must be given a new id.
+  void renumber(const std::vector<int>& newId)
+  {
+    std::vector<int> element;
+    for (int i = 0; i < static_cast<int>(_element.size()); ++i)
+    {
+      const int e = _element[i];
+      if (e == -1)
+        continue;
+
+      assert(i < static_cast<int>(newId.size()) && newId[i] != -1);
+      const int j = newId[i];
+      if (j >= static_cast<int>(element.size()))
+        element.resize(j + 1, -1);
+
+      element[j] = e;
+      _owner[find(e)] = j;
+    }
+    _element.swap(element);
+  }
+
+  /// Inserts the original nodes of preNode into result
+  void getOrgNodes(Node preNode, NodeSet& result) const
+  {
+    for (OrgNodeIt orgNodeIt(*this, preNode); orgNodeIt != lemon::INVALID; ++orgNodeIt)
+    {
+      result.insert(orgNodeIt);
+    }
+  }
+
+  /// Inserts the preprocessed nodes of orgNode into result
+  void getPreNodes(Node orgNode, NodeSet& result) const
+  {
+    const int orgId = Graph::id(orgNode);
+    if (orgId >= static_cast<int>(_firstCopy.size()))
+      return;
+
+    for (int e = _firstCopy[orgId]; e != -1; e = _nextCopy[e])
+    {
+      const int owner = _owner[find(e)];
+      if (owner != -1)
+        result.insert(Graph::nodeFromId(owner));
+    }
+  }
+
+private:
+  int element(Node preNode) const
+  {
+    const int preId = Graph::id(preNode);
+    return preId < static_cast<int>(_element.size()) ? _element[preId] : -1;
+  }
+
+  int newElement(Node orgNode, int owner)
+  {
+    const int e = static_cast<int>(_parent.size());
+    const int orgId = Graph::id(orgNode);
+    if (orgId >= static_cast<int>(_firstCopy.size()))
+      _firstCopy.resize(orgId + 1, -1);
+
+    _parent.push_back(e);
+    _size.push_back(1);
+    _next.push_back(e);
+    _org.push_back(orgId);
+    _nextCopy.push_back(_firstCopy[orgId]);
+    _owner.push_back(owner);
+    _firstCopy[orgId] = e;
+    return e;
+  }
+
+  /// Root of the set of e, without path compression
+  int find(int e) const
+  {
+    while (_parent[e] != e)
+      e = _parent[e];
+    return e;
+  }
+
+  /// Root of the set of e, compresses the path to it
+  int findCompress(int e)
+  {
+    int root = find(e);
+    while (_parent[e] != root)
+    {
+      int next = _parent[e];
+      _parent[e] = root;
+      e = next;
+    }
+    return root;
+  }
+
+  /// Unites the sets of elements e1 and e2, the result is owned by owner
+  void unite(int e1, int e2, int owner)
+  {
+    int r1 = findCompress(e1);
+    int r2 = findCompress(e2);
+    assert(r1 != r2);
+
+    if (_size[r1] > _size[r2])
+      std::swap(r1, r2);
+
+    _parent[r1] = r2;
+    _size[r2] += _size[r1];
+    _owner[r2] = owner;
+    _owner[r1] = -1;
+
+    // splice the circular member lists
+    std::swap(_next[r1], _next[r2]);
+  }
+
+  /// Union-find parent of every element
+  std::vector<int> _parent;
+  /// Number of elements in the set of every root
+  std::vector<int> _size;
+  /// Next member of the set of every element (circular)
+  std::vector<int> _next;
+  /// Original node id of every element
+  std::vector<int> _org;
+  /// Next element of the same original node, -1 if none
+  std::vector<int> _nextCopy;
+  /// Preprocessed node id owning the set of every root, -1 if removed
+  std::vector<int> _owner;
+  /// First element of every original node id
+  std::vector<int> _firstCopy;
+  /// An element of every preprocessed node id, -1 if none
+  std::vector<int> _element;
+};
+
+} // namespace mwcs
+} // namespace nina
+
+#endif // PROVENANCEFOREST_H
@@ -12,6 +12,11 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <algorithm>
+#include "changelog.h"
+#include "compactnodeset.h"
+#include "degreebuckets.h"
+#include "provenanceforest.h"
 
 namespace nina {
 namespace mwcs {
@@ -31,11 +36,21 @@ public:
   typedef typename Graph::template NodeMap<Node> NodeMap;
   typedef std::set<Node> NodeSet;
   typedef typename NodeSet::iterator NodeSetIt;
-  typedef typename Graph::template NodeMap<NodeSet> NodeSetMap;
-  typedef typename std::vector<NodeSet> DegreeNodeSetVector;
+  // adjacency and provenance bookkeeping
+  typedef CompactNodeSet<Graph> CompactNodeSetType;
+  typedef typename CompactNodeSetType::const_iterator CompactNodeSetIt;
+  typedef typename Graph::template NodeMap<CompactNodeSetType> NodeSetMap;
+  typedef DegreeBuckets<Graph> DegreeNodeBuckets;
+  typedef typename DegreeNodeBuckets::NodeIt DegreeNodeIt;
+  typedef ProvenanceForest<Graph> ProvenanceForestType;
+  typedef ChangeLog<Graph> ChangeLogType;
+  typedef std::vector<Node> NodeVector;
 
 public:
   Rule()
+    : _pLog(NULL)
+    , _logPos(0)
+    , _nThreads(1)
   {
   }
   
@@ -43,76 +58,129 @@ public:
   {
   }
   
+  /// Starts a run of the preprocessing, the rule reports its changes
+  /// to pLog and re-examines the nodes logged there by all rules;
+  /// passing NULL detaches the rule, which then examines all nodes
+  /// on every invocation. Overrides must reset all state of a previous
+  /// run here, see clone()
+  virtual void init(ChangeLogType* pLog)
+  {
+    _pLog = pLog;
+    _logPos = 0;
+  }
+  
   virtual int apply(Graph& g,
                     const NodeSet& rootNodes,
                     LabelNodeMap& label,
                     WeightNodeMap& score,
-                    NodeSetMap& mapToPre,
-                    NodeSetMap& preOrigNodes,
+                    ProvenanceForestType& provenance,
                     NodeSetMap& neighbors,
                     int& nNodes,
                     int& nArcs,
                     int& nEdges,
                     DegreeNodeMap& degree,
-                    DegreeNodeSetVector& degreeVector,
+                    DegreeNodeBuckets& degreeBuckets,
                     double& LB) = 0;
   
   virtual std::string name() const = 0;
   
+  /// Returns a copy of the rule, including its configuration such as the
+  /// number of threads; the state of a run is reset by init()
+  virtual Rule* clone() const = 0;
+  
+  /// Sets the number of threads the rule may use within an invocation
+  void setThreads(int nThreads)
+  {
+    _nThreads = std::max(nThreads, 1);
+  }
+  
+  int getThreads() const
+  {
+    return _nThreads;
+  }
+  
 protected:
+  ChangeLogType* _pLog;
+  /// Position up to which _pLog has been read by this rule
+  int _logPos;
+  int _nThreads;
+
+  /// Records that the degree, score or neighbors of node changed
+  void mark(Node node)
+  {
+    if (_pLog)
+      _pLog->mark(node);
+  }
+
+  /// Collects the nodes that changed since the previous invocation,
+  /// sorted and without duplicates; all nodes without a log
+  void collectDirty(const Graph& g, NodeVector& dirty)
+  {
+    dirty.clear();
+    if (!_pLog)
+    {
+      for (NodeIt v(g); v != lemon::INVALID; ++v)
+      {
+        dirty.push_back(v);
+      }
+      return;
+    }
+
+    for (; _logPos < _pLog->size(); ++_logPos)
+    {
+      Node v = (*_pLog)[_logPos];
+      if (g.valid(v))
+        dirty.push_back(v);
+    }
+    std::sort(dirty.begin(), dirty.end());
+    dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+  }
+
   void remove(Graph& g,
-              NodeSetMap& mapToPre,
-              NodeSetMap& preOrigNodes,
+              ProvenanceForestType& provenance,
               NodeSetMap& neighbors,
               int& nNodes,
               int& nArcs,
               int& nEdges,
               DegreeNodeMap& degree,
-              DegreeNodeSetVector& degreeVector,
+              DegreeNodeBuckets& degreeBuckets,
               Node node)
   {
     // decrease the degrees of adjacent nodes and update neighbors
     for (IncEdgeIt e(g, node); e != lemon::INVALID; ++e)
     {
       Node adjNode = g.oppositeNode(node, e);
-      int d = degree[adjNode]--;
-      degreeVector[d].erase(adjNode);
-      degreeVector[d-1].insert(adjNode);
+      degreeBuckets.move(adjNode, --degree[adjNode]);
       neighbors[adjNode].erase(node);
+      mark(adjNode);
       
       nEdges--;
       nArcs -= 2;
     }
     
     // remove the node from degree vector
-    degreeVector[degree[node]].erase(node);
+    degreeBuckets.erase(node);
     
-    // update mapToPre
-    const NodeSet& nodes = preOrigNodes[node];
-    for (NodeSetIt nodeIt = nodes.begin(); nodeIt != nodes.end(); nodeIt++)
-    {
-      // unmap
-      mapToPre[*nodeIt].erase(node);
-    }
+    // unmap the original nodes
+    provenance.remove(node);
     
     // remove the node from the graph
     g.erase(node);
     --nNodes;
     
-//    assert(isValid(g, mapToPre, preOrigNodes, neighbors, nNodes, nArcs, nEdges, degree, degreeVector));
+//    assert(isValid(g, provenance, neighbors, nNodes, nArcs, nEdges, degree, degreeBuckets));
   }
   
   Node extract(Graph& g,
                LabelNodeMap& label,
                WeightNodeMap& score,
-               NodeSetMap& mapToPre,
-               NodeSetMap& preOrigNodes,
+               ProvenanceForestType& provenance,
                NodeSetMap& neighbors,
                int& nNodes,
                int& nArcs,
                int& nEdges,
                DegreeNodeMap& degree,
-               DegreeNodeSetVector& degreeVector,
+               DegreeNodeBuckets& degreeBuckets,
                Node node)
   {
     Node newNode = g.addNode();
@@ -120,35 +188,29 @@ protected:
     label[newNode] = label[node];
     score[newNode] = score[node];
     
-    const NodeSet& orgNodes = preOrigNodes[node];
-    preOrigNodes[newNode].insert(orgNodes.begin(), orgNodes.end());
+    provenance.copy(node, newNode);
     
     degree[newNode] = 0;
     
     ++nNodes;
-    
-    for (NodeSetIt orgNodeIt = orgNodes.begin(); orgNodeIt != orgNodes.end(); ++orgNodeIt)
-    {
-      mapToPre[*orgNodeIt].insert(newNode);
-    }
 
-    degreeVector[0].insert(newNode);
+    degreeBuckets.insert(newNode, 0);
+    mark(newNode);
     
-//    assert(isValid(g, mapToPre, preOrigNodes, neighbors, nNodes, nArcs, nEdges, degree, degreeVector));
+//    assert(isValid(g, provenance, neighbors, nNodes, nArcs, nEdges, degree, degreeBuckets));
     return newNode;
   }
   
   Node merge(Graph& g,
              LabelNodeMap& label,
              WeightNodeMap& score,
-             NodeSetMap& mapToPre,
-             NodeSetMap& preOrigNodes,
+             ProvenanceForestType& provenance,
              NodeSetMap& neighbors,
              int& nNodes,
              int& nArcs,
              int& nEdges,
              DegreeNodeMap& degree,
-             DegreeNodeSetVector& degreeVector,
+             DegreeNodeBuckets& degreeBuckets,
              Node node1,
              Node node2,
              double& LB)
@@ -159,23 +221,19 @@ protected:
     // node1 is deleted, node2 is kept
     Node minNode = node1, maxNode = node2;
     
-    // erase maxNode and minNode from degreeVector, we'll reinsert them later
-    degreeVector[degree[minNode]].erase(minNode);
-    degreeVector[degree[maxNode]].erase(maxNode);
+    // erase maxNode and minNode from degreeBuckets, we'll reinsert them later
+    degreeBuckets.erase(minNode);
+    degreeBuckets.erase(maxNode);
     
     // now rewire the edges incident to minNode to maxNode
-    NodeSet& maxNodeNeighbors = neighbors[maxNode];
-    NodeSet& minNodeNeighbors = neighbors[minNode];
+    CompactNodeSetType& maxNodeNeighbors = neighbors[maxNode];
+    CompactNodeSetType& minNodeNeighbors = neighbors[minNode];
     
     minNodeNeighbors.erase(maxNode);
     maxNodeNeighbors.erase(minNode);
     
-    NodeSet intersection;
-    std::set_intersection(minNodeNeighbors.begin(), minNodeNeighbors.end(),
-                          maxNodeNeighbors.begin(), maxNodeNeighbors.end(),
-                          std::inserter(intersection, intersection.begin()));
-    
-    // remove edges incident to minNode and intersection => prevent multiple edges
+    // remove edges incident to minNode and a common neighbor => prevent multiple edges,
+    // maxNodeNeighbors is not altered in this loop
     for (IncEdgeIt e(g, minNode); e != lemon::INVALID;)
     {
       Node node = g.oppositeNode(minNode, e);
@@ -186,17 +244,15 @@ protected:
         continue;
       }
       
-      assert(neighbors[node].find(minNode) != neighbors[node].end());
+      assert(neighbors[node].contains(minNode));
       neighbors[node].erase(minNode);
       neighbors[node].insert(maxNode);
+      mark(node);
       
-      if (intersection.find(node) != intersection.end())
+      if (maxNodeNeighbors.contains(node))
       {
         // adjust degree of node
-        int d = degree[node];
-        degreeVector[d].erase(node);
-        degreeVector[d-1].insert(node);
-        --degree[node];
+        degreeBuckets.move(node, --degree[node]);
         
         // remove edge
         Edge toDelete = e;
@@ -214,35 +270,20 @@ protected:
     }
     
     // now update the neighbor sets
-    maxNodeNeighbors.insert(minNodeNeighbors.begin(), minNodeNeighbors.end());
+    maxNodeNeighbors.insert(minNodeNeighbors);
     
     // update degree of maxNode
     int d = degree[maxNode] = static_cast<int>(maxNodeNeighbors.size());
-    
-    if (degreeVector.size() <= static_cast<size_t>(d))
-    {
-      // add node sets to degreeVector
-      int len = d - degreeVector.size() + 1;
-      for (int i = 0; i < len; i++)
-        degreeVector.push_back(NodeSet());
-    }
-    
-    degreeVector[d].insert(maxNode);
+    degreeBuckets.insert(maxNode, d);
     
     // update score of maxNode
     score[maxNode] += score[minNode];
     
     // update set of original nodes corresponding to maxNode
-    const NodeSet& minOrgNodeSet = preOrigNodes[minNode];
-    for (NodeSetIt nodeIt = minOrgNodeSet.begin(); nodeIt != minOrgNodeSet.end(); nodeIt++)
-    {
-      preOrigNodes[maxNode].insert(*nodeIt);
-      mapToPre[*nodeIt].erase(minNode);
-      mapToPre[*nodeIt].insert(maxNode);
-    }
+    provenance.merge(minNode, maxNode);
     
-    // merge the labels
-    label[maxNode] += "_" + label[minNode];
+    // labels are not merged, MwcsPreprocessedGraph::getLabel()
+    // renders them from the provenance
     
     // erase minNode
     g.contract(maxNode, minNode, true);
@@ -256,6 +297,10 @@ protected:
       LB = score[maxNode];
     }
     
+    mark(maxNode);
+    if (_pLog)
+      _pLog->markMerge();
+    
 #ifdef DEBUG
     int d2 = 0;
     for (IncEdgeIt e(g, maxNode); e != lemon::INVALID; ++e)
@@ -267,21 +312,20 @@ protected:
     assert(degree[maxNode] == static_cast<int>(neighbors[maxNode].size()));
     assert(degree[maxNode] >= 0);
     assert(lemon::simpleGraph(g));
-//    assert(isValid(g, mapToPre, preOrigNodes, neighbors, nNodes, nArcs, nEdges, degree, degreeVector));
+//    assert(isValid(g, provenance, neighbors, nNodes, nArcs, nEdges, degree, degreeBuckets));
 #endif
     
     return maxNode;
   }
   
   bool isValid(Graph& g,
-               NodeSetMap& mapToPre,
-               NodeSetMap& preOrigNodes,
+               ProvenanceForestType& provenance,
                NodeSetMap& neighbors,
                int& nNodes,
                int& nArcs,
                int& nEdges,
                DegreeNodeMap& degree,
-               DegreeNodeSetVector& degreeVector)
+               DegreeNodeBuckets& degreeBuckets)
   {
     if (!lemon::simpleGraph(g))
       return false;
@@ -305,7 +349,7 @@ protected:
       if (neighbors[v].size() != static_cast<size_t>(newDeg[v]))
         return false;
       
-      if (degreeVector[degree[v]].find(v) == degreeVector[degree[v]].end())
+      if (!degreeBuckets.contains(v, degree[v]))
         return false;
       
       if (newNeighbors[v] != neighbors[v])
@@ -9,17 +9,34 @@
 #define SHORTESTPATH_H
 
 #include <lemon/core.h>
-#include <lemon/adaptors.h>
-#include <lemon/dijkstra.h>
+#include <assert.h>
 #include <string>
 #include <vector>
 #include <set>
-#include <list>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <thread>
 #include "rule.h"
 
 namespace nina {
 namespace mwcs {
 
+/// Removes a non-positive degree 2 node v with neighbors u and w if there
+/// is another path from u to w whose interior nodes have a total negative
+/// score of at least score[v]
+///
+/// The searches run on a flat snapshot of the graph (CSR by node id) taken
+/// at the start of an invocation, where node removals of the invocation are
+/// flagged. A search from u is a Dijkstra over the costs -score of the
+/// interior nodes which is bounded by -score[v]: it stops as soon as a
+/// neighbor of w is settled or all tentative distances exceed the bound.
+///
+/// With multiple threads the candidates are searched in batches, all searches
+/// of a batch read the snapshot at the start of the batch. The removals are
+/// applied serially afterwards, in candidate order: a node is removed if the
+/// path found for it does not use a node removed in the meantime, otherwise
+/// it is searched again. Hence the result equals that of the serial rule.
 template<typename GR,
          typename WGHT = typename GR::template NodeMap<double> >
 class ShortestPath : public Rule<GR, WGHT>
@@ -31,15 +48,23 @@ public:
   typedef typename Parent::NodeMap NodeMap;
   typedef typename Parent::NodeSet NodeSet;
   typedef typename Parent::NodeSetIt NodeSetIt;
+  typedef typename Parent::CompactNodeSetType CompactNodeSetType;
+  typedef typename Parent::CompactNodeSetIt CompactNodeSetIt;
   typedef typename Parent::NodeSetMap NodeSetMap;
+  typedef typename Parent::ProvenanceForestType ProvenanceForestType;
   typedef typename Parent::DegreeNodeMap DegreeNodeMap;
-  typedef typename Parent::DegreeNodeSetVector DegreeNodeSetVector;
+  typedef typename Parent::DegreeNodeBuckets DegreeNodeBuckets;
+  typedef typename Parent::DegreeNodeIt DegreeNodeIt;
   typedef typename Parent::LabelNodeMap LabelNodeMap;
+  typedef typename Parent::ChangeLogType ChangeLogType;
   
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
 
   using Parent::remove;
   using Parent::merge;
+  using Parent::collectDirty;
+  using Parent::_pLog;
+  using Parent::_nThreads;
 
   ShortestPath();
   virtual ~ShortestPath() {}
@@ -47,78 +72,262 @@ public:
                     const NodeSet& rootNodes,
                     LabelNodeMap& label,
                     WeightNodeMap& score,
-                    NodeSetMap& mapToPre,
-                    NodeSetMap& preOrigNodes,
+                    ProvenanceForestType& provenance,
                     NodeSetMap& neighbors,
                     int& nNodes,
                     int& nArcs,
                     int& nEdges,
                     DegreeNodeMap& degree,
-                    DegreeNodeSetVector& degreeVector,
+                    DegreeNodeBuckets& degreeBuckets,
                     double& LB);
 
   virtual std::string name() const { return "ShortestPath"; }
+
+  virtual Parent* clone() const { return new ShortestPath(*this); }
+  
+  virtual void init(ChangeLogType* pLog)
+  {
+    Parent::init(pLog);
+    // the nodes to start with are the ones in the log
+    _full = false;
+    _nMerges = 0;
+  }
   
 private:
-  typedef lemon::FilterNodes<const Graph, BoolNodeMap> SubGraph;
-  typedef typename SubGraph::Node SubNode;
-  typedef std::list<Node> NodeList;
-  typedef typename NodeList::const_iterator NodeListIt;
-  
-  double shortCircuit(SubGraph& g,
-                      const DoubleArcMap& arcCost,
-                      const WeightNodeMap& score,
-                      Node u,
-                      Node v,
-                      Node w,
-                      NodeList& path);
+  typedef std::vector<Node> NodeVector;
+  typedef std::vector<int> IntVector;
+  typedef std::vector<double> DoubleVector;
+  typedef std::pair<double, int> HeapItem;
+  typedef std::vector<HeapItem> HeapItemVector;
+  
+  /// Number of candidates searched per thread and batch
+  static const int BATCH_SIZE = 256;
+  
+  /// Scratch space of the searches of a single thread
+  struct Workspace
+  {
+    Workspace()
+      : _dist()
+      , _pred()
+      , _stamp()
+      , _curStamp(0)
+      , _heap()
+      , _path()
+    {
+    }
+    
+    /// Tentative distance, only valid if _stamp equals _curStamp
+    DoubleVector _dist;
+    IntVector _pred;
+    IntVector _stamp;
+    int _curStamp;
+    /// Min-heap of (distance, node id), outdated items are skipped
+    HeapItemVector _heap;
+    /// Interior nodes of the paths found
+    IntVector _path;
+  };
+  
+  /// Outcome of the search of a candidate
+  struct Result
+  {
+    bool _found;
+    /// Workspace holding the interior nodes of the path found
+    int _thread;
+    int _pathBegin;
+    int _pathEnd;
+  };
+  
+  typedef std::vector<Workspace> WorkspaceVector;
+  typedef std::vector<Result> ResultVector;
+  
+  NodeVector _dirty;
+  /// Whether all degree 2 nodes need to be examined
+  bool _full;
+  /// Number of merges in the log at the previous invocation
+  int _nMerges;
+  
+  /// Snapshot: neighbors of node id i are _adj[_offset[i]].._adj[_offset[i+1]-1]
+  IntVector _offset;
+  IntVector _adj;
+  /// Cost of passing through a node, i.e. max(-score, 0)
+  DoubleVector _cost;
+  /// Nodes removed since the snapshot was taken
+  std::vector<bool> _removed;
+  
+  WorkspaceVector _workspace;
+  
+  void buildSnapshot(const Graph& g,
+                     const WeightNodeMap& score,
+                     const DegreeNodeMap& degree);
+  
+  bool search(Workspace& ws, int u, int v, int w) const;
+  
+  bool pathRemoved(const Workspace& ws, const Result& result) const;
+  
+  void searchBatch(int thread,
+                   size_t begin,
+                   size_t end,
+                   const IntVector& endpoints,
+                   ResultVector& results);
 };
 
 template<typename GR, typename WGHT>
 inline ShortestPath<GR, WGHT>::ShortestPath()
   : Parent()
+  , _dirty()
+  , _full(true)
+  , _nMerges(0)
+  , _offset()
+  , _adj()
+  , _cost()
+  , _removed()
+  , _workspace()
 {
 }
   
 template<typename GR, typename WGHT>
-inline double ShortestPath<GR, WGHT>::shortCircuit(SubGraph& g,
-                                                   const DoubleArcMap& arcCost,
-                                                   const WeightNodeMap& score,
-                                                   Node u,
-                                                   Node v,
-                                                   Node w,
-                                                   NodeList& path)
+inline void ShortestPath<GR, WGHT>::buildSnapshot(const Graph& g,
+                                                  const WeightNodeMap& score,
+                                                  const DegreeNodeMap& degree)
 {
-  g.disable(v);
+  const int n = g.maxNodeId() + 1;
+  
+  _offset.assign(n + 1, 0);
+  _cost.assign(n, 0);
+  _removed.assign(n, false);
+  for (NodeIt v(g); v != lemon::INVALID; ++v)
+  {
+    _offset[g.id(v) + 1] = degree[v];
+    _cost[g.id(v)] = score[v] > 0 ? 0 : -score[v];
+  }
+  for (int i = 0; i < n; ++i)
+  {
+    _offset[i + 1] += _offset[i];
+  }
   
-  double pathLength = 0;
+  _adj.resize(_offset[n]);
+  for (NodeIt v(g); v != lemon::INVALID; ++v)
+  {
+    int k = _offset[g.id(v)];
+    for (IncEdgeIt e(g, v); e != lemon::INVALID; ++e)
+    {
+      _adj[k++] = g.id(g.oppositeNode(v, e));
+    }
+    assert(k == _offset[g.id(v) + 1]);
+  }
   
-  // and now let's do a Dijkstra
-  lemon::Dijkstra<SubGraph, DoubleArcMap> dijkstra(g, arcCost);
-  dijkstra.run(u);
+  for (size_t t = 0; t < _workspace.size(); ++t)
+  {
+    Workspace& ws = _workspace[t];
+    if (static_cast<int>(ws._stamp.size()) < n)
+    {
+      ws._dist.resize(n);
+      ws._pred.resize(n);
+      ws._stamp.resize(n, 0);
+    }
+  }
+}
+
+template<typename GR, typename WGHT>
+inline bool ShortestPath<GR, WGHT>::search(Workspace& ws,
+                                           int u,
+                                           int v,
+                                           int w) const
+{
+  // the interior of a path from u to w may cost at most -score[v]
+  const double bound = _cost[v];
   
-  if (!dijkstra.reached(w))
+  if (ws._curStamp == std::numeric_limits<int>::max())
   {
-    pathLength = -std::numeric_limits<double>::max();
+    std::fill(ws._stamp.begin(), ws._stamp.end(), 0);
+    ws._curStamp = 0;
   }
-  else
+  const int stamp = ++ws._curStamp;
+  
+  std::greater<HeapItem> cmp;
+  ws._heap.clear();
+  ws._heap.push_back(HeapItem(0, u));
+  ws._dist[u] = 0;
+  ws._pred[u] = -1;
+  ws._stamp[u] = stamp;
+  
+  while (!ws._heap.empty())
   {
-    SubNode subNode = w;
-    while (dijkstra.predArc(subNode) != lemon::INVALID)
+    std::pop_heap(ws._heap.begin(), ws._heap.end(), cmp);
+    const double d = ws._heap.back().first;
+    const int x = ws._heap.back().second;
+    ws._heap.pop_back();
+    
+    if (d > ws._dist[x])
+      continue;
+    
+    // d is the cost of the interior of a shortest path from u to x,
+    // hence a shortest path to w via x costs d as well
+    for (int k = _offset[x]; k < _offset[x + 1]; ++k)
     {
-      subNode = dijkstra.predNode(subNode);
-      if (subNode != u)
+      const int y = _adj[k];
+      if (y == v || _removed[y])
+        continue;
+      
+      if (y == w)
       {
-        path.push_front(subNode);
-        if (score[subNode] < 0)
-          pathLength += score[subNode];
+        for (int z = x; z != u; z = ws._pred[z])
+        {
+          ws._path.push_back(z);
+        }
+        return true;
+      }
+      
+      const double dy = d + _cost[y];
+      if (dy <= bound && (ws._stamp[y] != stamp || dy < ws._dist[y]))
+      {
+        ws._dist[y] = dy;
+        ws._pred[y] = x;
+        ws._stamp[y] = stamp;
+        ws._heap.push_back(HeapItem(dy, y));
+        std::push_heap(ws._heap.begin(), ws._heap.end(), cmp);
       }
     }
   }
   
-  g.enable(v);
-  
-  return pathLength;
+  return false;
+}
+
+template<typename GR, typename WGHT>
+inline bool ShortestPath<GR, WGHT>::pathRemoved(const Workspace& ws,
+                                                const Result& result) const
+{
+  for (int k = result._pathBegin; k < result._pathEnd; ++k)
+  {
+    if (_removed[ws._path[k]])
+      return true;
+  }
+  return false;
+}
+
+template<typename GR, typename WGHT>
+inline void ShortestPath<GR, WGHT>::searchBatch(int thread,
+                                                size_t begin,
+                                                size_t end,
+                                                const IntVector& endpoints,
+                                                ResultVector& results)
+{
+  Workspace& ws = _workspace[thread];
+  ws._path.clear();
+  for (size_t i = begin; i < end; ++i)
+  {
+    Result& result = results[i];
+    result._found = false;
+    result._thread = thread;
+    result._pathBegin = result._pathEnd = static_cast<int>(ws._path.size());
+    
+    const int v = endpoints[3 * i + 1];
+    if (v != -1)
+    {
+      result._found = search(ws, endpoints[3 * i], v, endpoints[3 * i + 2]);
+      result._pathEnd = static_cast<int>(ws._path.size());
+    }
+  }
 }
   
 template<typename GR, typename WGHT>
@@ -126,78 +335,128 @@ inline int ShortestPath<GR, WGHT>::apply(Graph& g,
                                          const NodeSet& rootNodes,
                                          LabelNodeMap& label,
                                          WeightNodeMap& score,
-                                         NodeSetMap& mapToPre,
-                                         NodeSetMap& preOrigNodes,
+                                         ProvenanceForestType& provenance,
                                          NodeSetMap& neighbors,
                                          int& nNodes,
                                          int& nArcs,
                                          int& nEdges,
                                          DegreeNodeMap& degree,
-                                         DegreeNodeSetVector& degreeVector,
+                                         DegreeNodeBuckets& degreeBuckets,
                                          double& LB)
 {
   int res = 0;
   
-  if (degreeVector.size() <= 2)
+  // removals only lengthen paths, so without merges since the previous
+  // invocation only the changed nodes can have become applicable;
+  // a merge may shorten paths anywhere and calls for a full scan
+  collectDirty(g, _dirty);
+  if (!_pLog || _pLog->getMergeCount() != _nMerges)
   {
-    // nothing to remove, there are no degree 2 nodes
-    return 0;
+    _full = true;
+    _nMerges = _pLog ? _pLog->getMergeCount() : 0;
   }
-  else if (degreeVector[2].size() > 1000)
+  
+  if (degreeBuckets.empty(2))
   {
-    // too many nodes
+    // nothing to remove, there are no degree 2 nodes
+    _full = false;
     return 0;
   }
   
-  // let's construct the arc costs
-  DoubleArcMap arcCost(g);
-  for (ArcIt a(g); a != lemon::INVALID; ++a)
+  // removals move neighbors between buckets, so collect the candidates first
+  NodeVector candidates;
+  if (_full)
   {
-    arcCost[a] = score[g.target(a)] > 0 ? 0 : -score[g.target(a)];
-    assert(arcCost[a] >= 0);
+    candidates.reserve(degreeBuckets.size(2));
+    for (DegreeNodeIt nodeIt(degreeBuckets, 2); nodeIt != lemon::INVALID; ++nodeIt)
+    {
+      if (score[nodeIt] <= 0 && rootNodes.find(nodeIt) == rootNodes.end())
+        candidates.push_back(nodeIt);
+    }
+    _full = false;
   }
-
-  BoolNodeMap filter(g, true);
-  SubGraph subG(g, filter);
+  else
+  {
+    for (size_t i = 0; i < _dirty.size(); ++i)
+    {
+      Node v = _dirty[i];
+      if (degree[v] == 2 && score[v] <= 0 && rootNodes.find(v) == rootNodes.end())
+        candidates.push_back(v);
+    }
+  }
+  
+  if (candidates.empty())
+    return 0;
   
-  for (NodeIt v(g); v != lemon::INVALID;)
+  const int nCandidates = static_cast<int>(candidates.size());
+  const int nThreads = std::max(1, std::min(_nThreads, nCandidates / BATCH_SIZE));
+  _workspace.resize(nThreads);
+  buildSnapshot(g, score, degree);
+  
+  // per candidate of a batch: ids of u, v and w, v is -1 if not applicable
+  IntVector endpoints;
+  ResultVector results;
+  const size_t batchSize = nThreads == 1 ? 1 : static_cast<size_t>(nThreads) * BATCH_SIZE;
+  for (size_t first = 0; first < candidates.size(); first += batchSize)
   {
-    if (degree[v] == 2 && score[v] <= 0 && rootNodes.find(v) == rootNodes.end())
+    const size_t last = std::min(candidates.size(), first + batchSize);
+    const size_t n = last - first;
+    
+    endpoints.assign(3 * n, -1);
+    results.resize(n);
+    for (size_t i = 0; i < n; ++i)
     {
-      Edge e1 = IncEdgeIt(g, v);
-      Edge e2 = ++IncEdgeIt(g, v);
-      
-      Node u = g.oppositeNode(v, e1);
-      Node w = g.oppositeNode(v, e2);
-      
-      NodeList path;
-      double pathLength = shortCircuit(subG, arcCost, score, u, v, w, path);
+      Node v = candidates[first + i];
       
-      if (pathLength >= score[v])
+      // an earlier removal may have lowered the degree of v
+      if (degree[v] == 2)
       {
-//          std::cout << label[v] << " ( " << score[v] << " ) : "
-//                    << label[u] << " (" << score[u] << ")";
-//          for (NodeListIt nodeIt = path.begin(); nodeIt != path.end(); ++nodeIt)
-//          {
-//            std::cout << " -- " << label[*nodeIt] << " (" << score[*nodeIt] << ")";
-//          }
-//          std::cout << " -- " << label[w] << " (" << score[w] << ")" << std::endl;
-        
-        Node curV = v;
-        ++v;
-        remove(g, mapToPre, preOrigNodes, neighbors,
-               nNodes, nArcs, nEdges,
-               degree, degreeVector, curV);
-        ++res;
+        IncEdgeIt e(g, v);
+        endpoints[3 * i] = g.id(g.oppositeNode(v, e));
+        endpoints[3 * i + 1] = g.id(v);
+        endpoints[3 * i + 2] = g.id(g.oppositeNode(v, ++e));
       }
-      else
+    }
+    
+    if (nThreads == 1)
+    {
+      searchBatch(0, 0, n, endpoints, results);
+    }
+    else
+    {
+      std::vector<std::thread> threads;
+      for (int t = 0; t < nThreads; ++t)
+      {
+        threads.push_back(std::thread(&ShortestPath::searchBatch, this, t,
+                                      t * n / nThreads, (t + 1) * n / nThreads,
+                                      std::cref(endpoints), std::ref(results)));
+      }
+      for (int t = 0; t < nThreads; ++t)
       {
-        ++v;
+        threads[t].join();
       }
     }
-    else
+    
+    for (size_t i = 0; i < n; ++i)
     {
-      ++v;
+      Node v = candidates[first + i];
+      const Result& result = results[i];
+      if (!result._found || degree[v] != 2)
+        continue;
+      
+      // the path found may have been cut by a removal of this batch
+      if (pathRemoved(_workspace[result._thread], result))
+      {
+        Workspace& ws = _workspace[result._thread];
+        if (!search(ws, endpoints[3 * i], endpoints[3 * i + 1], endpoints[3 * i + 2]))
+          continue;
+      }
+      
+      remove(g, provenance, neighbors,
+             nNodes, nArcs, nEdges,
+             degree, degreeBuckets, v);
+      _removed[endpoints[3 * i + 1]] = true;
+      ++res;
     }
   }
   
@@ -207,4 +466,4 @@ inline int ShortestPath<GR, WGHT>::apply(Graph& g,
 } // namespace mwcs
 } // namespace nina
 
-#endif // SHORTESTPATH_H
\ No newline at end of file
+#endif // SHORTESTPATH_H
@@ -0,0 +1,472 @@
+/*
+ * snapshot.h
+ *
+ *  Created on: 16-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include "parser/mappedfile.h"
+
+namespace nina {
+namespace mwcs {
+
+/// Instance metadata stored alongside a snapshot
+///
+/// Holds what the drivers would otherwise take from the parser.
+struct SnapshotInfo
+{
+  /// Instance name
+  std::string _name;
+  /// Total node profit (PCST)
+  double _totalNodeProfit;
+  /// Ids of the original root nodes (rooted PCST)
+  std::vector<int> _rootNodes;
+
+  SnapshotInfo()
+    : _name()
+    , _totalNodeProfit(0)
+    , _rootNodes()
+  {
+  }
+};
+
+/// Binary snapshot of a (preprocessed) instance
+///
+/// Layout: a fixed-size header followed by 8-byte aligned arrays in native
+/// byte order. A snapshot is mapped with a single mmap and validated in
+/// place; the arrays are then copied into the instance graph, which skips
+/// parsing and preprocessing but not building the graph.
+class Snapshot
+{
+public:
+  static const uint32_t VERSION = 2;
+
+  enum Flags
+  {
+    HAS_PVALUES = 1
+  };
+
+  struct Header
+  {
+    char _magic[8];
+    uint32_t _version;
+    uint32_t _flags;
+    uint64_t _key;
+    uint64_t _size;
+    int32_t _nOrgNodes;
+    int32_t _nOrgEdges;
+    int32_t _nNodes;
+    int32_t _nEdges;
+    int32_t _nRootNodes;
+    int32_t _nameLength;
+    double _totalNodeProfit;
+  };
+
+  /// Returns the key of the given input files and settings
+  ///
+  /// The key is a 64-bit FNV-1a hash of the contents of each file,
+  /// the settings string and the snapshot version. As hashing reads the
+  /// inputs in full, the key is recorded in a stamp file in dir together
+  /// with the name, size and modification time of each file. While these
+  /// match, the recorded key is returned without reading the inputs.
+  /// Returns 0 if a file could not be read.
+  static uint64_t key(const std::string& dir,
+                      const std::vector<std::string>& filenames,
+                      const std::string& settings)
+  {
+    std::string stamp;
+    if (!getStamp(filenames, settings, stamp))
+      return 0;
+
+    const std::string stampFilename =
+      filename(dir, hash(FNV_OFFSET, stamp.data(), stamp.data() + stamp.size()), ".key");
+
+    uint64_t h = readStamp(stampFilename, stamp);
+    if (h == 0)
+    {
+      h = contentKey(filenames, settings);
+      if (h != 0)
+      {
+        std::string data(stamp);
+        data.append(reinterpret_cast<const char*>(&h), sizeof(h));
+        save(stampFilename, data.data(), data.size());
+      }
+    }
+    return h;
+  }
+
+  /// Returns the snapshot filename in directory dir for the given key
+  static std::string filename(const std::string& dir, uint64_t key)
+  {
+    return filename(dir, key, ".snap");
+  }
+
+  static void initHeader(Header& header, uint64_t key)
+  {
+    memset(&header, 0, sizeof(Header));
+    memcpy(header._magic, "HEINZSNP", 8);
+    header._version = VERSION;
+    header._key = key;
+  }
+
+  static bool checkHeader(const Header& header, uint64_t key, uint64_t size)
+  {
+    return memcmp(header._magic, "HEINZSNP", 8) == 0
+        && header._version == VERSION
+        && header._key == key
+        && header._size == size
+        && header._nOrgNodes >= 0 && header._nOrgEdges >= 0
+        && header._nNodes >= 0 && header._nEdges >= 0
+        && header._nRootNodes >= 0 && header._nameLength >= 0;
+  }
+
+  /// Writes size bytes of data to filename
+  ///
+  /// The data is written to a temporary file first and then renamed,
+  /// so concurrent runs never observe a partially written file.
+  static bool save(const std::string& filename, const char* data, size_t size)
+  {
+    std::stringstream ss;
+    ss << filename << ".tmp." << getpid();
+    const std::string tmpFilename = ss.str();
+
+    FILE* f = fopen(tmpFilename.c_str(), "wb");
+    if (!f)
+      return false;
+
+    bool ok = fwrite(data, 1, size, f) == size;
+    ok = fclose(f) == 0 && ok;
+    ok = ok && rename(tmpFilename.c_str(), filename.c_str()) == 0;
+
+    if (!ok)
+      remove(tmpFilename.c_str());
+
+    return ok;
+  }
+
+private:
+  static const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+
+  /// Hashes the contents of the input files, the settings and the version
+  static uint64_t contentKey(const std::vector<std::string>& filenames,
+                             const std::string& settings)
+  {
+    uint64_t h = FNV_OFFSET;
+    for (size_t i = 0; i < filenames.size(); ++i)
+    {
+      MappedFile file;
+      if (!file.open(filenames[i]))
+        return 0;
+
+      h = hash(h, file.begin(), file.end());
+      h = hash(h, "\0", "\0" + 1);
+    }
+
+    h = hash(h, settings.data(), settings.data() + settings.size());
+
+    uint32_t version = VERSION;
+    const char* pVersion = reinterpret_cast<const char*>(&version);
+    h = hash(h, pVersion, pVersion + sizeof(version));
+
+    // 0 is reserved for 'no key'
+    return h == 0 ? 1 : h;
+  }
+
+  /// Describes the input files by name, size and modification time,
+  /// followed by the settings and the version
+  static bool getStamp(const std::vector<std::string>& filenames,
+                       const std::string& settings,
+                       std::string& stamp)
+  {
+    std::stringstream ss;
+    for (size_t i = 0; i < filenames.size(); ++i)
+    {
+      struct stat st;
+      if (stat(filenames[i].c_str(), &st) != 0)
+        return false;
+
+      ss << filenames[i] << '\0' << st.st_size << ' ' << st.st_mtime << '\n';
+    }
+    ss << settings << '\0' << VERSION;
+    stamp = ss.str();
+    return true;
+  }
+
+  /// Returns the key recorded in stamp file filename if it was recorded
+  /// for stamp, 0 otherwise
+  static uint64_t readStamp(const std::string& filename, const std::string& stamp)
+  {
+    uint64_t h = 0;
+    FILE* f = fopen(filename.c_str(), "rb");
+    if (!f)
+      return 0;
+
+    std::vector<char> data(stamp.size() + sizeof(h) + 1);
+    size_t n = fread(&data.front(), 1, data.size(), f);
+    fclose(f);
+
+    if (n == stamp.size() + sizeof(h)
+        && memcmp(&data.front(), stamp.data(), stamp.size()) == 0)
+    {
+      memcpy(&h, &data[stamp.size()], sizeof(h));
+    }
+    return h;
+  }
+
+  static std::string filename(const std::string& dir, uint64_t key, const char* extension)
+  {
+    std::stringstream ss;
+    ss << dir;
+    if (!dir.empty() && dir[dir.size() - 1] != '/')
+      ss << '/';
+    ss << std::hex << std::setw(16) << std::setfill('0') << key << extension;
+    return ss.str();
+  }
+
+  static uint64_t hash(uint64_t h, const char* begin, const char* end)
+  {
+    for (const char* p = begin; p != end; ++p)
+    {
+      h ^= static_cast<unsigned char>(*p);
+      h *= 1099511628211ULL;
+    }
+    return h;
+  }
+};
+
+/// Serializes arrays into an in-memory snapshot buffer
+class SnapshotWriter
+{
+public:
+  SnapshotWriter()
+    : _buffer(sizeof(Snapshot::Header), 0)
+  {
+  }
+
+  Snapshot::Header& header()
+  {
+    return *reinterpret_cast<Snapshot::Header*>(&_buffer.front());
+  }
+
+  template<typename T>
+  void write(const T* pData, size_t n)
+  {
+    if (n > 0)
+    {
+      const char* p = reinterpret_cast<const char*>(pData);
+      _buffer.insert(_buffer.end(), p, p + n * sizeof(T));
+    }
+
+    // keep every array 8-byte aligned
+    while (_buffer.size() % 8 != 0)
+      _buffer.push_back(0);
+  }
+
+  template<typename T>
+  void write(const std::vector<T>& data)
+  {
+    write(data.empty() ? NULL : &data.front(), data.size());
+  }
+
+  /// Writes the buffer to filename, see Snapshot::save()
+  bool save(const std::string& filename)
+  {
+    header()._size = _buffer.size();
+    return Snapshot::save(filename, &_buffer.front(), _buffer.size());
+  }
+
+private:
+  std::vector<char> _buffer;
+};
+
+/// Provides in-place access to the arrays of a snapshot file
+class SnapshotReader
+{
+public:
+  SnapshotReader()
+    : _file()
+    , _pPos(NULL)
+  {
+  }
+
+  bool open(const std::string& filename, uint64_t key)
+  {
+    if (!_file.open(filename) || _file.size() < sizeof(Snapshot::Header))
+      return false;
+
+    _pPos = _file.begin() + sizeof(Snapshot::Header);
+    return Snapshot::checkHeader(header(), key, _file.size());
+  }
+
+  const Snapshot::Header& header() const
+  {
+    return *reinterpret_cast<const Snapshot::Header*>(_file.begin());
+  }
+
+  /// Returns a pointer to the next array of n elements, NULL if truncated
+  template<typename T>
+  const T* read(size_t n)
+  {
+    size_t bytes = n * sizeof(T);
+    size_t padded = (bytes + 7) & ~static_cast<size_t>(7);
+    if (_pPos == NULL || n > _file.size()
+        || static_cast<size_t>(_file.end() - _pPos) < padded)
+    {
+      _pPos = NULL;
+      return NULL;
+    }
+
+    const T* p = reinterpret_cast<const T*>(_pPos);
+    _pPos += padded;
+    return p;
+  }
+
+  bool good() const
+  {
+    return _pPos != NULL;
+  }
+
+  /// Whether pOffsets holds n + 1 nondecreasing offsets starting at 0
+  static bool validOffsets(const uint64_t* pOffsets, size_t n)
+  {
+    if (!pOffsets || pOffsets[0] != 0)
+      return false;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (pOffsets[i] > pOffsets[i + 1])
+        return false;
+    }
+    return true;
+  }
+
+  /// Whether all m indices are in [0, n)
+  static bool validIndices(const int32_t* pIndices, size_t m, int n)
+  {
+    if (!pIndices)
+      return false;
+
+    for (size_t i = 0; i < m; ++i)
+    {
+      if (!(0 <= pIndices[i] && pIndices[i] < n))
+        return false;
+    }
+    return true;
+  }
+
+private:
+  MappedFile _file;
+  const char* _pPos;
+};
+
+template<typename GR>
+class StpParser;
+
+template<typename GR>
+class StpPcstParser;
+
+template<typename GR>
+inline void getSnapshotInfo(const StpParser<GR>& parser,
+                            SnapshotInfo& info)
+{
+  info._name = parser.getName();
+}
+
+template<typename GR>
+inline void getSnapshotInfo(const StpPcstParser<GR>& parser,
+                            SnapshotInfo& info)
+{
+  typedef typename StpPcstParser<GR>::NodeSet NodeSet;
+  typedef typename NodeSet::const_iterator NodeSetIt;
+
+  info._name = parser.getName();
+  info._totalNodeProfit = parser.getTotalNodeProfit();
+
+  const NodeSet rootNodes = parser.getRootNodes();
+  info._rootNodes.clear();
+  for (NodeSetIt nodeIt = rootNodes.begin(); nodeIt != rootNodes.end(); ++nodeIt)
+  {
+    info._rootNodes.push_back(parser.getGraph()->id(*nodeIt));
+  }
+}
+
+/// Returns the original root nodes recorded in info
+template<typename PREGR>
+inline typename PREGR::NodeSet getSnapshotRootNodes(const PREGR& instance,
+                                                    const SnapshotInfo& info)
+{
+  typename PREGR::NodeSet rootNodes;
+  for (size_t i = 0; i < info._rootNodes.size(); ++i)
+  {
+    rootNodes.insert(instance.getOrgGraph().nodeFromId(info._rootNodes[i]));
+  }
+  return rootNodes;
+}
+
+/// Parses and preprocesses an instance, or loads it from the snapshot cache
+///
+/// If cacheDir is nonempty, the snapshot keyed by the input file and
+/// settings is loaded from cacheDir when present, otherwise it is written
+/// there after preprocessing. If rooted, the root nodes of the instance are
+/// passed on to the preprocessing.
+template<typename PREGR, typename PARSER>
+inline bool initSnapshotInstance(PREGR& instance,
+                                 PARSER& parser,
+                                 const std::string& cacheDir,
+                                 const std::string& settings,
+                                 bool rooted,
+                                 SnapshotInfo& info)
+{
+  std::string filename;
+  uint64_t key = 0;
+  if (!cacheDir.empty())
+  {
+    std::stringstream ss;
+    ss << settings << ";rooted=" << rooted;
+    key = Snapshot::key(cacheDir, std::vector<std::string>(1, parser.getFilename()), ss.str());
+    if (key != 0)
+      filename = Snapshot::filename(cacheDir, key);
+  }
+
+  if (!filename.empty() && instance.readSnapshot(filename, key, info))
+  {
+    return true;
+  }
+
+  if (!instance.init(&parser, false))
+  {
+    return false;
+  }
+
+  getSnapshotInfo(parser, info);
+  if (!rooted)
+  {
+    info._rootNodes.clear();
+  }
+  instance.preprocess(getSnapshotRootNodes(instance, info));
+  instance.compact();
+
+  if (!filename.empty())
+  {
+    instance.writeSnapshot(filename, key, info);
+  }
+
+  return true;
+}
+
+} // namespace mwcs
+} // namespace nina
+
+#endif // SNAPSHOT_H
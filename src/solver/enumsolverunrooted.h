@@ -18,6 +18,7 @@
 #include "mwcs.h"
 #include "mwcsgraph.h"
 #include "mwcspreprocessedgraph.h"
+#include "mwcssubinstance.h"
 
 #include "solver/solverunrooted.h"
 #include "solver/impl/solverrootedimpl.h"
@@ -80,12 +81,14 @@ public:
 
 protected:
   typedef MwcsPreprocessedGraph<Graph, WeightNodeMap, LabelNodeMap, WeightEdgeMap> MwcsPreGraphType;
+  typedef MwcsSubInstance<Graph, WeightNodeMap, LabelNodeMap, WeightEdgeMap> SubInstanceType;
   typedef lemon::FilterNodes<const Graph, BoolNodeMap> SubGraph;
   typedef typename SubGraph::Node SubNode;
   typedef typename SubGraph::NodeIt SubNodeIt;
   typedef typename SubGraph::ArcIt SubArcIt;
   typedef typename Graph::template NodeMap<Node> NodeMap;
   
+  typedef std::vector<NodeVector> NodeVectorVector;
   typedef std::vector<Edge> EdgeVector;
   typedef typename EdgeVector::const_iterator EdgeVectorIt;
   
@@ -140,8 +143,6 @@ private:
   
   bool solveBlock(MwcsPreGraphType& mwcsGraph,
                   Node orgC,
-                  int blockIndex,
-                  int nBlocks,
                   NodeSet& solutionUnrooted,
                   double& solutionScoreUnrooted,
                   double& solutionScoreUnrootedUB,
@@ -182,46 +183,110 @@ private:
     }
   }
   
-  void initLocalGraph(const Graph& g,
-                      const WeightNodeMap& scoreG,
-                      const LabelNodeMap& labelG,
-                      BoolNodeMap& filterG,
-                      Graph& subG,
-                      DoubleNodeMap& weightSubG,
-                      LabelNodeMap& labelSubG,
-                      NodeMap& mapToG,
-                      MwcsPreGraphType& mwcsSubGraph)
+  /// Solves a connected subinstance whose solution follows from its scores,
+  /// without materializing it; returns false if the subinstance is not trivial
+  bool solveTrivial(const SubInstanceType& subInstance,
+                    NodeSet& solutionSet,
+                    double& solutionScore)
   {
-    SubGraph subTmpSameCompG(g, filterG);
-    lemon::graphCopy(subTmpSameCompG, subG)
-      .nodeMap(scoreG, weightSubG)
-      .nodeMap(labelG, labelSubG)
-      .nodeCrossRef(mapToG)
-      .run();
+    solutionSet.clear();
+    solutionScore = 0;
+    
+    if (subInstance.getMinScore() >= 0)
+    {
+      // the entire subinstance
+      const NodeVector& nodes = subInstance.getNodes();
+      solutionSet.insert(nodes.begin(), nodes.end());
+      for (int i = 0; i < subInstance.getNodeCount(); ++i)
+      {
+        solutionScore += subInstance.getScore(i);
+      }
+    }
+    else if (subInstance.getNodeCount() == 2 && subInstance.getMaxScore() > 0)
+    {
+      // a single edge with one positive end
+      const int i = subInstance.getScore(0) > 0 ? 0 : 1;
+      solutionSet.insert(subInstance.getNode(i));
+      solutionScore = subInstance.getScore(i);
+    }
+    else if (subInstance.getMaxScore() > 0)
+    {
+      return false;
+    }
     
-    mwcsSubGraph.init(&subG, &labelSubG, &weightSubG, NULL);
+    if (solutionScore > _scoreUB)
+    {
+      _scoreUB = solutionScore;
+    }
+    if (g_verbosity > VERBOSE_NONE)
+    {
+      std::cerr << "[" << solutionScore << ", " << solutionScore << "]" << std::endl;
+    }
+    return true;
   }
   
-  void initLocalGraph(const Graph& g,
-                      const WeightNodeMap& scoreG,
-                      const LabelNodeMap& labelG,
-                      BoolNodeMap& filterG,
-                      Graph& subG,
-                      DoubleNodeMap& weightSubG,
-                      LabelNodeMap& labelSubG,
-                      NodeMap& mapToG,
-                      NodeMap& mapToSubG,
-                      MwcsPreGraphType& mwcsSubGraph)
+  /// Solves a block whose unrooted solution and solution rooted at the
+  /// cut node orgC follow from its scores, without materializing it;
+  /// returns false if the block is not trivial
+  bool solveTrivialBlock(const SubInstanceType& blockInstance,
+                         Node orgC,
+                         NodeSet& solutionUnrooted,
+                         double& solutionScoreUnrooted,
+                         NodeSet& solutionRooted,
+                         double& solutionScoreRooted) const
   {
-    SubGraph subTmpSameCompG(g, filterG);
-    lemon::graphCopy(subTmpSameCompG, subG)
-      .nodeMap(scoreG, weightSubG)
-      .nodeMap(labelG, labelSubG)
-      .nodeCrossRef(mapToG)
-      .nodeRef(mapToSubG)
-      .run();
+    const int c = orgC != lemon::INVALID ? blockInstance.getIndex(orgC) : -1;
+    assert(orgC == lemon::INVALID || c != -1);
+    
+    solutionUnrooted.clear();
+    solutionScoreUnrooted = 0;
+    solutionRooted.clear();
+    solutionScoreRooted = 0;
+    
+    if (blockInstance.getMaxScore() <= 0)
+    {
+      // negative block, only the cut node is kept
+      if (c != -1)
+      {
+        solutionRooted.insert(orgC);
+        solutionScoreRooted = blockInstance.getScore(c);
+      }
+    }
+    else if (blockInstance.getMinScore() >= 0)
+    {
+      // the entire block
+      const NodeVector& nodes = blockInstance.getNodes();
+      solutionUnrooted.insert(nodes.begin(), nodes.end());
+      for (int i = 0; i < blockInstance.getNodeCount(); ++i)
+      {
+        solutionScoreUnrooted += blockInstance.getScore(i);
+      }
+      if (c != -1)
+      {
+        solutionRooted = solutionUnrooted;
+        solutionScoreRooted = solutionScoreUnrooted;
+      }
+    }
+    else if (blockInstance.getNodeCount() == 2)
+    {
+      // a bridge with one positive end
+      const int i = blockInstance.getScore(0) > 0 ? 0 : 1;
+      solutionUnrooted.insert(blockInstance.getNode(i));
+      solutionScoreUnrooted = blockInstance.getScore(i);
+      if (c != -1)
+      {
+        solutionRooted = solutionUnrooted;
+        solutionRooted.insert(orgC);
+        solutionScoreRooted = c == i ? solutionScoreUnrooted
+                                     : solutionScoreUnrooted + blockInstance.getScore(c);
+      }
+    }
+    else
+    {
+      return false;
+    }
     
-    mwcsSubGraph.init(&subG, &labelSubG, &weightSubG, NULL);
+    return true;
   }
   
   void printNodeSet(const MwcsGraphType& mwcsGraph,
@@ -273,59 +338,56 @@ template<typename GR, typename WGHT, typename NLBL, typename EWGHT>
 inline bool EnumSolverUnrooted<GR, WGHT, NLBL, EWGHT>::solve(const MwcsGraphType& mwcsGraph)
 {
   const Graph& g = mwcsGraph.getGraph();
-  BoolNodeMap allowedNodesSameComp(g);
   
-  // 1. iterate over the components
+  // 1. group the nodes by component
   int nComponents = mwcsGraph.getComponentCount();
   const IntNodeMap& comp = mwcsGraph.getComponentMap();
   
+  NodeVectorVector nodesInComp(nComponents);
+  for (NodeIt node(g); node != lemon::INVALID; ++node)
+  {
+    nodesInComp[comp[node]].push_back(node);
+  }
+  
+  SubInstanceType subInstance(mwcsGraph);
   for (int compIdx = 0; compIdx < nComponents; ++compIdx)
   {
-    lemon::mapFill(g, allowedNodesSameComp, false);
-    for (NodeIt node(g); node != lemon::INVALID; ++node)
-    {
-      allowedNodesSameComp[node] = comp[node] == compIdx;
-    }
-    
-    Graph subG;
-    DoubleNodeMap weightSubG(subG);
-    LabelNodeMap labelSubG(subG);
-    NodeMap mapToG(subG);
-    MwcsPreGraphType mwcsSubGraph;
-    
-    // 2b. create subgraph
-    initLocalGraph(g,
-                   mwcsGraph.getScores(),
-                   mwcsGraph.getLabels(),
-                   allowedNodesSameComp,
-                   subG,
-                   weightSubG,
-                   labelSubG,
-                   mapToG,
-                   mwcsSubGraph);
+    subInstance.init(nodesInComp[compIdx]);
+    NodeVector().swap(nodesInComp[compIdx]);
     
     if (g_verbosity >= VERBOSE_ESSENTIAL)
     {
       std::cout << std::endl;
       std::cout << "// Considering component " << compIdx + 1 << "/" << nComponents
-                << ": contains " << mwcsSubGraph.getNodeCount() << " nodes and "
-                << mwcsSubGraph.getEdgeCount() << " edges" << std::endl;
+                << ": contains " << subInstance.getNodeCount() << " nodes and "
+                << subInstance.getEdgeCount() << " edges" << std::endl;
     }
     
-    // 3. solve
+    // 2. solve, the component is only copied if it is not trivial
     double solutionScore;
-    double solutionScoreUB;
-    NodeSet solutionSet;
-    if (!solveComponent(mwcsSubGraph, solutionSet, solutionScore, solutionScoreUB))
+    NodeSet orgSolutionSet;
+    if (!solveTrivial(subInstance, orgSolutionSet, solutionScore))
     {
-      return false;
+      Graph subG;
+      DoubleNodeMap weightSubG(subG);
+      NodeMap mapToG(subG);
+      MwcsPreGraphType mwcsSubGraph;
+      
+      subInstance.materialize(subG, weightSubG, mapToG, mwcsSubGraph);
+      
+      double solutionScoreUB;
+      NodeSet solutionSet;
+      if (!solveComponent(mwcsSubGraph, solutionSet, solutionScore, solutionScoreUB))
+      {
+        return false;
+      }
+      map(mwcsSubGraph, mapToG, solutionSet, orgSolutionSet);
     }
     
     if (solutionScore > _score)
     {
       _score = solutionScore;
-      _solutionSet.clear();
-      map(mwcsSubGraph, mapToG, solutionSet, _solutionSet);
+      _solutionSet.swap(orgSolutionSet);
     }
   }
   
@@ -382,12 +444,11 @@ inline bool EnumSolverUnrooted<GR, WGHT, NLBL, EWGHT>::solveComponent(MwcsPreGra
     
     Graph subG;
     DoubleNodeMap weightSubG(subG);
-    LabelNodeMap labelSubG(subG);
     NodeMap mapToG(subG);
     NodeMap mapToSubG(g);
     MwcsPreGraphType mwcsSubGraph;
     
-    BoolNodeMap sameBlock(g, false);
+    SubInstanceType blockInstance(mwcsGraph);
     
     int nBlocks = bcTree.getNumBlockTreeNodes();
     int blockIndex = 0;
@@ -407,43 +468,43 @@ inline bool EnumSolverUnrooted<GR, WGHT, NLBL, EWGHT>::solveComponent(MwcsPreGra
           Node orgC = c != lemon::INVALID ? bcTree.getArticulationPoint(c) : lemon::INVALID;
           
           const NodeSet& nodesInBlock = bcTree.getRealNodes(b);
+          blockInstance.init(nodesInBlock);
           
-          lemon::mapFill(g, sameBlock, false);
-          for (NodeSetIt nodeIt = nodesInBlock.begin(); nodeIt != nodesInBlock.end(); ++nodeIt)
+          if (g_verbosity >= VERBOSE_ESSENTIAL)
           {
-            sameBlock[*nodeIt] = true;
+            std::cout << std::endl;
+            std::cout << "// Considering block " << blockIndex + 1 << "/" << nBlocks
+                      << ": contains " << blockInstance.getNodeCount() << " nodes and "
+                      << blockInstance.getEdgeCount() << " edges" << std::endl;
           }
           
-          initLocalGraph(g,
-                         mwcsGraph.getScores(),
-                         mwcsGraph.getLabels(),
-                         sameBlock,
-                         subG,
-                         weightSubG,
-                         labelSubG,
-                         mapToG,
-                         mapToSubG,
-                         mwcsSubGraph);
-          
-          NodeSet solutionUnrooted, solutionRooted;
-          double scoreUnrooted, scoreRooted;
-          double scoreUnrootedUB, scoreRootedUB;
-          
-          assert(orgC == lemon::INVALID || mwcsSubGraph.getPreNodes(mapToSubG[orgC]).size() == 1);
+          NodeSet orgSolutionUnrooted, orgSolutionRooted;
+          double scoreUnrooted = 0, scoreRooted = 0;
           
-          if (!solveBlock(mwcsSubGraph,
-                          orgC != lemon::INVALID ? mapToSubG[orgC] : lemon::INVALID,
-                          blockIndex, nBlocks,
-                          solutionUnrooted, scoreUnrooted, scoreUnrootedUB,
-                          solutionRooted, scoreRooted, scoreRootedUB))
+          // the block is only copied if its solutions do not follow from its scores
+          if (!solveTrivialBlock(blockInstance, orgC,
+                                 orgSolutionUnrooted, scoreUnrooted,
+                                 orgSolutionRooted, scoreRooted))
           {
-            return false;
+            blockInstance.materialize(subG, weightSubG, mapToG, mapToSubG, mwcsSubGraph);
+            
+            NodeSet solutionUnrooted, solutionRooted;
+            double scoreUnrootedUB, scoreRootedUB;
+            
+            assert(orgC == lemon::INVALID || mwcsSubGraph.getPreNodes(mapToSubG[orgC]).size() == 1);
+            
+            if (!solveBlock(mwcsSubGraph,
+                            orgC != lemon::INVALID ? mapToSubG[orgC] : lemon::INVALID,
+                            solutionUnrooted, scoreUnrooted, scoreUnrootedUB,
+                            solutionRooted, scoreRooted, scoreRootedUB))
+            {
+              return false;
+            }
+            
+            map(mwcsSubGraph, mapToG, solutionUnrooted, orgSolutionUnrooted);
+            map(mwcsSubGraph, mapToG, solutionRooted, orgSolutionRooted);
           }
           
-          
-          NodeSet orgSolutionUnrooted;
-          map(mwcsSubGraph, mapToG, solutionUnrooted, orgSolutionUnrooted);
-          
           if (orgC == lemon::INVALID)
           {
             // there is no cut node, so just merge the solution a single node
@@ -459,7 +520,7 @@ inline bool EnumSolverUnrooted<GR, WGHT, NLBL, EWGHT>::solveComponent(MwcsPreGra
           }
           else
           {
-            if (scoreUnrooted != scoreRooted && solutionUnrooted != solutionRooted)
+            if (scoreUnrooted != scoreRooted && orgSolutionUnrooted != orgSolutionRooted)
             {
               // rooted solution is different
               
@@ -483,9 +544,6 @@ inline bool EnumSolverUnrooted<GR, WGHT, NLBL, EWGHT>::solveComponent(MwcsPreGra
             else
             {
               // rooted solution is not negative
-              NodeSet orgSolutionRooted;
-              map(mwcsSubGraph, mapToG, solutionRooted, orgSolutionRooted);
-
               // collapse it into the cut node and remove the other nodes
               NodeSet solutionComplementSet;
               std::set_difference(nodesInBlock.begin(), nodesInBlock.end(),
@@ -737,7 +795,6 @@ inline bool EnumSolverUnrooted<GR, WGHT, NLBL, EWGHT>::solveTriComp(MwcsPreGraph
   // create a new graph induced by nodesTriComp
   Graph subG;
   DoubleNodeMap weightSubG(subG);
-  LabelNodeMap labelSubG(subG);
   NodeMap mapToG(subG);
   NodeMap mapToSubG(g);
   MwcsPreGraphType mwcsSubGraph;
@@ -750,16 +807,9 @@ inline bool EnumSolverUnrooted<GR, WGHT, NLBL, EWGHT>::solveTriComp(MwcsPreGraph
   
   assert(orgC == lemon::INVALID || !sameTriComp[orgC]);
   
-  initLocalGraph(g,
-                 mwcsGraph.getScores(),
-                 mwcsGraph.getLabels(),
-                 sameTriComp,
-                 subG,
-                 weightSubG,
-                 labelSubG,
-                 mapToG,
-                 mapToSubG,
-                 mwcsSubGraph);
+  SubInstanceType triCompInstance(mwcsGraph);
+  triCompInstance.init(nodesTriComp);
+  triCompInstance.materialize(subG, weightSubG, mapToG, mapToSubG, mwcsSubGraph);
   
   // start by solving the unrooted formulation
 //  printNodeSet(mwcsGraph, nodesTriComp);
@@ -1076,24 +1126,9 @@ inline bool EnumSolverUnrooted<GR, WGHT, NLBL, EWGHT>::solveTriComp(MwcsPreGraph
 //  // print the gadget
 //  if (nV4 != lemon::INVALID)
 //    gadget.insert(nV4);
-//  subG.clear();
-//  lemon::mapFill(g, sameTriComp, false);
-//  for (NodeSetIt nodeIt = gadget.begin(); nodeIt != gadget.end(); ++nodeIt)
-//  {
-//    sameTriComp[*nodeIt] = true;
-//  }
-//  
 //  mwcsSubGraph.clear();
-//  initLocalGraph(g,
-//                 mwcsGraph.getScores(),
-//                 mwcsGraph.getLabels(),
-//                 sameTriComp,
-//                 subG,
-//                 weightSubG,
-//                 labelSubG,
-//                 mapToG,
-//                 mapToSubG,
-//                 mwcsSubGraph);
+//  triCompInstance.init(gadget);
+//  triCompInstance.materialize(subG, weightSubG, mapToG, mapToSubG, mwcsSubGraph);
 //
 //  std::cout << "gadget:" << std::endl;
 //  mwcsSubGraph.print(std::cout);
@@ -1342,8 +1377,6 @@ inline void EnumSolverUnrooted<GR, WGHT, NLBL, EWGHT>::rootSpqrTree(const Graph&
 template<typename GR, typename WGHT, typename NLBL, typename EWGHT>
 inline bool EnumSolverUnrooted<GR, WGHT, NLBL, EWGHT>::solveBlock(MwcsPreGraphType& mwcsGraph,
                                                                   Node orgC,
-                                                                  int blockIndex,
-                                                                  int nBlocks,
                                                                   NodeSet& solutionUnrooted,
                                                                   double& solutionScoreUnrooted,
                                                                   double& solutionScoreUnrootedUB,
@@ -1356,14 +1389,6 @@ inline bool EnumSolverUnrooted<GR, WGHT, NLBL, EWGHT>::solveBlock(MwcsPreGraphTy
   assert(orgC == lemon::INVALID || mwcsGraph.getOrgGraph().valid(orgC));
   assert(lemon::connected(g));
   
-  if (g_verbosity >= VERBOSE_ESSENTIAL)
-  {
-    std::cout << std::endl;
-    std::cout << "// Considering block " << blockIndex + 1 << "/" << nBlocks
-              << ": contains " << mwcsGraph.getNodeCount() << " nodes and "
-              << mwcsGraph.getEdgeCount() << " edges" << std::endl;
-  }
-
   if (lemon::mapMaxValue(g, mwcsGraph.getScores()) <= 0)
   {
     solutionUnrooted.clear();
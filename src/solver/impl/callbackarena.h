@@ -0,0 +1,211 @@
+/*
+ * callbackarena.h
+ *
+ *  Created on: 17-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef CALLBACKARENA_H
+#define CALLBACKARENA_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <new>
+#include <vector>
+#include <algorithm>
+
+namespace nina {
+namespace mwcs {
+
+/// Bump allocator for the temporaries of a single CPLEX callback (clone)
+///
+/// Memory is handed out from large blocks and never freed individually;
+/// the whole arena is rewound at the end of every callback invocation,
+/// see Invocation. Once the arena has grown to the footprint of the
+/// largest invocation, it consists of a single block and an invocation
+/// does not allocate any memory of the heap.
+///
+/// Every callback clone owns its arena, hence no locking is needed.
+/// Copying an arena yields a fresh, empty arena.
+class CallbackArena
+{
+public:
+  /// Scope of a callback invocation, rewinds the arena on exit
+  class Invocation
+  {
+  public:
+    Invocation(CallbackArena& arena)
+      : _arena(arena)
+    {
+    }
+
+    ~Invocation()
+    {
+      _arena.reset();
+    }
+
+  private:
+    CallbackArena& _arena;
+  };
+
+  CallbackArena(size_t blockSize = 1 << 16)
+    : _blockSize(blockSize)
+    , _blocks()
+    , _pCur(NULL)
+    , _pEnd(NULL)
+  {
+  }
+
+  CallbackArena(const CallbackArena& other)
+    : _blockSize(other._blockSize)
+    , _blocks()
+    , _pCur(NULL)
+    , _pEnd(NULL)
+  {
+  }
+
+  ~CallbackArena()
+  {
+    release();
+  }
+
+  /// Returns bytes of memory aligned to align (a power of two)
+  void* allocate(size_t bytes, size_t align)
+  {
+    assert(align != 0 && (align & (align - 1)) == 0);
+
+    char* p = alignUp(_pCur, align);
+    if (_pCur == NULL || p + bytes > _pEnd)
+    {
+      grow(bytes + align);
+      p = alignUp(_pCur, align);
+    }
+
+    _pCur = p + bytes;
+    return p;
+  }
+
+  /// Rewinds the arena, all memory handed out so far is released
+  void reset()
+  {
+    if (_blocks.size() > 1)
+    {
+      // replace the blocks by a single one that fits all of them
+      size_t size = 0;
+      for (size_t i = 0; i < _blocks.size(); ++i)
+      {
+        size += _blocks[i].second;
+      }
+      release();
+      addBlock(size);
+    }
+    else if (!_blocks.empty())
+    {
+      _pCur = _blocks.front().first;
+    }
+  }
+
+private:
+  typedef std::pair<char*, size_t> Block;
+  typedef std::vector<Block> BlockVector;
+
+  size_t _blockSize;
+  BlockVector _blocks;
+  char* _pCur;
+  char* _pEnd;
+
+  CallbackArena& operator=(const CallbackArena&);
+
+  static char* alignUp(char* p, size_t align)
+  {
+    const size_t offset = reinterpret_cast<size_t>(p) & (align - 1);
+    return offset == 0 ? p : p + (align - offset);
+  }
+
+  void grow(size_t bytes)
+  {
+    addBlock(std::max(bytes, _blocks.empty() ? _blockSize : 2 * _blocks.back().second));
+  }
+
+  void addBlock(size_t size)
+  {
+    char* pBlock = static_cast<char*>(malloc(size));
+    if (pBlock == NULL)
+      throw std::bad_alloc();
+
+    _blocks.push_back(Block(pBlock, size));
+    _pCur = pBlock;
+    _pEnd = pBlock + size;
+  }
+
+  void release()
+  {
+    for (size_t i = 0; i < _blocks.size(); ++i)
+    {
+      free(_blocks[i].first);
+    }
+    _blocks.clear();
+    _pCur = _pEnd = NULL;
+  }
+};
+
+/// STL allocator that allocates from a CallbackArena,
+/// deallocation is deferred to the next reset of the arena
+template<typename T>
+class ArenaAllocator
+{
+public:
+  typedef T value_type;
+
+  template<typename U>
+  struct rebind
+  {
+    typedef ArenaAllocator<U> other;
+  };
+
+  ArenaAllocator(CallbackArena& arena)
+    : _pArena(&arena)
+  {
+  }
+
+  template<typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other)
+    : _pArena(other.getArena())
+  {
+  }
+
+  T* allocate(size_t n)
+  {
+    return static_cast<T*>(_pArena->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, size_t)
+  {
+  }
+
+  CallbackArena* getArena() const
+  {
+    return _pArena;
+  }
+
+  template<typename U>
+  bool operator==(const ArenaAllocator<U>& other) const
+  {
+    return _pArena == other.getArena();
+  }
+
+  template<typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const
+  {
+    return _pArena != other.getArena();
+  }
+
+private:
+  CallbackArena* _pArena;
+};
+
+} // namespace mwcs
+} // namespace nina
+
+#endif // CALLBACKARENA_H
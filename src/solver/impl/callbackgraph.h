@@ -0,0 +1,156 @@
+/*
+ * callbackgraph.h
+ *
+ *  Created on: 17-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef CALLBACKGRAPH_H
+#define CALLBACKGRAPH_H
+
+#include <assert.h>
+#include <set>
+#include <vector>
+#include <lemon/core.h>
+#include "csrgraph.h"
+
+namespace nina {
+namespace mwcs {
+
+/// Thread-private copy of the graph and node weights of an instance,
+/// owned by a single CPLEX callback (clone)
+///
+/// The copy is laid out in variable order: the node of variable i has
+/// id i, hence the adjacency (CSR), the scores and the degrees are flat
+/// arrays indexed by variable and LP values can be read at Graph::id(v)
+/// without any translation.
+///
+/// LEMON maps register themselves at their graph, which is not thread-safe.
+/// A callback that only allocates maps of its own copy, and runs LEMON
+/// algorithms on it, hence does not need to lock. The copy is built without
+/// allocating maps of the source graph: nodes and edges are referenced
+/// by their (static) source ids. Copying a CallbackGraph preserves all ids,
+/// such that the nodes of a callback are also the nodes of its clones.
+template<typename GR,
+         typename NWGHT = typename GR::template NodeMap<double> >
+class CallbackGraph
+{
+public:
+  typedef GR SourceGraph;
+  typedef NWGHT SourceWeightNodeMap;
+  typedef typename SourceGraph::template NodeMap<int> SourceIntNodeMap;
+  typedef typename SourceGraph::Node SourceNode;
+  typedef typename SourceGraph::Edge SourceEdge;
+  typedef typename SourceGraph::NodeIt SourceNodeIt;
+  typedef std::set<SourceNode> SourceNodeSet;
+  typedef typename SourceNodeSet::const_iterator SourceNodeSetIt;
+
+  typedef CsrGraph Graph;
+  TEMPLATE_GRAPH_TYPEDEFS(Graph);
+  typedef DoubleNodeMap WeightNodeMap;
+  typedef std::set<Node> NodeSet;
+
+  /// Builds the copy, nodeMap gives the variable index of every node
+  CallbackGraph(const SourceGraph& g,
+                const SourceWeightNodeMap& weight,
+                const SourceIntNodeMap& nodeMap)
+    : _g()
+    , _weight(_g)
+    , _node(g.maxNodeId() + 1, lemon::INVALID)
+  {
+    std::vector<Edge> edge(g.maxEdgeId() + 1, lemon::INVALID);
+    IdRefMap<SourceNode, Node> nodeRef(_node);
+    IdRefMap<SourceEdge, Edge> edgeRef(edge);
+    _g.build(g, nodeMap, nodeRef, edgeRef);
+
+    for (SourceNodeIt v(g); v != lemon::INVALID; ++v)
+    {
+      _weight[nodeRef[v]] = weight[v];
+    }
+  }
+
+  CallbackGraph(const CallbackGraph& other)
+    : _g()
+    , _weight(_g)
+    , _node(other._node)
+  {
+    _g.build(other._g);
+    lemon::mapCopy(_g, other._weight, _weight);
+  }
+
+  const Graph& getGraph() const
+  {
+    return _g;
+  }
+
+  const WeightNodeMap& getScores() const
+  {
+    return _weight;
+  }
+
+  /// Number of nodes, i.e. variables
+  int getNodeCount() const
+  {
+    return _g.nodeNum();
+  }
+
+  /// Variable index of v
+  static int getIndex(Node v)
+  {
+    return Graph::id(v);
+  }
+
+  /// Node of variable index i
+  static Node getNode(int i)
+  {
+    return Graph::nodeFromId(i);
+  }
+
+  Node getNode(SourceNode v) const
+  {
+    assert(v != lemon::INVALID);
+    return _node[SourceGraph::id(v)];
+  }
+
+  NodeSet getNodes(const SourceNodeSet& nodes) const
+  {
+    NodeSet res;
+    for (SourceNodeSetIt nodeIt = nodes.begin(); nodeIt != nodes.end(); ++nodeIt)
+    {
+      res.insert(getNode(*nodeIt));
+    }
+    return res;
+  }
+
+private:
+  /// Reference map of CsrGraph::build(), indexed by source id
+  template<typename K, typename V>
+  class IdRefMap
+  {
+  public:
+    IdRefMap(std::vector<V>& ref)
+      : _ref(ref)
+    {
+    }
+
+    V& operator[](const K& k)
+    {
+      return _ref[SourceGraph::id(k)];
+    }
+
+  private:
+    std::vector<V>& _ref;
+  };
+
+  CallbackGraph& operator=(const CallbackGraph&);
+
+  Graph _g;
+  WeightNodeMap _weight;
+  /// Node of every source node, indexed by source node id
+  std::vector<Node> _node;
+};
+
+} // namespace mwcs
+} // namespace nina
+
+#endif // CALLBACKGRAPH_H
@@ -0,0 +1,509 @@
+/*
+ * arccut.h
+ *
+ *  Created on: 16-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef ARCCUT_H
+#define ARCCUT_H
+
+#include <ilcplex/ilocplex.h>
+#include <ilcplex/ilocplexi.h>
+#include <ilconcert/ilothread.h>
+#include <lemon/tolerance.h>
+#include <lemon/smart_graph.h>
+#include <vector>
+#include <queue>
+#include "backoff.h"
+#include "bk_alg.h"
+
+namespace nina {
+namespace mwcs {
+
+/// Directed cuts of the PCST arc model
+///
+/// Nodes and arcs are identified by their variable indices: arc j goes
+/// from node _arcSource[j] to node _arcTarget[j]. In the rooted model,
+/// the root nodes are given; in the unrooted model the root is chosen by
+/// the variables _r. The cut for a node set S and a node v in S reads
+/// z(delta^-(S)) + r(S) >= x_v. No LEMON maps on the input graph are
+/// used, so callbacks need not synchronize.
+class ArcCut
+{
+protected:
+  typedef std::vector<int> IntVector;
+  typedef IntVector::const_iterator IntVectorIt;
+
+  IloBoolVarArray _x;
+  IloBoolVarArray _z;
+  IloBoolVarArray _r;
+  const int _n;
+  const int _m;
+  const IntVector& _arcSource;
+  const IntVector& _arcTarget;
+  const IntVector _rootNodes;
+  const int _maxNumberOfCuts;
+  const lemon::Tolerance<double> _tol;
+  /// Out-arcs and in-arcs of every node in CSR form
+  IntVector _outOffset;
+  IntVector _outArcs;
+  IntVector _inOffset;
+  IntVector _inArcs;
+
+  // same epsilon as NodeCut
+  static constexpr double _epsilon = 1e-5;
+
+public:
+  ArcCut(IloBoolVarArray x,
+         IloBoolVarArray z,
+         IloBoolVarArray r,
+         int n,
+         int m,
+         const IntVector& arcSource,
+         const IntVector& arcTarget,
+         const IntVector& rootNodes,
+         int maxNumberOfCuts)
+    : _x(x)
+    , _z(z)
+    , _r(r)
+    , _n(n)
+    , _m(m)
+    , _arcSource(arcSource)
+    , _arcTarget(arcTarget)
+    , _rootNodes(rootNodes)
+    , _maxNumberOfCuts(maxNumberOfCuts)
+    , _tol(_epsilon)
+    , _outOffset()
+    , _outArcs()
+    , _inOffset()
+    , _inArcs()
+  {
+    initAdjacency(_arcSource, _outOffset, _outArcs);
+    initAdjacency(_arcTarget, _inOffset, _inArcs);
+  }
+
+  ArcCut(const ArcCut& other)
+    : _x(other._x)
+    , _z(other._z)
+    , _r(other._r)
+    , _n(other._n)
+    , _m(other._m)
+    , _arcSource(other._arcSource)
+    , _arcTarget(other._arcTarget)
+    , _rootNodes(other._rootNodes)
+    , _maxNumberOfCuts(other._maxNumberOfCuts)
+    , _tol(other._tol)
+    , _outOffset(other._outOffset)
+    , _outArcs(other._outArcs)
+    , _inOffset(other._inOffset)
+    , _inArcs(other._inArcs)
+  {
+  }
+
+  virtual ~ArcCut()
+  {
+  }
+
+protected:
+  bool rooted() const
+  {
+    return !_rootNodes.empty();
+  }
+
+  void initAdjacency(const IntVector& end,
+                     IntVector& offset,
+                     IntVector& arcs) const
+  {
+    offset.assign(_n + 1, 0);
+    for (int j = 0; j < _m; ++j)
+    {
+      ++offset[end[j] + 1];
+    }
+    for (int i = 0; i < _n; ++i)
+    {
+      offset[i + 1] += offset[i];
+    }
+
+    arcs.resize(_m);
+    IntVector pos(offset.begin(), offset.end() - 1);
+    for (int j = 0; j < _m; ++j)
+    {
+      arcs[pos[end[j]]++] = j;
+    }
+  }
+
+  /// Adds x_v <= z(delta^-(S)) + r(S) for every v in targets,
+  /// inS is the characteristic vector of S
+  template<typename CBK>
+  void addViolatedConstraints(CBK& cbk,
+                              const IntVector& S,
+                              const std::vector<bool>& inS,
+                              const IntVector& targets,
+                              int& nCuts)
+  {
+    IloExpr rhs(cbk.getEnv());
+    for (IntVectorIt it = S.begin(); it != S.end(); ++it)
+    {
+      for (int k = _inOffset[*it]; k < _inOffset[*it + 1]; ++k)
+      {
+        int j = _inArcs[k];
+        if (!inS[_arcSource[j]])
+          rhs += _z[j];
+      }
+      if (!rooted())
+        rhs += _r[*it];
+    }
+
+    for (IntVectorIt it = targets.begin(); it != targets.end(); ++it)
+    {
+      cbk.add(_x[*it] <= rhs, IloCplex::UseCutPurge).end();
+      ++nCuts;
+    }
+    rhs.end();
+  }
+};
+
+/// Separates integer solutions: the selected nodes that cannot be reached
+/// from the root via selected arcs form cycles, which are cut off
+class ArcCutLazyConstraint : public IloCplex::LazyConstraintCallbackI,
+                             public ArcCut
+{
+public:
+  ArcCutLazyConstraint(IloEnv env,
+                       IloBoolVarArray x,
+                       IloBoolVarArray z,
+                       IloBoolVarArray r,
+                       int n,
+                       int m,
+                       const IntVector& arcSource,
+                       const IntVector& arcTarget,
+                       const IntVector& rootNodes,
+                       int maxNumberOfCuts)
+    : IloCplex::LazyConstraintCallbackI(env)
+    , ArcCut(x, z, r, n, m, arcSource, arcTarget, rootNodes, maxNumberOfCuts)
+  {
+  }
+
+  ArcCutLazyConstraint(const ArcCutLazyConstraint& other)
+    : IloCplex::LazyConstraintCallbackI(other)
+    , ArcCut(other)
+  {
+  }
+
+  virtual ~ArcCutLazyConstraint()
+  {
+  }
+
+protected:
+  virtual void main()
+  {
+    separate();
+  }
+
+  virtual IloCplex::CallbackI* duplicateCallback() const
+  {
+    return (new (getEnv()) ArcCutLazyConstraint(*this));
+  }
+
+  void separate()
+  {
+    IloNumArray x_values(getEnv(), _n);
+    IloNumArray z_values(getEnv(), _m);
+    getValues(x_values, _x);
+    getValues(z_values, _z);
+
+    // mark the nodes reachable from the root via selected arcs
+    std::vector<bool> reached(_n, false);
+    std::queue<int> queue;
+    if (rooted())
+    {
+      for (IntVectorIt it = _rootNodes.begin(); it != _rootNodes.end(); ++it)
+      {
+        reached[*it] = true;
+        queue.push(*it);
+      }
+    }
+    else
+    {
+      IloNumArray r_values(getEnv(), _n);
+      getValues(r_values, _r);
+      for (int i = 0; i < _n; ++i)
+      {
+        if (r_values[i] > 0.5)
+        {
+          reached[i] = true;
+          queue.push(i);
+        }
+      }
+      r_values.end();
+    }
+
+    while (!queue.empty())
+    {
+      int i = queue.front();
+      queue.pop();
+      for (int k = _outOffset[i]; k < _outOffset[i + 1]; ++k)
+      {
+        int j = _outArcs[k];
+        if (z_values[j] > 0.5 && !reached[_arcTarget[j]])
+        {
+          reached[_arcTarget[j]] = true;
+          queue.push(_arcTarget[j]);
+        }
+      }
+    }
+
+    // every component of the remaining selected nodes is a violated set
+    std::vector<bool> inS(_n, false);
+    std::vector<bool> visited(_n, false);
+    int nCuts = 0;
+    for (int i = 0; i < _n; ++i)
+    {
+      if (reached[i] || visited[i] || x_values[i] < 0.5)
+        continue;
+
+      IntVector S;
+      visited[i] = true;
+      queue.push(i);
+      while (!queue.empty())
+      {
+        int u = queue.front();
+        queue.pop();
+        S.push_back(u);
+        inS[u] = true;
+        for (int dir = 0; dir < 2; ++dir)
+        {
+          const IntVector& offset = dir == 0 ? _outOffset : _inOffset;
+          const IntVector& arcs = dir == 0 ? _outArcs : _inArcs;
+          for (int k = offset[u]; k < offset[u + 1]; ++k)
+          {
+            int j = arcs[k];
+            int w = dir == 0 ? _arcTarget[j] : _arcSource[j];
+            if (z_values[j] > 0.5 && !reached[w] && !visited[w])
+            {
+              visited[w] = true;
+              queue.push(w);
+            }
+          }
+        }
+      }
+
+      addViolatedConstraints(*this, S, inS, S, nCuts);
+      for (IntVectorIt it = S.begin(); it != S.end(); ++it)
+      {
+        inS[*it] = false;
+      }
+    }
+
+    x_values.end();
+    z_values.end();
+  }
+};
+
+/// Separates fractional solutions by a maximum flow from an artificial
+/// source to every selected node, the arc capacities are given by z
+/// and the capacities of the arcs leaving the source by r (unrooted) or
+/// by the root nodes (rooted)
+class ArcCutUserCut : public IloCplex::UserCutCallbackI,
+                      public ArcCut
+{
+protected:
+  typedef lemon::SmartDigraph Digraph;
+  typedef Digraph::Arc DiArc;
+  typedef Digraph::Node DiNode;
+  typedef Digraph::ArcMap<double> CapacityMap;
+  typedef nina::BkFlowAlg<Digraph> BkAlg;
+
+  /// Node i of _h is node i of the model, node _n is the source;
+  /// arc j of _h is arc j of the model, arc _m + i goes from the source to i
+  Digraph _h;
+  CapacityMap _cap;
+  DiNode _diSource;
+  BkAlg* _pBK;
+
+  int _cutCount;
+  int _nodeNumber;
+
+  static constexpr double _cutEpsilon = 0.00001 * _epsilon;
+  const lemon::Tolerance<double> _cutTol;
+  BackOff _backOff;
+  bool _makeAttempt;
+
+public:
+  ArcCutUserCut(IloEnv env,
+                IloBoolVarArray x,
+                IloBoolVarArray z,
+                IloBoolVarArray r,
+                int n,
+                int m,
+                const IntVector& arcSource,
+                const IntVector& arcTarget,
+                const IntVector& rootNodes,
+                int maxNumberOfCuts,
+                const BackOff& backOff)
+    : IloCplex::UserCutCallbackI(env)
+    , ArcCut(x, z, r, n, m, arcSource, arcTarget, rootNodes, maxNumberOfCuts)
+    , _h()
+    , _cap(_h)
+    , _diSource(lemon::INVALID)
+    , _pBK(NULL)
+    , _cutCount(0)
+    , _nodeNumber(0)
+    , _cutTol(_cutEpsilon)
+    , _backOff(backOff)
+    , _makeAttempt(true)
+  {
+    init();
+  }
+
+  ArcCutUserCut(const ArcCutUserCut& other)
+    : IloCplex::UserCutCallbackI(other)
+    , ArcCut(other)
+    , _h()
+    , _cap(_h)
+    , _diSource(lemon::INVALID)
+    , _pBK(NULL)
+    , _cutCount(0)
+    , _nodeNumber(0)
+    , _cutTol(other._cutTol)
+    , _backOff(other._backOff)
+    , _makeAttempt(other._makeAttempt)
+  {
+    init();
+  }
+
+  virtual ~ArcCutUserCut()
+  {
+    delete _pBK;
+  }
+
+protected:
+  void init()
+  {
+    _h.reserveNode(_n + 1);
+    _h.reserveArc(_m + _n);
+    for (int i = 0; i < _n; ++i)
+    {
+      _h.addNode();
+    }
+    _diSource = _h.addNode();
+
+    for (int j = 0; j < _m; ++j)
+    {
+      _cap[_h.addArc(_h.nodeFromId(_arcSource[j]), _h.nodeFromId(_arcTarget[j]))] = 0;
+    }
+    for (int i = 0; i < _n; ++i)
+    {
+      _cap[_h.addArc(_diSource, _h.nodeFromId(i))] = 0;
+    }
+
+    _pBK = new BkAlg(_h, _cap);
+  }
+
+  virtual IloCplex::CallbackI* duplicateCallback() const
+  {
+    return (new (getEnv()) ArcCutUserCut(*this));
+  }
+
+  virtual void main()
+  {
+    if (_nodeNumber != getNnodes())
+    {
+      _nodeNumber = getNnodes();
+      _cutCount = 0;
+      _makeAttempt = _backOff.makeAttempt();
+    }
+
+    if (_makeAttempt && (_cutCount < _maxNumberOfCuts || _cutCount == -1 || (_nodeNumber == 0 && _cutCount < 50)))
+    {
+      separate();
+      ++_cutCount;
+    }
+  }
+
+  void separate()
+  {
+    IloNumArray x_values(getEnv(), _n);
+    IloNumArray z_values(getEnv(), _m);
+    getValues(x_values, _x);
+    getValues(z_values, _z);
+
+    for (int j = 0; j < _m; ++j)
+    {
+      _cap[_h.arcFromId(j)] = std::max(z_values[j], 0.);
+    }
+
+    std::vector<bool> isRoot(_n, false);
+    if (rooted())
+    {
+      for (IntVectorIt it = _rootNodes.begin(); it != _rootNodes.end(); ++it)
+      {
+        isRoot[*it] = true;
+      }
+      for (int i = 0; i < _n; ++i)
+      {
+        _cap[_h.arcFromId(_m + i)] = isRoot[i] ? 1 : 0;
+      }
+    }
+    else
+    {
+      IloNumArray r_values(getEnv(), _n);
+      getValues(r_values, _r);
+      for (int i = 0; i < _n; ++i)
+      {
+        _cap[_h.arcFromId(_m + i)] = std::max(r_values[i], 0.);
+      }
+      r_values.end();
+    }
+
+    std::vector<bool> inS(_n, false);
+    int nCuts = 0;
+
+    _pBK->setSource(_diSource);
+    for (int i = 0; i < _n; ++i)
+    {
+      const double x_i_value = x_values[i];
+      if (isRoot[i] || !_tol.nonZero(x_i_value))
+        continue;
+
+      _pBK->setTarget(_h.nodeFromId(i));
+      _pBK->setCap(_cap);
+      _pBK->run();
+
+      if (!_tol.less(_pBK->maxFlow(), x_i_value))
+        continue;
+
+      // S is the sink side of the minimum cut
+      IntVector S;
+      for (int k = 0; k < _n; ++k)
+      {
+        if (!_pBK->cut(_h.nodeFromId(k)))
+        {
+          S.push_back(k);
+          inS[k] = true;
+        }
+      }
+
+      // numerical instability may cause maxFlow < x_i_value
+      // even though there is nothing to cut
+      if (inS[i])
+      {
+        addViolatedConstraints(*this, S, inS, IntVector(1, i), nCuts);
+      }
+
+      for (IntVectorIt it = S.begin(); it != S.end(); ++it)
+      {
+        inS[*it] = false;
+      }
+    }
+
+    x_values.end();
+    z_values.end();
+  }
+};
+
+} // namespace mwcs
+} // namespace nina
+
+#endif // ARCCUT_H
@@ -15,10 +15,25 @@
 #include <lemon/tolerance.h>
 #include <set>
 #include <queue>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "utils.h"
+#include "solver/impl/callbackgraph.h"
+#include "solver/impl/callbackarena.h"
 
 namespace nina {
 namespace mwcs {
 
+/// Base class of the node separation callbacks
+///
+/// Every callback (clone) separates on its own CallbackGraph, hence none
+/// of them needs to lock. The CallbackGraph is in variable order, i.e.
+/// node v corresponds to variables _x[_g.id(v)] and _y[_g.id(v)], and
+/// node-wide passes iterate over the variable indices 0.._n-1. The temporaries of a separation round are
+/// allocated from the arena of the callback, which is rewound at the end
+/// of every invocation (see CallbackArena::Invocation); node sets are
+/// represented by sorted arena vectors (NodeVector).
 template<typename GR,
          typename NWGHT = typename GR::template NodeMap<double>,
          typename NLBL = typename GR::template NodeMap<std::string>,
@@ -26,8 +41,13 @@ template<typename GR,
 class NodeCut
 {
 public:
-  typedef GR Graph;
-  typedef NWGHT WeightNodeMap;
+  typedef CallbackGraph<GR, NWGHT> CallbackGraphType;
+  typedef typename CallbackGraphType::SourceGraph SourceGraph;
+  typedef typename CallbackGraphType::SourceWeightNodeMap SourceWeightNodeMap;
+  typedef typename CallbackGraphType::SourceIntNodeMap SourceIntNodeMap;
+  typedef typename CallbackGraphType::SourceNodeSet SourceNodeSet;
+  typedef typename CallbackGraphType::Graph Graph;
+  typedef typename CallbackGraphType::WeightNodeMap WeightNodeMap;
   typedef NLBL LabelNodeMap;
   typedef EWGHT WeightEdgeMap;
 
@@ -35,26 +55,99 @@ protected:
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
   typedef std::set<Node> NodeSet;
   typedef typename NodeSet::const_iterator NodeSetIt;
-  typedef std::vector<NodeSet> NodeSetVector;
-  typedef typename NodeSetVector::const_iterator NodeSetVectorIt;
+  typedef std::vector<Node, ArenaAllocator<Node> > NodeVector;
+  typedef typename NodeVector::const_iterator NodeVectorIt;
+  typedef std::vector<int, ArenaAllocator<int> > IntVector;
   typedef lemon::FilterNodes<const Graph, const BoolNodeMap> SubGraph;
   typedef typename SubGraph::NodeIt SubNodeIt;
   typedef typename SubGraph::EdgeIt SubEdgeIt;
   typedef std::queue<Node> NodeQueue;
 
+  /// Sorted range of nodes
+  class NodeRange
+  {
+  public:
+    typedef NodeVectorIt const_iterator;
+
+    NodeRange(NodeVectorIt first, NodeVectorIt last)
+      : _first(first)
+      , _last(last)
+    {
+    }
+
+    NodeVectorIt begin() const
+    {
+      return _first;
+    }
+
+    NodeVectorIt end() const
+    {
+      return _last;
+    }
+
+    size_t size() const
+    {
+      return _last - _first;
+    }
+
+    bool empty() const
+    {
+      return _first == _last;
+    }
+
+  private:
+    NodeVectorIt _first;
+    NodeVectorIt _last;
+  };
+
+  /// Nodes of the nonzero components, grouped by component
+  /// and in ascending order within every component
+  class ComponentVector
+  {
+  public:
+    ComponentVector(CallbackArena& arena)
+      : _nodes(arena)
+      , _offset(arena)
+    {
+    }
+
+    int size() const
+    {
+      return _offset.empty() ? 0 : static_cast<int>(_offset.size()) - 1;
+    }
+
+    NodeRange operator[](int i) const
+    {
+      assert(0 <= i && i < size());
+      return NodeRange(_nodes.begin() + _offset[i], _nodes.begin() + _offset[i + 1]);
+    }
+
+  private:
+    NodeVector _nodes;
+    /// Start of every component in _nodes, followed by _nodes.size()
+    IntVector _offset;
+
+    friend class NodeCut;
+  };
+
 protected:
   IloBoolVarArray _x;
   IloBoolVarArray _y;
+  const CallbackGraphType _callbackGraph;
   const Graph& _g;
   const WeightNodeMap& _weight;
-  const IntNodeMap& _nodeMap;
   const int _n;
   const int _maxNumberOfCuts;
   const lemon::Tolerance<double> _tol;
-  BoolNodeMap* _pNodeBoolMap;
-  const SubGraph* _pSubG;
-  IntNodeMap* _pComp;
-  IloFastMutex* _pMutex;
+  BoolNodeMap _nodeBoolMap;
+  const SubGraph _subG;
+  IntNodeMap _comp;
+  CallbackArena _arena;
+  /// LP values of _x and _y, reused by every invocation
+  IloNumArray _xValues;
+  IloNumArray _yValues;
+  /// Right-hand side of the cuts, reused by every invocation
+  IloExpr _rhs;
 
   // 1e-5 is the epsilon that CPLEX uses (for deciding integrality),
   // i.e. if |x| < 1e-5 it's considered to be 0 by CPLEX.
@@ -65,175 +158,215 @@ protected:
 public:
   NodeCut(IloBoolVarArray x,
           IloBoolVarArray y,
-          const Graph& g,
-          const WeightNodeMap& weight,
-          const IntNodeMap& nodeMap,
+          const SourceGraph& g,
+          const SourceWeightNodeMap& weight,
+          const SourceIntNodeMap& nodeMap,
           int n,
-          int maxNumberOfCuts,
-          IloFastMutex* pMutex)
+          int maxNumberOfCuts)
     : _x(x)
     , _y(y)
-    , _g(g)
-    , _weight(weight)
-    , _nodeMap(nodeMap)
+    , _callbackGraph(g, weight, nodeMap)
+    , _g(_callbackGraph.getGraph())
+    , _weight(_callbackGraph.getScores())
     , _n(n)
     , _maxNumberOfCuts(maxNumberOfCuts)
     , _tol(_epsilon)
-    , _pNodeBoolMap(NULL)
-    , _pSubG(NULL)
-    , _pComp(NULL)
-    , _pMutex(pMutex)
+    , _nodeBoolMap(_g)
+    , _subG(_g, _nodeBoolMap)
+    , _comp(_g)
+    , _arena()
+    , _xValues(x.getEnv(), n)
+    , _yValues(x.getEnv(), n)
+    , _rhs(x.getEnv())
   {
-    lock();
-    _pNodeBoolMap = new BoolNodeMap(_g);
-    _pSubG = new SubGraph(_g, *_pNodeBoolMap);
-    _pComp = new IntNodeMap(_g);
-    unlock();
+    assert(_n == _callbackGraph.getNodeCount());
   }
 
   NodeCut(const NodeCut& other)
     : _x(other._x)
     , _y(other._y)
-    , _g(other._g)
-    , _weight(other._weight)
-    , _nodeMap(other._nodeMap)
+    , _callbackGraph(other._callbackGraph)
+    , _g(_callbackGraph.getGraph())
+    , _weight(_callbackGraph.getScores())
     , _n(other._n)
     , _maxNumberOfCuts(other._maxNumberOfCuts)
     , _tol(other._tol)
-    , _pNodeBoolMap(NULL)
-    , _pSubG(NULL)
-    , _pComp(NULL)
-    , _pMutex(other._pMutex)
+    , _nodeBoolMap(_g)
+    , _subG(_g, _nodeBoolMap)
+    , _comp(_g)
+    , _arena(other._arena)
+    , _xValues(other._x.getEnv(), other._n)
+    , _yValues(other._x.getEnv(), other._n)
+    , _rhs(other._x.getEnv())
   {
-    lock();
-    _pNodeBoolMap = new BoolNodeMap(_g);
-    _pSubG = new SubGraph(_g, *_pNodeBoolMap);
-    _pComp = new IntNodeMap(_g);
-    unlock();
   }
 
   virtual ~NodeCut()
   {
-    lock();
-    delete _pNodeBoolMap;
-    delete _pSubG;
-    delete _pComp;
-    unlock();
+    if (g_verbosity >= VERBOSE_DEBUG && _arena.getInvocationCount() > 0)
+    {
+      std::cout << "// Node cut callback: " << _arena.getInvocationCount()
+                << " invocations, "
+                << static_cast<double>(_arena.getAllocationCount()) / _arena.getInvocationCount()
+                << " (max " << _arena.getMaxAllocationCount()
+                << ") allocations and at most " << _arena.getMaxBytes()
+                << " bytes per invocation, "
+                << _arena.getTotalTime() / _arena.getInvocationCount()
+                << " s (max " << _arena.getMaxTime()
+                << " s) per invocation" << std::endl;
+    }
+
+    _xValues.end();
+    _yValues.end();
+    _rhs.end();
   }
 
 protected:
-  void lock()
+  static bool contains(const NodeSet& S, Node v)
   {
-    if (_pMutex)
-      _pMutex->lock();
+    return S.find(v) != S.end();
   }
 
-  void unlock()
+  template<typename NS>
+  static bool contains(const NS& S, Node v)
   {
-    if (_pMutex)
-      _pMutex->unlock();
+    return std::binary_search(S.begin(), S.end(), v);
   }
-  
-  NodeSetVector determineConnectedComponents(const IloNumArray& x_values)
+
+  /// Whether the sorted node sets S and T share a node
+  template<typename NS1, typename NS2>
+  static bool intersects(const NS1& S, const NS2& T)
+  {
+    typename NS1::const_iterator it1 = S.begin();
+    typename NS2::const_iterator it2 = T.begin();
+    while (it1 != S.end() && it2 != T.end())
+    {
+      if (*it1 < *it2)
+        ++it1;
+      else if (*it2 < *it1)
+        ++it2;
+      else
+        return true;
+    }
+    return false;
+  }
+
+  /// Sorts S and removes duplicates
+  static void makeSet(NodeVector& S)
   {
-    // update _pSubG
-    for (NodeIt v(_g); v != lemon::INVALID; ++v)
+    std::sort(S.begin(), S.end());
+    S.erase(std::unique(S.begin(), S.end()), S.end());
+  }
+
+  template<typename NS1, typename NS2>
+  static bool equal(const NS1& S, const NS2& T)
+  {
+    return S.size() == T.size() && std::equal(S.begin(), S.end(), T.begin());
+  }
+
+  void determineConnectedComponents(const IloNumArray& x_values,
+                                    ComponentVector& nonZeroComponents)
+  {
+    // update _subG
+    for (int i = 0; i < _n; ++i)
     {
-      double val = x_values[_nodeMap[v]];
-      _pNodeBoolMap->set(v, _tol.nonZero(val));
+      _nodeBoolMap.set(_g.nodeFromId(i), _tol.nonZero(x_values[i]));
     }
     
-    int nComp = lemon::connectedComponents(*_pSubG, *_pComp);
+    int nComp = lemon::connectedComponents(_subG, _comp);
     
-    NodeSetVector nonZeroComponents(nComp, NodeSet());
-    for (SubNodeIt i(*_pSubG); i != lemon::INVALID; ++i)
+    // bucket the nodes by component, in ascending order
+    IntVector& offset = nonZeroComponents._offset;
+    offset.assign(nComp + 1, 0);
+    for (int id = 0; id < _n; ++id)
+    {
+      const Node i = _g.nodeFromId(id);
+      if (_nodeBoolMap[i])
+      {
+        ++offset[_comp[i] + 1];
+      }
+    }
+    for (int compIdx = 0; compIdx < nComp; ++compIdx)
     {
-      int compIdx = (*_pComp)[i];
-      nonZeroComponents[compIdx].insert(i);
+      offset[compIdx + 1] += offset[compIdx];
+    }
+
+    NodeVector& nodes = nonZeroComponents._nodes;
+    nodes.resize(offset[nComp]);
+    IntVector next(offset.begin(), offset.end() - 1, _arena);
+    for (int id = 0; id < _n; ++id)
+    {
+      const Node i = _g.nodeFromId(id);
+      if (_nodeBoolMap[i])
+      {
+        nodes[next[_comp[i]]++] = i;
+      }
     }
-    
-    return nonZeroComponents;
   }
-  
-  template<typename CBK>
-  void separateConnectedComponent(const NodeSet& S,
-                                  const NodeSet rootNodes,
-                                  const IloNumArray& x_values,
-                                  const IloNumArray& y_values,
-                                  CBK& cbk,
-                                  int& nCuts)
+
+  /// Inserts into dS the neighbors of S that are not in S
+  template<typename NS>
+  void determineBoundary(const NS& S,
+                         NodeVector& dS) const
   {
-#ifdef DEBUG
-    NodeSet intersection;
-    std::set_intersection(rootNodes.begin(), rootNodes.end(),
-                          S.begin(), S.end(),
-                          std::inserter(intersection, intersection.begin()));
-    assert(intersection.size() == 0);
-#endif
-
-    IloExpr rhs(cbk.getEnv());
-    
-    // determine dS
-    NodeSet dS;
-    for (NodeSetIt it = S.begin(); it != S.end(); ++it)
+    for (typename NS::const_iterator it = S.begin(); it != S.end(); ++it)
     {
       const Node i = *it;
       for (OutArcIt a(_g, i); a != lemon::INVALID; ++a)
       {
         const Node j = _g.target(a);
-        if (S.find(j) == S.end())
+        if (!contains(S, j))
         {
-          dS.insert(j);
+          dS.push_back(j);
         }
       }
     }
+    makeSet(dS);
+  }
+  
+  template<typename CBK, typename NS, typename RS>
+  void separateConnectedComponent(const NS& S,
+                                  const RS& rootNodes,
+                                  const IloNumArray& x_values,
+                                  const IloNumArray& y_values,
+                                  CBK& cbk,
+                                  int& nCuts)
+  {
+    assert(!intersects(rootNodes, S));
+
+    // determine dS
+    NodeVector dS(_arena);
+    determineBoundary(S, dS);
     
-    constructRHS(rhs, dS, S);
-    for (NodeSetIt it = S.begin(); it != S.end(); ++it)
+    constructRHS(_rhs, dS, S);
+    for (typename NS::const_iterator it = S.begin(); it != S.end(); ++it)
     {
       assert(isValid(*it, dS, S));
-      cbk.add(_x[_nodeMap[*it]] <= rhs, IloCplex::UseCutPurge).end();
+      cbk.add(_x[_g.id(*it)] <= _rhs, IloCplex::UseCutPurge).end();
       ++nCuts;
     }
-
-    rhs.end();
   }
   
-  template<typename CBK>
-  void separateRootedConnectedComponent(const NodeSet& S,
+  template<typename CBK, typename NS>
+  void separateRootedConnectedComponent(const NS& S,
                                         const Node root,
                                         const IloNumArray& x_values,
                                         CBK& cbk,
                                         int& nCuts)
   {
-    assert(S.find(root) == S.end());
+    assert(!contains(S, root));
 
-    IloExpr rhs(cbk.getEnv());
-    
     // determine dS
-    NodeSet dS;
-    for (NodeSetIt it = S.begin(); it != S.end(); ++it)
-    {
-      const Node i = *it;
-      for (OutArcIt a(_g, i); a != lemon::INVALID; ++a)
-      {
-        const Node j = _g.target(a);
-        if (S.find(j) == S.end())
-        {
-          dS.insert(j);
-        }
-      }
-    }
+    NodeVector dS(_arena);
+    determineBoundary(S, dS);
     
-    constructRHS(rhs, dS);
-    for (NodeSetIt it = S.begin(); it != S.end(); ++it)
+    constructRHS(_rhs, dS);
+    for (typename NS::const_iterator it = S.begin(); it != S.end(); ++it)
     {
       assert(isValid(*it, dS, S));
-      cbk.add(_x[_nodeMap[*it]] <= rhs, IloCplex::UseCutPurge).end();
+      cbk.add(_x[_g.id(*it)] <= _rhs, IloCplex::UseCutPurge).end();
       ++nCuts;
     }
-    
-    rhs.end();
   }
 
   void printNonZeroVars(IloCplex::ControlCallbackI& cbk,
@@ -241,187 +374,148 @@ protected:
                         IloNumArray values) const
   {
     std::cerr << cbk.getNnodes() << ":";
-    for (NodeIt i(_g); i != lemon::INVALID; ++i)
+    for (int i = 0; i < _n; ++i)
     {
-      double i_value = values[_nodeMap[i]];
+      double i_value = values[i];
       if (!_tol.nonZero(i_value)) continue;
-      std::cerr << " " << variables[_nodeMap[i]].getName()
-                << " (" << _g.id(i) << ", " << _weight[i] << ", " << i_value << ") " ;
+      std::cerr << " " << variables[i].getName()
+                << " (" << i << ", " << _weight[_g.nodeFromId(i)] << ", " << i_value << ") " ;
 
-      if (cbk.getDirection(variables[_nodeMap[i]]) == CPX_BRANCH_UP)
+      if (cbk.getDirection(variables[i]) == CPX_BRANCH_UP)
         std::cerr << "*";
     }
     std::cerr << std::endl;
   }
 
-  void printNodeSet(const NodeSet& nodes,
+  template<typename NS>
+  void printNodeSet(const NS& nodes,
                     IloBoolVarArray variables,
                     IloNumArray values) const
   {
     std::cout.precision(std::numeric_limits<double>::digits10);
     bool first = true;
-    for (NodeSetIt it = nodes.begin(); it != nodes.end(); it++)
+    for (typename NS::const_iterator it = nodes.begin(); it != nodes.end(); it++)
     {
       if (!first)
         std::cout << " ";
       else
         first = false;
 
-      std::cout << _g.id(*it) << "(" << variables[_nodeMap[*it]].getName()
-                << " = " << std::fixed << values[_nodeMap[*it]]
-                << (_tol.nonZero(values[_nodeMap[*it]]) ? "*" : "") << ")";
+      std::cout << _g.id(*it) << "(" << variables[_g.id(*it)].getName()
+                << " = " << std::fixed << values[_g.id(*it)]
+                << (_tol.nonZero(values[_g.id(*it)]) ? "*" : "") << ")";
     }
     std::cout << std::endl;
   }
   
-  void printNodeSet(const NodeSet& nodes,
+  template<typename NS>
+  void printNodeSet(const NS& nodes,
                     IloBoolVarArray variables) const
   {
     bool first = true;
-    for (NodeSetIt it = nodes.begin(); it != nodes.end(); it++)
+    for (typename NS::const_iterator it = nodes.begin(); it != nodes.end(); it++)
     {
       if (!first)
         std::cout << " ";
       else
         first = false;
       
-      std::cout << _g.id(*it) << "(" << variables[_nodeMap[*it]].getName() << ")";
+      std::cout << _g.id(*it) << "(" << variables[_g.id(*it)].getName() << ")";
     }
     std::cout << std::endl;
   }
   
-  template<typename CBK>
+  template<typename CBK, typename NS>
   void addViolatedConstraint(CBK& cbk,
                              Node target,
-                             const NodeSet& dS)
+                             const NS& dS)
   {
     assert(isValid(target, dS));
     if (dS.empty())
     {
-      //std::cout << cbk.getNnodes() << ": " << _x[_nodeMap[target]].getName() << " <= 0" << std::endl;
-      cbk.add(_x[_nodeMap[target]] <= 0);
+      //std::cout << cbk.getNnodes() << ": " << _x[_g.id(target)].getName() << " <= 0" << std::endl;
+      cbk.add(_x[_g.id(target)] <= 0);
       // there should only be one component!
       assert(false);
     }
     else
     {
-      IloExpr expr(cbk.getEnv());
-      
-      //bool first = true;
-      //std::cout << cbk.getNnodes() << ": " << _x[_nodeMap[target]].getName() << " <=";
-      for (NodeSetIt nodeIt = dS.begin(); nodeIt != dS.end(); nodeIt++)
-      {
-        expr += _x[_nodeMap[*nodeIt]];
-        
-        //std::cout << (first ? " " : " + ") << _x[_nodeMap[*nodeIt]].getName();
-        //first = false;
-      }
+      constructRHS(_rhs, dS);
       
-      IloConstraint constraint = _x[_nodeMap[target]] <= expr;
+      IloConstraint constraint = _x[_g.id(target)] <= _rhs;
       cbk.add(constraint, IloCplex::UseCutPurge);
       constraint.end();
-      
-      expr.end();
     }
   }
   
-  bool isValid(Node target, const NodeSet& dS) const
+  template<typename NS>
+  bool isValid(Node target, const NS& dS) const
   {
-    return dS.find(target) == dS.end();
+    return !contains(dS, target);
   }
   
-  template<typename CBK>
+  template<typename CBK, typename NS1, typename NS2>
   void addViolatedConstraint(CBK& cbk,
                              Node target,
-                             const NodeSet& dS,
-                             const NodeSet& S)
+                             const NS1& dS,
+                             const NS2& S)
   {
     assert(isValid(target, dS, S));
     if (dS.empty() && S.empty())
     {
-      //std::cout << cbk.getNnodes() << ": " << _x[_nodeMap[target]].getName() << " <= 0" << std::endl;
-      cbk.add(_x[_nodeMap[target]] <= 0);
+      //std::cout << cbk.getNnodes() << ": " << _x[_g.id(target)].getName() << " <= 0" << std::endl;
+      cbk.add(_x[_g.id(target)] <= 0);
       // target should be in S!
       assert(false);
     }
     else
     {
-      IloExpr expr(cbk.getEnv());
-      
-      //bool first = true;
-      //std::cout << cbk.getNnodes() << ": " << _x[_nodeMap[target]].getName() << " <=";
-      for (NodeSetIt nodeIt = dS.begin(); nodeIt != dS.end(); nodeIt++)
-      {
-        expr += _x[_nodeMap[*nodeIt]];
-        
-        //std::cout << (first ? " " : " + ") << _x[_nodeMap[*nodeIt]].getName();
-        //first = false;
-      }
+      constructRHS(_rhs, dS, S);
       
-      for (NodeSetIt nodeIt = S.begin(); nodeIt != S.end(); nodeIt++)
-      {
-        expr += _y[_nodeMap[*nodeIt]];
-        
-        //std::cout << (first ? " " : " + ") << _y[_nodeMap[*nodeIt]].getName();
-        //first = false;
-      }
-      
-      //std::cout << std::endl;
-      
-      IloConstraint constraint = _x[_nodeMap[target]] <= expr;
+      IloConstraint constraint = _x[_g.id(target)] <= _rhs;
       cbk.add(constraint, IloCplex::UseCutPurge);
       constraint.end();
-      
-      expr.end();
     }
   }
 
+  template<typename NS>
   void constructRHS(IloExpr& rhs,
-                    const NodeSet& dS)
+                    const NS& dS)
   {
     rhs.clear();
-    for (NodeSetIt nodeIt = dS.begin(); nodeIt != dS.end(); nodeIt++)
+    for (typename NS::const_iterator nodeIt = dS.begin(); nodeIt != dS.end(); nodeIt++)
     {
-      rhs += _x[_nodeMap[*nodeIt]];
+      rhs += _x[_g.id(*nodeIt)];
     }
   }
   
+  template<typename NS1, typename NS2>
   void constructRHS(IloExpr& rhs,
-                    const NodeSet& dS,
-                    const NodeSet& S)
+                    const NS1& dS,
+                    const NS2& S)
   {
     rhs.clear();
-    for (NodeSetIt nodeIt = dS.begin(); nodeIt != dS.end(); nodeIt++)
+    for (typename NS1::const_iterator nodeIt = dS.begin(); nodeIt != dS.end(); nodeIt++)
     {
-      rhs += _x[_nodeMap[*nodeIt]];
+      rhs += _x[_g.id(*nodeIt)];
     }
     
-    for (NodeSetIt nodeIt = S.begin(); nodeIt != S.end(); nodeIt++)
+    for (typename NS2::const_iterator nodeIt = S.begin(); nodeIt != S.end(); nodeIt++)
     {
-      rhs += _y[_nodeMap[*nodeIt]];
+      rhs += _y[_g.id(*nodeIt)];
     }
   }
 
+  template<typename NS1, typename NS2>
   bool isValid(Node target,
-               const NodeSet& dS,
-               const NodeSet& S) const
+               const NS1& dS,
+               const NS2& S)
   {
-    NodeSet ddS;
-    for (NodeSetIt nodeIt = S.begin(); nodeIt != S.end(); ++nodeIt)
-    {
-      Node u = *nodeIt;
-      for (OutArcIt a(_g, u); a != lemon::INVALID; ++a)
-      {
-        Node v = _g.target(a);
-        if (S.find(v) == S.end())
-        {
-          ddS.insert(v);
-        }
-      }
-    }
+    NodeVector ddS(_arena);
+    determineBoundary(S, ddS);
     
     // let's do a bfs from target
-    NodeSet SS;
+    NodeVector SS(_arena);
     BoolNodeMap visited(_g, false);
 
     NodeQueue Q;
@@ -431,26 +525,27 @@ protected:
       Node v = Q.front();
       Q.pop();
       visited[v] = true;
-      SS.insert(v);
+      SS.push_back(v);
       
       for (IncEdgeIt e(_g, v); e != lemon::INVALID; ++e)
       {
         Node u = _g.oppositeNode(v, e);
-        if (!visited[u] && dS.find(u) == dS.end())
+        if (!visited[u] && !contains(dS, u))
         {
           Q.push(u);
         }
       }
     }
+    makeSet(SS);
     
-    if (S != SS)
+    if (!equal(S, SS))
     {
       std::cerr << std::endl << "SS" << std::endl;
       printNodeSet(SS, _y);
       return false;
     }
     
-    if (dS != ddS)
+    if (!equal(dS, ddS))
     {
       std::cerr << std::endl << "ddS" << std::endl;
       printNodeSet(ddS, _x);
@@ -459,13 +554,13 @@ protected:
     else
     {
       // target must be in S
-      if (S.find(target) == S.end())
+      if (!contains(S, target))
       {
         return false;
       }
       
       // but must not be in dS
-      if (dS.find(target) != dS.end())
+      if (contains(dS, target))
       {
         return false;
       }
@@ -15,8 +15,6 @@
 #include <lemon/smart_graph.h>
 #include <vector>
 #include <set>
-#include <queue>
-#include <list>
 #include "nodecut.h"
 
 namespace nina {
@@ -30,28 +28,31 @@ class NodeCutLazy : public IloCplex::LazyConstraintCallbackI,
                     public NodeCut<GR, NWGHT, NLBL, EWGHT>
 {
 public:
-  typedef GR Graph;
-  typedef NWGHT WeightNodeMap;
+  typedef NodeCut<GR, NWGHT, NLBL, EWGHT> Parent;
+  typedef typename Parent::CallbackGraphType CallbackGraphType;
+  typedef typename Parent::SourceGraph SourceGraph;
+  typedef typename Parent::SourceWeightNodeMap SourceWeightNodeMap;
+  typedef typename Parent::SourceIntNodeMap SourceIntNodeMap;
+  typedef typename Parent::SourceNodeSet SourceNodeSet;
+  typedef typename Parent::Graph Graph;
+  typedef typename Parent::WeightNodeMap WeightNodeMap;
   typedef NLBL LabelNodeMap;
   typedef EWGHT WeightEdgeMap;
-  typedef NodeCut<GR, NWGHT, NLBL, EWGHT> Parent;
   
   using Parent::_x;
   using Parent::_y;
+  using Parent::_callbackGraph;
   using Parent::_g;
   using Parent::_weight;
-  using Parent::_nodeMap;
   using Parent::_n;
   using Parent::_maxNumberOfCuts;
   using Parent::_tol;
-  using Parent::_pNodeBoolMap;
-  using Parent::_pSubG;
-  using Parent::_pComp;
-  using Parent::_pMutex;
+  using Parent::_nodeBoolMap;
+  using Parent::_subG;
+  using Parent::_comp;
+  using Parent::_arena;
   using Parent::_epsilon;
   
-  using Parent::lock;
-  using Parent::unlock;
   using Parent::determineConnectedComponents;
   using Parent::separateConnectedComponent;
   
@@ -62,14 +63,13 @@ public:
   NodeCutLazy(IloEnv env,
               IloBoolVarArray x,
               IloBoolVarArray y,
-              const Graph& g,
-              const WeightNodeMap& weight,
-              const IntNodeMap& nodeMap,
+              const SourceGraph& g,
+              const SourceWeightNodeMap& weight,
+              const SourceIntNodeMap& nodeMap,
               int n,
-              int maxNumberOfCuts,
-              IloFastMutex* pMutex)
+              int maxNumberOfCuts)
     : IloCplex::LazyConstraintCallbackI(env)
-    , Parent(x, y, g, weight, nodeMap, n, maxNumberOfCuts, pMutex)
+    , Parent(x, y, g, weight, nodeMap, n, maxNumberOfCuts)
   {
   }
   
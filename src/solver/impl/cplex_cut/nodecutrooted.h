@@ -21,37 +21,43 @@ template<typename GR,
 class NodeCutRootedLazyConstraint : public NodeCutLazy<GR, NWGHT, NLBL, EWGHT>
 {
 public:
-  typedef GR Graph;
-  typedef NWGHT WeightNodeMap;
+  typedef NodeCutLazy<GR, NWGHT, NLBL, EWGHT> Parent;
+  typedef typename Parent::CallbackGraphType CallbackGraphType;
+  typedef typename Parent::SourceGraph SourceGraph;
+  typedef typename Parent::SourceWeightNodeMap SourceWeightNodeMap;
+  typedef typename Parent::SourceIntNodeMap SourceIntNodeMap;
+  typedef typename Parent::SourceNodeSet SourceNodeSet;
+  typedef typename Parent::Graph Graph;
+  typedef typename Parent::WeightNodeMap WeightNodeMap;
   typedef NLBL LabelNodeMap;
   typedef EWGHT WeightEdgeMap;
-  typedef NodeCutLazy<GR, NWGHT, NLBL, EWGHT> Parent;
 
 protected:
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
 
   typedef typename Parent::NodeSet NodeSet;
   typedef typename Parent::NodeSetIt NodeSetIt;
-  typedef typename Parent::NodeSetVector NodeSetVector;
-  typedef typename Parent::NodeSetVectorIt NodeSetVectorIt;
+  typedef typename Parent::NodeVector NodeVector;
+  typedef typename Parent::NodeVectorIt NodeVectorIt;
+  typedef typename Parent::NodeRange NodeRange;
+  typedef typename Parent::ComponentVector ComponentVector;
   typedef typename Parent::SubGraph SubGraph;
   typedef typename Parent::SubNodeIt SubNodeIt;
   
   using Parent::_x;
+  using Parent::_callbackGraph;
   using Parent::_g;
   using Parent::_weight;
-  using Parent::_nodeMap;
   using Parent::_n;
   using Parent::_maxNumberOfCuts;
   using Parent::_tol;
-  using Parent::_pNodeBoolMap;
-  using Parent::_pMutex;
+  using Parent::_nodeBoolMap;
   using Parent::_y;
-  using Parent::_pSubG;
-  using Parent::_pComp;
+  using Parent::_subG;
+  using Parent::_comp;
+  using Parent::_arena;
+  using Parent::_xValues;
   
-  using Parent::lock;
-  using Parent::unlock;
   using Parent::addViolatedConstraint;
   using Parent::getEnv;
   using Parent::getValues;
@@ -60,21 +66,23 @@ protected:
   using Parent::add;
   using Parent::determineConnectedComponents;
   using Parent::separateRootedConnectedComponent;
+  using Parent::contains;
+  using Parent::makeSet;
+  using Parent::equal;
   
   friend class NodeCut<GR, NWGHT, NLBL, EWGHT>;
 
 public:
   NodeCutRootedLazyConstraint(IloEnv env,
                               IloBoolVarArray x,
-                              const Graph& g,
-                              const WeightNodeMap& weight,
-                              NodeSet rootNodes,
-                              const IntNodeMap& nodeMap,
+                              const SourceGraph& g,
+                              const SourceWeightNodeMap& weight,
+                              const SourceNodeSet& rootNodes,
+                              const SourceIntNodeMap& nodeMap,
                               int n,
-                              int maxNumberOfCuts,
-                              IloFastMutex* pMutex)
-    : Parent(env, x, IloBoolVarArray(), g, weight, nodeMap, n, maxNumberOfCuts, pMutex)
-    , _rootNodes(rootNodes)
+                              int maxNumberOfCuts)
+    : Parent(env, x, IloBoolVarArray(), g, weight, nodeMap, n, maxNumberOfCuts)
+    , _rootNodes(_callbackGraph.getNodes(rootNodes))
   {
   }
 
@@ -94,6 +102,7 @@ protected:
 protected:
   virtual void main()
   {
+    CallbackArena::Invocation invocation(_arena);
     separate();
   }
 
@@ -104,28 +113,26 @@ protected:
   
   void separate()
   {
-    IloNumArray x_values(getEnv(), _n);
-    getValues(x_values, _x);
+    getValues(_xValues, _x);
     
     // determine connected components
-    NodeSetVector nonZeroComponents = determineConnectedComponents(x_values);
+    ComponentVector nonZeroComponents(_arena);
+    determineConnectedComponents(_xValues, nonZeroComponents);
     
     int nCuts = 0;
-    for (NodeSetVectorIt it = nonZeroComponents.begin(); it != nonZeroComponents.end(); ++it)
+    for (int compIdx = 0; compIdx < nonZeroComponents.size(); ++compIdx)
     {
-      const NodeSet& nonZeroComponent = *it;
+      const NodeRange nonZeroComponent = nonZeroComponents[compIdx];
       for (NodeSetIt rootIt = _rootNodes.begin(); rootIt != _rootNodes.end(); ++rootIt)
       {
         Node root = *rootIt;
-        if (nonZeroComponent.find(root) == nonZeroComponent.end())
+        if (!contains(nonZeroComponent, root))
         {
-          separateRootedConnectedComponent(*it, *rootIt, x_values, *this, nCuts);
+          separateRootedConnectedComponent(nonZeroComponent, *rootIt, _xValues, *this, nCuts);
         }
       }
     }
     
-    x_values.end();
-    
 //    std::cerr << "#comps: " << nonZeroComponents.size() << ", generated " << nCuts << " lazy cuts" << std::endl;
   }
 };
@@ -137,11 +144,16 @@ template<typename GR,
 class NodeCutRootedUserCut : public NodeCutUser<GR, NWGHT, NLBL, EWGHT>
 {
 public:
-  typedef GR Graph;
-  typedef NWGHT WeightNodeMap;
+  typedef NodeCutUser<GR, NWGHT, NLBL, EWGHT> Parent;
+  typedef typename Parent::CallbackGraphType CallbackGraphType;
+  typedef typename Parent::SourceGraph SourceGraph;
+  typedef typename Parent::SourceWeightNodeMap SourceWeightNodeMap;
+  typedef typename Parent::SourceIntNodeMap SourceIntNodeMap;
+  typedef typename Parent::SourceNodeSet SourceNodeSet;
+  typedef typename Parent::Graph Graph;
+  typedef typename Parent::WeightNodeMap WeightNodeMap;
   typedef NLBL LabelNodeMap;
   typedef EWGHT WeightEdgeMap;
-  typedef NodeCutUser<GR, NWGHT, NLBL, EWGHT> Parent;
 
 protected:
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
@@ -158,29 +170,29 @@ protected:
   typedef typename Parent::CapacityMap CapacityMap;
   typedef typename Parent::NodeSet NodeSet;
   typedef typename Parent::NodeSetIt NodeSetIt;
-  typedef typename Parent::NodeSetVector NodeSetVector;
-  typedef typename Parent::NodeSetVectorIt NodeSetVectorIt;
+  typedef typename Parent::NodeVector NodeVector;
+  typedef typename Parent::NodeVectorIt NodeVectorIt;
+  typedef typename Parent::NodeRange NodeRange;
+  typedef typename Parent::ComponentVector ComponentVector;
   typedef typename Parent::SubGraph SubGraph;
   typedef typename Parent::SubNodeIt SubNodeIt;
   typedef typename Parent::NodeQueue NodeQueue;
-  typedef typename Parent::DiNodeQueue DiNodeQueue;
   typedef typename Parent::DiNodeSet DiNodeSet;
   typedef typename Parent::DiNodeSetIt DiNodeSetIt;
-  typedef typename Parent::DiNodeList DiNodeList;
-  typedef typename Parent::DiNodeListIt DiNodeListIt;
+  typedef typename Parent::DiNodeVector DiNodeVector;
+  typedef typename Parent::DiNodeVectorIt DiNodeVectorIt;
   typedef typename Parent::BkAlg BkAlg;
   typedef typename Parent::DiBoolNodeMap DiBoolNodeMap;
   
   using Parent::_x;
   using Parent::_y;
+  using Parent::_callbackGraph;
   using Parent::_g;
   using Parent::_weight;
-  using Parent::_nodeMap;
   using Parent::_n;
   using Parent::_maxNumberOfCuts;
   using Parent::_tol;
-  using Parent::_pNodeBoolMap;
-  using Parent::_pMutex;
+  using Parent::_nodeBoolMap;
   using Parent::_epsilon;
   using Parent::_cutEpsilon;
   using Parent::_h;
@@ -194,11 +206,11 @@ protected:
   using Parent::_marked;
   using Parent::_cutCount;
   using Parent::_nodeNumber;
-  using Parent::_pSubG;
-  using Parent::_pComp;
+  using Parent::_subG;
+  using Parent::_comp;
+  using Parent::_arena;
+  using Parent::_xValues;
   
-  using Parent::lock;
-  using Parent::unlock;
   using Parent::determineFwdCutSet;
   using Parent::determineBwdCutSet;
   using Parent::addViolatedConstraint;
@@ -209,22 +221,24 @@ protected:
   using Parent::add;
   using Parent::determineConnectedComponents;
   using Parent::separateRootedConnectedComponent;
+  using Parent::contains;
+  using Parent::makeSet;
+  using Parent::equal;
   
   friend class NodeCut<GR, NWGHT, NLBL, EWGHT>;
 
 public:
   NodeCutRootedUserCut(IloEnv env,
                        IloBoolVarArray x,
-                       const Graph& g,
-                       const WeightNodeMap& weight,
-                       NodeSet rootNodes,
-                       const IntNodeMap& nodeMap,
+                       const SourceGraph& g,
+                       const SourceWeightNodeMap& weight,
+                       const SourceNodeSet& rootNodes,
+                       const SourceIntNodeMap& nodeMap,
                        int n,
                        int maxNumberOfCuts,
-                       IloFastMutex* pMutex,
                        BackOff backOff)
-    : Parent(env, x, IloBoolVarArray(), g, weight, nodeMap, n, maxNumberOfCuts, pMutex, backOff)
-    , _rootNodes(rootNodes)
+    : Parent(env, x, IloBoolVarArray(), g, weight, nodeMap, n, maxNumberOfCuts, backOff)
+    , _rootNodes(_callbackGraph.getNodes(rootNodes))
   {
     init();
     _pBK = new BkAlg(_h, _cap);
@@ -234,36 +248,8 @@ public:
     : Parent(other)
     , _rootNodes(other._rootNodes)
   {
-    typename Digraph::template NodeMap<DiNode> nodeMap(other._h);
-    typename Digraph::template ArcMap<DiArc> arcMap(other._h);
-    
-    lemon::digraphCopy(other._h, _h)
-    .nodeRef(nodeMap)
-    .arcRef(arcMap)
-    .nodeMap(other._h2g, _h2g)
-    .arcMap(other._cap, _cap)
-    .run();
-    
-    lock();
-    _pG2h1 = new NodeDiNodeMap(_g);
-    _pG2h2 = new NodeDiNodeMap(_g);
-    unlock();
-    
-    for (NodeIt v(_g); v != lemon::INVALID; ++v)
-    {
-      DiNode v1 = (*other._pG2h1)[v];
-      DiNode v2 = (*other._pG2h2)[v];
-      
-      _pG2h1->set(v, nodeMap[v1]);
-      if (v2 != lemon::INVALID)
-        _pG2h2->set(v, nodeMap[v2]);
-    }
-    
-    for (DiNodeSetIt diRootIt = other._diRootSet.begin();
-         diRootIt != other._diRootSet.end(); ++diRootIt)
-    {
-      _diRootSet.insert(nodeMap[*diRootIt]);
-    }
+    // _h only depends on _g and _rootNodes, which are the same as in other
+    init();
     _pBK = new BkAlg(_h, _cap);
   }
 
@@ -280,24 +266,22 @@ protected:
     return (new (getEnv()) NodeCutRootedUserCut(*this));
   }
   
-  void separateMinCut(const NodeSet& nonZeroComponent,
+  void separateMinCut(const NodeRange& nonZeroComponent,
                       const Node root,
                       const IloNumArray& x_values,
                       int& nCuts, int& nBackCuts, int& nNestedCuts)
   {
-    IloExpr rhs(getEnv());
-    
     DiNode diRoot = (*_pG2h1)[root];
     
     _pBK->setSource(diRoot);
-    _pNodeBoolMap->set(root, false);
-    for (NodeSetIt it = nonZeroComponent.begin(); it != nonZeroComponent.end(); ++it)
+    _nodeBoolMap.set(root, false);
+    for (NodeVectorIt it = nonZeroComponent.begin(); it != nonZeroComponent.end(); ++it)
     {
       Node i = *it;
       // skip if node was already considered or its x-value is 0
-      if (!(*_pNodeBoolMap)[i]) continue;
+      if (!_nodeBoolMap[i]) continue;
       
-      const double x_i_value = x_values[_nodeMap[i]];
+      const double x_i_value = x_values[_g.id(i)];
       
       _pBK->setTarget((*_pG2h2)[i]);
       _pBK->setCap(_cap);
@@ -321,7 +305,7 @@ protected:
         if (_tol.less(minCutValue, x_i_value))
         {
           // determine N (forward)
-          NodeSet fwdDS;
+          NodeVector fwdDS(_arena);
           determineFwdCutSet(_h, *_pBK, diRoot, _h2g, _marked, fwdDS);
           
           // numerical instability may cause minCutValue < x_i_value
@@ -329,13 +313,13 @@ protected:
           if (fwdDS.empty()) break;
           
           // determine N (backward)
-          NodeSet bwdDS;
+          NodeVector bwdDS(_arena);
           determineBwdCutSet(_h, *_pBK, diRoot, _h2g, _marked, bwdDS);
           
-          bool backCuts = fwdDS.size() != bwdDS.size() || fwdDS != bwdDS;
+          bool backCuts = !equal(fwdDS, bwdDS);
           
           // add violated constraints
-          _pNodeBoolMap->set(i, false);
+          _nodeBoolMap.set(i, false);
           addViolatedConstraint(*this, i, fwdDS);
           ++nCuts;
           if (nestedCut) ++nNestedCuts;
@@ -362,9 +346,7 @@ protected:
       }
     }
     
-    _pNodeBoolMap->set(root, true);
-    
-    rhs.end();
+    _nodeBoolMap.set(root, true);
   }
   
 //  void separateConnectedComponents(const IloNumArray& x_values,
@@ -375,9 +357,9 @@ protected:
 //    typedef typename NodeSetVector::const_iterator NodeSetVectorIt;
 //    
 //    NodeSetVector compMatrix(nComp, NodeSet());
-//    for (SubNodeIt i(*_pSubG); i != lemon::INVALID; ++i)
+//    for (SubNodeIt i(_subG); i != lemon::INVALID; ++i)
 //    {
-//      int compIdx = (*_pComp)[i];
+//      int compIdx = _comp[i];
 //      compMatrix[compIdx].insert(i);
 //    }
 //    
@@ -408,7 +390,7 @@ protected:
 //      constructRHS(rhs, dS);
 //      for (NodeSetIt it = S.begin(); it != S.end(); ++it)
 //      {
-//        IloConstraint constraint = _x[_nodeMap[*it]] <= rhs;
+//        IloConstraint constraint = _x[_g.id(*it)] <= rhs;
 //        add(constraint, IloCplex::UseCutPurge);
 //        constraint.end();
 //        
@@ -420,12 +402,12 @@ protected:
 
   void separate()
   {
-    IloNumArray x_values(getEnv(), _n);
-    getValues(x_values, _x);
+    getValues(_xValues, _x);
     
     // determine connected components
-    computeCapacities(_cap, x_values);
-    NodeSetVector nonZeroComponents = determineConnectedComponents(x_values);
+    computeCapacities(_cap, _xValues);
+    ComponentVector nonZeroComponents(_arena);
+    determineConnectedComponents(_xValues, nonZeroComponents);
     
     int nCuts = 0;
     int nBackCuts = 0;
@@ -434,17 +416,17 @@ protected:
     for (NodeSetIt rootIt = _rootNodes.begin(); rootIt != _rootNodes.end(); ++rootIt)
     {
       Node root = *rootIt;
-      for (NodeSetVectorIt it = nonZeroComponents.begin(); it != nonZeroComponents.end(); ++it)
+      for (int compIdx = 0; compIdx < nonZeroComponents.size(); ++compIdx)
       {
-        const NodeSet& nonZeroComponent = *it;
-        if (_nodeNumber == 0 || nonZeroComponent.find(root) != nonZeroComponent.end())
+        const NodeRange nonZeroComponent = nonZeroComponents[compIdx];
+        if (_nodeNumber == 0 || contains(nonZeroComponent, root))
         {
           // todo give separateMinCut nonZeroComponent
-          separateMinCut(nonZeroComponent, root, x_values, nCuts, nBackCuts, nNestedCuts);
+          separateMinCut(nonZeroComponent, root, _xValues, nCuts, nBackCuts, nNestedCuts);
         }
         else
         {
-          separateRootedConnectedComponent(nonZeroComponent, root, x_values, *this, nCuts);
+          separateRootedConnectedComponent(nonZeroComponent, root, _xValues, *this, nCuts);
         }
       }
     
@@ -461,25 +443,24 @@ protected:
 //              << ": generated " << nCuts
 //              << " user cuts of which " << nBackCuts << " are back-cuts and "
 //              << nNestedCuts << " are nested cuts" << std::endl;
-    
-    x_values.end();
   }
   
   void computeCapacities(CapacityMap& capacity,
                          IloNumArray x_values)
   {
     // cap((i,j)) = x_i
-    for (NodeIt v(_g); v != lemon::INVALID; ++v)
+    for (int i = 0; i < _n; ++i)
     {
-      double val = x_values[_nodeMap[v]];
+      const Node v = _g.nodeFromId(i);
+      double val = x_values[i];
       if (!_tol.nonZero(val))
       {
-        _pNodeBoolMap->set(v, false);
+        _nodeBoolMap.set(v, false);
         val = 10 * _cutEpsilon;
       }
       else
       {
-        _pNodeBoolMap->set(v, true);
+        _nodeBoolMap.set(v, true);
       }
       
       DiNode v1 = (*_pG2h1)[v];
@@ -501,13 +482,13 @@ protected:
                           const DiNode diRoot,
                           const DiNodeNodeMap& h2g,
                           DiBoolNodeMap& marked,
-                          NodeSet& dS)
+                          NodeVector& dS)
   {
     DiNode target = bk.getTarget();
-    DiNodeList diS;
+    DiNodeVector diS(_arena);
     determineBwdCutSet(h, bk, diRoot, target, marked, diS);
     
-    for (DiNodeListIt nodeIt = diS.begin(); nodeIt != diS.end(); nodeIt++)
+    for (DiNodeVectorIt nodeIt = diS.begin(); nodeIt != diS.end(); nodeIt++)
     {
       DiNode v = *nodeIt;
       assert(marked[v]);
@@ -521,10 +502,12 @@ protected:
           //std::cout << _h.id(u) << " -> "
           //          << _h.id(v) << " "
           //          << bk.flow(a) << "/" << bk.cap(a) << std::endl;
-          dS.insert(h2g[v]);
+          dS.push_back(h2g[v]);
         }
       }
     }
+    
+    makeSet(dS);
   }
   
   void determineFwdCutSet(const Digraph& h,
@@ -532,13 +515,13 @@ protected:
                           const DiNode diRoot,
                           const DiNodeNodeMap& h2g,
                           DiBoolNodeMap& marked,
-                          NodeSet& dS)
+                          NodeVector& dS)
   {
     DiNode target = bk.getTarget();
-    DiNodeList diS;
+    DiNodeVector diS(_arena);
     determineFwdCutSet(h, bk, diRoot, marked, diS);
     
-    for (DiNodeListIt nodeIt = diS.begin(); nodeIt != diS.end(); nodeIt++)
+    for (DiNodeVectorIt nodeIt = diS.begin(); nodeIt != diS.end(); nodeIt++)
     {
       DiNode v = *nodeIt;
       assert(marked[v]);
@@ -552,10 +535,12 @@ protected:
           //std::cout << _h.id(v) << " -> "
           //          << _h.id(w) << " "
           //          << bk.flow(a) << "/" << bk.cap(a) << " : " << bk.resCap(a) << std::endl;
-          dS.insert(h2g[w]);
+          dS.push_back(h2g[w]);
         }
       }
     }
+    
+    makeSet(dS);
   }
   
   void init()
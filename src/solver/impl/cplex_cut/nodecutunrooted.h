@@ -22,38 +22,46 @@ template<typename GR,
 class NodeCutUnrootedLazyConstraint : public NodeCutLazy<GR, NWGHT, NLBL, EWGHT>
 {
 public:
-  typedef GR Graph;
-  typedef NWGHT WeightNodeMap;
+  typedef NodeCutLazy<GR, NWGHT, NLBL, EWGHT> Parent;
+  typedef typename Parent::CallbackGraphType CallbackGraphType;
+  typedef typename Parent::SourceGraph SourceGraph;
+  typedef typename Parent::SourceWeightNodeMap SourceWeightNodeMap;
+  typedef typename Parent::SourceIntNodeMap SourceIntNodeMap;
+  typedef typename Parent::SourceNodeSet SourceNodeSet;
+  typedef typename Parent::Graph Graph;
+  typedef typename Parent::WeightNodeMap WeightNodeMap;
   typedef NLBL LabelNodeMap;
   typedef EWGHT WeightEdgeMap;
-  typedef NodeCutLazy<GR, NWGHT, NLBL, EWGHT> Parent;
 
 protected:
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
   
   typedef typename Parent::NodeSet NodeSet;
   typedef typename Parent::NodeSetIt NodeSetIt;
-  typedef typename Parent::NodeSetVector NodeSetVector;
-  typedef typename Parent::NodeSetVectorIt NodeSetVectorIt;
+  typedef typename Parent::NodeVector NodeVector;
+  typedef typename Parent::NodeVectorIt NodeVectorIt;
+  typedef typename Parent::NodeRange NodeRange;
+  typedef typename Parent::ComponentVector ComponentVector;
   typedef typename Parent::SubGraph SubGraph;
   typedef typename Parent::SubNodeIt SubNodeIt;
 
   using Parent::_x;
   using Parent::_y;
+  using Parent::_callbackGraph;
   using Parent::_g;
   using Parent::_weight;
-  using Parent::_nodeMap;
   using Parent::_n;
   using Parent::_maxNumberOfCuts;
   using Parent::_tol;
-  using Parent::_pNodeBoolMap;
-  using Parent::_pMutex;
+  using Parent::_nodeBoolMap;
   using Parent::_epsilon;
-  using Parent::_pSubG;
-  using Parent::_pComp;
+  using Parent::_subG;
+  using Parent::_comp;
+  using Parent::_arena;
+  using Parent::_xValues;
+  using Parent::_yValues;
+  using Parent::_rhs;
   
-  using Parent::lock;
-  using Parent::unlock;
   using Parent::getEnv;
   using Parent::getValues;
   using Parent::constructRHS;
@@ -61,6 +69,9 @@ protected:
   using Parent::isValid;
   using Parent::determineConnectedComponents;
   using Parent::separateConnectedComponent;
+  using Parent::intersects;
+  using Parent::makeSet;
+  using Parent::equal;
   
   friend class NodeCut<GR, NWGHT, NLBL, EWGHT>;
 
@@ -68,13 +79,12 @@ public:
   NodeCutUnrootedLazyConstraint(IloEnv env,
                                 IloBoolVarArray x,
                                 IloBoolVarArray y,
-                                const Graph& g,
-                                const WeightNodeMap& weight,
-                                const IntNodeMap& nodeMap,
+                                const SourceGraph& g,
+                                const SourceWeightNodeMap& weight,
+                                const SourceIntNodeMap& nodeMap,
                                 int n,
-                                int maxNumberOfCuts,
-                                IloFastMutex* pMutex)
-    : Parent(env, x, y, g, weight, nodeMap, n, maxNumberOfCuts, pMutex)
+                                int maxNumberOfCuts)
+    : Parent(env, x, y, g, weight, nodeMap, n, maxNumberOfCuts)
   {
   }
 
@@ -90,6 +100,7 @@ public:
 protected:
   virtual void main()
   {
+    CallbackArena::Invocation invocation(_arena);
     separate();
   }
 
@@ -100,47 +111,35 @@ protected:
 
   void separate()
   {
-    IloNumArray x_values(getEnv(), _n);
-    getValues(x_values, _x);
+    getValues(_xValues, _x);
+    getValues(_yValues, _y);
     
-    IloNumArray y_values(getEnv(), _n);
-    getValues(y_values, _y);
-    
-    // determine non-zero y-vars
-    NodeSet rootNodes;
-    for (NodeIt i(_g); i != lemon::INVALID; ++i)
+    // determine non-zero y-vars, in ascending order
+    NodeVector rootNodes(_arena);
+    for (int i = 0; i < _n; ++i)
     {
-      int idx_i = _nodeMap[i];
-      if (_tol.nonZero(y_values[idx_i]))
+      if (_tol.nonZero(_yValues[i]))
       {
-        rootNodes.insert(i);
+        rootNodes.push_back(_g.nodeFromId(i));
       }
     }
     
     assert(rootNodes.size() == 1);
     
     // determine connected components
-    NodeSetVector nonZeroComponents = determineConnectedComponents(x_values);
+    ComponentVector nonZeroComponents(_arena);
+    determineConnectedComponents(_xValues, nonZeroComponents);
 
     int nCuts = 0;
-    for (NodeSetVectorIt it = nonZeroComponents.begin(); it != nonZeroComponents.end(); ++it)
+    for (int compIdx = 0; compIdx < nonZeroComponents.size(); ++compIdx)
     {
-      const NodeSet& nonZeroComponent = *it;
-      
-      NodeSet intersection;
-      std::set_intersection(rootNodes.begin(), rootNodes.end(),
-                            nonZeroComponent.begin(), nonZeroComponent.end(),
-                            std::inserter(intersection, intersection.begin()));
-      
-      if (intersection.size() == 0)
+      const NodeRange nonZeroComponent = nonZeroComponents[compIdx];
+      if (!intersects(rootNodes, nonZeroComponent))
       {
-        separateConnectedComponent(*it, rootNodes, x_values, y_values, *this, nCuts);
+        separateConnectedComponent(nonZeroComponent, rootNodes, _xValues, _yValues, *this, nCuts);
       }
     }
     
-    x_values.end();
-    y_values.end();
-    
 //    std::cerr << "#comps: " << nonZeroComponents.size() << ", generated " << nCuts << " lazy cuts" << std::endl;
   }
 };
@@ -152,11 +151,16 @@ template<typename GR,
 class NodeCutUnrootedUserCut : public NodeCutUser<GR, NWGHT, NLBL, EWGHT>
 {
 public:
-  typedef GR Graph;
-  typedef NWGHT WeightNodeMap;
+  typedef NodeCutUser<GR, NWGHT, NLBL, EWGHT> Parent;
+  typedef typename Parent::CallbackGraphType CallbackGraphType;
+  typedef typename Parent::SourceGraph SourceGraph;
+  typedef typename Parent::SourceWeightNodeMap SourceWeightNodeMap;
+  typedef typename Parent::SourceIntNodeMap SourceIntNodeMap;
+  typedef typename Parent::SourceNodeSet SourceNodeSet;
+  typedef typename Parent::Graph Graph;
+  typedef typename Parent::WeightNodeMap WeightNodeMap;
   typedef NLBL LabelNodeMap;
   typedef EWGHT WeightEdgeMap;
-  typedef NodeCutUser<GR, NWGHT, NLBL, EWGHT> Parent;
 
 protected:
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
@@ -173,30 +177,30 @@ protected:
   typedef typename Parent::CapacityMap CapacityMap;
   typedef typename Parent::NodeSet NodeSet;
   typedef typename Parent::NodeSetIt NodeSetIt;
-  typedef typename Parent::NodeSetVector NodeSetVector;
-  typedef typename Parent::NodeSetVectorIt NodeSetVectorIt;
+  typedef typename Parent::NodeVector NodeVector;
+  typedef typename Parent::NodeVectorIt NodeVectorIt;
+  typedef typename Parent::NodeRange NodeRange;
+  typedef typename Parent::ComponentVector ComponentVector;
   typedef typename Parent::SubGraph SubGraph;
   typedef typename Parent::SubNodeIt SubNodeIt;
   typedef typename Parent::SubEdgeIt SubEdgeIt;
   typedef typename Parent::NodeQueue NodeQueue;
-  typedef typename Parent::DiNodeQueue DiNodeQueue;
   typedef typename Parent::DiNodeSet DiNodeSet;
   typedef typename Parent::DiNodeSetIt DiNodeSetIt;
-  typedef typename Parent::DiNodeList DiNodeList;
-  typedef typename Parent::DiNodeListIt DiNodeListIt;
+  typedef typename Parent::DiNodeVector DiNodeVector;
+  typedef typename Parent::DiNodeVectorIt DiNodeVectorIt;
   typedef typename Parent::BkAlg BkAlg;
   typedef typename Parent::DiBoolNodeMap DiBoolNodeMap;
 
   using Parent::_x;
   using Parent::_y;
+  using Parent::_callbackGraph;
   using Parent::_g;
   using Parent::_weight;
-  using Parent::_nodeMap;
   using Parent::_n;
   using Parent::_maxNumberOfCuts;
   using Parent::_tol;
-  using Parent::_pNodeBoolMap;
-  using Parent::_pMutex;
+  using Parent::_nodeBoolMap;
   using Parent::_epsilon;
   using Parent::_cutEpsilon;
   using Parent::_h;
@@ -210,11 +214,13 @@ protected:
   using Parent::_marked;
   using Parent::_cutCount;
   using Parent::_nodeNumber;
-  using Parent::_pSubG;
-  using Parent::_pComp;
+  using Parent::_subG;
+  using Parent::_comp;
+  using Parent::_arena;
+  using Parent::_xValues;
+  using Parent::_yValues;
+  using Parent::_rhs;
 
-  using Parent::lock;
-  using Parent::unlock;
   using Parent::determineFwdCutSet;
   using Parent::determineBwdCutSet;
   using Parent::add;
@@ -225,6 +231,9 @@ protected:
   using Parent::isValid;
   using Parent::determineConnectedComponents;
   using Parent::separateConnectedComponent;
+  using Parent::intersects;
+  using Parent::makeSet;
+  using Parent::equal;
   
   friend class NodeCut<GR, NWGHT, NLBL, EWGHT>;
 
@@ -232,19 +241,15 @@ public:
   NodeCutUnrootedUserCut(IloEnv env,
                          IloBoolVarArray x,
                          IloBoolVarArray y,
-                         const Graph& g,
-                         const WeightNodeMap& weight,
-                         const IntNodeMap& nodeMap,
+                         const SourceGraph& g,
+                         const SourceWeightNodeMap& weight,
+                         const SourceIntNodeMap& nodeMap,
                          int n,
                          int maxNumberOfCuts,
-                         IloFastMutex* pMutex,
                          BackOff backOff)
-    : Parent(env, x, y, g, weight, nodeMap, n, maxNumberOfCuts, pMutex, backOff)
+    : Parent(env, x, y, g, weight, nodeMap, n, maxNumberOfCuts, backOff)
   {
-    lock();
     _pG2hRootArc = new NodeDiArcMap(_g);
-    unlock();
-    
     init();
     _pBK = new BkAlg(_h, _cap);
   }
@@ -252,39 +257,9 @@ public:
   NodeCutUnrootedUserCut(const NodeCutUnrootedUserCut& other)
     : Parent(other)
   {
-    typename Digraph::template NodeMap<DiNode> nodeMap(other._h);
-    typename Digraph::template ArcMap<DiArc> arcMap(other._h);
-    
-    lemon::digraphCopy(other._h, _h)
-    .nodeRef(nodeMap)
-    .arcRef(arcMap)
-    .nodeMap(other._h2g, _h2g)
-    .arcMap(other._cap, _cap)
-    .run();
-    
-    lock();
-    _pG2h1 = new NodeDiNodeMap(_g);
-    _pG2h2 = new NodeDiNodeMap(_g);
+    // _h only depends on _g, which is the same as in other
     _pG2hRootArc = new NodeDiArcMap(_g);
-    unlock();
-    
-    for (NodeIt v(_g); v != lemon::INVALID; ++v)
-    {
-      DiNode v1 = (*other._pG2h1)[v];
-      DiNode v2 = (*other._pG2h2)[v];
-      DiArc root_arc_v = (*other._pG2hRootArc)[v];
-      
-      _pG2h1->set(v, nodeMap[v1]);
-      _pG2h2->set(v, nodeMap[v2]);
-      _pG2hRootArc->set(v, arcMap[root_arc_v]);
-    }
-    
-    for (DiNodeSetIt diRootIt = other._diRootSet.begin();
-         diRootIt != other._diRootSet.end(); ++diRootIt)
-    {
-      _diRootSet.insert(nodeMap[*diRootIt]);
-    }
-    
+    init();
     _pBK = new BkAlg(_h, _cap);
   }
 
@@ -298,24 +273,22 @@ protected:
     return (new (getEnv()) NodeCutUnrootedUserCut(*this));
   }
   
-  void separateMinCut(const NodeSet& nonZeroComponent,
+  void separateMinCut(const NodeRange& nonZeroComponent,
                       const IloNumArray& x_values,
                       const IloNumArray& y_values,
                       int& nCuts, int& nBackCuts, int& nNestedCuts)
   {
-    IloExpr rhs(getEnv());
-    
     assert(_diRootSet.size() == 1);
     DiNode diRoot = *_diRootSet.begin();
 
     _pBK->setSource(diRoot);
-    for (NodeSetIt it = nonZeroComponent.begin(); it != nonZeroComponent.end(); ++it)
+    for (NodeVectorIt it = nonZeroComponent.begin(); it != nonZeroComponent.end(); ++it)
     {
       Node i = *it;
       // skip if node was already considered or its x-value is 0
-      if (!(*_pNodeBoolMap)[i]) continue;
+      if (!_nodeBoolMap[i]) continue;
       
-      const double x_i_value = x_values[_nodeMap[i]];
+      const double x_i_value = x_values[_g.id(i)];
       
       _pBK->setTarget((*_pG2h2)[i]);
       _pBK->setCap(_cap);
@@ -339,7 +312,7 @@ protected:
         if (_tol.less(minCutValue, x_i_value))
         {
           // determine N (forward)
-          NodeSet fwdS, fwdDS;
+          NodeVector fwdS(_arena), fwdDS(_arena);
           determineFwdCutSet(_h, *_pBK, diRoot, _h2g, _marked, fwdDS, fwdS);
           
           // numerical instability may cause minCutValue < x_i_value
@@ -347,19 +320,17 @@ protected:
           if (fwdS.empty() && fwdDS.empty()) break;
           
           // determine N (backward)
-          NodeSet bwdS, bwdDS;
+          NodeVector bwdS(_arena), bwdDS(_arena);
           determineBwdCutSet(_h, *_pBK, diRoot, _h2g, _marked, bwdDS, bwdS);
           
-          bool backCuts = fwdDS.size() != bwdDS.size() ||
-          fwdS.size() != bwdS.size() ||
-          fwdDS != bwdDS || bwdS != fwdS;
+          bool backCuts = !equal(fwdDS, bwdDS) || !equal(bwdS, fwdS);
           
           // add violated constraints for all nodes j in fwdS with x_j >= x_i
-          constructRHS(rhs, fwdDS, fwdS);
-          for (NodeSetIt it2 = fwdS.begin(); it2 != fwdS.end(); ++it2)
+          constructRHS(_rhs, fwdDS, fwdS);
+          for (NodeVectorIt it2 = fwdS.begin(); it2 != fwdS.end(); ++it2)
           {
             const Node j = *it2;
-            const double x_j_value = x_values[_nodeMap[j]];
+            const double x_j_value = x_values[_g.id(j)];
             
             if (_tol.less(minCutValue, x_j_value))
             {
@@ -375,8 +346,8 @@ protected:
               assert(isValid(j, fwdDS, fwdS));
               //              std::cerr << x_j_value - minCutValue << std::endl;
               
-              _pNodeBoolMap->set(j, false);
-              add(_x[_nodeMap[j]] <= rhs, IloCplex::UseCutPurge).end();
+              _nodeBoolMap.set(j, false);
+              add(_x[_g.id(j)] <= _rhs, IloCplex::UseCutPurge).end();
               
               ++nCuts;
               if (nestedCut) ++nNestedCuts;
@@ -386,18 +357,18 @@ protected:
           if (backCuts)
           {
             // add violated constraints for all nodes j in bwdS with x_j >= x_i
-            constructRHS(rhs, bwdDS, bwdS);
-            for (NodeSetIt it2 = bwdS.begin(); it2 != bwdS.end(); ++it2)
+            constructRHS(_rhs, bwdDS, bwdS);
+            for (NodeVectorIt it2 = bwdS.begin(); it2 != bwdS.end(); ++it2)
             {
               const Node j = *it2;
-              const double x_j_value = x_values[_nodeMap[j]];
+              const double x_j_value = x_values[_g.id(j)];
               
               if (_tol.less(minCutValue, x_j_value))
               {
                 assert(isValid(j, bwdDS, bwdS));
                 
-                _pNodeBoolMap->set(j, false);
-                add(_x[_nodeMap[j]] <= rhs, IloCplex::UseCutPurge).end();
+                _nodeBoolMap.set(j, false);
+                add(_x[_g.id(j)] <= _rhs, IloCplex::UseCutPurge).end();
                 
                 ++nCuts;
                 ++nBackCuts;
@@ -420,8 +391,6 @@ protected:
 //        }
       }
     }
-    
-    rhs.end();
   }
   
 //  void separateMinCutLocal(const NodeSet& nonZeroComponent,
@@ -442,14 +411,14 @@ protected:
 //    BkAlg bk(h, cap);
 //
 //    bk.setSource(diRoot);
-//    _pNodeBoolMap->set(root, false);
+//    _nodeBoolMap.set(root, false);
 //    for (NodeSetIt it = nonZeroComponent.begin(); it != nonZeroComponent.end(); ++it)
 //    {
 //      Node i = *it;
 //      // skip if node was already considered or its x-value is 0
-//      if (!(*_pNodeBoolMap)[i]) continue;
+//      if (!_nodeBoolMap[i]) continue;
 //      
-//      const double x_i_value = x_values[_nodeMap[i]];
+//      const double x_i_value = x_values[_g.id(i)];
 //
 //      bk.setTarget((*_pG2h2)[i]);
 //      bk.setCap(cap);
@@ -498,7 +467,7 @@ protected:
 //          for (NodeSetIt it2 = fwdS.begin(); it2 != fwdS.end(); ++it2)
 //          {
 //            const Node j = *it2;
-//            const double x_j_value = x_values[_nodeMap[j]];
+//            const double x_j_value = x_values[_g.id(j)];
 //            
 //            if (_tol.less(minCutValue, x_j_value))
 //            {
@@ -514,8 +483,8 @@ protected:
 //              assert(isValid(j, fwdDS, fwdS));
 ////              std::cerr << x_j_value - minCutValue << std::endl;
 //              
-//              _pNodeBoolMap->set(j, false);
-//              add(_x[_nodeMap[j]] <= rhs, IloCplex::UseCutPurge).end();
+//              _nodeBoolMap.set(j, false);
+//              add(_x[_g.id(j)] <= rhs, IloCplex::UseCutPurge).end();
 //              
 //              ++nCuts;
 //              if (nestedCut) ++nNestedCuts;
@@ -529,14 +498,14 @@ protected:
 //            for (NodeSetIt it2 = bwdS.begin(); it2 != bwdS.end(); ++it2)
 //            {
 //              const Node j = *it2;
-//              const double x_j_value = x_values[_nodeMap[j]];
+//              const double x_j_value = x_values[_g.id(j)];
 //              
 //              if (_tol.less(minCutValue, x_j_value))
 //              {
 //                assert(isValid(j, bwdDS, bwdS));
 //                
-//                _pNodeBoolMap->set(j, false);
-//                add(_x[_nodeMap[j]] <= rhs, IloCplex::UseCutPurge).end();
+//                _nodeBoolMap.set(j, false);
+//                add(_x[_g.id(j)] <= rhs, IloCplex::UseCutPurge).end();
 //                
 //                ++nCuts;
 //                ++nBackCuts;
@@ -564,42 +533,33 @@ protected:
   
   void separate()
   {
-    IloNumArray x_values(getEnv(), _n);
-    getValues(x_values, _x);
-    
-    IloNumArray y_values(getEnv(), _n);
-    getValues(y_values, _y);
+    getValues(_xValues, _x);
+    getValues(_yValues, _y);
     
     // determine connected components
-    NodeSet rootNodes = computeCapacities(_cap, x_values, y_values);
-    NodeSetVector nonZeroComponents = determineConnectedComponents(x_values);
+    NodeVector rootNodes(_arena);
+    computeCapacities(_cap, _xValues, _yValues, rootNodes);
+    ComponentVector nonZeroComponents(_arena);
+    determineConnectedComponents(_xValues, nonZeroComponents);
     
     int nCuts = 0;
     int nBackCuts = 0;
     int nNestedCuts = 0;
 
-    for (NodeSetVectorIt it = nonZeroComponents.begin(); it != nonZeroComponents.end(); ++it)
+    for (int compIdx = 0; compIdx < nonZeroComponents.size(); ++compIdx)
     {
-      const NodeSet& nonZeroComponent = *it;
-      
-      NodeSet intersection;
-      std::set_intersection(rootNodes.begin(), rootNodes.end(),
-                            nonZeroComponent.begin(), nonZeroComponent.end(),
-                            std::inserter(intersection, intersection.begin()));
+      const NodeRange nonZeroComponent = nonZeroComponents[compIdx];
       
-      if (_nodeNumber == 0 || intersection.size() > 0)
+      if (_nodeNumber == 0 || intersects(rootNodes, nonZeroComponent))
       {
-        separateMinCut(nonZeroComponent, x_values, y_values, nCuts, nBackCuts, nNestedCuts);
+        separateMinCut(nonZeroComponent, _xValues, _yValues, nCuts, nBackCuts, nNestedCuts);
       }
       else
       {
-        separateConnectedComponent(nonZeroComponent, rootNodes, x_values, y_values, *this, nCuts);
+        separateConnectedComponent(nonZeroComponent, rootNodes, _xValues, _yValues, *this, nCuts);
       }
     }
     
-    x_values.end();
-    y_values.end();
-    
 //    std::cerr << "[";
 //    for (NodeSetVectorIt it = nonZeroComponents.begin(); it != nonZeroComponents.end(); ++it)
 //    {
@@ -629,14 +589,14 @@ protected:
                           const DiNode diRoot,
                           const DiNodeNodeMap& h2g,
                           DiBoolNodeMap& marked,
-                          NodeSet& dS,
-                          NodeSet& S)
+                          NodeVector& dS,
+                          NodeVector& S)
   {
     DiNode target = bk.getTarget();
-    DiNodeList diS;
+    DiNodeVector diS(_arena);
     determineBwdCutSet(h, bk, diRoot, target, marked, diS);
     
-    for (DiNodeListIt nodeIt = diS.begin(); nodeIt != diS.end(); nodeIt++)
+    for (DiNodeVectorIt nodeIt = diS.begin(); nodeIt != diS.end(); nodeIt++)
     {
       DiNode v = *nodeIt;
       assert(marked[v]);
@@ -651,17 +611,20 @@ protected:
           //std::cout << _h.id(u) << " -> "
           //          << _h.id(v) << " "
           //          << bk.flow(a) << "/" << bk.cap(a) << std::endl;
-          S.insert(h2g[v]);
+          S.push_back(h2g[v]);
         }
         else if (!marked[u])
         {
           //std::cout << _h.id(u) << " -> "
           //          << _h.id(v) << " "
           //          << bk.flow(a) << "/" << bk.cap(a) << std::endl;
-          dS.insert(h2g[v]);
+          dS.push_back(h2g[v]);
         }
       }
     }
+    
+    makeSet(dS);
+    makeSet(S);
   }
   
   void determineFwdCutSet(const Digraph& h,
@@ -669,14 +632,14 @@ protected:
                           const DiNode diRoot,
                           const DiNodeNodeMap& h2g,
                           DiBoolNodeMap& marked,
-                          NodeSet& dS,
-                          NodeSet& S)
+                          NodeVector& dS,
+                          NodeVector& S)
   {
     DiNode target = bk.getTarget();
-    DiNodeList diS;
+    DiNodeVector diS(_arena);
     determineFwdCutSet(h, bk, diRoot, marked, diS);
     
-    for (DiNodeListIt nodeIt = diS.begin(); nodeIt != diS.end(); nodeIt++)
+    for (DiNodeVectorIt nodeIt = diS.begin(); nodeIt != diS.end(); nodeIt++)
     {
       DiNode v = *nodeIt;
       assert(marked[v]);
@@ -691,7 +654,7 @@ protected:
             //std::cout << _h.id(v) << " -> "
             //          << _h.id(w) << " "
             //          << bk.flow(a) << "/" << bk.cap(a) << std::endl;
-            S.insert(h2g[w]);
+            S.push_back(h2g[w]);
           }
         }
       }
@@ -705,11 +668,14 @@ protected:
             //std::cout << _h.id(v) << " -> "
             //          << _h.id(w) << " "
             //          << bk.flow(a) << "/" << bk.cap(a) << std::endl;
-            dS.insert(h2g[w]);
+            dS.push_back(h2g[w]);
           }
         }
       }
     }
+    
+    makeSet(dS);
+    makeSet(S);
   }
   
   void init()
@@ -777,8 +743,8 @@ protected:
     {
       const Node i = *it;
       
-      double x_i_value = x_values[_nodeMap[i]];
-      double y_i_value = y_values[_nodeMap[i]];
+      double x_i_value = x_values[_g.id(i)];
+      double y_i_value = y_values[_g.id(i)];
       
       DiNode i1 = h.addNode();
       DiNode i2 = h.addNode();
@@ -800,8 +766,8 @@ protected:
         {
           shell.insert(j);
           
-          double x_j_value = x_values[_nodeMap[j]];
-          double y_j_value = y_values[_nodeMap[j]];
+          double x_j_value = x_values[_g.id(j)];
+          double y_j_value = y_values[_g.id(j)];
           
           assert(!_tol.nonZero(x_j_value));
           
@@ -844,42 +810,41 @@ protected:
     }
   }
   
-  NodeSet computeCapacities(CapacityMap& capacity,
-                            IloNumArray x_values,
-                            IloNumArray y_values)
+  void computeCapacities(CapacityMap& capacity,
+                         IloNumArray x_values,
+                         IloNumArray y_values,
+                         NodeVector& rootNodes)
   {
-    NodeSet rootNodes;
-    
-    for (NodeIt v(_g); v != lemon::INVALID; ++v)
+    for (int i = 0; i < _n; ++i)
     {
+      const Node v = _g.nodeFromId(i);
+      
       // cap((i,j)) = x_i
-      double val = x_values[_nodeMap[v]];
+      double val = x_values[i];
       if (!_tol.nonZero(val))
       {
-        _pNodeBoolMap->set(v, false);
+        _nodeBoolMap.set(v, false);
         val = 10 * _cutEpsilon;
       }
       else
       {
-        _pNodeBoolMap->set(v, true);
+        _nodeBoolMap.set(v, true);
       }
       DiNode v1 = (*_pG2h1)[v];
       capacity[DiOutArcIt(_h, v1)] = val;
       
       // cap((r,i)) = y_i
-      val = y_values[_nodeMap[v]];
+      val = y_values[i];
       if (!_tol.nonZero(val))
       {
         val = 10 * _cutEpsilon;
       }
       else
       {
-        rootNodes.insert(v);
+        rootNodes.push_back(v);
       }
       capacity[(*_pG2hRootArc)[v]] = val;
     }
-    
-    return rootNodes;
   }
 };
 
@@ -15,8 +15,6 @@
 #include <lemon/smart_graph.h>
 #include <vector>
 #include <set>
-#include <queue>
-#include <list>
 #include "nodecut.h"
 #include "backoff.h"
 #include "bk_alg.h"
@@ -32,25 +30,28 @@ class NodeCutUser : public IloCplex::UserCutCallbackI,
                     public NodeCut<GR, NWGHT, NLBL, EWGHT>
 {
 public:
-  typedef GR Graph;
-  typedef NWGHT WeightNodeMap;
+  typedef NodeCut<GR, NWGHT, NLBL, EWGHT> Parent;
+  typedef typename Parent::CallbackGraphType CallbackGraphType;
+  typedef typename Parent::SourceGraph SourceGraph;
+  typedef typename Parent::SourceWeightNodeMap SourceWeightNodeMap;
+  typedef typename Parent::SourceIntNodeMap SourceIntNodeMap;
+  typedef typename Parent::SourceNodeSet SourceNodeSet;
+  typedef typename Parent::Graph Graph;
+  typedef typename Parent::WeightNodeMap WeightNodeMap;
   typedef NLBL LabelNodeMap;
   typedef EWGHT WeightEdgeMap;
-  typedef NodeCut<GR, NWGHT, NLBL, EWGHT> Parent;
   
   using Parent::_x;
   using Parent::_y;
+  using Parent::_callbackGraph;
   using Parent::_g;
   using Parent::_weight;
-  using Parent::_nodeMap;
   using Parent::_n;
   using Parent::_maxNumberOfCuts;
   using Parent::_tol;
-  using Parent::_pNodeBoolMap;
-  using Parent::_pMutex;
+  using Parent::_nodeBoolMap;
+  using Parent::_arena;
   using Parent::_epsilon;
-  using Parent::lock;
-  using Parent::unlock;
   
 protected:
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
@@ -70,18 +71,20 @@ protected:
   
   typedef typename Parent::NodeSet NodeSet;
   typedef typename Parent::NodeSetIt NodeSetIt;
-  typedef typename Parent::NodeSetVector NodeSetVector;
-  typedef typename Parent::NodeSetVectorIt NodeSetVectorIt;
+  typedef typename Parent::NodeVector NodeVector;
+  typedef typename Parent::NodeVectorIt NodeVectorIt;
+  typedef typename Parent::IntVector IntVector;
+  typedef typename Parent::NodeRange NodeRange;
+  typedef typename Parent::ComponentVector ComponentVector;
   typedef typename Parent::SubGraph SubGraph;
   typedef typename Parent::SubNodeIt SubNodeIt;
   typedef typename Parent::SubEdgeIt SubEdgeIt;
   typedef typename Parent::NodeQueue NodeQueue;
 
-  typedef std::queue<DiNode> DiNodeQueue;
   typedef std::set<DiNode> DiNodeSet;
   typedef typename DiNodeSet::const_iterator DiNodeSetIt;
-  typedef std::list<DiNode> DiNodeList;
-  typedef DiNodeList::const_iterator DiNodeListIt;
+  typedef std::vector<DiNode, ArenaAllocator<DiNode> > DiNodeVector;
+  typedef typename DiNodeVector::const_iterator DiNodeVectorIt;
   
   typedef nina::BkFlowAlg<Digraph> BkAlg;
   typedef typename Digraph::NodeMap<bool> DiBoolNodeMap;
@@ -110,15 +113,14 @@ public:
   NodeCutUser(IloEnv env,
               IloBoolVarArray x,
               IloBoolVarArray y,
-              const Graph& g,
-              const WeightNodeMap& weight,
-              const IntNodeMap& nodeMap,
+              const SourceGraph& g,
+              const SourceWeightNodeMap& weight,
+              const SourceIntNodeMap& nodeMap,
               int n,
               int maxNumberOfCuts,
-              IloFastMutex* pMutex,
               const BackOff& backOff)
     : IloCplex::UserCutCallbackI(env)
-    , Parent(x, y, g, weight, nodeMap, n, maxNumberOfCuts, pMutex)
+    , Parent(x, y, g, weight, nodeMap, n, maxNumberOfCuts)
     , _h()
     , _cap(_h)
     , _pG2h1(NULL)
@@ -134,10 +136,8 @@ public:
     , _backOff(backOff)
     , _makeAttempt(true)
   {
-    lock();
     _pG2h1 = new NodeDiNodeMap(_g);
     _pG2h2 = new NodeDiNodeMap(_g);
-    unlock();
   }
   
   NodeCutUser(const NodeCutUser& other)
@@ -159,22 +159,23 @@ public:
     , _makeAttempt(other._makeAttempt)
   {
     // TODO: to what values should I set cutCount and nodeNumber??
+    _pG2h1 = new NodeDiNodeMap(_g);
+    _pG2h2 = new NodeDiNodeMap(_g);
   }
   
   virtual ~NodeCutUser()
   {
     delete _pBK;
-    
-    lock();
     delete _pG2h1;
     delete _pG2h2;
     delete _pG2hRootArc;
-    unlock();
   }
   
 protected:
   virtual void main()
   {
+    CallbackArena::Invocation invocation(_arena);
+    
 //    if (!isAfterCutLoop())
 //    {
 //      return;
@@ -200,22 +201,20 @@ protected:
                           const BkAlg& bk,
                           const DiNode diRoot,
                           DiBoolNodeMap& marked,
-                          DiNodeList& diS)
+                          DiNodeVector& diS)
   {
     // we do a BFS on the *residual network* starting from _diRoot
-    // and only following arcs that have nonzero residual capacity
+    // and only following arcs that have nonzero residual capacity,
+    // diS is the BFS queue
     
     lemon::mapFill(h, marked, false);
     
-    DiNodeQueue queue;
-    queue.push(diRoot);
+    diS.push_back(diRoot);
     marked[diRoot] = true;
     
-    while (!queue.empty())
+    for (size_t head = 0; head < diS.size(); ++head)
     {
-      DiNode v = queue.front();
-      queue.pop();
-      diS.push_back(v);
+      DiNode v = diS[head];
       
       for (DiOutArcIt a(h, v); a != lemon::INVALID; ++a)
       {
@@ -223,7 +222,7 @@ protected:
         
         if (!marked[w] && _cutTol.nonZero(bk.resCap(a)))
         {
-          queue.push(w);
+          diS.push_back(w);
           marked[w] = true;
         }
       }
@@ -234,7 +233,7 @@ protected:
         
         if (!marked[w] && _cutTol.nonZero(bk.revResCap(a)))
         {
-          queue.push(w);
+          diS.push_back(w);
           marked[w] = true;
         }
       }
@@ -248,22 +247,20 @@ protected:
                           const DiNode diRoot,
                           const DiNode target,
                           DiBoolNodeMap& marked,
-                          DiNodeList& diS)
+                          DiNodeVector& diS)
   {
     // we do a BFS on the reversed *residual network* starting from target
-    // and only following arcs that have nonzero residual capacity
+    // and only following arcs that have nonzero residual capacity,
+    // diS is the BFS queue
     
     lemon::mapFill(h, marked, false);
     
-    DiNodeQueue queue;
-    queue.push(target);
+    diS.push_back(target);
     marked[target] = true;
     
-    while (!queue.empty())
+    for (size_t head = 0; head < diS.size(); ++head)
     {
-      DiNode v = queue.front();
-      queue.pop();
-      diS.push_back(v);
+      DiNode v = diS[head];
       
       for (DiInArcIt a(h, v); a != lemon::INVALID; ++a)
       {
@@ -271,7 +268,7 @@ protected:
         
         if (!marked[u] && _cutTol.nonZero(bk.resCap(a)))
         {
-          queue.push(u);
+          diS.push_back(u);
           marked[u] = true;
         }
       }
@@ -282,7 +279,7 @@ protected:
         
         if (!marked[u] && _cutTol.nonZero(bk.revResCap(a)))
         {
-          queue.push(u);
+          diS.push_back(u);
           marked[u] = true;
         }
       }
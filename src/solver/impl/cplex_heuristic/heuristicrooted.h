@@ -15,10 +15,17 @@
 #include <lemon/kruskal.h>
 #include <set>
 #include "solver/impl/treesolverrootedimpl.h"
+#include "solver/impl/callbackgraph.h"
 
 namespace nina {
 namespace mwcs {
 
+/// Tree heuristic: solves the instance restricted to a minimum spanning
+/// tree, with edge costs derived from the current LP values
+///
+/// Every callback (clone) runs on its own CallbackGraph, hence none
+/// of them needs to lock. The CallbackGraph is in variable order,
+/// node v corresponds to variable _x[_g.id(v)].
 template<typename GR,
          typename NWGHT = typename GR::template NodeMap<double>,
          typename NLBL = typename GR::template NodeMap<std::string>,
@@ -26,10 +33,15 @@ template<typename GR,
 class HeuristicRooted : public IloCplex::HeuristicCallbackI
 {
 public:
-  typedef GR Graph;
-  typedef NWGHT WeightNodeMap;
-  typedef NLBL LabelNodeMap;
-  typedef EWGHT WeightEdgeMap;
+  typedef CallbackGraph<GR, NWGHT> CallbackGraphType;
+  typedef typename CallbackGraphType::SourceGraph SourceGraph;
+  typedef typename CallbackGraphType::SourceWeightNodeMap SourceWeightNodeMap;
+  typedef typename CallbackGraphType::SourceIntNodeMap SourceIntNodeMap;
+  typedef typename CallbackGraphType::SourceNodeSet SourceNodeSet;
+  typedef typename CallbackGraphType::Graph Graph;
+  typedef typename CallbackGraphType::WeightNodeMap WeightNodeMap;
+  typedef typename Graph::template NodeMap<std::string> LabelNodeMap;
+  typedef typename Graph::template EdgeMap<double> WeightEdgeMap;
   
 protected:
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
@@ -44,33 +56,31 @@ public:
   HeuristicRooted(IloEnv env,
                   IloBoolVarArray x,
 //                  IloBoolVarArray z,
-                  const Graph& g,
-                  const WeightNodeMap& weight,
-                  NodeSet rootNodes,
-                  const IntNodeMap& nodeMap,
+                  const SourceGraph& g,
+                  const SourceWeightNodeMap& weight,
+                  const SourceNodeSet& rootNodes,
+                  const SourceIntNodeMap& nodeMap,
 //                  const IntEdgeMap& edgeMap,
                   int n,
-                  int m,
-                  IloFastMutex* pMutex)
+                  int m)
     : IloCplex::HeuristicCallbackI(env)
     , _x(x)
 //    , _z(z)
-    , _g(g)
-    , _weight(weight)
-    , _rootNodes(rootNodes)
-    , _nodeMap(nodeMap)
+    , _callbackGraph(g, weight, nodeMap)
+    , _g(_callbackGraph.getGraph())
+    , _weight(_callbackGraph.getScores())
+    , _rootNodes(_callbackGraph.getNodes(rootNodes))
 //    , _edgeMap(edgeMap)
     , _n(n)
     , _m(m)
+    , _xValues(env, n)
     , _pEdgeCost(NULL)
     , _pEdgeFilterMap(NULL)
     , _pSubG(NULL)
     , _pSubSolutionMap(NULL)
     , _pMwcsSubGraph(NULL)
     , _pMwcsSubTreeSolver(NULL)
-    , _pMutex(pMutex)
   {
-    lock();
     _pEdgeCost = new DoubleEdgeMap(_g);
     _pEdgeFilterMap = new BoolEdgeMap(_g, false);
     _pSubG = new SubGraphType(_g, *_pEdgeFilterMap);
@@ -78,29 +88,27 @@ public:
     _pMwcsSubGraph = new MwcsSubGraphType();
     _pMwcsSubGraph->init(_pSubG, NULL, &_weight, NULL);
     _pMwcsSubTreeSolver = new TreeSolverRootedImplType();
-    unlock();
   }
   
   HeuristicRooted(const HeuristicRooted& other)
     : IloCplex::HeuristicCallbackI(other._env)
     , _x(other._x)
 //    , _z(other._z)
-    , _g(other._g)
-    , _weight(other._weight)
+    , _callbackGraph(other._callbackGraph)
+    , _g(_callbackGraph.getGraph())
+    , _weight(_callbackGraph.getScores())
     , _rootNodes(other._rootNodes)
-    , _nodeMap(other._nodeMap)
 //    , _edgeMap(other._edgeMap)
     , _n(other._n)
     , _m(other._m)
+    , _xValues(other._env, other._n)
     , _pEdgeCost(NULL)
     , _pEdgeFilterMap(NULL)
     , _pSubG(NULL)
     , _pSubSolutionMap(NULL)
     , _pMwcsSubGraph(NULL)
     , _pMwcsSubTreeSolver(NULL)
-    , _pMutex(other._pMutex)
   {
-    lock();
     _pEdgeCost = new DoubleEdgeMap(_g);
     _pEdgeFilterMap = new BoolEdgeMap(_g, false);
     _pSubG = new SubGraphType(_g, *_pEdgeFilterMap);
@@ -108,19 +116,17 @@ public:
     _pMwcsSubGraph = new MwcsSubGraphType();
     _pMwcsSubGraph->init(_pSubG, NULL, &_weight, NULL);
     _pMwcsSubTreeSolver = new TreeSolverRootedImplType();
-    unlock();
   }
   
   ~HeuristicRooted()
   {
-    lock();
     delete _pMwcsSubTreeSolver;
     delete _pMwcsSubGraph;
     delete _pEdgeCost;
     delete _pEdgeFilterMap;
     delete _pSubSolutionMap;
     delete _pSubG;
-    unlock();
+    _xValues.end();
   }
   
 protected:
@@ -147,18 +153,6 @@ protected:
     return (new (_env) HeuristicRooted(*this));
   }
   
-  void lock()
-  {
-    if (_pMutex)
-      _pMutex->lock();
-  }
-  
-  void unlock()
-  {
-    if (_pMutex)
-      _pMutex->unlock();
-  }
-  
   void setCplexSolution(IloBoolVarArray solutionVar, IloNumArray solution, double solutionWeight)
   {
     // we can't provide CPLEX the solutionWeight because in the PCST case we use a different objective
@@ -167,28 +161,20 @@ protected:
   
   void computeEdgeWeights()
   {
-    IloNumArray x_values(_env, _n);
-    getValues(x_values, _x);
+    getValues(_xValues, _x);
     
     for (EdgeIt e(_g); e != lemon::INVALID; ++e)
     {
-      Node u = _g.u(e);
-      Node v = _g.v(e);
-      
-      double x_u = x_values[_nodeMap[u]];
-      double x_v = x_values[_nodeMap[v]];
+      double x_u = _xValues[_g.id(_g.u(e))];
+      double x_v = _xValues[_g.id(_g.v(e))];
       
       _pEdgeCost->set(e, 2 - (x_u + x_v));
     }
-    
-    x_values.end();
   }
   
   void computeMinimumCostSpanningTree()
   {
-    lock();
     lemon::kruskal(_g, *_pEdgeCost, *_pEdgeFilterMap);
-    unlock();
   }
   
   virtual bool computeMaxWeightConnectedSubtree(IloBoolVarArray& solutionVar,
@@ -214,7 +200,7 @@ protected:
       
       for (NodeSetIt it = solutionSet.begin(); it != solutionSet.end(); ++it)
       {
-        solution[_nodeMap[*it]] = 1;
+        solution[_g.id(*it)] = 1;
       }
             
 //      for (EdgeIt e(_g); e != lemon::INVALID; ++e)
@@ -234,20 +220,21 @@ protected:
 protected:
   IloBoolVarArray _x;
 //  IloBoolVarArray _z;
+  const CallbackGraphType _callbackGraph;
   const Graph& _g;
   const WeightNodeMap& _weight;
   NodeSet _rootNodes;
-  const IntNodeMap& _nodeMap;
 //  const IntEdgeMap& _edgeMap;
   const int _n;
   const int _m;
+  /// LP values of _x, indexed by node id (variable order)
+  IloNumArray _xValues;
   DoubleEdgeMap* _pEdgeCost;
   BoolEdgeMap* _pEdgeFilterMap;
   const SubGraphType* _pSubG;
   SubBoolNodeMap* _pSubSolutionMap;
   MwcsSubGraphType* _pMwcsSubGraph;
   TreeSolverRootedImplType* _pMwcsSubTreeSolver;
-  IloFastMutex* _pMutex;
 };
   
 } // namespace mwcs
@@ -27,11 +27,16 @@ template<typename GR,
 class HeuristicUnrooted : public HeuristicRooted<GR, NWGHT, NLBL, EWGHT>
 {
 public:
-  typedef GR Graph;
-  typedef NWGHT WeightNodeMap;
-  typedef NLBL LabelNodeMap;
-  typedef EWGHT WeightEdgeMap;
   typedef HeuristicRooted<GR, NWGHT, NLBL, EWGHT> Parent;
+  typedef typename Parent::CallbackGraphType CallbackGraphType;
+  typedef typename Parent::SourceGraph SourceGraph;
+  typedef typename Parent::SourceWeightNodeMap SourceWeightNodeMap;
+  typedef typename Parent::SourceIntNodeMap SourceIntNodeMap;
+  typedef typename Parent::SourceNodeSet SourceNodeSet;
+  typedef typename Parent::Graph Graph;
+  typedef typename Parent::WeightNodeMap WeightNodeMap;
+  typedef typename Parent::LabelNodeMap LabelNodeMap;
+  typedef typename Parent::WeightEdgeMap WeightEdgeMap;
   
   using Parent::_env;
   using Parent::_x;
@@ -39,11 +44,9 @@ public:
   using Parent::_g;
   using Parent::_weight;
   using Parent::_rootNodes;
-  using Parent::_nodeMap;
 //  using Parent::_edgeMap;
   using Parent::_n;
   using Parent::_m;
-  using Parent::_pMutex;
   using Parent::_pMwcsSubGraph;
   using Parent::_pSubSolutionMap;
   using Parent::hasIncumbent;
@@ -54,8 +57,6 @@ public:
   using Parent::getValue;
   using Parent::getValues;
   using Parent::setCplexSolution;
-  using Parent::lock;
-  using Parent::unlock;
   
 protected:
   TEMPLATE_GRAPH_TYPEDEFS(Graph);
@@ -70,22 +71,19 @@ public:
                     IloBoolVarArray x,
                     IloBoolVarArray y,
 //                    IloBoolVarArray z,
-                    const Graph& g,
-                    const WeightNodeMap& weight,
-                    const IntNodeMap& nodeMap,
+                    const SourceGraph& g,
+                    const SourceWeightNodeMap& weight,
+                    const SourceIntNodeMap& nodeMap,
 //                    const IntEdgeMap& edgeMap,
                     int n,
-                    int m,
-                    IloFastMutex* pMutex)
+                    int m)
 //    : Parent(env, x, z, g, weight, lemon::INVALID, nodeMap, edgeMap, n, m, pMutex)
-    : Parent(env, x, g, weight, NodeSet(), nodeMap, n, m, pMutex)
+    : Parent(env, x, g, weight, SourceNodeSet(), nodeMap, n, m)
     , _y(y)
     , _tol(_epsilon)
     , _pMwcsSubTreeUnrootedSolver(NULL)
   {
-    lock();
     _pMwcsSubTreeUnrootedSolver = new TreeSolverUnrootedImplType();
-    unlock();
   }
     
   HeuristicUnrooted(const HeuristicUnrooted& other)
@@ -94,16 +92,12 @@ public:
     , _tol(other._tol)
     , _pMwcsSubTreeUnrootedSolver(NULL)
   {
-    lock();
     _pMwcsSubTreeUnrootedSolver = new TreeSolverUnrootedImplType();
-    unlock();
   }
     
   ~HeuristicUnrooted()
   {
-    lock();
     delete _pMwcsSubTreeUnrootedSolver;
-    unlock();
   }
 
 protected:
@@ -138,11 +132,11 @@ protected:
     IloNumArray y_values(_env, _n);
     getValues(y_values, _y);
     
-    for (NodeIt i(_g); i != lemon::INVALID; ++i)
+    for (int i = 0; i < _n; ++i)
     {
-      if (_tol.nonZero(y_values[_nodeMap[i]]))
+      if (_tol.nonZero(y_values[i]))
       {
-        _rootNodes.insert(i);
+        _rootNodes.insert(_g.nodeFromId(i));
       }
     }
     
@@ -176,7 +170,7 @@ protected:
       int smallestIdx = _x.getSize();
       for (NodeSetIt it = solutionSet.begin(); it != solutionSet.end(); ++it)
       {
-        int idx = _nodeMap[*it];
+        int idx = _g.id(*it);
         solution[idx] = 1;
         if (idx < smallestIdx && _weight[*it] > 0)
         {
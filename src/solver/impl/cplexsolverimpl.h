@@ -44,6 +44,8 @@ public:
   typedef typename NodeVector::const_iterator NodeVectorIt;
   typedef std::vector<Node> InvNodeIntMap;
   typedef std::vector<Arc> InvArcIntMap;
+  typedef std::vector<int> IntVector;
+  typedef std::vector<double> DoubleVector;
   
   struct Options
   {
@@ -53,7 +55,8 @@ public:
             int timeLimit,
             int multiThreading,
             int memoryLimit,
-            bool pcst)
+            bool pcst,
+            bool names = false)
       : _backOff(backOff)
       , _analysis(analysis)
       , _maxNumberOfCuts(maxNumberOfCuts)
@@ -61,6 +64,7 @@ public:
       , _multiThreading(multiThreading)
       , _memoryLimit(memoryLimit)
       , _pcst(pcst)
+      , _names(names)
     {
     }
     
@@ -71,6 +75,9 @@ public:
     int _multiThreading;
     int _memoryLimit;
     bool _pcst;
+    /// Whether variables are named after the node labels (for debugging
+    /// and exportModel(), rendering the labels is not for free)
+    bool _names;
   };
 
 protected:
@@ -81,6 +88,9 @@ protected:
     , _m(0)
     , _pNode(NULL)
     , _invNode()
+    , _score()
+    , _adjOffset()
+    , _adj()
     , _env()
     , _model(_env)
     , _cplex(_model)
@@ -117,6 +127,12 @@ protected:
   int _m;
   IntNodeMap* _pNode;
   InvNodeIntMap _invNode;
+  /// Score of every variable
+  DoubleVector _score;
+  /// The neighbors of variable i are _adj[_adjOffset[i]], ...,
+  /// _adj[_adjOffset[i+1] - 1], as variable indices
+  IntVector _adjOffset;
+  IntVector _adj;
   IloEnv _env;
   IloModel _model;
   IloCplex _cplex;
@@ -134,6 +150,12 @@ protected:
   
   virtual bool solveModel() = 0;
 
+  /// Degree of the node of variable i
+  int degree(int i) const
+  {
+    return _adjOffset[i + 1] - _adjOffset[i];
+  }
+
 private:
   struct NodesDegComp
   {
@@ -219,26 +241,42 @@ inline void CplexSolverImpl<GR, NWGHT, NLBL, EWGHT>::initVariables(const MwcsGra
 
     // x_i = 0 if node i is not in the subgraph
     // x_i = 1 if node i is the subgraph
-    snprintf(buf, 1024, "x_%s", mwcsGraph.getLabel(v).c_str());
-//    snprintf(buf, 1024, "x_%d", g.id(v));
-    _x[i].setName(buf);
+    if (_options._names)
+    {
+      snprintf(buf, 1024, "x_%s", mwcsGraph.getLabel(v).c_str());
+      _x[i].setName(buf);
+    }
 
     (*_pNode)[v] = i;
   }
+
+  // scores and adjacency in variable order, such that the constraints
+  // can be generated by scanning flat arrays
+  _score.resize(_n);
+  _adjOffset.assign(_n + 1, 0);
+  _adj.clear();
+  _adj.reserve(2 * mwcsGraph.getEdgeCount());
+  for (i = 0; i < _n; ++i)
+  {
+    Node v = _invNode[i];
+    _score[i] = mwcsGraph.getScore(v);
+    for (IncEdgeIt e(g, v); e != lemon::INVALID; ++e)
+    {
+      _adj.push_back((*_pNode)[g.oppositeNode(v, e)]);
+    }
+    _adjOffset[i + 1] = static_cast<int>(_adj.size());
+  }
 }
   
 template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
 inline void CplexSolverImpl<GR, NWGHT, NLBL, EWGHT>::initConstraints(const MwcsGraphType& mwcsGraph)
 {
-  const Graph& g = mwcsGraph.getGraph();
-  const WeightNodeMap& weight = mwcsGraph.getScores();
-
   IloExpr expr(_env);
   
   // objective function
   for (int i = 0; i < _n ; i++)
   {
-    expr += _x[i] * weight[_invNode[i]];
+    expr += _x[i] * _score[i];
   }
   _model.add(IloObjective(_env, expr, IloObjective::Maximize));
 
@@ -246,15 +284,15 @@ inline void CplexSolverImpl<GR, NWGHT, NLBL, EWGHT>::initConstraints(const MwcsG
   if (_pAnalysis)
   {
     int nAnalyzeConstraints = 0;
-    for (NodeIt i(g); i != lemon::INVALID; ++i)
+    for (int i = 0; i < _n; ++i)
     {
-      if (weight[i] > 0)
+      if (_score[i] > 0)
       {
-        for (NodeIt j(g); j != lemon::INVALID; ++j)
+        for (int j = 0; j < _n; ++j)
         {
-          if (weight[j] > 0 && _pAnalysis->ok(i, j))
+          if (_score[j] > 0 && _pAnalysis->ok(_invNode[i], _invNode[j]))
           {
-            _model.add(_x[(*_pNode)[i]] <= _x[(*_pNode)[j]]);
+            _model.add(_x[i] <= _x[j]);
             nAnalyzeConstraints++;
           }
         }
@@ -0,0 +1,414 @@
+/*
+ * cutsolverpcstimpl.h
+ *
+ *  Created on: 16-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef CUTSOLVERPCSTIMPL_H
+#define CUTSOLVERPCSTIMPL_H
+
+#include "solverimpl.h"
+#include "cplexsolverimpl.h"
+#include "cplex_cut/arccut.h"
+#include "cplex_incumbent/pcstincumbent.h"
+#include "pcstgraph.h"
+
+#include <ilconcert/ilothread.h>
+
+namespace nina {
+namespace mwcs {
+
+/// Solves PCST instances with costs on the edges (see PcstGraph)
+///
+/// Every edge uv gives rise to the arcs (u,v) and (v,u) with variables
+/// z_uv and z_vu. A solution is an arborescence: every selected node
+/// other than the root has exactly one incoming arc. Without root nodes,
+/// at most one node is chosen as root by the variables r.
+template<typename GR,
+         typename NWGHT = typename GR::template NodeMap<double>,
+         typename NLBL = typename GR::template NodeMap<std::string>,
+         typename EWGHT = typename GR::template EdgeMap<double> >
+class CutSolverPcstImpl : public SolverImpl<GR, NWGHT, NLBL, EWGHT>,
+                          public CplexSolverImpl<GR, NWGHT, NLBL, EWGHT>
+{
+public:
+  typedef GR Graph;
+  typedef NWGHT WeightNodeMap;
+  typedef NLBL LabelNodeMap;
+  typedef EWGHT WeightEdgeMap;
+
+  typedef SolverImpl<Graph, WeightNodeMap, LabelNodeMap, WeightEdgeMap> Parent1;
+  typedef CplexSolverImpl<Graph, WeightNodeMap, LabelNodeMap, WeightEdgeMap> Parent2;
+
+  typedef typename Parent1::MwcsGraphType MwcsGraphType;
+  typedef typename Parent1::NodeSet NodeSet;
+  typedef typename Parent1::NodeSetIt NodeSetIt;
+
+  typedef typename Parent2::Options Options;
+
+  typedef PcstGraph<Graph, WeightNodeMap, LabelNodeMap, WeightEdgeMap> PcstGraphType;
+  typedef typename PcstGraphType::EdgeSet EdgeSet;
+  typedef PcstIncumbent<Graph, WeightNodeMap, LabelNodeMap, WeightEdgeMap> PcstIncumbentType;
+
+  TEMPLATE_GRAPH_TYPEDEFS(Graph);
+
+  using Parent1::_pMwcsGraph;
+  using Parent2::_options;
+  using Parent2::_n;
+  using Parent2::_m;
+  using Parent2::_pNode;
+  using Parent2::_invNode;
+  using Parent2::_env;
+  using Parent2::_model;
+  using Parent2::_cplex;
+  using Parent2::_x;
+  using Parent2::initVariables;
+  using Parent2::clean;
+
+public:
+  CutSolverPcstImpl(const Options& options)
+    : Parent1()
+    , Parent2(options)
+    , _pPcstGraph(NULL)
+    , _rootNodes()
+    , _z()
+    , _r()
+    , _arcSource()
+    , _arcTarget()
+    , _invEdge()
+    , _rootIndices()
+  {
+  }
+
+  virtual ~CutSolverPcstImpl()
+  {
+  }
+
+  /// Without root nodes, the instance is solved unrooted
+  void init(const PcstGraphType& pcstGraph, const NodeSet& rootNodes)
+  {
+    _pMwcsGraph = _pPcstGraph = &pcstGraph;
+    _rootNodes = rootNodes;
+    initVariables(pcstGraph);
+    initConstraints(pcstGraph);
+  }
+
+  bool solve(double& score, double& scoreUB, BoolNodeMap& solutionMap, NodeSet& solutionSet)
+  {
+    EdgeSet solutionEdges;
+    return solve(score, scoreUB, solutionMap, solutionSet, solutionEdges);
+  }
+
+  bool solve(double& score,
+             double& scoreUB,
+             BoolNodeMap& solutionMap,
+             NodeSet& solutionSet,
+             EdgeSet& solutionEdges);
+
+protected:
+  typedef std::vector<int> IntVector;
+  typedef std::vector<Edge> InvEdgeIntMap;
+
+  const PcstGraphType* _pPcstGraph;
+  NodeSet _rootNodes;
+  /// Arc 2i is u(e) -> v(e) and arc 2i + 1 is v(e) -> u(e)
+  /// for the edge e with index i
+  IloBoolVarArray _z;
+  IloBoolVarArray _r;
+  IntVector _arcSource;
+  IntVector _arcTarget;
+  InvEdgeIntMap _invEdge;
+  IntVector _rootIndices;
+
+  virtual void initVariables(const MwcsGraphType& mwcsGraph);
+  virtual void initConstraints(const MwcsGraphType& mwcsGraph);
+  bool solveModel();
+};
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void CutSolverPcstImpl<GR, NWGHT, NLBL, EWGHT>::initVariables(const MwcsGraphType& mwcsGraph)
+{
+  Parent2::initVariables(mwcsGraph);
+
+  const Graph& g = mwcsGraph.getGraph();
+  const int nEdges = mwcsGraph.getEdgeCount();
+
+  _m = 2 * nEdges;
+  _z = IloBoolVarArray(_env, _m);
+  _r = _rootNodes.empty() ? IloBoolVarArray(_env, _n) : IloBoolVarArray();
+
+  _invEdge.clear();
+  _invEdge.reserve(nEdges);
+  _arcSource.resize(_m);
+  _arcTarget.resize(_m);
+
+  char buf[1024];
+
+  int i = 0;
+  for (EdgeIt e(g); e != lemon::INVALID; ++e, ++i)
+  {
+    int u = (*_pNode)[g.u(e)];
+    int v = (*_pNode)[g.v(e)];
+    _invEdge.push_back(e);
+
+    _arcSource[2 * i] = _arcTarget[2 * i + 1] = u;
+    _arcTarget[2 * i] = _arcSource[2 * i + 1] = v;
+
+    if (!_options._names)
+      continue;
+
+    snprintf(buf, 1024, "z_%s_%s", mwcsGraph.getLabel(g.u(e)).c_str(),
+             mwcsGraph.getLabel(g.v(e)).c_str());
+    _z[2 * i].setName(buf);
+    snprintf(buf, 1024, "z_%s_%s", mwcsGraph.getLabel(g.v(e)).c_str(),
+             mwcsGraph.getLabel(g.u(e)).c_str());
+    _z[2 * i + 1].setName(buf);
+  }
+
+  if (_rootNodes.empty() && _options._names)
+  {
+    for (i = 0; i < _n; ++i)
+    {
+      snprintf(buf, 1024, "r_%s", mwcsGraph.getLabel(_invNode[i]).c_str());
+      _r[i].setName(buf);
+    }
+  }
+
+  _rootIndices.clear();
+  for (NodeSetIt nodeIt = _rootNodes.begin(); nodeIt != _rootNodes.end(); ++nodeIt)
+  {
+    _rootIndices.push_back((*_pNode)[*nodeIt]);
+  }
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline void CutSolverPcstImpl<GR, NWGHT, NLBL, EWGHT>::initConstraints(const MwcsGraphType& mwcsGraph)
+{
+  const WeightNodeMap& weight = mwcsGraph.getScores();
+  const bool rooted = !_rootNodes.empty();
+
+  IloExpr expr(_env);
+
+  // objective function: prizes of the nodes minus costs of the edges
+  for (int i = 0; i < _n; ++i)
+  {
+    expr += _x[i] * weight[_invNode[i]];
+  }
+  for (int i = 0; i < static_cast<int>(_invEdge.size()); ++i)
+  {
+    expr -= (_z[2 * i] + _z[2 * i + 1]) * _pPcstGraph->getCost(_invEdge[i]);
+  }
+  _model.add(IloObjective(_env, expr, IloObjective::Maximize));
+
+  std::vector<bool> isRoot(_n, false);
+  for (IntVector::const_iterator it = _rootIndices.begin(); it != _rootIndices.end(); ++it)
+  {
+    isRoot[*it] = true;
+    _model.add(_x[*it] == 1);
+  }
+
+  // in-degree: every selected node but the root has one incoming arc
+  std::vector<IloExpr> inArcs;
+  inArcs.reserve(_n);
+  for (int i = 0; i < _n; ++i)
+  {
+    inArcs.push_back(IloExpr(_env));
+  }
+  for (int j = 0; j < _m; ++j)
+  {
+    if (isRoot[_arcTarget[j]])
+      _model.add(_z[j] == 0);
+    else
+      inArcs[_arcTarget[j]] += _z[j];
+  }
+  for (int i = 0; i < _n; ++i)
+  {
+    if (!rooted)
+      _model.add(inArcs[i] + _r[i] == _x[i]);
+    else if (!isRoot[i])
+      _model.add(inArcs[i] == _x[i]);
+    inArcs[i].end();
+  }
+
+  if (!rooted)
+  {
+    expr.clear();
+    for (int i = 0; i < _n; ++i)
+    {
+      expr += _r[i];
+    }
+    _model.add(expr <= 1);
+  }
+
+  // an edge can only be used in one direction, between selected nodes
+  for (int i = 0; i < static_cast<int>(_invEdge.size()); ++i)
+  {
+    _model.add(_z[2 * i] + _z[2 * i + 1] <= _x[_arcSource[2 * i]]);
+    _model.add(_z[2 * i] + _z[2 * i + 1] <= _x[_arcTarget[2 * i]]);
+  }
+
+  // nodes that are not in the same component as the root get x_i = 0
+  for (NodeSetIt rootIt = _rootNodes.begin(); rootIt != _rootNodes.end(); ++rootIt)
+  {
+    const int rootComp = mwcsGraph.getComponent(*rootIt);
+    for (int i = 0; i < _n; ++i)
+    {
+      if (mwcsGraph.getComponent(_invNode[i]) != rootComp)
+      {
+        _model.add(_x[i] == 0);
+      }
+    }
+  }
+
+  expr.end();
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline bool CutSolverPcstImpl<GR, NWGHT, NLBL, EWGHT>::solveModel()
+{
+  IloFastMutex* pMutex = NULL;
+  if (_options._multiThreading > 1)
+  {
+    pMutex = new IloFastMutex();
+  }
+
+  IloCplex::LazyConstraintCallbackI* pLazyCut = NULL;
+  IloCplex::UserCutCallbackI* pUserCut = NULL;
+  IloCplex::IncumbentCallbackI* pIncumbent = NULL;
+  _cplex.setParam( IloCplex::HeurFreq      , -1 );
+  _cplex.setParam( IloCplex::Cliques       , -1 );
+  _cplex.setParam( IloCplex::MCFCuts       , -1 );
+  _cplex.setParam( IloCplex::MIPEmphasis, IloCplex::MIPEmphasisBestBound );
+
+  pLazyCut = new (_env) ArcCutLazyConstraint(_env, _x, _z, _r, _n, _m,
+                                             _arcSource, _arcTarget, _rootIndices,
+                                             _options._maxNumberOfCuts);
+  pUserCut = new (_env) ArcCutUserCut(_env, _x, _z, _r, _n, _m,
+                                      _arcSource, _arcTarget, _rootIndices,
+                                      _options._maxNumberOfCuts, _options._backOff);
+
+  if (g_pOut)
+  {
+    pIncumbent = new (_env) PcstIncumbentType(_env, _pPcstGraph->getTotalPrize(), pMutex);
+  }
+
+  _cplex.setParam(IloCplex::MIPInterval, 1);
+
+  IloCplex::Callback cb(pLazyCut);
+  _cplex.use(cb);
+
+  IloCplex::Callback cb2(pUserCut);
+  _cplex.use(cb2);
+
+  IloCplex::Callback cb3(pIncumbent);
+  if (pIncumbent)
+    _cplex.use(cb3);
+
+  bool res = _cplex.solve();
+  cb.end();
+  cb2.end();
+  if (pIncumbent)
+  {
+    cb3.end();
+  }
+
+  if (g_verbosity > VERBOSE_NONE)
+  {
+    if (res)
+    {
+      std::cerr << "[" << _cplex.getObjValue() << ", "
+                << _cplex.getBestObjValue() << "]" << std::endl;
+    }
+    else
+    {
+      std::cerr << "[0, 0]" << std::endl;
+    }
+  }
+
+  delete pMutex;
+  return res;
+}
+
+template<typename GR, typename NWGHT, typename NLBL, typename EWGHT>
+inline bool CutSolverPcstImpl<GR, NWGHT, NLBL, EWGHT>::solve(double& score,
+                                                             double& scoreUB,
+                                                             BoolNodeMap& solutionMap,
+                                                             NodeSet& solutionSet,
+                                                             EdgeSet& solutionEdges)
+{
+  // the edges have to be read before solveCplex() cleans up the model
+  solutionEdges.clear();
+
+  // shut up cplex
+  if (g_verbosity < VERBOSE_NON_ESSENTIAL)
+  {
+    _cplex.setOut(_env.getNullStream());
+    _cplex.setWarning(_env.getNullStream());
+    _cplex.setError(_env.getNullStream());
+  }
+  else
+  {
+    _cplex.setOut(std::cerr);
+    _cplex.setWarning(std::cerr);
+    _cplex.setError(std::cerr);
+  }
+
+  if (_options._timeLimit > 0)
+  {
+    int limit = _options._timeLimit - g_timer.realTime();
+    limit = std::max(1, limit);
+    _cplex.setParam(IloCplex::TiLim, limit);
+  }
+
+  if (_options._memoryLimit > 0)
+  {
+    _cplex.setParam(IloCplex::TreLim, _options._memoryLimit);
+  }
+
+  if (_options._multiThreading > 1)
+  {
+    _cplex.setParam(IloCplex::ParallelMode, -1);
+    _cplex.setParam(IloCplex::Threads, _options._multiThreading);
+  }
+
+  if (!solveModel())
+  {
+    if (g_verbosity >= VERBOSE_ESSENTIAL && _cplex.getStatus() != IloAlgorithm::Infeasible)
+    {
+      std::cerr << "Optimization problems. CPLEX status code " << _cplex.getStatus() << std::endl;
+    }
+    clean();
+    return false;
+  }
+
+  solutionSet.clear();
+  for (int i = 0; i < _n; ++i)
+  {
+    Node node = _invNode[i];
+    solutionMap[node] = _cplex.getValue(_x[i]) > 0.5;
+    if (solutionMap[node])
+    {
+      solutionSet.insert(node);
+    }
+  }
+
+  for (int i = 0; i < static_cast<int>(_invEdge.size()); ++i)
+  {
+    if (_cplex.getValue(_z[2 * i]) + _cplex.getValue(_z[2 * i + 1]) > 0.5)
+    {
+      solutionEdges.insert(_invEdge[i]);
+    }
+  }
+
+  score = _cplex.getObjValue();
+  scoreUB = _cplex.getBestObjValue();
+  clean();
+
+  return true;
+}
+
+} // namespace mwcs
+} // namespace nina
+
+#endif // CUTSOLVERPCSTIMPL_H
@@ -61,6 +61,9 @@ public:
   using Parent2::_m;
   using Parent2::_pNode;
   using Parent2::_invNode;
+  using Parent2::_score;
+  using Parent2::_adjOffset;
+  using Parent2::_adj;
   using Parent2::_env;
   using Parent2::_model;
   using Parent2::_cplex;
@@ -103,17 +106,16 @@ inline void CutSolverRootedImpl<GR, NWGHT, NLBL, EWGHT>::initConstraints(const M
 {
   Parent2::initConstraints(mwcsGraph);
 
-  const Graph& g = mwcsGraph.getGraph();
-  const WeightNodeMap& weight = mwcsGraph.getScores();
-  
   IloExpr expr(_env);
   char buf[1024];
   
+  std::vector<bool> isRoot(_n, false);
   int i = 0;
   for (NodeSetIt nodeIt = _rootNodes.begin(); nodeIt != _rootNodes.end(); ++nodeIt, ++i)
   {
     // x_r = 1
     int r = (*_pNode)[*nodeIt];
+    isRoot[r] = true;
     IloConstraint c;
     _model.add(c = (_x[r] == 1));
     
@@ -123,34 +125,34 @@ inline void CutSolverRootedImpl<GR, NWGHT, NLBL, EWGHT>::initConstraints(const M
   
   // if you pick a non-root node then at least one
   // of its direct neighbors must be part of the solution as well
-  for (NodeIt i(g); i != lemon::INVALID; ++i)
+  for (int i = 0; i < _n; ++i)
   {
-    if (_rootNodes.find(i) != _rootNodes.end())
+    if (isRoot[i])
       continue;
     
     expr.clear();
-    for (IncEdgeIt e(g, i); e != lemon::INVALID; ++e)
+    for (int k = _adjOffset[i]; k < _adjOffset[i + 1]; ++k)
     {
-      Node j = g.oppositeNode(i, e);
-      expr += _x[(*_pNode)[j]];
+      const int j = _adj[k];
+      expr += _x[j];
       
       // if i is negative then its positive neighbors must be in
-      if (weight[i] < 0 && weight[j] > 0)
-        _model.add(_x[(*_pNode)[i]] <= _x[(*_pNode)[j]]);
+      if (_score[i] < 0 && _score[j] > 0)
+        _model.add(_x[i] <= _x[j]);
     }
     
-    _model.add(_x[(*_pNode)[i]] <= expr);
+    _model.add(_x[i] <= expr);
   }
   
   for (NodeSetIt rootIt = _rootNodes.begin(); rootIt != _rootNodes.end(); ++rootIt)
   {
     // nodes i that are not in the same component as the root get x_i = 0
     const int rootComp = mwcsGraph.getComponent(*rootIt);
-    for (NodeIt i(g); i != lemon::INVALID; ++i)
+    for (int i = 0; i < _n; ++i)
     {
-      if (mwcsGraph.getComponent(i) != rootComp)
+      if (mwcsGraph.getComponent(_invNode[i]) != rootComp)
       {
-        _model.add(_x[(*_pNode)[i]] == 0);
+        _model.add(_x[i] == 0);
       }
     }
   }
@@ -162,6 +164,8 @@ inline bool CutSolverRootedImpl<GR, NWGHT, NLBL, EWGHT>::solveModel()
   const Graph& g = _pMwcsGraph->getGraph();
   const WeightNodeMap& weight = _pMwcsGraph->getScores();
 
+  // only the incumbent callbacks share state, the separation and heuristic
+  // callbacks work on thread-private copies of the graph
   IloFastMutex* pMutex = NULL;
   if (_options._multiThreading > 1)
   {
@@ -192,15 +196,15 @@ inline bool CutSolverRootedImpl<GR, NWGHT, NLBL, EWGHT>::solveModel()
   _cplex.setParam( IloCplex::MIPEmphasis, IloCplex::MIPEmphasisBestBound );
 
   pLazyCut = new (_env) NodeCutRootedLazyConstraintType(_env, _x, g, weight, _rootNodes, *_pNode,
-                                                        _n, _options._maxNumberOfCuts, pMutex);
+                                                        _n, _options._maxNumberOfCuts);
   pUserCut = new (_env) NodeCutRootedUserCutType(_env, _x, g, weight, _rootNodes, *_pNode,
-                                                 _n, _options._maxNumberOfCuts, pMutex,
+                                                 _n, _options._maxNumberOfCuts,
                                                  _options._backOff);
     
   pHeuristic = new (_env) HeuristicRootedType(_env, _x, //_z,
                                               g, weight, _rootNodes,
                                               *_pNode, //*_pEdge,
-                                              _n, _m, pMutex);
+                                              _n, _m);
   
   if (g_pOut)
   {
@@ -58,6 +58,9 @@ public:
   using Parent2::_m;
   using Parent2::_pNode;
   using Parent2::_invNode;
+  using Parent2::_score;
+  using Parent2::_adjOffset;
+  using Parent2::_adj;
   using Parent2::_env;
   using Parent2::_model;
   using Parent2::_cplex;
@@ -121,16 +124,17 @@ inline void CutSolverUnrootedImpl<GR, NWGHT, NLBL, EWGHT>::initVariables(const M
   _n = mwcsGraph.getNodeCount();
   _y = IloBoolVarArray(_env, _n);
   
+  // y_i = 0 if node i is not the root node
+  // y_i = 1 if node i is picked as the root node
+  if (!_options._names)
+    return;
+  
   char buf[1024];
   int i = 0;
   for (NodeVectorIt it = _invNode.begin(); it != _invNode.end(); ++it, ++i)
   {
     Node v = *it;
-
-    // y_i = 0 if node i is not the root node
-    // y_i = 1 if node i is picked as the root node
     snprintf(buf, 1024, "y_%s", mwcsGraph.getLabel(v).c_str());
-    //snprintf(buf, 1024, "y_%d", g.id(v));
     _y[i].setName(buf);
   }
 }
@@ -140,9 +144,6 @@ inline void CutSolverUnrootedImpl<GR, NWGHT, NLBL, EWGHT>::initConstraints(const
 {
   Parent2::initConstraints(mwcsGraph);
   
-  const Graph& g = mwcsGraph.getGraph();
-  const WeightNodeMap& weight = mwcsGraph.getScores();
-  
   IloExpr expr(_env);
 
   // there is at most one root node
@@ -171,8 +172,7 @@ inline void CutSolverUnrootedImpl<GR, NWGHT, NLBL, EWGHT>::initConstraints(const
   expr.clear();
   for (int i = 0; i < _n; i++)
   {
-    double weight_i = weight[_invNode[i]];
-    if (weight_i < 0)
+    if (_score[i] < 0)
     {
       expr += _y[i];
     }
@@ -183,29 +183,29 @@ inline void CutSolverUnrootedImpl<GR, NWGHT, NLBL, EWGHT>::initConstraints(const
   expr.clear();
   for (int i = 0; i < _n ; i++)
   {
-    expr += _x[i] * weight[_invNode[i]];
+    expr += _x[i] * _score[i];
   }
   _model.add(expr >= 0);
   
   // if you pick a node then it must be the root node
   // or at least one of its direct neighbors must be part
   // of the solution as well
-  for (NodeIt i(g); i != lemon::INVALID; ++i)
+  for (int i = 0; i < _n; ++i)
   {
     expr.clear();
-    for (IncEdgeIt e(g, i); e != lemon::INVALID; ++e)
+    for (int k = _adjOffset[i]; k < _adjOffset[i + 1]; ++k)
     {
-      Node j = g.oppositeNode(i, e);
-      expr += _x[(*_pNode)[j]];
+      const int j = _adj[k];
+      expr += _x[j];
       
       // if i is negative then its positive neighbors must be in
-      if (weight[i] < 0 && weight[j] > 0)
-        _model.add(_x[(*_pNode)[i]] <= _x[(*_pNode)[j]]);
+      if (_score[i] < 0 && _score[j] > 0)
+        _model.add(_x[i] <= _x[j]);
     }
     
-    expr += _y[(*_pNode)[i]];
+    expr += _y[i];
     
-    _model.add(_x[(*_pNode)[i]] <= expr);
+    _model.add(_x[i] <= expr);
   }
   
   // if you pick a negative node, then at least two of its direct neighbors
@@ -218,33 +218,29 @@ inline void CutSolverUnrootedImpl<GR, NWGHT, NLBL, EWGHT>::initConstraints(const
     {
       std::cout << std::endl;
     }
-    int idx = 1;
-    for (NodeIt i(g); i != lemon::INVALID; ++i, ++idx)
+    for (int id_i = 0; id_i < _n; ++id_i)
     {
       if (g_verbosity >= VERBOSE_DEBUG)
       {
-        std::cout << "\rAdding symmetry breaking constraints " << idx << "/" << _n << std::flush;
+        std::cout << "\rAdding symmetry breaking constraints " << id_i + 1 << "/" << _n << std::flush;
       }
-      if (weight[i] <= 0)
+      if (_score[id_i] <= 0)
       {
         expr.clear();
-        for (IncEdgeIt e(g, i); e != lemon::INVALID; ++e)
+        for (int k = _adjOffset[id_i]; k < _adjOffset[id_i + 1]; ++k)
         {
-          Node j = g.oppositeNode(i, e);
-          expr += _x[(*_pNode)[j]];
+          expr += _x[_adj[k]];
         }
-        _model.add(2 * _x[(*_pNode)[i]] <= expr);
+        _model.add(2 * _x[id_i] <= expr);
       }
       else
       {
         // symmetry breaking
         // sum_{j > i, w_j > 0} y_j <= 1 - x_i
-        int id_i = (*_pNode)[i];
         expr.clear();
         for (int id_j = id_i + 1; id_j < _n; ++id_j)
         {
-          Node j = _invNode[id_j];
-          if (weight[j] < 0) continue;
+          if (_score[id_j] < 0) continue;
           expr += _y[id_j];
 	  _model.add(_y[id_j] <= 1 - _x[id_i]); // will be removed in later versions, see resolved issue
         }
@@ -264,6 +260,8 @@ inline bool CutSolverUnrootedImpl<GR, NWGHT, NLBL, EWGHT>::solveModel()
   const Graph& g = _pMwcsGraph->getGraph();
   const WeightNodeMap& weight = _pMwcsGraph->getScores();
 
+  // only the incumbent callbacks share state, the separation and heuristic
+  // callbacks work on thread-private copies of the graph
   IloFastMutex* pMutex = NULL;
   if (_options._multiThreading > 1)
   {
@@ -296,15 +294,15 @@ inline bool CutSolverUnrootedImpl<GR, NWGHT, NLBL, EWGHT>::solveModel()
 //    _cplex.setParam( IloCplex::RepeatPresolve,  0 );
 
   pLazyCut = new (_env) NodeCutUnrootedLazyConstraint<GR, NWGHT, NLBL, EWGHT>(_env, _x, _y, g, weight, *_pNode,
-                                                                              _n, _options._maxNumberOfCuts, pMutex);
+                                                                              _n, _options._maxNumberOfCuts);
   pUserCut = new (_env) NodeCutUnrootedUserCut<GR, NWGHT, NLBL, EWGHT>(_env, _x, _y, g, weight, *_pNode,
-                                                                       _n, _options._maxNumberOfCuts, pMutex,
+                                                                       _n, _options._maxNumberOfCuts,
                                                                        _options._backOff);
 
   pHeuristic = new (_env) HeuristicUnrootedType(_env, _x, _y, //_z,
                                                 g, weight,
                                                 *_pNode, //*_pEdge,
-                                                _n, _m, pMutex);
+                                                _n, _m);
   
   if (g_pOut)
   {
@@ -332,6 +332,7 @@ inline bool TreeHeuristicSolverImpl<GR, NWGHT, NLBL, EWGHT>::solveMonteCarlo(con
   double newScoreUB;
   SubBoolNodeMap newSolutionMap(_pMwcsSubGraph->getGraph());
   NodeSet newSolutionSet;
+  std::vector<bool> orgSolution;
 
   lemon::Timer timer;
   double elapsedTimeLastIt = 0;
@@ -369,7 +370,8 @@ inline bool TreeHeuristicSolverImpl<GR, NWGHT, NLBL, EWGHT>::solveMonteCarlo(con
       
       if (g_pOut)
       {
-        *g_pOut << "Solution " << g_timer.realTime() << " " << reEvaluatePCST(mwcsGraph, solutionSet) << std::endl;
+        mwcsGraph.projectModule(solutionSet, orgSolution);
+        *g_pOut << "Solution " << g_timer.realTime() << " " << reEvaluatePCST(mwcsGraph, orgSolution) << std::endl;
       }
     }
     
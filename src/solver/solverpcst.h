@@ -0,0 +1,81 @@
+/*
+ * solverpcst.h
+ *
+ *  Created on: 16-oct-2026
+ *      Author: M. El-Kebir
+ */
+
+#ifndef SOLVERPCST_H
+#define SOLVERPCST_H
+
+#include "solver.h"
+#include "impl/cutsolverpcstimpl.h"
+
+namespace nina {
+namespace mwcs {
+
+/// Solver for PCST instances with costs on the edges,
+/// the solution consists of a node set and an edge set
+template<typename GR,
+         typename NWGHT = typename GR::template NodeMap<double>,
+         typename NLBL = typename GR::template NodeMap<std::string>,
+         typename EWGHT = typename GR::template EdgeMap<double> >
+class SolverPcst : public Solver<GR, NWGHT, NLBL, EWGHT>
+{
+public:
+  typedef GR Graph;
+  typedef NWGHT WeightNodeMap;
+  typedef NLBL LabelNodeMap;
+  typedef EWGHT WeightEdgeMap;
+
+  typedef Solver<Graph, WeightNodeMap, LabelNodeMap, WeightEdgeMap> Parent;
+  typedef CutSolverPcstImpl<Graph, WeightNodeMap, LabelNodeMap, WeightEdgeMap> CutSolverPcstImplType;
+  typedef typename CutSolverPcstImplType::PcstGraphType PcstGraphType;
+  typedef typename CutSolverPcstImplType::EdgeSet EdgeSet;
+  typedef typename Parent::NodeSet NodeSet;
+  typedef typename Parent::NodeSetIt NodeSetIt;
+
+  TEMPLATE_GRAPH_TYPEDEFS(Graph);
+
+  using Parent::_score;
+  using Parent::_scoreUB;
+  using Parent::_pSolutionMap;
+  using Parent::_solutionSet;
+
+public:
+  SolverPcst(CutSolverPcstImplType* pImpl)
+    : _pImpl(pImpl)
+    , _solutionEdges()
+  {
+  }
+
+  virtual ~SolverPcst()
+  {
+    delete _pImpl;
+  }
+
+  /// Without root nodes, the instance is solved unrooted
+  virtual bool solve(const PcstGraphType& pcstGraph,
+                     const NodeSet& rootNodes)
+  {
+    delete _pSolutionMap;
+    _pSolutionMap = new BoolNodeMap(pcstGraph.getGraph(), false);
+
+    _pImpl->init(pcstGraph, rootNodes);
+    return _pImpl->solve(_score, _scoreUB, *_pSolutionMap, _solutionSet, _solutionEdges);
+  }
+
+  const EdgeSet& getSolutionEdges() const
+  {
+    return _solutionEdges;
+  }
+
+protected:
+  CutSolverPcstImplType* _pImpl;
+  EdgeSet _solutionEdges;
+};
+
+} // namespace mwcs
+} // namespace nina
+
+#endif // SOLVERPCST_H
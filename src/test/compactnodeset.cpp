@@ -0,0 +1,184 @@
+/*
+ *  compactnodeset.cpp
+ *
+ *   Created on: 17-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include <iostream>
+#include <set>
+#include <vector>
+#include <cstdlib>
+#include <lemon/list_graph.h>
+
+#include "preprocessing/compactnodeset.h"
+
+using namespace nina::mwcs;
+
+typedef lemon::ListGraph Graph;
+typedef Graph::Node Node;
+typedef CompactNodeSet<Graph> NodeSetType;
+typedef NodeSetType::const_iterator NodeSetIt;
+typedef std::set<int> IdSet;
+
+static int g_nFailures = 0;
+
+static void check(bool condition, const char* what)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << what << std::endl;
+    ++g_nFailures;
+  }
+}
+
+static Node node(int id)
+{
+  return Graph::nodeFromId(id);
+}
+
+/// Whether set contains exactly the ids of ref, in increasing order
+static bool same(const NodeSetType& set, const IdSet& ref)
+{
+  if (set.size() != ref.size())
+    return false;
+
+  IdSet::const_iterator refIt = ref.begin();
+  for (NodeSetIt it = set.begin(); it != set.end(); ++it, ++refIt)
+  {
+    if (Graph::id(*it) != *refIt || !set.contains(*it))
+      return false;
+  }
+  return true;
+}
+
+static void testGrow()
+{
+  NodeSetType set;
+  IdSet ref;
+  for (int i = NodeSetType::INLINE_CAPACITY; i > 0; --i)
+  {
+    set.insert(node(2 * i));
+    ref.insert(2 * i);
+  }
+  check(same(set, ref), "contents of inline set");
+
+  // the inline array is full, the set moves to the heap
+  for (int i = 0; i < 4 * NodeSetType::INLINE_CAPACITY; ++i)
+  {
+    set.insert(node(2 * i + 1));
+    ref.insert(2 * i + 1);
+  }
+  check(same(set, ref), "contents after growing");
+
+  NodeSetType other;
+  other.insert(node(1000));
+  other.insert(node(0));
+  set.insert(other);
+  ref.insert(1000);
+  ref.insert(0);
+  check(same(set, ref), "contents after inserting a set");
+
+  NodeSetType moved(std::move(set));
+  check(same(moved, ref) && set.empty(), "move");
+  other = moved;
+  check(same(other, ref) && other == moved, "assignment");
+}
+
+static void testSparse()
+{
+  NodeSetType sparse;
+  IdSet sparseRef;
+  for (int i = 0; i < 256; ++i)
+  {
+    sparse.insert(node(1000 * i));
+    sparseRef.insert(1000 * i);
+  }
+  const int largeId = 1 << 20;
+  sparse.insert(node(largeId));
+  sparseRef.insert(largeId);
+  check(same(sparse, sparseRef), "contents of sparse set");
+}
+
+static void testEraseWhileIterating(int n)
+{
+  NodeSetType set;
+  IdSet ref;
+  for (int i = 0; i < n; ++i)
+  {
+    set.insert(node(i));
+    ref.insert(i);
+  }
+
+  // erase every other node through the iterator
+  int steps = 0;
+  bool erase = true;
+  for (NodeSetIt it = set.begin(); it != set.end() && steps <= n; ++steps)
+  {
+    if (erase)
+    {
+      ref.erase(Graph::id(*it));
+      it = set.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+    erase = !erase;
+  }
+  check(steps == n, "erase(const_iterator) visits every node once");
+  check(same(set, ref), "contents after erase(const_iterator)");
+
+  // erase every remaining node through the iterator
+  steps = 0;
+  for (NodeSetIt it = set.begin(); it != set.end() && steps <= n; ++steps)
+  {
+    it = set.erase(it);
+  }
+  check(set.empty(), "erase(const_iterator) empties the set");
+}
+
+static void testRandom()
+{
+  srand(1);
+  for (int round = 0; round < 100; ++round)
+  {
+    NodeSetType set;
+    IdSet ref;
+    const int range = round % 2 == 0 ? 128 : 100000;
+    for (int i = 0; i < 2000; ++i)
+    {
+      const int id = rand() % range;
+      if (rand() % 3 == 0)
+      {
+        check(set.erase(node(id)) == (ref.erase(id) == 1), "erase result");
+      }
+      else
+      {
+        check(set.insert(node(id)) == ref.insert(id).second, "insert result");
+      }
+    }
+    check(same(set, ref), "contents after random operations");
+
+    NodeSetType copy(set);
+    check(copy == set, "copy equals original");
+  }
+}
+
+int main(int argc, char** argv)
+{
+  testGrow();
+  testSparse();
+  testEraseWhileIterating(3);
+  testEraseWhileIterating(200);
+  testRandom();
+
+  if (g_nFailures > 0)
+  {
+    std::cerr << g_nFailures << " check(s) failed" << std::endl;
+    return 1;
+  }
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,218 @@
+/*
+ *  csrgraph.cpp
+ *
+ *   Created on: 17-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include <iostream>
+#include <set>
+#include <vector>
+#include <utility>
+#include <cstdlib>
+#include <lemon/list_graph.h>
+#include <lemon/concept_check.h>
+#include <lemon/concepts/graph.h>
+#include <lemon/concepts/graph_components.h>
+
+#include "csrgraph.h"
+
+using namespace nina::mwcs;
+
+typedef lemon::ListGraph Graph;
+typedef Graph::Node Node;
+typedef Graph::Edge Edge;
+typedef Graph::NodeIt NodeIt;
+typedef Graph::EdgeIt EdgeIt;
+typedef Graph::IncEdgeIt IncEdgeIt;
+typedef Graph::NodeMap<CsrGraph::Node> NodeRefMap;
+typedef Graph::EdgeMap<CsrGraph::Edge> EdgeRefMap;
+typedef std::set<std::pair<int, int> > EdgeIdSet;
+
+static int g_nFailures = 0;
+
+static void check(bool condition, const char* what)
+{
+  if (!condition)
+  {
+    std::cerr << "FAILED: " << what << std::endl;
+    ++g_nFailures;
+  }
+}
+
+/// Random multigraph with loops, parallel edges and erased items,
+/// such that the ids of g have gaps
+static void randomGraph(Graph& g, int n, int m)
+{
+  std::vector<Node> nodes;
+  for (int i = 0; i < n; ++i)
+  {
+    nodes.push_back(g.addNode());
+  }
+  for (int i = 0; i < m; ++i)
+  {
+    g.addEdge(nodes[rand() % n], nodes[rand() % n]);
+  }
+  for (int i = 0; i < n / 10; ++i)
+  {
+    Node v = nodes[rand() % n];
+    if (g.valid(v))
+      g.erase(v);
+  }
+  for (EdgeIt e(g); e != lemon::INVALID;)
+  {
+    Edge f = e;
+    ++e;
+    if (rand() % 10 == 0)
+      g.erase(f);
+  }
+}
+
+/// Number of arcs leaving every node, a loop leaves its node twice
+static void arcDegrees(const Graph& g, Graph::NodeMap<int>& degree)
+{
+  lemon::mapFill(g, degree, 0);
+  for (EdgeIt e(g); e != lemon::INVALID; ++e)
+  {
+    ++degree[g.u(e)];
+    ++degree[g.v(e)];
+  }
+}
+
+/// Whether csr is graph g under nodeRef and edgeRef
+static void checkSame(const Graph& g,
+                      const CsrGraph& csr,
+                      const NodeRefMap& nodeRef,
+                      const EdgeRefMap& edgeRef)
+{
+  Graph::NodeMap<int> degree(g);
+  arcDegrees(g, degree);
+
+  check(lemon::countNodes(csr) == lemon::countNodes(g), "node count");
+  check(lemon::countEdges(csr) == lemon::countEdges(g), "edge count");
+  check(lemon::countArcs(csr) == lemon::countArcs(g), "arc count");
+  check(csr.maxNodeId() == lemon::countNodes(g) - 1, "dense node ids");
+  check(csr.maxEdgeId() == lemon::countEdges(g) - 1, "dense edge ids");
+
+  for (EdgeIt e(g); e != lemon::INVALID; ++e)
+  {
+    CsrGraph::Edge f = edgeRef[e];
+    check(csr.u(f) == nodeRef[g.u(e)] && csr.v(f) == nodeRef[g.v(e)], "edge end nodes");
+
+    CsrGraph::Arc a = csr.direct(f, true);
+    check(csr.source(a) == csr.u(f) && csr.target(a) == csr.v(f), "forward arc");
+    check(CsrGraph::Edge(a) == f && csr.direction(a), "forward arc direction");
+    a = csr.direct(f, false);
+    check(csr.source(a) == csr.v(f) && csr.target(a) == csr.u(f), "backward arc");
+
+    bool found = false;
+    for (CsrGraph::Edge h = csr.findEdge(csr.u(f), csr.v(f));
+         h != lemon::INVALID; h = csr.findEdge(csr.u(f), csr.v(f), h))
+    {
+      found = found || h == f;
+    }
+    check(found, "findEdge() finds every edge");
+  }
+
+  for (NodeIt v(g); v != lemon::INVALID; ++v)
+  {
+    CsrGraph::Node w = nodeRef[v];
+
+    EdgeIdSet inc, csrInc;
+    for (IncEdgeIt e(g, v); e != lemon::INVALID; ++e)
+    {
+      inc.insert(std::make_pair(csr.id(edgeRef[e]), csr.id(nodeRef[g.oppositeNode(v, e)])));
+    }
+    for (CsrGraph::IncEdgeIt f(csr, w); f != lemon::INVALID; ++f)
+    {
+      csrInc.insert(std::make_pair(csr.id(f), csr.id(csr.oppositeNode(w, f))));
+    }
+    check(inc == csrInc, "incident edges");
+    check(csr.degree(w) == lemon::countOutArcs(csr, w), "degree");
+
+    int nOut = 0, nIn = 0;
+    for (CsrGraph::OutArcIt a(csr, w); a != lemon::INVALID; ++a, ++nOut)
+    {
+      check(csr.source(a) == w, "source of out arc");
+    }
+    for (CsrGraph::InArcIt a(csr, w); a != lemon::INVALID; ++a, ++nIn)
+    {
+      check(csr.target(a) == w, "target of in arc");
+    }
+    check(nOut == nIn && nOut == degree[v], "in and out arc counts");
+  }
+}
+
+static void testBuild()
+{
+  srand(1);
+  for (int round = 0; round < 20; ++round)
+  {
+    Graph g;
+    randomGraph(g, 10 + 10 * round, 40 * round);
+
+    CsrGraph csr;
+    NodeRefMap nodeRef(g);
+    EdgeRefMap edgeRef(g);
+    csr.build(g, nodeRef, edgeRef);
+    checkSame(g, csr, nodeRef, edgeRef);
+
+    // maps are sized by the graph
+    Graph::NodeMap<int> degree(g);
+    arcDegrees(g, degree);
+    CsrGraph::NodeMap<int> csrDegree(csr, 0);
+    for (CsrGraph::ArcIt a(csr); a != lemon::INVALID; ++a)
+    {
+      ++csrDegree[csr.source(a)];
+    }
+    for (NodeIt v(g); v != lemon::INVALID; ++v)
+    {
+      check(csrDegree[nodeRef[v]] == degree[v], "node map");
+    }
+
+    // node v gets id index[v]
+    Graph::NodeMap<int> index(g);
+    int i = lemon::countNodes(g);
+    for (NodeIt v(g); v != lemon::INVALID; ++v)
+    {
+      index[v] = --i;
+    }
+    CsrGraph indexed;
+    NodeRefMap indexedNodeRef(g);
+    EdgeRefMap indexedEdgeRef(g);
+    indexed.build(g, index, indexedNodeRef, indexedEdgeRef);
+    checkSame(g, indexed, indexedNodeRef, indexedEdgeRef);
+    for (NodeIt v(g); v != lemon::INVALID; ++v)
+    {
+      check(indexed.id(indexedNodeRef[v]) == index[v], "indexed node ids");
+    }
+
+    // a copy has the same ids
+    CsrGraph copy;
+    copy.build(indexed);
+    checkSame(g, copy, indexedNodeRef, indexedEdgeRef);
+
+    // rebuilding replaces the graph
+    copy.build(g, nodeRef, edgeRef);
+    checkSame(g, copy, nodeRef, edgeRef);
+    copy.clear();
+    check(lemon::countNodes(copy) == 0 && lemon::countEdges(copy) == 0, "clear()");
+  }
+}
+
+int main(int argc, char** argv)
+{
+  lemon::checkConcept<lemon::concepts::Graph, CsrGraph>();
+  lemon::checkConcept<lemon::concepts::ClearableGraphComponent<>, CsrGraph>();
+
+  testBuild();
+
+  if (g_nFailures > 0)
+  {
+    std::cerr << g_nFailures << " check(s) failed" << std::endl;
+    return 1;
+  }
+
+  std::cout << "All checks passed" << std::endl;
+  return 0;
+}
@@ -5,6 +5,9 @@
 #include <lemon/time_measure.h>
 #include <ostream>
 #include <set>
+#include <vector>
+#include <algorithm>
+#include "parser/nodekindmap.h"
 
 namespace nina {
 namespace mwcs {
@@ -27,52 +30,29 @@ void printCommentSection(const std::string& name,
 
 void printRunSection(int threads, double primalObjValue, double dualObjValue);
 
+/// Returns the PCST objective of a solution projected onto the original
+/// graph, inSolution is indexed by original node id (see projectModule())
 template<typename MWCSGR>
 inline double reEvaluatePCST(const MWCSGR& mwcsGraph,
-                             const std::set<Node>& solution)
+                             const std::vector<bool>& inSolution)
 {
-  typedef std::set<Node> NodeSet;
-  typedef NodeSet::const_iterator NodeSetIt;
-  
-  NodeSet solutionEdges;
-  NodeSet solutionNodes;
-  
+  // edges in the solution contribute their cost,
+  // vertices not in the solution their prize
+  const Graph& orgG = mwcsGraph.getOrgGraph();
+  const NodeKindMap& kinds = mwcsGraph.getOrgNodeKinds();
+  const int n = std::min(static_cast<int>(inSolution.size()), kinds.size());
+
   double cost = 0;
-  for (NodeSetIt nodeIt = solution.begin(); nodeIt != solution.end(); ++nodeIt)
+  for (int i = 0; i < n; ++i)
   {
-    const NodeSet& orgNodes = mwcsGraph.getOrgNodes(*nodeIt);
-    for (NodeSetIt orgNodeIt = orgNodes.begin(); orgNodeIt != orgNodes.end(); ++orgNodeIt)
+    const NodeKind kind = kinds.kind(i);
+    if (kind == NODE_KIND_EDGE && inSolution[i])
     {
-      Node orgNode = *orgNodeIt;
-      const std::string& label = mwcsGraph.getOrgLabel(orgNode);
-      int idU = -1, idV = -1;
-      char c = '\0';
-      if (sscanf(label.c_str(), "%d--%d%c", &idU, &idV, &c) == 2)
-      {
-        // edge
-        solutionEdges.insert(orgNode);
-        cost += -1 * mwcsGraph.getOrgScore(orgNode);
-      }
-      else if (sscanf(label.c_str(), "%d%c", &idU, &c) == 1)
-      {
-        // node
-        solutionNodes.insert(*orgNodeIt);
-      }
+      cost += -1 * mwcsGraph.getOrgScore(orgG.nodeFromId(i));
     }
-  }
-  
-  const Graph& orgG = mwcsGraph.getOrgGraph();
-  for (NodeIt v(orgG); v != lemon::INVALID; ++v)
-  {
-    const std::string& label = mwcsGraph.getOrgLabel(v);
-    
-    int idU = -1;
-    char c = '\0';
-    if (solutionEdges.find(v) == solutionEdges.end() &&
-        solutionNodes.find(v) == solutionNodes.end() &&
-        sscanf(label.c_str(), "%d%c", &idU, &c) == 1)
+    else if (kind == NODE_KIND_VERTEX && !inSolution[i])
     {
-      cost += mwcsGraph.getOrgScore(v);
+      cost += mwcsGraph.getOrgScore(orgG.nodeFromId(i));
     }
   }
   
@@ -0,0 +1,49 @@
+#!/usr/bin/python
+import os
+import sys
+import subprocess
+
+if len(sys.argv) < 4:
+    sys.stderr.write("Usage: " + sys.argv[0] + " <subdivided_executable> <native_executable> <input_file> ...\n")
+    sys.exit(1)
+
+executables = [("subdivided", sys.argv[1]), ("native", sys.argv[2])]
+input_files = sys.argv[3:]
+time_limit = 60
+threads = 1
+
+def run_section(executable, input_file, output_file):
+    command = executable + " " + input_file + " " + str(time_limit) + " " + str(threads) + " " + output_file
+    print(command)
+    status = subprocess.call(command, shell=True)
+    if status != 0:
+        sys.exit(status)
+    # primal objective and time from the DIMACS 'SECTION Run'
+    values = {}
+    in_run = False
+    for line in open(output_file):
+        columns = line.split()
+        if columns == ["SECTION", "Run"]:
+            in_run = True
+        elif in_run and columns == ["End"]:
+            break
+        elif in_run and len(columns) == 2:
+            values[columns[0]] = float(columns[1])
+    return (values["Primal"], values["Time"])
+
+results = []
+for input_file in input_files:
+    name = os.path.splitext(os.path.basename(input_file))[0]
+    results.append([name] + [run_section(executable, input_file, name + "." + model + ".dimacs")
+                             for model, executable in executables])
+
+print("%-16s %13s %11s %13s %10s" % ("instance", "subdivided", "native", "subdivided s", "native s"))
+status = 0
+for name, (subdivided, subdivided_time), (native, native_time) in results:
+    print("%-16s %13.6f %11.6f %13.2f %10.2f" % (name, subdivided, native, subdivided_time, native_time))
+    if abs(subdivided - native) > 1e-6 * max(1., abs(subdivided)):
+        sys.stderr.write(name + ": native objective " + str(native)
+                         + " differs from subdivided objective " + str(subdivided) + "\n")
+        status = 1
+
+sys.exit(status)
@@ -0,0 +1,53 @@
+#!/usr/bin/python
+import os
+import sys
+import subprocess
+
+if len(sys.argv) < 3:
+    sys.stderr.write("Usage: " + sys.argv[0] + " <executable> <input_file> ...\n")
+    sys.exit(1)
+
+executable = sys.argv[1]
+input_files = sys.argv[2:]
+time_limit = 60
+threads = [1, 2, 4, 8]
+
+def run(input_file, nThreads, output_file):
+    command = executable + " " + input_file + " " + str(time_limit) + " " + str(nThreads) + " " + output_file
+    print(command)
+    process = subprocess.Popen(command, shell=True)
+    # the resource usage of this run only, ru_maxrss is in kilobytes
+    status, usage = os.wait4(process.pid, 0)[1:]
+    if status != 0:
+        sys.exit(1)
+    # primal objective and time from the DIMACS 'SECTION Run'
+    values = {}
+    in_run = False
+    for line in open(output_file):
+        columns = line.split()
+        if columns == ["SECTION", "Run"]:
+            in_run = True
+        elif in_run and columns == ["End"]:
+            break
+        elif in_run and len(columns) == 2:
+            values[columns[0]] = float(columns[1])
+    return (values["Primal"], values["Time"], usage.ru_maxrss / 1024.)
+
+results = []
+for input_file in input_files:
+    name = os.path.splitext(os.path.basename(input_file))[0]
+    for nThreads in threads:
+        results.append((name, nThreads) + run(input_file, nThreads, name + ".m" + str(nThreads) + ".dimacs"))
+
+print("%-16s %8s %13s %10s %10s" % ("instance", "threads", "objective", "time s", "peak MB"))
+status = 0
+for name, nThreads, objective, time, rss in results:
+    print("%-16s %8d %13.6f %10.2f %10.1f" % (name, nThreads, objective, time, rss))
+    serial = [result[2] for result in results if result[0] == name and result[1] == threads[0]][0]
+    if abs(objective - serial) > 1e-6 * max(1., abs(serial)):
+        sys.stderr.write(name + ": objective " + str(objective) + " with " + str(nThreads)
+                         + " threads differs from objective " + str(serial) + " with "
+                         + str(threads[0]) + " thread\n")
+        status = 1
+
+sys.exit(status)
@@ -0,0 +1,51 @@
+#!/usr/bin/python
+import os
+import sys
+import shutil
+import tempfile
+import subprocess
+
+if len(sys.argv) != 3 and len(sys.argv) != 4:
+    sys.stderr.write("Usage: " + sys.argv[0] + " <bench_preprocess_executable> <input_file> [-pcst]\n")
+    sys.exit(1)
+
+executable = sys.argv[1]
+input_file = sys.argv[2]
+options = ""
+if len(sys.argv) == 4:
+    options = " " + sys.argv[3]
+threads = [1, 4]
+
+def reduced_graph(nThreads, output_dir):
+    os.mkdir(output_dir)
+    command = executable + options + " -r 1 -m " + str(nThreads) + " -o " + output_dir + " " + input_file
+    print(command)
+    process = subprocess.Popen(command, shell=True, stdout=subprocess.PIPE)
+    output = process.communicate()[0].decode()
+    if process.returncode != 0:
+        sys.exit(process.returncode)
+    # header line, followed by: file nodes edges nodes' edges' best mean
+    columns = output.splitlines()[1].split()
+    print(output.splitlines()[1])
+    reduced_file = os.path.join(output_dir, os.path.basename(input_file) + ".reduced")
+    return ((int(columns[3]), int(columns[4])), open(reduced_file).read())
+
+output_dir = tempfile.mkdtemp()
+try:
+    graphs = [reduced_graph(nThreads, os.path.join(output_dir, str(nThreads)))
+              for nThreads in threads]
+finally:
+    shutil.rmtree(output_dir)
+
+for i in range(1, len(threads)):
+    if graphs[i][0] != graphs[0][0]:
+        sys.stderr.write("With " + str(threads[i]) + " threads: " + str(graphs[i][0][0]) + " nodes and "
+                         + str(graphs[i][0][1]) + " edges remaining, with " + str(threads[0]) + " thread: "
+                         + str(graphs[0][0][0]) + " nodes and " + str(graphs[0][0][1]) + " edges\n")
+        sys.exit(1)
+    if graphs[i][1] != graphs[0][1]:
+        sys.stderr.write("With " + str(threads[i]) + " threads the reduced graph differs from the one with "
+                         + str(threads[0]) + " thread\n")
+        sys.exit(1)
+
+sys.exit(0)
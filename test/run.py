@@ -2,14 +2,17 @@
 import sys
 import subprocess
 
-if len(sys.argv) != 5:
-    sys.stderr.write("Usage: " + sys.argv[0] + " <executable> <check_executable> <input_file> <output_file>\n")
+if len(sys.argv) != 5 and len(sys.argv) != 6:
+    sys.stderr.write("Usage: " + sys.argv[0] + " <executable> <check_executable> <input_file> <output_file> [<objective>]\n")
     sys.exit(1)
 
 executable = sys.argv[1]
 check_executable = sys.argv[2]
 input_file = sys.argv[3]
 output_file = sys.argv[4]
+check_options = ""
+if len(sys.argv) == 6:
+    check_options = " -opt " + sys.argv[5]
 time_limit = 10
 threads = 1
 
@@ -20,7 +23,7 @@ if status != 0:
     sys.exit(status)
 else:
     print "Checking solution " + output_file
-    print(check_executable + " -stp " + input_file + " -s " + output_file)
-    status = subprocess.call(check_executable + " -stp " + input_file + " -s " + output_file, shell=True)
+    print(check_executable + " -stp " + input_file + " -s " + output_file + check_options)
+    status = subprocess.call(check_executable + " -stp " + input_file + " -s " + output_file + check_options, shell=True)
 
 sys.exit(status)